@@ -0,0 +1,550 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/miniconda/lib/cmake/c-ares/c-ares-config-version.cmake"
+  "/root/miniconda/lib/cmake/c-ares/c-ares-config.cmake"
+  "/root/miniconda/lib/cmake/c-ares/c-ares-targets-release.cmake"
+  "/root/miniconda/lib/cmake/c-ares/c-ares-targets.cmake"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/c/CMakeLists.txt"
+  "/root/repo/c/docs/CMakeLists.txt"
+  "/root/repo/c/examples/CMakeLists.txt"
+  "/root/repo/c/include/proton/annotations.h"
+  "/root/repo/c/include/proton/cid.h"
+  "/root/repo/c/include/proton/codec.h"
+  "/root/repo/c/include/proton/condition.h"
+  "/root/repo/c/include/proton/connection.h"
+  "/root/repo/c/include/proton/connection_driver.h"
+  "/root/repo/c/include/proton/cproton.i"
+  "/root/repo/c/include/proton/delivery.h"
+  "/root/repo/c/include/proton/disposition.h"
+  "/root/repo/c/include/proton/engine.h"
+  "/root/repo/c/include/proton/error.h"
+  "/root/repo/c/include/proton/event.h"
+  "/root/repo/c/include/proton/handlers.h"
+  "/root/repo/c/include/proton/import_export.h"
+  "/root/repo/c/include/proton/link.h"
+  "/root/repo/c/include/proton/listener.h"
+  "/root/repo/c/include/proton/log.h"
+  "/root/repo/c/include/proton/logger.h"
+  "/root/repo/c/include/proton/message.h"
+  "/root/repo/c/include/proton/messenger.h"
+  "/root/repo/c/include/proton/netaddr.h"
+  "/root/repo/c/include/proton/object.h"
+  "/root/repo/c/include/proton/proactor.h"
+  "/root/repo/c/include/proton/proactor_ext.h"
+  "/root/repo/c/include/proton/raw_connection.h"
+  "/root/repo/c/include/proton/reactor.h"
+  "/root/repo/c/include/proton/sasl.h"
+  "/root/repo/c/include/proton/sasl_plugin.h"
+  "/root/repo/c/include/proton/selectable.h"
+  "/root/repo/c/include/proton/session.h"
+  "/root/repo/c/include/proton/ssl.h"
+  "/root/repo/c/include/proton/terminus.h"
+  "/root/repo/c/include/proton/tls.h"
+  "/root/repo/c/include/proton/transport.h"
+  "/root/repo/c/include/proton/type_compat.h"
+  "/root/repo/c/include/proton/types.h"
+  "/root/repo/c/include/proton/url.h"
+  "/root/repo/c/include/proton/version.h.in"
+  "/root/repo/c/src/ProtonConfig.cmake.in"
+  "/root/repo/c/src/compiler/gcc/start.c"
+  "/root/repo/c/src/compiler/msvc/start.c"
+  "/root/repo/c/src/core/autodetect.c"
+  "/root/repo/c/src/core/autodetect.h"
+  "/root/repo/c/src/core/buffer.c"
+  "/root/repo/c/src/core/buffer.h"
+  "/root/repo/c/src/core/codec.c"
+  "/root/repo/c/src/core/config.h"
+  "/root/repo/c/src/core/connection_driver.c"
+  "/root/repo/c/src/core/consumers.h"
+  "/root/repo/c/src/core/data.h"
+  "/root/repo/c/src/core/decoder.c"
+  "/root/repo/c/src/core/decoder.h"
+  "/root/repo/c/src/core/dispatch_actions.h"
+  "/root/repo/c/src/core/dispatcher.c"
+  "/root/repo/c/src/core/dispatcher.h"
+  "/root/repo/c/src/core/emitters.h"
+  "/root/repo/c/src/core/encoder.c"
+  "/root/repo/c/src/core/encoder.h"
+  "/root/repo/c/src/core/engine-internal.h"
+  "/root/repo/c/src/core/engine.c"
+  "/root/repo/c/src/core/error.c"
+  "/root/repo/c/src/core/event.c"
+  "/root/repo/c/src/core/fixed_string.h"
+  "/root/repo/c/src/core/framing.c"
+  "/root/repo/c/src/core/framing.h"
+  "/root/repo/c/src/core/init.c"
+  "/root/repo/c/src/core/init.h"
+  "/root/repo/c/src/core/log.c"
+  "/root/repo/c/src/core/log_private.h"
+  "/root/repo/c/src/core/logger.c"
+  "/root/repo/c/src/core/logger_private.h"
+  "/root/repo/c/src/core/max_align.h"
+  "/root/repo/c/src/core/memory.c"
+  "/root/repo/c/src/core/memory.h"
+  "/root/repo/c/src/core/message-internal.h"
+  "/root/repo/c/src/core/message.c"
+  "/root/repo/c/src/core/object/iterator.c"
+  "/root/repo/c/src/core/object/list.c"
+  "/root/repo/c/src/core/object/map.c"
+  "/root/repo/c/src/core/object/object.c"
+  "/root/repo/c/src/core/object/record.c"
+  "/root/repo/c/src/core/object/string.c"
+  "/root/repo/c/src/core/object_private.h"
+  "/root/repo/c/src/core/transport.c"
+  "/root/repo/c/src/core/transport.h"
+  "/root/repo/c/src/core/types.c"
+  "/root/repo/c/src/core/util.c"
+  "/root/repo/c/src/core/util.h"
+  "/root/repo/c/src/core/util_str.h"
+  "/root/repo/c/src/core/value_dump.c"
+  "/root/repo/c/src/core/value_dump.h"
+  "/root/repo/c/src/extra/url.c"
+  "/root/repo/c/src/handlers/flowcontroller.c"
+  "/root/repo/c/src/handlers/handshaker.c"
+  "/root/repo/c/src/handlers/iohandler.c"
+  "/root/repo/c/src/libqpid-proton-core.pc.in"
+  "/root/repo/c/src/libqpid-proton-proactor.pc.in"
+  "/root/repo/c/src/libqpid-proton.pc.in"
+  "/root/repo/c/src/messenger/messenger.c"
+  "/root/repo/c/src/messenger/messenger.h"
+  "/root/repo/c/src/messenger/store.c"
+  "/root/repo/c/src/messenger/store.h"
+  "/root/repo/c/src/messenger/subscription.c"
+  "/root/repo/c/src/messenger/subscription.h"
+  "/root/repo/c/src/messenger/transform.c"
+  "/root/repo/c/src/messenger/transform.h"
+  "/root/repo/c/src/platform/platform.c"
+  "/root/repo/c/src/platform/platform.h"
+  "/root/repo/c/src/platform/platform_fmt.h"
+  "/root/repo/c/src/proactor/epoll-internal.h"
+  "/root/repo/c/src/proactor/epoll.c"
+  "/root/repo/c/src/proactor/epoll_name_lookup.h"
+  "/root/repo/c/src/proactor/epoll_name_lookup_async.c"
+  "/root/repo/c/src/proactor/epoll_name_lookup_sync.c"
+  "/root/repo/c/src/proactor/epoll_raw_connection.c"
+  "/root/repo/c/src/proactor/epoll_timer.c"
+  "/root/repo/c/src/proactor/epoll_uring.c"
+  "/root/repo/c/src/proactor/libuv.c"
+  "/root/repo/c/src/proactor/netaddr-internal.c"
+  "/root/repo/c/src/proactor/netaddr-internal.h"
+  "/root/repo/c/src/proactor/proactor-internal.c"
+  "/root/repo/c/src/proactor/proactor-internal.h"
+  "/root/repo/c/src/proactor/raw_connection-internal.h"
+  "/root/repo/c/src/proactor/raw_connection.c"
+  "/root/repo/c/src/proactor/win_iocp.cpp"
+  "/root/repo/c/src/reactor/acceptor.c"
+  "/root/repo/c/src/reactor/connection.c"
+  "/root/repo/c/src/reactor/handler.c"
+  "/root/repo/c/src/reactor/io.h"
+  "/root/repo/c/src/reactor/io/posix/io.c"
+  "/root/repo/c/src/reactor/io/posix/selector.c"
+  "/root/repo/c/src/reactor/io/windows/io.c"
+  "/root/repo/c/src/reactor/io/windows/iocp.c"
+  "/root/repo/c/src/reactor/io/windows/iocp.h"
+  "/root/repo/c/src/reactor/io/windows/selector.c"
+  "/root/repo/c/src/reactor/io/windows/write_pipeline.c"
+  "/root/repo/c/src/reactor/reactor.c"
+  "/root/repo/c/src/reactor/reactor.h"
+  "/root/repo/c/src/reactor/selectable.c"
+  "/root/repo/c/src/reactor/selectable.h"
+  "/root/repo/c/src/reactor/selector.h"
+  "/root/repo/c/src/reactor/timer.c"
+  "/root/repo/c/src/sasl/cyrus_sasl.c"
+  "/root/repo/c/src/sasl/cyrus_stub.c"
+  "/root/repo/c/src/sasl/default_sasl.c"
+  "/root/repo/c/src/sasl/sasl-internal.h"
+  "/root/repo/c/src/sasl/sasl.c"
+  "/root/repo/c/src/ssl/openssl.c"
+  "/root/repo/c/src/ssl/schannel.cpp"
+  "/root/repo/c/src/ssl/ssl-internal.h"
+  "/root/repo/c/src/ssl/ssl_stub.c"
+  "/root/repo/c/src/tls/openssl.c"
+  "/root/repo/c/tests/CMakeLists.txt"
+  "/root/repo/c/tests/fuzz/CMakeLists.txt"
+  "/root/repo/c/tools/CMakeLists.txt"
+  "/root/repo/c/versions.cmake"
+  "/root/repo/cpp/CMakeLists.txt"
+  "/root/repo/cpp/ProtonCppConfig.cmake.in"
+  "/root/repo/cpp/docs/CMakeLists.txt"
+  "/root/repo/cpp/examples/CMakeLists.txt"
+  "/root/repo/cpp/libqpid-proton-cpp.pc.in"
+  "/root/repo/cpp/tests.cmake"
+  "/root/repo/cpp/versions.cmake"
+  "/root/repo/go/CMakeLists.txt"
+  "/root/repo/go/examples/CMakeLists.txt"
+  "/root/repo/misc/config.bat.in"
+  "/root/repo/misc/config.sh.in"
+  "/root/repo/python/CMakeLists.txt"
+  "/root/repo/tests/CMakeLists.txt"
+  "/root/repo/tests/PNAddTest.cmake"
+  "/root/repo/tests/RuntimeCheck.cmake"
+  "/root/repo/tests/cpp/CMakeLists.txt"
+  "/root/repo/tests/examples/CMakeLists.txt"
+  "/root/repo/tools/cmake/Modules/CheckPythonModule.cmake"
+  "/root/repo/tools/cmake/Modules/FindCyrusSASL.cmake"
+  "/root/repo/tools/cmake/Modules/FindJsonCpp.cmake"
+  "/root/repo/tools/cmake/config/ProtonConfig.cmake"
+  "/root/repo/tools/cmake/config/ProtonCppConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/BasicConfigVersion-AnyNewerVersion.cmake.in"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeDependentOption.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakePackageConfigHelpers.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeParseArguments.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CTest.cmake"
+  "/usr/share/cmake-3.25/Modules/CTestTargets.cmake"
+  "/usr/share/cmake-3.25/Modules/CTestUseLaunchers.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLanguage.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckSymbolExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/DartConfiguration.tcl.in"
+  "/usr/share/cmake-3.25/Modules/FindDoxygen.cmake"
+  "/usr/share/cmake-3.25/Modules/FindOpenSSL.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPkgConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython/Support.cmake"
+  "/usr/share/cmake-3.25/Modules/FindSWIG.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/WriteBasicConfigVersionFile.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "DartConfiguration.tcl"
+  "DartConfiguration.tcl"
+  "config.sh"
+  "config.bat"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "c/include/proton/version.h"
+  "c/include/proton/annotations.h"
+  "c/include/proton/cid.h"
+  "c/include/proton/codec.h"
+  "c/include/proton/condition.h"
+  "c/include/proton/connection.h"
+  "c/include/proton/connection_driver.h"
+  "c/include/proton/cproton.i"
+  "c/include/proton/delivery.h"
+  "c/include/proton/disposition.h"
+  "c/include/proton/engine.h"
+  "c/include/proton/error.h"
+  "c/include/proton/event.h"
+  "c/include/proton/handlers.h"
+  "c/include/proton/import_export.h"
+  "c/include/proton/link.h"
+  "c/include/proton/listener.h"
+  "c/include/proton/log.h"
+  "c/include/proton/logger.h"
+  "c/include/proton/message.h"
+  "c/include/proton/messenger.h"
+  "c/include/proton/netaddr.h"
+  "c/include/proton/object.h"
+  "c/include/proton/proactor.h"
+  "c/include/proton/proactor_ext.h"
+  "c/include/proton/raw_connection.h"
+  "c/include/proton/reactor.h"
+  "c/include/proton/sasl.h"
+  "c/include/proton/sasl_plugin.h"
+  "c/include/proton/selectable.h"
+  "c/include/proton/session.h"
+  "c/include/proton/ssl.h"
+  "c/include/proton/terminus.h"
+  "c/include/proton/tls.h"
+  "c/include/proton/transport.h"
+  "c/include/proton/type_compat.h"
+  "c/include/proton/types.h"
+  "c/include/proton/url.h"
+  "c/src/compiler/gcc/start.c"
+  "c/src/compiler/msvc/start.c"
+  "c/src/core/autodetect.c"
+  "c/src/core/autodetect.h"
+  "c/src/core/buffer.c"
+  "c/src/core/buffer.h"
+  "c/src/core/codec.c"
+  "c/src/core/config.h"
+  "c/src/core/connection_driver.c"
+  "c/src/core/consumers.h"
+  "c/src/core/data.h"
+  "c/src/core/decoder.c"
+  "c/src/core/decoder.h"
+  "c/src/core/dispatch_actions.h"
+  "c/src/core/dispatcher.c"
+  "c/src/core/dispatcher.h"
+  "c/src/core/emitters.h"
+  "c/src/core/encoder.c"
+  "c/src/core/encoder.h"
+  "c/src/core/engine-internal.h"
+  "c/src/core/engine.c"
+  "c/src/core/error.c"
+  "c/src/core/event.c"
+  "c/src/core/fixed_string.h"
+  "c/src/core/framing.c"
+  "c/src/core/framing.h"
+  "c/src/core/init.c"
+  "c/src/core/init.h"
+  "c/src/core/log.c"
+  "c/src/core/log_private.h"
+  "c/src/core/logger.c"
+  "c/src/core/logger_private.h"
+  "c/src/core/max_align.h"
+  "c/src/core/memory.c"
+  "c/src/core/memory.h"
+  "c/src/core/message-internal.h"
+  "c/src/core/message.c"
+  "c/src/core/object/iterator.c"
+  "c/src/core/object/list.c"
+  "c/src/core/object/map.c"
+  "c/src/core/object/object.c"
+  "c/src/core/object/record.c"
+  "c/src/core/object/string.c"
+  "c/src/core/object_private.h"
+  "c/src/core/transport.c"
+  "c/src/core/transport.h"
+  "c/src/core/types.c"
+  "c/src/core/util.c"
+  "c/src/core/util.h"
+  "c/src/core/util_str.h"
+  "c/src/core/value_dump.c"
+  "c/src/core/value_dump.h"
+  "c/src/extra/url.c"
+  "c/src/handlers/flowcontroller.c"
+  "c/src/handlers/handshaker.c"
+  "c/src/handlers/iohandler.c"
+  "c/src/messenger/messenger.c"
+  "c/src/messenger/messenger.h"
+  "c/src/messenger/store.c"
+  "c/src/messenger/store.h"
+  "c/src/messenger/subscription.c"
+  "c/src/messenger/subscription.h"
+  "c/src/messenger/transform.c"
+  "c/src/messenger/transform.h"
+  "c/src/platform/platform.c"
+  "c/src/platform/platform.h"
+  "c/src/platform/platform_fmt.h"
+  "c/src/proactor/epoll-internal.h"
+  "c/src/proactor/epoll.c"
+  "c/src/proactor/epoll_name_lookup.h"
+  "c/src/proactor/epoll_name_lookup_async.c"
+  "c/src/proactor/epoll_name_lookup_sync.c"
+  "c/src/proactor/epoll_raw_connection.c"
+  "c/src/proactor/epoll_timer.c"
+  "c/src/proactor/epoll_uring.c"
+  "c/src/proactor/libuv.c"
+  "c/src/proactor/netaddr-internal.c"
+  "c/src/proactor/netaddr-internal.h"
+  "c/src/proactor/proactor-internal.c"
+  "c/src/proactor/proactor-internal.h"
+  "c/src/proactor/raw_connection-internal.h"
+  "c/src/proactor/raw_connection.c"
+  "c/src/proactor/win_iocp.cpp"
+  "c/src/reactor/acceptor.c"
+  "c/src/reactor/connection.c"
+  "c/src/reactor/handler.c"
+  "c/src/reactor/io.h"
+  "c/src/reactor/io/posix/io.c"
+  "c/src/reactor/io/posix/selector.c"
+  "c/src/reactor/io/windows/io.c"
+  "c/src/reactor/io/windows/iocp.c"
+  "c/src/reactor/io/windows/iocp.h"
+  "c/src/reactor/io/windows/selector.c"
+  "c/src/reactor/io/windows/write_pipeline.c"
+  "c/src/reactor/reactor.c"
+  "c/src/reactor/reactor.h"
+  "c/src/reactor/selectable.c"
+  "c/src/reactor/selectable.h"
+  "c/src/reactor/selector.h"
+  "c/src/reactor/timer.c"
+  "c/src/sasl/cyrus_sasl.c"
+  "c/src/sasl/cyrus_stub.c"
+  "c/src/sasl/default_sasl.c"
+  "c/src/sasl/sasl-internal.h"
+  "c/src/sasl/sasl.c"
+  "c/src/ssl/openssl.c"
+  "c/src/ssl/schannel.cpp"
+  "c/src/ssl/ssl-internal.h"
+  "c/src/ssl/ssl_stub.c"
+  "c/src/tls/openssl.c"
+  "c/libqpid-proton.pc"
+  "c/libqpid-proton-core.pc"
+  "c/libqpid-proton-proactor.pc"
+  "c/ProtonConfig.cmake"
+  "c/ProtonConfigVersion.cmake"
+  "c/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "c/docs/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "c/examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "c/tests/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "c/tests/fuzz/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "c/tools/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "cpp/libqpid-proton-cpp.pc"
+  "cpp/ProtonCppConfig.cmake"
+  "cpp/ProtonCppConfigVersion.cmake"
+  "cpp/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "cpp/examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "cpp/docs/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "go/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "go/examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "python/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/cpp/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/Experimental.dir/DependInfo.cmake"
+  "CMakeFiles/Nightly.dir/DependInfo.cmake"
+  "CMakeFiles/Continuous.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyMemoryCheck.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyStart.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyBuild.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyTest.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/NightlySubmit.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalStart.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalBuild.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalTest.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalSubmit.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousStart.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousBuild.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousTest.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousSubmit.dir/DependInfo.cmake"
+  "CMakeFiles/docs.dir/DependInfo.cmake"
+  "CMakeFiles/doc.dir/DependInfo.cmake"
+  "c/CMakeFiles/generated_c_files.dir/DependInfo.cmake"
+  "c/CMakeFiles/qpid-proton-core-objects.dir/DependInfo.cmake"
+  "c/CMakeFiles/qpid-proton-platform-io-objects.dir/DependInfo.cmake"
+  "c/CMakeFiles/qpid-proton-core.dir/DependInfo.cmake"
+  "c/CMakeFiles/qpid-proton-proactor-objects.dir/DependInfo.cmake"
+  "c/CMakeFiles/qpid-proton-proactor.dir/DependInfo.cmake"
+  "c/CMakeFiles/qpid-proton.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-broker.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-send.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-receive.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-direct.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-send-abort.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-send-ssl.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-raw_echo.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-raw_connect.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-send-fd.dir/DependInfo.cmake"
+  "c/examples/CMakeFiles/c-direct-fd.dir/DependInfo.cmake"
+  "c/tests/CMakeFiles/test_main.dir/DependInfo.cmake"
+  "c/tests/CMakeFiles/c-core-test.dir/DependInfo.cmake"
+  "c/tests/CMakeFiles/c-extra-test.dir/DependInfo.cmake"
+  "c/tests/CMakeFiles/c-proactor-test.dir/DependInfo.cmake"
+  "c/tests/CMakeFiles/c-raw-connection-test.dir/DependInfo.cmake"
+  "c/tests/CMakeFiles/c-raw-connection-proactor-test.dir/DependInfo.cmake"
+  "c/tests/CMakeFiles/c-ssl-proactor-test.dir/DependInfo.cmake"
+  "c/tests/fuzz/CMakeFiles/StandaloneFuzzTargetMain.dir/DependInfo.cmake"
+  "c/tests/fuzz/CMakeFiles/fuzz-connection-driver.dir/DependInfo.cmake"
+  "c/tests/fuzz/CMakeFiles/fuzz-message-decode.dir/DependInfo.cmake"
+  "c/tests/fuzz/CMakeFiles/fuzz-url.dir/DependInfo.cmake"
+  "c/tests/fuzz/CMakeFiles/fuzz-sniff-header.dir/DependInfo.cmake"
+  "c/tools/CMakeFiles/msgr-recv.dir/DependInfo.cmake"
+  "c/tools/CMakeFiles/msgr-send.dir/DependInfo.cmake"
+  "c/tools/CMakeFiles/reactor-recv.dir/DependInfo.cmake"
+  "c/tools/CMakeFiles/reactor-send.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/qpid-proton-cpp.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/codec_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/connection_driver_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/interop_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/message_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/map_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/scalar_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/value_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/container_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/reconnect_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/link_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/credit_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/delivery_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/context_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/connect_config_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/pkcs11_test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/cpp-test.dir/DependInfo.cmake"
+  "cpp/CMakeFiles/cpp-core-test.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/broker.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/helloworld.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/simple_connect.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/simple_recv.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/simple_send.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/reconnect_client.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/message_properties.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/scheduled_send_03.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/direct_recv.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/direct_send.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/client.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/server.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/server_direct.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/connection_options.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/queue_browser.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/colour_send.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/selected_recv.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/flow_control.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/ssl.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/ssl_client_cert.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/encode_decode.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/scheduled_send.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/service_bus.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/multithreaded_client.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/multithreaded_client_flow_control.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/tx_send.dir/DependInfo.cmake"
+  "cpp/examples/CMakeFiles/tx_recv.dir/DependInfo.cmake"
+  "go/CMakeFiles/go-pkg-link.dir/DependInfo.cmake"
+  "go/CMakeFiles/go-mod-link.dir/DependInfo.cmake"
+  "go/CMakeFiles/go-build.dir/DependInfo.cmake"
+  "go/examples/CMakeFiles/go_example_electron_broker.dir/DependInfo.cmake"
+  "go/examples/CMakeFiles/go_example_electron_receive.dir/DependInfo.cmake"
+  "go/examples/CMakeFiles/go_example_electron_send.dir/DependInfo.cmake"
+  "go/examples/CMakeFiles/go_example_proton_broker.dir/DependInfo.cmake"
+  "go/examples/CMakeFiles/go_example_test.dir/DependInfo.cmake"
+  "python/CMakeFiles/pysrc_copied.dir/DependInfo.cmake"
+  "python/CMakeFiles/pypkg_src_copied.dir/DependInfo.cmake"
+  "python/CMakeFiles/pytest_cffi.dir/DependInfo.cmake"
+  "tests/cpp/CMakeFiles/tx_tester.dir/DependInfo.cmake"
+  )
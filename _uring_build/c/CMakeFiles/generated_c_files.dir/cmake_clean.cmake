@@ -0,0 +1,14 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generated_c_files"
+  "src/core/frame_consumers.c"
+  "src/core/frame_consumers.h"
+  "src/core/frame_generators.c"
+  "src/core/frame_generators.h"
+  "src/encodings.h"
+  "src/protocol.h"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/generated_c_files.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,57 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/src/compiler/gcc/start.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/compiler/gcc/start.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/compiler/gcc/start.c.o.d"
+  "/root/repo/c/src/core/autodetect.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/autodetect.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/autodetect.c.o.d"
+  "/root/repo/c/src/core/buffer.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/buffer.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/buffer.c.o.d"
+  "/root/repo/c/src/core/codec.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/codec.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/codec.c.o.d"
+  "/root/repo/c/src/core/connection_driver.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/connection_driver.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/connection_driver.c.o.d"
+  "/root/repo/c/src/core/decoder.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/decoder.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/decoder.c.o.d"
+  "/root/repo/c/src/core/dispatcher.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/dispatcher.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/dispatcher.c.o.d"
+  "/root/repo/c/src/core/encoder.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/encoder.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/encoder.c.o.d"
+  "/root/repo/c/src/core/engine.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/engine.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/engine.c.o.d"
+  "/root/repo/c/src/core/error.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/error.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/error.c.o.d"
+  "/root/repo/c/src/core/event.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/event.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/event.c.o.d"
+  "/root/repo/_uring_build/c/src/core/frame_consumers.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_consumers.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_consumers.c.o.d"
+  "/root/repo/_uring_build/c/src/core/frame_generators.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_generators.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_generators.c.o.d"
+  "/root/repo/c/src/core/framing.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/framing.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/framing.c.o.d"
+  "/root/repo/c/src/core/init.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/init.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/init.c.o.d"
+  "/root/repo/c/src/core/logger.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/logger.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/logger.c.o.d"
+  "/root/repo/c/src/core/memory.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/memory.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/memory.c.o.d"
+  "/root/repo/c/src/core/message.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/message.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/message.c.o.d"
+  "/root/repo/c/src/core/object/iterator.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/iterator.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/iterator.c.o.d"
+  "/root/repo/c/src/core/object/list.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/list.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/list.c.o.d"
+  "/root/repo/c/src/core/object/map.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/map.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/map.c.o.d"
+  "/root/repo/c/src/core/object/object.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/object.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/object.c.o.d"
+  "/root/repo/c/src/core/object/record.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/record.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/record.c.o.d"
+  "/root/repo/c/src/core/object/string.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/string.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/object/string.c.o.d"
+  "/root/repo/c/src/core/transport.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/transport.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/transport.c.o.d"
+  "/root/repo/c/src/core/types.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/types.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/types.c.o.d"
+  "/root/repo/c/src/core/util.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/util.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/util.c.o.d"
+  "/root/repo/c/src/core/value_dump.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/value_dump.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/core/value_dump.c.o.d"
+  "/root/repo/c/src/sasl/cyrus_stub.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/sasl/cyrus_stub.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/sasl/cyrus_stub.c.o.d"
+  "/root/repo/c/src/sasl/default_sasl.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/sasl/default_sasl.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/sasl/default_sasl.c.o.d"
+  "/root/repo/c/src/sasl/sasl.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/sasl/sasl.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/sasl/sasl.c.o.d"
+  "/root/repo/c/src/ssl/openssl.c" "c/CMakeFiles/qpid-proton-core-objects.dir/src/ssl/openssl.c.o" "gcc" "c/CMakeFiles/qpid-proton-core-objects.dir/src/ssl/openssl.c.o.d"
+  )
+
+# Pairs of files generated by the same build rule.
+set(CMAKE_MULTIPLE_OUTPUT_PAIRS
+  "/root/repo/_uring_build/c/src/core/frame_consumers.h" "/root/repo/_uring_build/c/src/core/frame_consumers.c"
+  "/root/repo/_uring_build/c/src/core/frame_generators.h" "/root/repo/_uring_build/c/src/core/frame_generators.c"
+  )
+
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
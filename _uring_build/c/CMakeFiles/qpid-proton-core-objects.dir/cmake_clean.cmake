@@ -0,0 +1,77 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/qpid-proton-core-objects.dir/src/compiler/gcc/start.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/compiler/gcc/start.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/autodetect.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/autodetect.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/buffer.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/buffer.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/codec.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/codec.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/connection_driver.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/connection_driver.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/decoder.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/decoder.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/dispatcher.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/dispatcher.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/encoder.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/encoder.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/engine.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/engine.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/error.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/error.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/event.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/event.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_consumers.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_consumers.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_generators.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/frame_generators.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/framing.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/framing.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/init.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/init.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/logger.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/logger.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/memory.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/memory.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/message.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/message.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/iterator.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/iterator.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/list.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/list.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/map.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/map.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/object.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/object.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/record.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/record.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/string.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/object/string.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/transport.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/transport.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/types.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/types.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/util.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/util.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/value_dump.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/core/value_dump.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/sasl/cyrus_stub.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/sasl/cyrus_stub.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/sasl/default_sasl.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/sasl/default_sasl.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/sasl/sasl.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/sasl/sasl.c.o.d"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/ssl/openssl.c.o"
+  "CMakeFiles/qpid-proton-core-objects.dir/src/ssl/openssl.c.o.d"
+  "src/core/frame_consumers.c"
+  "src/core/frame_consumers.h"
+  "src/core/frame_generators.c"
+  "src/core/frame_generators.h"
+  "src/encodings.h"
+  "src/protocol.h"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/qpid-proton-core-objects.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
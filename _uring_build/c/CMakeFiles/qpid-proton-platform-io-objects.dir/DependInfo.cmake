@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/src/platform/platform.c" "c/CMakeFiles/qpid-proton-platform-io-objects.dir/src/platform/platform.c.o" "gcc" "c/CMakeFiles/qpid-proton-platform-io-objects.dir/src/platform/platform.c.o.d"
+  "/root/repo/c/src/reactor/io/posix/io.c" "c/CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/io.c.o" "gcc" "c/CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/io.c.o.d"
+  "/root/repo/c/src/reactor/io/posix/selector.c" "c/CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/selector.c.o" "gcc" "c/CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/selector.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
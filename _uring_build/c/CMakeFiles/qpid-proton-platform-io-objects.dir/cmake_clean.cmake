@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/qpid-proton-platform-io-objects.dir/src/platform/platform.c.o"
+  "CMakeFiles/qpid-proton-platform-io-objects.dir/src/platform/platform.c.o.d"
+  "CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/io.c.o"
+  "CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/io.c.o.d"
+  "CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/selector.c.o"
+  "CMakeFiles/qpid-proton-platform-io-objects.dir/src/reactor/io/posix/selector.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/qpid-proton-platform-io-objects.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
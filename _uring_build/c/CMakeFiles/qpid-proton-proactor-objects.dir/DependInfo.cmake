@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/src/proactor/epoll.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll.c.o.d"
+  "/root/repo/c/src/proactor/epoll_name_lookup_async.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_name_lookup_async.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_name_lookup_async.c.o.d"
+  "/root/repo/c/src/proactor/epoll_raw_connection.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_raw_connection.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_raw_connection.c.o.d"
+  "/root/repo/c/src/proactor/epoll_timer.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_timer.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_timer.c.o.d"
+  "/root/repo/c/src/proactor/epoll_uring.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_uring.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_uring.c.o.d"
+  "/root/repo/c/src/proactor/netaddr-internal.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/netaddr-internal.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/netaddr-internal.c.o.d"
+  "/root/repo/c/src/proactor/proactor-internal.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/proactor-internal.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/proactor-internal.c.o.d"
+  "/root/repo/c/src/proactor/raw_connection.c" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/raw_connection.c.o" "gcc" "c/CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/raw_connection.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll.c.o.d"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_name_lookup_async.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_name_lookup_async.c.o.d"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_raw_connection.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_raw_connection.c.o.d"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_timer.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_timer.c.o.d"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_uring.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/epoll_uring.c.o.d"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/netaddr-internal.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/netaddr-internal.c.o.d"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/proactor-internal.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/proactor-internal.c.o.d"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/raw_connection.c.o"
+  "CMakeFiles/qpid-proton-proactor-objects.dir/src/proactor/raw_connection.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/qpid-proton-proactor-objects.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,40 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/src/core/log.c" "c/CMakeFiles/qpid-proton.dir/src/core/log.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/core/log.c.o.d"
+  "/root/repo/c/src/extra/url.c" "c/CMakeFiles/qpid-proton.dir/src/extra/url.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/extra/url.c.o.d"
+  "/root/repo/c/src/handlers/flowcontroller.c" "c/CMakeFiles/qpid-proton.dir/src/handlers/flowcontroller.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/handlers/flowcontroller.c.o.d"
+  "/root/repo/c/src/handlers/handshaker.c" "c/CMakeFiles/qpid-proton.dir/src/handlers/handshaker.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/handlers/handshaker.c.o.d"
+  "/root/repo/c/src/handlers/iohandler.c" "c/CMakeFiles/qpid-proton.dir/src/handlers/iohandler.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/handlers/iohandler.c.o.d"
+  "/root/repo/c/src/messenger/messenger.c" "c/CMakeFiles/qpid-proton.dir/src/messenger/messenger.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/messenger/messenger.c.o.d"
+  "/root/repo/c/src/messenger/store.c" "c/CMakeFiles/qpid-proton.dir/src/messenger/store.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/messenger/store.c.o.d"
+  "/root/repo/c/src/messenger/subscription.c" "c/CMakeFiles/qpid-proton.dir/src/messenger/subscription.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/messenger/subscription.c.o.d"
+  "/root/repo/c/src/messenger/transform.c" "c/CMakeFiles/qpid-proton.dir/src/messenger/transform.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/messenger/transform.c.o.d"
+  "/root/repo/c/src/reactor/acceptor.c" "c/CMakeFiles/qpid-proton.dir/src/reactor/acceptor.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/reactor/acceptor.c.o.d"
+  "/root/repo/c/src/reactor/connection.c" "c/CMakeFiles/qpid-proton.dir/src/reactor/connection.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/reactor/connection.c.o.d"
+  "/root/repo/c/src/reactor/handler.c" "c/CMakeFiles/qpid-proton.dir/src/reactor/handler.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/reactor/handler.c.o.d"
+  "/root/repo/c/src/reactor/reactor.c" "c/CMakeFiles/qpid-proton.dir/src/reactor/reactor.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/reactor/reactor.c.o.d"
+  "/root/repo/c/src/reactor/selectable.c" "c/CMakeFiles/qpid-proton.dir/src/reactor/selectable.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/reactor/selectable.c.o.d"
+  "/root/repo/c/src/reactor/timer.c" "c/CMakeFiles/qpid-proton.dir/src/reactor/timer.c.o" "gcc" "c/CMakeFiles/qpid-proton.dir/src/reactor/timer.c.o.d"
+  )
+
+# Pairs of files generated by the same build rule.
+set(CMAKE_MULTIPLE_OUTPUT_PAIRS
+  "/root/repo/_uring_build/c/libqpid-proton.so" "/root/repo/_uring_build/c/libqpid-proton.so.11.19.0"
+  "/root/repo/_uring_build/c/libqpid-proton.so.11" "/root/repo/_uring_build/c/libqpid-proton.so.11.19.0"
+  )
+
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
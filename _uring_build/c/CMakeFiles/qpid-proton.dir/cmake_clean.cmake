@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/qpid-proton.dir/src/core/log.c.o"
+  "CMakeFiles/qpid-proton.dir/src/core/log.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/extra/url.c.o"
+  "CMakeFiles/qpid-proton.dir/src/extra/url.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/handlers/flowcontroller.c.o"
+  "CMakeFiles/qpid-proton.dir/src/handlers/flowcontroller.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/handlers/handshaker.c.o"
+  "CMakeFiles/qpid-proton.dir/src/handlers/handshaker.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/handlers/iohandler.c.o"
+  "CMakeFiles/qpid-proton.dir/src/handlers/iohandler.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/messenger/messenger.c.o"
+  "CMakeFiles/qpid-proton.dir/src/messenger/messenger.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/messenger/store.c.o"
+  "CMakeFiles/qpid-proton.dir/src/messenger/store.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/messenger/subscription.c.o"
+  "CMakeFiles/qpid-proton.dir/src/messenger/subscription.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/messenger/transform.c.o"
+  "CMakeFiles/qpid-proton.dir/src/messenger/transform.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/reactor/acceptor.c.o"
+  "CMakeFiles/qpid-proton.dir/src/reactor/acceptor.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/reactor/connection.c.o"
+  "CMakeFiles/qpid-proton.dir/src/reactor/connection.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/reactor/handler.c.o"
+  "CMakeFiles/qpid-proton.dir/src/reactor/handler.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/reactor/reactor.c.o"
+  "CMakeFiles/qpid-proton.dir/src/reactor/reactor.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/reactor/selectable.c.o"
+  "CMakeFiles/qpid-proton.dir/src/reactor/selectable.c.o.d"
+  "CMakeFiles/qpid-proton.dir/src/reactor/timer.c.o"
+  "CMakeFiles/qpid-proton.dir/src/reactor/timer.c.o.d"
+  "libqpid-proton.pdb"
+  "libqpid-proton.so"
+  "libqpid-proton.so.11"
+  "libqpid-proton.so.11.19.0"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/qpid-proton.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/c
+# Build directory: /root/repo/_uring_build/c
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("docs")
+subdirs("examples")
+subdirs("tests")
+subdirs("tools")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-broker.dir/broker.c.o"
+  "CMakeFiles/c-broker.dir/broker.c.o.d"
+  "broker"
+  "broker.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-broker.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-direct-fd.dir/direct-fd.c.o"
+  "CMakeFiles/c-direct-fd.dir/direct-fd.c.o.d"
+  "direct-fd"
+  "direct-fd.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-direct-fd.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-direct.dir/direct.c.o"
+  "CMakeFiles/c-direct.dir/direct.c.o.d"
+  "direct"
+  "direct.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-direct.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
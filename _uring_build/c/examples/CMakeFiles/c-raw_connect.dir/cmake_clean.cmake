@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-raw_connect.dir/raw_connect.c.o"
+  "CMakeFiles/c-raw_connect.dir/raw_connect.c.o.d"
+  "raw_connect"
+  "raw_connect.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-raw_connect.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-raw_echo.dir/raw_echo.c.o"
+  "CMakeFiles/c-raw_echo.dir/raw_echo.c.o.d"
+  "raw_echo"
+  "raw_echo.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-raw_echo.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
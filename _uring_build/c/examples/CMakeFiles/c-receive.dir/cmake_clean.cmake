@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-receive.dir/receive.c.o"
+  "CMakeFiles/c-receive.dir/receive.c.o.d"
+  "receive"
+  "receive.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-receive.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
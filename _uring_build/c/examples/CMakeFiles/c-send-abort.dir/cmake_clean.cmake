@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-send-abort.dir/send-abort.c.o"
+  "CMakeFiles/c-send-abort.dir/send-abort.c.o.d"
+  "send-abort"
+  "send-abort.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-send-abort.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-send-fd.dir/send-fd.c.o"
+  "CMakeFiles/c-send-fd.dir/send-fd.c.o.d"
+  "send-fd"
+  "send-fd.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-send-fd.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-send-ssl.dir/send-ssl.c.o"
+  "CMakeFiles/c-send-ssl.dir/send-ssl.c.o.d"
+  "send-ssl"
+  "send-ssl.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-send-ssl.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
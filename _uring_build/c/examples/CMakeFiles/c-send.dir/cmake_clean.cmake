@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-send.dir/send.c.o"
+  "CMakeFiles/c-send.dir/send.c.o.d"
+  "send"
+  "send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c-send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,328 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include <proton/error.h>
+#include <proton/object.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "buffer.h"
+#include "memory.h"
+#include "util.h"
+
+struct pn_buffer_t {
+  char *bytes;
+  uint32_t capacity;
+  uint32_t start;
+  uint32_t size;
+  bool embedded; // bytes live in the same allocation as the buffer
+};
+
+PN_STRUCT_CLASSDEF(pn_buffer)
+
+pn_buffer_t *pn_buffer(size_t capacity)
+{
+  pn_buffer_t *buf = (pn_buffer_t *) pni_mem_allocate(PN_CLASSCLASS(pn_buffer), sizeof(pn_buffer_t));
+  if (buf != NULL) {
+    buf->capacity = capacity;
+    buf->start = 0;
+    buf->size = 0;
+    buf->embedded = false;
+    if (capacity > 0) {
+        buf->bytes = (char *) pni_mem_suballocate(PN_CLASSCLASS(pn_buffer), buf, capacity);
+        if (buf->bytes == NULL) {
+            pni_mem_deallocate(PN_CLASSCLASS(pn_buffer), buf);
+            buf = NULL;
+        }
+    }
+    else {
+        buf->bytes = NULL;
+    }
+  }
+  return buf;
+}
+
+// A buffer whose first capacity bytes are allocated along with it. It only
+// needs a separate allocation once it has to grow past them.
+pn_buffer_t *pni_buffer_inline(size_t capacity)
+{
+  pn_buffer_t *buf = (pn_buffer_t *) pni_mem_allocate(PN_CLASSCLASS(pn_buffer), sizeof(pn_buffer_t) + capacity);
+  if (buf != NULL) {
+    buf->capacity = capacity;
+    buf->start = 0;
+    buf->size = 0;
+    buf->embedded = capacity > 0;
+    buf->bytes = capacity > 0 ? (char *) (buf + 1) : NULL;
+  }
+  return buf;
+}
+
+void pn_buffer_free(pn_buffer_t *buf)
+{
+  if (buf) {
+    if (!buf->embedded) pni_mem_subdeallocate(PN_CLASSCLASS(pn_buffer), buf, buf->bytes);
+    pni_mem_deallocate(PN_CLASSCLASS(pn_buffer), buf);
+  }
+}
+
+size_t pn_buffer_size(pn_buffer_t *buf)
+{
+  return buf->size;
+}
+
+size_t pn_buffer_capacity(pn_buffer_t *buf)
+{
+  return buf->capacity;
+}
+
+size_t pn_buffer_available(pn_buffer_t *buf)
+{
+  return buf->capacity - buf->size;
+}
+
+static size_t pni_buffer_head(pn_buffer_t *buf)
+{
+  return buf->start;
+}
+
+static size_t pni_buffer_tail(pn_buffer_t *buf)
+{
+  size_t tail = buf->start + buf->size;
+  if (tail >= buf->capacity)
+    tail -= buf->capacity;
+  return tail;
+}
+
+static bool pni_buffer_wrapped(pn_buffer_t *buf)
+{
+  return buf->size && pni_buffer_head(buf) >= pni_buffer_tail(buf);
+}
+
+static size_t pni_buffer_tail_space(pn_buffer_t *buf)
+{
+  if (pni_buffer_wrapped(buf)) {
+    return pn_buffer_available(buf);
+  } else {
+    return buf->capacity - pni_buffer_tail(buf);
+  }
+}
+
+int pn_buffer_ensure(pn_buffer_t *buf, size_t size)
+{
+  if (pn_buffer_available(buf) >= size) return 0;
+
+  size_t old_capacity = buf->capacity;
+  size_t old_head = pni_buffer_head(buf);
+  // Contents that end exactly at the end of the space are not really wrapped,
+  // and moving them to the end of the new space would only cost a rotate later
+  bool wrapped = buf->start + buf->size > buf->capacity;
+
+  uint32_t needed = (uint32_t)(buf->size + size);
+  if (needed < 32) needed = 32;
+  uint32_t new_capacity = pni_round_up_pow2(needed);
+
+  if (buf->embedded) {
+    // Spill out of the embedded bytes, unwrapping the contents on the way
+    char *new_bytes = (char *) pni_mem_suballocate(PN_CLASSCLASS(pn_buffer), buf, new_capacity);
+    if (!new_bytes) {
+      return PN_OUT_OF_MEMORY;
+    }
+    pn_buffer_get(buf, 0, buf->size, new_bytes);
+    buf->bytes = new_bytes;
+    buf->capacity = new_capacity;
+    buf->start = 0;
+    buf->embedded = false;
+    return 0;
+  }
+
+  char* new_bytes = (char *) pni_mem_subreallocate(PN_CLASSCLASS(pn_buffer), buf, buf->bytes, new_capacity);
+  if (!new_bytes) {
+    return PN_OUT_OF_MEMORY;
+  }
+  buf->bytes = new_bytes;
+  buf->capacity = new_capacity;
+
+  if (wrapped) {
+    size_t n = old_capacity - old_head;
+    memmove(buf->bytes + buf->capacity - n, buf->bytes + old_head, n);
+    buf->start = buf->capacity - n;
+  }
+
+  return 0;
+}
+
+int pn_buffer_append(pn_buffer_t *buf, const char *bytes, size_t size)
+{
+  if (!size) return 0;
+  int err = pn_buffer_ensure(buf, size);
+  if (err) return err;
+
+  size_t tail = pni_buffer_tail(buf);
+  size_t tail_space = pni_buffer_tail_space(buf);
+  size_t n = pn_min(tail_space, size);
+
+  // Heuristic check for a strange usage in messenger
+  if (bytes!=buf->bytes+tail) {
+    memcpy(buf->bytes + tail, bytes, n);
+    memcpy(buf->bytes, bytes + n, size - n);
+  }
+  buf->size += size;
+
+  return 0;
+}
+
+static size_t pni_buffer_index(pn_buffer_t *buf, size_t index)
+{
+  size_t result = buf->start + index;
+  if (result >= buf->capacity) result -= buf->capacity;
+  return result;
+}
+
+size_t pn_buffer_get(pn_buffer_t *buf, size_t offset, size_t size, char *dst)
+{
+  size = pn_min(size, buf->size);
+  size_t start = pni_buffer_index(buf, offset);
+  size_t stop = pni_buffer_index(buf, offset + size);
+
+  if (size == 0) return 0;
+
+  size_t sz1;
+  size_t sz2;
+
+  if (start >= stop) {
+    sz1 = buf->capacity - start;
+    sz2 = stop;
+  } else {
+    sz1 = stop - start;
+    sz2 = 0;
+  }
+
+  memcpy(dst, buf->bytes + start, sz1);
+  memcpy(dst + sz1, buf->bytes, sz2);
+
+  return sz1 + sz2;
+}
+
+int pn_buffer_trim(pn_buffer_t *buf, size_t left, size_t right)
+{
+  if (left + right > buf->size) return PN_ARG_ERR;
+
+  // In special case where we trim everything just clear buffer
+  if (left + right == buf->size) {
+    pn_buffer_clear(buf);
+    return 0;
+  }
+  buf->start += left;
+  if (buf->start >= buf->capacity)
+    buf->start -= buf->capacity;
+
+  buf->size -= left + right;
+
+  return 0;
+}
+
+void pn_buffer_clear(pn_buffer_t *buf)
+{
+  buf->start = 0;
+  buf->size = 0;
+}
+
+// Describe [offset, offset+size) of the buffer contents in place: returns the
+// number of slices (0, 1 or 2 if the range wraps) without defragmenting.
+size_t pn_buffer_slices(pn_buffer_t *buf, size_t offset, size_t size, pn_bytes_t slices[2])
+{
+  if (offset >= buf->size) return 0;
+  size = pn_min(size, buf->size - offset);
+  if (size == 0) return 0;
+
+  size_t start = pni_buffer_index(buf, offset);
+  size_t sz1 = pn_min(size, buf->capacity - start);
+  slices[0] = (pn_bytes_t){.size=sz1, .start=buf->bytes + start};
+  if (sz1 == size) return 1;
+  slices[1] = (pn_bytes_t){.size=size - sz1, .start=buf->bytes};
+  return 2;
+}
+
+static void pn_buffer_rotate (pn_buffer_t *buf, size_t sz) {
+  if (sz == 0) return;
+
+  unsigned c = 0, v = 0;
+  for (; c < buf->capacity; v++) {
+    unsigned t = v, tp = v + sz;
+    char tmp = buf->bytes[v];
+    c++;
+    while (tp != v) {
+      buf->bytes[t] = buf->bytes[tp];
+      t = tp;
+      tp += sz;
+      if (tp >= buf->capacity) tp -= buf->capacity;
+      c++;
+    }
+    buf->bytes[t] = tmp;
+  }
+}
+
+static inline int pn_buffer_defrag(pn_buffer_t *buf)
+{
+  pn_buffer_rotate(buf, buf->start);
+  buf->start = 0;
+  return 0;
+}
+
+pn_bytes_t pn_buffer_bytes(pn_buffer_t *buf)
+{
+  if (!buf) {
+    return (pn_bytes_t){0, NULL};
+  }
+  pn_buffer_defrag(buf);
+  return (pn_bytes_t){.size=buf->size, .start=buf->bytes};
+}
+
+pn_rwbytes_t pn_buffer_memory(pn_buffer_t *buf)
+{
+  if (!buf) {
+    return (pn_rwbytes_t){0, NULL};
+  }
+  pn_buffer_defrag(buf);
+  return (pn_rwbytes_t){.size=buf->size, .start=buf->bytes};
+}
+
+// Replace [offset, offset+remove) of the contents with size bytes, moving
+// only the contents that follow the range.
+int pni_buffer_splice(pn_buffer_t *buf, size_t offset, size_t remove, const char *bytes, size_t size)
+{
+  if (offset + remove > buf->size) return PN_ARG_ERR;
+  if (size > remove) {
+    int err = pn_buffer_ensure(buf, size - remove);
+    if (err) return err;
+  }
+  pn_buffer_defrag(buf);
+  size_t rest = buf->size - offset - remove;
+  if (size != remove) memmove(buf->bytes + offset + size, buf->bytes + offset + remove, rest);
+  if (size) memcpy(buf->bytes + offset, bytes, size);
+  buf->size = offset + size + rest;
+  return 0;
+}
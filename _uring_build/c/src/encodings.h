@@ -0,0 +1,46 @@
+/* generated from /root/repo/c/src/types.xml */
+#ifndef _PROTON_ENCODINGS_H
+#define _PROTON_ENCODINGS_H 1
+
+#define PNE_DESCRIPTOR          (0x00)
+#define PNE_NULL            (0x40)
+#define PNE_BOOLEAN         (0x56)
+#define PNE_TRUE            (0x41)
+#define PNE_FALSE           (0x42)
+#define PNE_UBYTE           (0x50)
+#define PNE_USHORT          (0x60)
+#define PNE_UINT            (0x70)
+#define PNE_SMALLUINT       (0x52)
+#define PNE_UINT0           (0x43)
+#define PNE_ULONG           (0x80)
+#define PNE_SMALLULONG      (0x53)
+#define PNE_ULONG0          (0x44)
+#define PNE_BYTE            (0x51)
+#define PNE_SHORT           (0x61)
+#define PNE_INT             (0x71)
+#define PNE_SMALLINT        (0x54)
+#define PNE_LONG            (0x81)
+#define PNE_SMALLLONG       (0x55)
+#define PNE_FLOAT           (0x72)
+#define PNE_DOUBLE          (0x82)
+#define PNE_DECIMAL32       (0x74)
+#define PNE_DECIMAL64       (0x84)
+#define PNE_DECIMAL128      (0x94)
+#define PNE_UTF32           (0x73)
+#define PNE_MS64            (0x83)
+#define PNE_UUID            (0x98)
+#define PNE_VBIN8           (0xa0)
+#define PNE_VBIN32          (0xb0)
+#define PNE_STR8_UTF8       (0xa1)
+#define PNE_STR32_UTF8      (0xb1)
+#define PNE_SYM8            (0xa3)
+#define PNE_SYM32           (0xb3)
+#define PNE_LIST0           (0x45)
+#define PNE_LIST8           (0xc0)
+#define PNE_LIST32          (0xd0)
+#define PNE_MAP8            (0xc1)
+#define PNE_MAP32           (0xd1)
+#define PNE_ARRAY8          (0xe0)
+#define PNE_ARRAY32         (0xf0)
+
+#endif /* encodings.h */
@@ -0,0 +1,30 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/tests/condition_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/condition_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/condition_test.cpp.o.d"
+  "/root/repo/c/tests/connection_driver_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/connection_driver_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/connection_driver_test.cpp.o.d"
+  "/root/repo/c/tests/data_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/data_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/data_test.cpp.o.d"
+  "/root/repo/c/tests/engine_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/engine_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/engine_test.cpp.o.d"
+  "/root/repo/c/tests/event_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/event_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/event_test.cpp.o.d"
+  "/root/repo/c/tests/message_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/message_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/message_test.cpp.o.d"
+  "/root/repo/c/tests/object_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/object_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/object_test.cpp.o.d"
+  "/root/repo/c/tests/pn_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/pn_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/pn_test.cpp.o.d"
+  "/root/repo/c/tests/pn_test_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/pn_test_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/pn_test_test.cpp.o.d"
+  "/root/repo/c/tests/refcount_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/refcount_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/refcount_test.cpp.o.d"
+  "/root/repo/c/tests/ssl_test.cpp" "c/tests/CMakeFiles/c-core-test.dir/ssl_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-core-test.dir/ssl_test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,31 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-core-test.dir/condition_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/condition_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/connection_driver_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/connection_driver_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/data_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/data_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/engine_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/engine_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/event_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/event_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/message_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/message_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/object_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/object_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/pn_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/pn_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/pn_test_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/pn_test_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/refcount_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/refcount_test.cpp.o.d"
+  "CMakeFiles/c-core-test.dir/ssl_test.cpp.o"
+  "CMakeFiles/c-core-test.dir/ssl_test.cpp.o.d"
+  "c-core-test"
+  "c-core-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/c-core-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-extra-test.dir/pn_test.cpp.o"
+  "CMakeFiles/c-extra-test.dir/pn_test.cpp.o.d"
+  "CMakeFiles/c-extra-test.dir/url_test.cpp.o"
+  "CMakeFiles/c-extra-test.dir/url_test.cpp.o.d"
+  "c-extra-test"
+  "c-extra-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/c-extra-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-proactor-test.dir/pn_test.cpp.o"
+  "CMakeFiles/c-proactor-test.dir/pn_test.cpp.o.d"
+  "CMakeFiles/c-proactor-test.dir/pn_test_proactor.cpp.o"
+  "CMakeFiles/c-proactor-test.dir/pn_test_proactor.cpp.o.d"
+  "CMakeFiles/c-proactor-test.dir/proactor_test.cpp.o"
+  "CMakeFiles/c-proactor-test.dir/proactor_test.cpp.o.d"
+  "c-proactor-test"
+  "c-proactor-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/c-proactor-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
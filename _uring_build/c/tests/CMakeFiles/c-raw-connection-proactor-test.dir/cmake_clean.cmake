@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-raw-connection-proactor-test.dir/pn_test.cpp.o"
+  "CMakeFiles/c-raw-connection-proactor-test.dir/pn_test.cpp.o.d"
+  "CMakeFiles/c-raw-connection-proactor-test.dir/pn_test_proactor.cpp.o"
+  "CMakeFiles/c-raw-connection-proactor-test.dir/pn_test_proactor.cpp.o.d"
+  "CMakeFiles/c-raw-connection-proactor-test.dir/raw_connection_proactor_test.cpp.o"
+  "CMakeFiles/c-raw-connection-proactor-test.dir/raw_connection_proactor_test.cpp.o.d"
+  "c-raw-connection-proactor-test"
+  "c-raw-connection-proactor-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C CXX)
+  include(CMakeFiles/c-raw-connection-proactor-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/tests/pn_test.cpp" "c/tests/CMakeFiles/c-raw-connection-test.dir/pn_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-raw-connection-test.dir/pn_test.cpp.o.d"
+  "/root/repo/c/tests/raw_connection_test.cpp" "c/tests/CMakeFiles/c-raw-connection-test.dir/raw_connection_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-raw-connection-test.dir/raw_connection_test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-raw-connection-test.dir/pn_test.cpp.o"
+  "CMakeFiles/c-raw-connection-test.dir/pn_test.cpp.o.d"
+  "CMakeFiles/c-raw-connection-test.dir/raw_connection_test.cpp.o"
+  "CMakeFiles/c-raw-connection-test.dir/raw_connection_test.cpp.o.d"
+  "c-raw-connection-test"
+  "c-raw-connection-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C CXX)
+  include(CMakeFiles/c-raw-connection-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
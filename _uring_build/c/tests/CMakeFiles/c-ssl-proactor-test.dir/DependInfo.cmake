@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/tests/pn_test.cpp" "c/tests/CMakeFiles/c-ssl-proactor-test.dir/pn_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-ssl-proactor-test.dir/pn_test.cpp.o.d"
+  "/root/repo/c/tests/pn_test_proactor.cpp" "c/tests/CMakeFiles/c-ssl-proactor-test.dir/pn_test_proactor.cpp.o" "gcc" "c/tests/CMakeFiles/c-ssl-proactor-test.dir/pn_test_proactor.cpp.o.d"
+  "/root/repo/c/tests/ssl_proactor_test.cpp" "c/tests/CMakeFiles/c-ssl-proactor-test.dir/ssl_proactor_test.cpp.o" "gcc" "c/tests/CMakeFiles/c-ssl-proactor-test.dir/ssl_proactor_test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-proactor.dir/DependInfo.cmake"
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/c-ssl-proactor-test.dir/pn_test.cpp.o"
+  "CMakeFiles/c-ssl-proactor-test.dir/pn_test.cpp.o.d"
+  "CMakeFiles/c-ssl-proactor-test.dir/pn_test_proactor.cpp.o"
+  "CMakeFiles/c-ssl-proactor-test.dir/pn_test_proactor.cpp.o.d"
+  "CMakeFiles/c-ssl-proactor-test.dir/ssl_proactor_test.cpp.o"
+  "CMakeFiles/c-ssl-proactor-test.dir/ssl_proactor_test.cpp.o.d"
+  "c-ssl-proactor-test"
+  "c-ssl-proactor-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/c-ssl-proactor-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,19 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/c/tests
+# Build directory: /root/repo/_uring_build/c/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(c-core-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/c-core-test")
+set_tests_properties(c-core-test PROPERTIES  WORKING_DIRECTORY "/root/repo/c/tests" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/CMakeLists.txt;49;pn_add_test;/root/repo/c/tests/CMakeLists.txt;58;add_c_test;/root/repo/c/tests/CMakeLists.txt;0;")
+add_test(c-extra-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/c-extra-test")
+set_tests_properties(c-extra-test PROPERTIES  WORKING_DIRECTORY "/root/repo/c/tests" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/CMakeLists.txt;49;pn_add_test;/root/repo/c/tests/CMakeLists.txt;73;add_c_test;/root/repo/c/tests/CMakeLists.txt;0;")
+add_test(c-proactor-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/c-proactor-test")
+set_tests_properties(c-proactor-test PROPERTIES  WORKING_DIRECTORY "/root/repo/c/tests" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/CMakeLists.txt;49;pn_add_test;/root/repo/c/tests/CMakeLists.txt;78;add_c_test;/root/repo/c/tests/CMakeLists.txt;0;")
+add_test(c-raw-connection-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/c-raw-connection-test")
+set_tests_properties(c-raw-connection-test PROPERTIES  WORKING_DIRECTORY "/root/repo/c/tests" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/CMakeLists.txt;49;pn_add_test;/root/repo/c/tests/CMakeLists.txt;81;add_c_test;/root/repo/c/tests/CMakeLists.txt;0;")
+add_test(c-raw-connection-proactor-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/c-raw-connection-proactor-test")
+set_tests_properties(c-raw-connection-proactor-test PROPERTIES  WORKING_DIRECTORY "/root/repo/c/tests" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/CMakeLists.txt;49;pn_add_test;/root/repo/c/tests/CMakeLists.txt;85;add_c_test;/root/repo/c/tests/CMakeLists.txt;0;")
+add_test(c-ssl-proactor-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/c-ssl-proactor-test")
+set_tests_properties(c-ssl-proactor-test PROPERTIES  WORKING_DIRECTORY "/root/repo/c/tests" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/CMakeLists.txt;49;pn_add_test;/root/repo/c/tests/CMakeLists.txt;89;add_c_test;/root/repo/c/tests/CMakeLists.txt;0;")
+subdirs("fuzz")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/StandaloneFuzzTargetMain.dir/StandaloneFuzzTargetInit.c.o"
+  "CMakeFiles/StandaloneFuzzTargetMain.dir/StandaloneFuzzTargetInit.c.o.d"
+  "CMakeFiles/StandaloneFuzzTargetMain.dir/StandaloneFuzzTargetMain.c.o"
+  "CMakeFiles/StandaloneFuzzTargetMain.dir/StandaloneFuzzTargetMain.c.o.d"
+  "libStandaloneFuzzTargetMain.a"
+  "libStandaloneFuzzTargetMain.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/StandaloneFuzzTargetMain.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
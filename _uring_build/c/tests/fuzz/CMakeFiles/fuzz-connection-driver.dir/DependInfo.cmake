@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/tests/fuzz/fuzz-connection-driver.c" "c/tests/fuzz/CMakeFiles/fuzz-connection-driver.dir/fuzz-connection-driver.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-connection-driver.dir/fuzz-connection-driver.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/c/tests/fuzz/CMakeFiles/StandaloneFuzzTargetMain.dir/DependInfo.cmake"
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fuzz-connection-driver.dir/fuzz-connection-driver.c.o"
+  "CMakeFiles/fuzz-connection-driver.dir/fuzz-connection-driver.c.o.d"
+  "fuzz-connection-driver"
+  "fuzz-connection-driver.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fuzz-connection-driver.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fuzz-message-decode.dir/fuzz-message-decode.c.o"
+  "CMakeFiles/fuzz-message-decode.dir/fuzz-message-decode.c.o.d"
+  "fuzz-message-decode"
+  "fuzz-message-decode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fuzz-message-decode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
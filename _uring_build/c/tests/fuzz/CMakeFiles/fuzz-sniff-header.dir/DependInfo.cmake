@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/src/core/autodetect.c" "c/tests/fuzz/CMakeFiles/fuzz-sniff-header.dir/__/__/src/core/autodetect.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-sniff-header.dir/__/__/src/core/autodetect.c.o.d"
+  "/root/repo/c/tests/fuzz/fuzz-sniff-header.c" "c/tests/fuzz/CMakeFiles/fuzz-sniff-header.dir/fuzz-sniff-header.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-sniff-header.dir/fuzz-sniff-header.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/c/tests/fuzz/CMakeFiles/StandaloneFuzzTargetMain.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fuzz-sniff-header.dir/__/__/src/core/autodetect.c.o"
+  "CMakeFiles/fuzz-sniff-header.dir/__/__/src/core/autodetect.c.o.d"
+  "CMakeFiles/fuzz-sniff-header.dir/fuzz-sniff-header.c.o"
+  "CMakeFiles/fuzz-sniff-header.dir/fuzz-sniff-header.c.o.d"
+  "fuzz-sniff-header"
+  "fuzz-sniff-header.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fuzz-sniff-header.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
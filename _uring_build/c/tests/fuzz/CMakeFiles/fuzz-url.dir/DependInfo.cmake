@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/c/src/core/memory.c" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/memory.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/memory.c.o.d"
+  "/root/repo/c/src/core/object/object.c" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/object/object.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/object/object.c.o.d"
+  "/root/repo/c/src/core/object/string.c" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/object/string.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/object/string.c.o.d"
+  "/root/repo/c/src/core/util.c" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/util.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/core/util.c.o.d"
+  "/root/repo/c/src/extra/url.c" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/extra/url.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/__/__/src/extra/url.c.o.d"
+  "/root/repo/c/tests/fuzz/fuzz-url.c" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/fuzz-url.c.o" "gcc" "c/tests/fuzz/CMakeFiles/fuzz-url.dir/fuzz-url.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/c/tests/fuzz/CMakeFiles/StandaloneFuzzTargetMain.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/memory.c.o"
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/memory.c.o.d"
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/object/object.c.o"
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/object/object.c.o.d"
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/object/string.c.o"
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/object/string.c.o.d"
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/util.c.o"
+  "CMakeFiles/fuzz-url.dir/__/__/src/core/util.c.o.d"
+  "CMakeFiles/fuzz-url.dir/__/__/src/extra/url.c.o"
+  "CMakeFiles/fuzz-url.dir/__/__/src/extra/url.c.o.d"
+  "CMakeFiles/fuzz-url.dir/fuzz-url.c.o"
+  "CMakeFiles/fuzz-url.dir/fuzz-url.c.o.d"
+  "fuzz-url"
+  "fuzz-url.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fuzz-url.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,14 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/c/tests/fuzz
+# Build directory: /root/repo/_uring_build/c/tests/fuzz
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(fuzz-connection-driver "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/fuzz/fuzz-connection-driver" "@/root/repo/_uring_build/c/tests/fuzz/fuzz-connection-driver-files")
+set_tests_properties(fuzz-connection-driver PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;63;pn_add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;79;pn_add_fuzz_test;/root/repo/c/tests/fuzz/CMakeLists.txt;0;")
+add_test(fuzz-message-decode "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/fuzz/fuzz-message-decode" "@/root/repo/_uring_build/c/tests/fuzz/fuzz-message-decode-files")
+set_tests_properties(fuzz-message-decode PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;63;pn_add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;81;pn_add_fuzz_test;/root/repo/c/tests/fuzz/CMakeLists.txt;0;")
+add_test(fuzz-url "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/fuzz/fuzz-url" "@/root/repo/_uring_build/c/tests/fuzz/fuzz-url-files")
+set_tests_properties(fuzz-url PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;63;pn_add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;85;pn_add_fuzz_test;/root/repo/c/tests/fuzz/CMakeLists.txt;0;")
+add_test(fuzz-sniff-header "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "/root/repo/_uring_build/c/tests/fuzz/fuzz-sniff-header" "@/root/repo/_uring_build/c/tests/fuzz/fuzz-sniff-header-files")
+set_tests_properties(fuzz-sniff-header PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;63;pn_add_test;/root/repo/c/tests/fuzz/CMakeLists.txt;103;pn_add_fuzz_test;/root/repo/c/tests/fuzz/CMakeLists.txt;0;")
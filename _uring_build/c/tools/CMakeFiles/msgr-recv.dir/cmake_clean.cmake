@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/msgr-recv.dir/msgr-common.c.o"
+  "CMakeFiles/msgr-recv.dir/msgr-common.c.o.d"
+  "CMakeFiles/msgr-recv.dir/msgr-recv.c.o"
+  "CMakeFiles/msgr-recv.dir/msgr-recv.c.o.d"
+  "msgr-recv"
+  "msgr-recv.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/msgr-recv.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
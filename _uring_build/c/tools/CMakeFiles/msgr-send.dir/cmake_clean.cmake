@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/msgr-send.dir/msgr-common.c.o"
+  "CMakeFiles/msgr-send.dir/msgr-common.c.o.d"
+  "CMakeFiles/msgr-send.dir/msgr-send.c.o"
+  "CMakeFiles/msgr-send.dir/msgr-send.c.o.d"
+  "msgr-send"
+  "msgr-send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/msgr-send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
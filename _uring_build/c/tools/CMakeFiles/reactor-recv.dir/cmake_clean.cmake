@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/reactor-recv.dir/msgr-common.c.o"
+  "CMakeFiles/reactor-recv.dir/msgr-common.c.o.d"
+  "CMakeFiles/reactor-recv.dir/reactor-recv.c.o"
+  "CMakeFiles/reactor-recv.dir/reactor-recv.c.o.d"
+  "reactor-recv"
+  "reactor-recv.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/reactor-recv.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/reactor-send.dir/msgr-common.c.o"
+  "CMakeFiles/reactor-send.dir/msgr-common.c.o.d"
+  "CMakeFiles/reactor-send.dir/reactor-send.c.o"
+  "CMakeFiles/reactor-send.dir/reactor-send.c.o.d"
+  "reactor-send"
+  "reactor-send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/reactor-send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
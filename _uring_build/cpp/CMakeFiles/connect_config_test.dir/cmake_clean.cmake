@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/connect_config_test.dir/src/connect_config_test.cpp.o"
+  "CMakeFiles/connect_config_test.dir/src/connect_config_test.cpp.o.d"
+  "connect_config_test"
+  "connect_config_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/connect_config_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
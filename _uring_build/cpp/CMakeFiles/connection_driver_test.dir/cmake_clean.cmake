@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/connection_driver_test.dir/src/connection_driver_test.cpp.o"
+  "CMakeFiles/connection_driver_test.dir/src/connection_driver_test.cpp.o.d"
+  "connection_driver_test"
+  "connection_driver_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/connection_driver_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
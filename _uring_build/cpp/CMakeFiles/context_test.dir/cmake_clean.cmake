@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/context_test.dir/src/context_test.cpp.o"
+  "CMakeFiles/context_test.dir/src/context_test.cpp.o.d"
+  "context_test"
+  "context_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/context_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/cpp/src/cpp-test.cpp" "cpp/CMakeFiles/cpp-core-test.dir/src/cpp-test.cpp.o" "gcc" "cpp/CMakeFiles/cpp-core-test.dir/src/cpp-test.cpp.o.d"
+  "/root/repo/cpp/src/object_test.cpp" "cpp/CMakeFiles/cpp-core-test.dir/src/object_test.cpp.o" "gcc" "cpp/CMakeFiles/cpp-core-test.dir/src/object_test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/cpp/CMakeFiles/qpid-proton-cpp.dir/DependInfo.cmake"
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cpp-core-test.dir/src/cpp-test.cpp.o"
+  "CMakeFiles/cpp-core-test.dir/src/cpp-test.cpp.o.d"
+  "CMakeFiles/cpp-core-test.dir/src/object_test.cpp.o"
+  "CMakeFiles/cpp-core-test.dir/src/object_test.cpp.o.d"
+  "cpp-core-test"
+  "cpp-core-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/cpp-core-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cpp-test.dir/src/cpp-test.cpp.o"
+  "CMakeFiles/cpp-test.dir/src/cpp-test.cpp.o.d"
+  "CMakeFiles/cpp-test.dir/src/url_test.cpp.o"
+  "CMakeFiles/cpp-test.dir/src/url_test.cpp.o.d"
+  "cpp-test"
+  "cpp-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/cpp-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/delivery_test.dir/src/delivery_test.cpp.o"
+  "CMakeFiles/delivery_test.dir/src/delivery_test.cpp.o.d"
+  "delivery_test"
+  "delivery_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/delivery_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/interop_test.dir/src/interop_test.cpp.o"
+  "CMakeFiles/interop_test.dir/src/interop_test.cpp.o.d"
+  "interop_test"
+  "interop_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/interop_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pkcs11_test.dir/src/pkcs11_test.cpp.o"
+  "CMakeFiles/pkcs11_test.dir/src/pkcs11_test.cpp.o.d"
+  "pkcs11_test"
+  "pkcs11_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pkcs11_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
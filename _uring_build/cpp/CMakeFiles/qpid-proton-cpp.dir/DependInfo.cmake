@@ -0,0 +1,83 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/cpp/src/binary.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/binary.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/binary.cpp.o.d"
+  "/root/repo/cpp/src/byte_array.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/byte_array.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/byte_array.cpp.o.d"
+  "/root/repo/cpp/src/connect_config.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connect_config.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connect_config.cpp.o.d"
+  "/root/repo/cpp/src/connection.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connection.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connection.cpp.o.d"
+  "/root/repo/cpp/src/connection_driver.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connection_driver.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connection_driver.cpp.o.d"
+  "/root/repo/cpp/src/connection_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connection_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/connection_options.cpp.o.d"
+  "/root/repo/cpp/src/container.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/container.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/container.cpp.o.d"
+  "/root/repo/cpp/src/contexts.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/contexts.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/contexts.cpp.o.d"
+  "/root/repo/cpp/src/data.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/data.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/data.cpp.o.d"
+  "/root/repo/cpp/src/decimal.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/decimal.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/decimal.cpp.o.d"
+  "/root/repo/cpp/src/decoder.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/decoder.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/decoder.cpp.o.d"
+  "/root/repo/cpp/src/delivery.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/delivery.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/delivery.cpp.o.d"
+  "/root/repo/cpp/src/duration.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/duration.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/duration.cpp.o.d"
+  "/root/repo/cpp/src/encoder.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/encoder.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/encoder.cpp.o.d"
+  "/root/repo/cpp/src/endpoint.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/endpoint.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/endpoint.cpp.o.d"
+  "/root/repo/cpp/src/error.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/error.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/error.cpp.o.d"
+  "/root/repo/cpp/src/error_condition.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/error_condition.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/error_condition.cpp.o.d"
+  "/root/repo/cpp/src/handler.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/handler.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/handler.cpp.o.d"
+  "/root/repo/cpp/src/init_tracer_stub.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/init_tracer_stub.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/init_tracer_stub.cpp.o.d"
+  "/root/repo/cpp/src/link.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/link.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/link.cpp.o.d"
+  "/root/repo/cpp/src/link_namer.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/link_namer.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/link_namer.cpp.o.d"
+  "/root/repo/cpp/src/listener.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/listener.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/listener.cpp.o.d"
+  "/root/repo/cpp/src/map.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/map.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/map.cpp.o.d"
+  "/root/repo/cpp/src/message.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/message.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/message.cpp.o.d"
+  "/root/repo/cpp/src/messaging_adapter.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/messaging_adapter.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/messaging_adapter.cpp.o.d"
+  "/root/repo/cpp/src/node_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/node_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/node_options.cpp.o.d"
+  "/root/repo/cpp/src/null.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/null.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/null.cpp.o.d"
+  "/root/repo/cpp/src/object.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/object.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/object.cpp.o.d"
+  "/root/repo/cpp/src/proactor_container_impl.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/proactor_container_impl.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/proactor_container_impl.cpp.o.d"
+  "/root/repo/cpp/src/proton_bits.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/proton_bits.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/proton_bits.cpp.o.d"
+  "/root/repo/cpp/src/receiver.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/receiver.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/receiver.cpp.o.d"
+  "/root/repo/cpp/src/receiver_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/receiver_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/receiver_options.cpp.o.d"
+  "/root/repo/cpp/src/reconnect_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/reconnect_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/reconnect_options.cpp.o.d"
+  "/root/repo/cpp/src/returned.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/returned.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/returned.cpp.o.d"
+  "/root/repo/cpp/src/sasl.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/sasl.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/sasl.cpp.o.d"
+  "/root/repo/cpp/src/scalar_base.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/scalar_base.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/scalar_base.cpp.o.d"
+  "/root/repo/cpp/src/sender.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/sender.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/sender.cpp.o.d"
+  "/root/repo/cpp/src/sender_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/sender_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/sender_options.cpp.o.d"
+  "/root/repo/cpp/src/session.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/session.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/session.cpp.o.d"
+  "/root/repo/cpp/src/session_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/session_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/session_options.cpp.o.d"
+  "/root/repo/cpp/src/source.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/source.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/source.cpp.o.d"
+  "/root/repo/cpp/src/ssl.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/ssl.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/ssl.cpp.o.d"
+  "/root/repo/cpp/src/ssl_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/ssl_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/ssl_options.cpp.o.d"
+  "/root/repo/cpp/src/target.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/target.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/target.cpp.o.d"
+  "/root/repo/cpp/src/terminus.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/terminus.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/terminus.cpp.o.d"
+  "/root/repo/cpp/src/timestamp.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/timestamp.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/timestamp.cpp.o.d"
+  "/root/repo/cpp/src/tracing_stub.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/tracing_stub.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/tracing_stub.cpp.o.d"
+  "/root/repo/cpp/src/tracker.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/tracker.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/tracker.cpp.o.d"
+  "/root/repo/cpp/src/transaction_options.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/transaction_options.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/transaction_options.cpp.o.d"
+  "/root/repo/cpp/src/transfer.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/transfer.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/transfer.cpp.o.d"
+  "/root/repo/cpp/src/transport.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/transport.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/transport.cpp.o.d"
+  "/root/repo/cpp/src/type_id.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/type_id.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/type_id.cpp.o.d"
+  "/root/repo/cpp/src/url.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/url.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/url.cpp.o.d"
+  "/root/repo/cpp/src/uuid.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/uuid.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/uuid.cpp.o.d"
+  "/root/repo/cpp/src/value.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/value.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/value.cpp.o.d"
+  "/root/repo/cpp/src/work_queue.cpp" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/work_queue.cpp.o" "gcc" "cpp/CMakeFiles/qpid-proton-cpp.dir/src/work_queue.cpp.o.d"
+  )
+
+# Pairs of files generated by the same build rule.
+set(CMAKE_MULTIPLE_OUTPUT_PAIRS
+  "/root/repo/_uring_build/cpp/libqpid-proton-cpp.so" "/root/repo/_uring_build/cpp/libqpid-proton-cpp.so.12.14.0"
+  "/root/repo/_uring_build/cpp/libqpid-proton-cpp.so.12" "/root/repo/_uring_build/cpp/libqpid-proton-cpp.so.12.14.0"
+  )
+
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-proactor.dir/DependInfo.cmake"
+  "/root/repo/_uring_build/c/CMakeFiles/qpid-proton-core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,123 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/qpid-proton-cpp.dir/src/binary.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/binary.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/byte_array.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/byte_array.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connect_config.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connect_config.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connection.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connection.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connection_driver.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connection_driver.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connection_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/connection_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/container.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/container.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/contexts.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/contexts.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/data.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/data.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/decimal.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/decimal.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/decoder.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/decoder.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/delivery.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/delivery.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/duration.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/duration.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/encoder.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/encoder.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/endpoint.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/endpoint.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/error.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/error.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/error_condition.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/error_condition.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/handler.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/handler.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/init_tracer_stub.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/init_tracer_stub.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/link.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/link.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/link_namer.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/link_namer.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/listener.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/listener.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/map.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/map.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/message.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/message.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/messaging_adapter.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/messaging_adapter.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/node_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/node_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/null.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/null.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/object.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/object.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/proactor_container_impl.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/proactor_container_impl.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/proton_bits.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/proton_bits.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/receiver.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/receiver.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/receiver_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/receiver_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/reconnect_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/reconnect_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/returned.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/returned.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/sasl.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/sasl.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/scalar_base.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/scalar_base.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/sender.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/sender.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/sender_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/sender_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/session.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/session.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/session_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/session_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/source.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/source.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/ssl.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/ssl.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/ssl_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/ssl_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/target.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/target.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/terminus.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/terminus.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/timestamp.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/timestamp.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/tracing_stub.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/tracing_stub.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/tracker.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/tracker.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/transaction_options.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/transaction_options.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/transfer.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/transfer.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/transport.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/transport.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/type_id.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/type_id.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/url.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/url.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/uuid.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/uuid.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/value.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/value.cpp.o.d"
+  "CMakeFiles/qpid-proton-cpp.dir/src/work_queue.cpp.o"
+  "CMakeFiles/qpid-proton-cpp.dir/src/work_queue.cpp.o.d"
+  "libqpid-proton-cpp.pdb"
+  "libqpid-proton-cpp.so"
+  "libqpid-proton-cpp.so.12"
+  "libqpid-proton-cpp.so.12.14.0"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/qpid-proton-cpp.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
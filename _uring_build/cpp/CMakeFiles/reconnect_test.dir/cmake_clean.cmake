@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/reconnect_test.dir/src/reconnect_test.cpp.o"
+  "CMakeFiles/reconnect_test.dir/src/reconnect_test.cpp.o.d"
+  "reconnect_test"
+  "reconnect_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/reconnect_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/scalar_test.dir/src/scalar_test.cpp.o"
+  "CMakeFiles/scalar_test.dir/src/scalar_test.cpp.o.d"
+  "scalar_test"
+  "scalar_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/scalar_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,42 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/cpp
+# Build directory: /root/repo/_uring_build/cpp
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(cpp-codec_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/codec_test")
+set_tests_properties(cpp-codec_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;53;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-connection_driver_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/connection_driver_test")
+set_tests_properties(cpp-connection_driver_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;54;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-interop_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/interop_test" "/root/repo/tests")
+set_tests_properties(cpp-interop_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;56;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-message_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/message_test")
+set_tests_properties(cpp-message_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;57;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-map_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/map_test")
+set_tests_properties(cpp-map_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;58;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-scalar_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/scalar_test")
+set_tests_properties(cpp-scalar_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;59;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-value_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/value_test")
+set_tests_properties(cpp-value_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;60;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-container_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/container_test")
+set_tests_properties(cpp-container_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;61;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-reconnect_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/reconnect_test")
+set_tests_properties(cpp-reconnect_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;62;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-link_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/link_test")
+set_tests_properties(cpp-link_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;63;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-credit_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/credit_test")
+set_tests_properties(cpp-credit_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;64;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-delivery_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/delivery_test")
+set_tests_properties(cpp-delivery_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;65;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-context_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/context_test")
+set_tests_properties(cpp-context_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;66;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-connect_config_test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/connect_config_test")
+set_tests_properties(cpp-connect_config_test PROPERTIES  WORKING_DIRECTORY "/root/repo/_uring_build/cpp" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;45;pn_add_test;/root/repo/cpp/tests.cmake;68;add_cpp_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-pkcs11_test "/root/repo/_uring_build/cpp/pkcs11_test")
+set_tests_properties(cpp-pkcs11_test PROPERTIES  SKIP_RETURN_CODE "127" _BACKTRACE_TRIPLES "/root/repo/cpp/tests.cmake;80;add_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-url-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/cpp-test" "[url]")
+set_tests_properties(cpp-url-test PROPERTIES  FAIL_REGULAR_EXPRESSION ".*No tests ran.*" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;103;pn_add_test;/root/repo/cpp/tests.cmake;120;add_catch_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+add_test(cpp-object-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "/root/repo/_uring_build/cpp/cpp-core-test" "[object]")
+set_tests_properties(cpp-object-test PROPERTIES  FAIL_REGULAR_EXPRESSION ".*No tests ran.*" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/cpp/tests.cmake;112;pn_add_test;/root/repo/cpp/tests.cmake;121;add_core_catch_test;/root/repo/cpp/tests.cmake;0;;/root/repo/cpp/CMakeLists.txt;245;include;/root/repo/cpp/CMakeLists.txt;0;")
+subdirs("examples")
+subdirs("docs")
@@ -0,0 +1,75 @@
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+
+# Name: Proton
+# Description: Qpid Proton C library
+# Version: 0.41.0
+# URL: http://qpid.apache.org/proton/
+
+
+####### Expanded from @PACKAGE_INIT@ by configure_package_config_file() #######
+####### Any changes to this file will be overwritten by the next CMake run ####
+####### The input file was ProtonCppConfig.cmake.in                            ########
+
+get_filename_component(PACKAGE_PREFIX_DIR "${CMAKE_CURRENT_LIST_DIR}/../../../" ABSOLUTE)
+
+macro(set_and_check _var _file)
+  set(${_var} "${_file}")
+  if(NOT EXISTS "${_file}")
+    message(FATAL_ERROR "File or directory ${_file} referenced by variable ${_var} does not exist !")
+  endif()
+endmacro()
+
+macro(check_required_components _NAME)
+  foreach(comp ${${_NAME}_FIND_COMPONENTS})
+    if(NOT ${_NAME}_${comp}_FOUND)
+      if(${_NAME}_FIND_REQUIRED_${comp})
+        set(${_NAME}_FOUND FALSE)
+      endif()
+    endif()
+  endforeach()
+endmacro()
+
+####################################################################################
+if (NOT ProtonCpp_USE_STATIC_LIBS)
+  include("${CMAKE_CURRENT_LIST_DIR}/ProtonCppTargets.cmake")
+else()
+  include("${CMAKE_CURRENT_LIST_DIR}/ProtonCppTargetsStatic.cmake")
+endif()
+
+set (ProtonCpp_VERSION 0.41.0)
+
+set_and_check (ProtonCpp_INCLUDE_DIRS ${PACKAGE_PREFIX_DIR}/include)
+set (ProtonCpp_LIBRARIES Proton::cpp)
+set (ProtonCpp_FOUND True)
+
+function(warn_components_not_found _NAME)
+  if (${_NAME}_FIND_QUIETLY)
+    return()
+  endif()
+
+  foreach(comp ${${_NAME}_FIND_COMPONENTS})
+    if(NOT ${_NAME}_${comp}_FOUND)
+      MESSAGE(STATUS "Requested ${_NAME} component ${comp} is NOT FOUND")
+    endif()
+  endforeach()
+endfunction()
+
+check_required_components(ProtonCpp)
+warn_components_not_found(ProtonCpp)
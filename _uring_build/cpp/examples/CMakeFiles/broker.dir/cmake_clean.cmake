@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/broker.dir/broker.cpp.o"
+  "CMakeFiles/broker.dir/broker.cpp.o.d"
+  "broker"
+  "broker.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/broker.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
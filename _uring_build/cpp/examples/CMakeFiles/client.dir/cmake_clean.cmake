@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/client.dir/client.cpp.o"
+  "CMakeFiles/client.dir/client.cpp.o.d"
+  "client"
+  "client.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/client.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
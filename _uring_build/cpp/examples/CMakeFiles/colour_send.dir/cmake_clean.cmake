@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/colour_send.dir/colour_send.cpp.o"
+  "CMakeFiles/colour_send.dir/colour_send.cpp.o.d"
+  "colour_send"
+  "colour_send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/colour_send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/connection_options.dir/connection_options.cpp.o"
+  "CMakeFiles/connection_options.dir/connection_options.cpp.o.d"
+  "connection_options"
+  "connection_options.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/connection_options.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/direct_recv.dir/direct_recv.cpp.o"
+  "CMakeFiles/direct_recv.dir/direct_recv.cpp.o.d"
+  "direct_recv"
+  "direct_recv.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/direct_recv.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
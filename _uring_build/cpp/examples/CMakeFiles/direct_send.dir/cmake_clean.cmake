@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/direct_send.dir/direct_send.cpp.o"
+  "CMakeFiles/direct_send.dir/direct_send.cpp.o.d"
+  "direct_send"
+  "direct_send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/direct_send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
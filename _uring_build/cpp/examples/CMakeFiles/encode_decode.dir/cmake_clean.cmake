@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/encode_decode.dir/encode_decode.cpp.o"
+  "CMakeFiles/encode_decode.dir/encode_decode.cpp.o.d"
+  "encode_decode"
+  "encode_decode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/encode_decode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
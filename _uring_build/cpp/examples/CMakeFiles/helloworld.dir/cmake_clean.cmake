@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/helloworld.dir/helloworld.cpp.o"
+  "CMakeFiles/helloworld.dir/helloworld.cpp.o.d"
+  "helloworld"
+  "helloworld.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/helloworld.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
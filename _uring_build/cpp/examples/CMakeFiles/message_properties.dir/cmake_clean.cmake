@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/message_properties.dir/message_properties.cpp.o"
+  "CMakeFiles/message_properties.dir/message_properties.cpp.o.d"
+  "message_properties"
+  "message_properties.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/message_properties.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multithreaded_client.dir/multithreaded_client.cpp.o"
+  "CMakeFiles/multithreaded_client.dir/multithreaded_client.cpp.o.d"
+  "multithreaded_client"
+  "multithreaded_client.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/multithreaded_client.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
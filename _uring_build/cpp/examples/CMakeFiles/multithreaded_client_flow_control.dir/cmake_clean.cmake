@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multithreaded_client_flow_control.dir/multithreaded_client_flow_control.cpp.o"
+  "CMakeFiles/multithreaded_client_flow_control.dir/multithreaded_client_flow_control.cpp.o.d"
+  "multithreaded_client_flow_control"
+  "multithreaded_client_flow_control.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/multithreaded_client_flow_control.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/queue_browser.dir/queue_browser.cpp.o"
+  "CMakeFiles/queue_browser.dir/queue_browser.cpp.o.d"
+  "queue_browser"
+  "queue_browser.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/queue_browser.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/reconnect_client.dir/reconnect_client.cpp.o"
+  "CMakeFiles/reconnect_client.dir/reconnect_client.cpp.o.d"
+  "reconnect_client"
+  "reconnect_client.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/reconnect_client.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
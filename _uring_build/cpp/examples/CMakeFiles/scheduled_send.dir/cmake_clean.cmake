@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/scheduled_send.dir/scheduled_send.cpp.o"
+  "CMakeFiles/scheduled_send.dir/scheduled_send.cpp.o.d"
+  "scheduled_send"
+  "scheduled_send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/scheduled_send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
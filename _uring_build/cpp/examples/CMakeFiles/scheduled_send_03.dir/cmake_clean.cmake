@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/scheduled_send_03.dir/scheduled_send_03.cpp.o"
+  "CMakeFiles/scheduled_send_03.dir/scheduled_send_03.cpp.o.d"
+  "scheduled_send_03"
+  "scheduled_send_03.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/scheduled_send_03.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
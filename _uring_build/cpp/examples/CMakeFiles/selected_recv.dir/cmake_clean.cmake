@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/selected_recv.dir/selected_recv.cpp.o"
+  "CMakeFiles/selected_recv.dir/selected_recv.cpp.o.d"
+  "selected_recv"
+  "selected_recv.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/selected_recv.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
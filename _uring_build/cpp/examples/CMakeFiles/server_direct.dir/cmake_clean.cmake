@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/server_direct.dir/server_direct.cpp.o"
+  "CMakeFiles/server_direct.dir/server_direct.cpp.o.d"
+  "server_direct"
+  "server_direct.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/server_direct.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/service_bus.dir/service_bus.cpp.o"
+  "CMakeFiles/service_bus.dir/service_bus.cpp.o.d"
+  "service_bus"
+  "service_bus.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/service_bus.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/simple_connect.dir/simple_connect.cpp.o"
+  "CMakeFiles/simple_connect.dir/simple_connect.cpp.o.d"
+  "simple_connect"
+  "simple_connect.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/simple_connect.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
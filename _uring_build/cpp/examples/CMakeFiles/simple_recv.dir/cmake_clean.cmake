@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/simple_recv.dir/simple_recv.cpp.o"
+  "CMakeFiles/simple_recv.dir/simple_recv.cpp.o.d"
+  "simple_recv"
+  "simple_recv.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/simple_recv.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/simple_send.dir/simple_send.cpp.o"
+  "CMakeFiles/simple_send.dir/simple_send.cpp.o.d"
+  "simple_send"
+  "simple_send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/simple_send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
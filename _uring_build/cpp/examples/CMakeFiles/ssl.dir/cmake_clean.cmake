@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ssl.dir/ssl.cpp.o"
+  "CMakeFiles/ssl.dir/ssl.cpp.o.d"
+  "ssl"
+  "ssl.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ssl.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ssl_client_cert.dir/ssl_client_cert.cpp.o"
+  "CMakeFiles/ssl_client_cert.dir/ssl_client_cert.cpp.o.d"
+  "ssl_client_cert"
+  "ssl_client_cert.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ssl_client_cert.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tx_recv.dir/tx_recv.cpp.o"
+  "CMakeFiles/tx_recv.dir/tx_recv.cpp.o.d"
+  "tx_recv"
+  "tx_recv.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tx_recv.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
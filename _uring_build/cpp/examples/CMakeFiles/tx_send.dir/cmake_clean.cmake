@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tx_send.dir/tx_send.cpp.o"
+  "CMakeFiles/tx_send.dir/tx_send.cpp.o.d"
+  "tx_send"
+  "tx_send.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tx_send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1 @@
+/root/repo/go/../go.mod
\ No newline at end of file
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/go-mod-link"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/go-mod-link.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/go-pkg-link"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/go-pkg-link.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
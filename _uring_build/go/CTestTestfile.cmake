@@ -0,0 +1,9 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/go
+# Build directory: /root/repo/_uring_build/go
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(go-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "GOPATH=/root/repo/_uring_build/go" "CGO_CFLAGS=-I/root/repo/_uring_build/c/include" "CGO_LDFLAGS=-L/root/repo/_uring_build/c" "PN_INTEROP_DIR=/root/repo/tests/interop" "SASLPASSWD=" "/usr/local/go/bin/go" "test" "-ldflags" "-r /root/repo/_uring_build/c" "-v" "/root/repo/_uring_build/go/pkg/...")
+set_tests_properties(go-test PROPERTIES  WORKING_DIRECTORY "/root/repo/_uring_build" _BACKTRACE_TRIPLES "/root/repo/go/CMakeLists.txt;83;add_test;/root/repo/go/CMakeLists.txt;0;")
+subdirs("examples")
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/go_example_electron_send"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/go_example_electron_send.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/go_example_proton_broker"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/go_example_proton_broker.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
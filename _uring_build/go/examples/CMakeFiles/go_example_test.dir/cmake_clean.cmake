@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/go_example_test"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/go_example_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/go/examples
+# Build directory: /root/repo/_uring_build/go/examples
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(go-example-electron "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "GOPATH=/root/repo/_uring_build/go" "CGO_CFLAGS=-I/root/repo/_uring_build/c/include" "CGO_LDFLAGS=-L/root/repo/_uring_build/c" "PN_INTEROP_DIR=/root/repo/tests/interop" "SASLPASSWD=" "/root/repo/_uring_build/go/examples/example_test" "-dir" "/root/repo/_uring_build/go/examples/electron" "-broker" "broker")
+set_tests_properties(go-example-electron PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/go/examples/CMakeLists.txt;45;pn_add_test;/root/repo/go/examples/CMakeLists.txt;0;")
+add_test(go-example-proton "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "GOPATH=/root/repo/_uring_build/go" "CGO_CFLAGS=-I/root/repo/_uring_build/c/include" "CGO_LDFLAGS=-L/root/repo/_uring_build/c" "PN_INTEROP_DIR=/root/repo/tests/interop" "SASLPASSWD=" "/root/repo/_uring_build/go/examples/example_test" "-dir" "/root/repo/_uring_build/go/examples/electron" "-broker" "../proton/broker")
+set_tests_properties(go-example-proton PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/go/examples/CMakeLists.txt;51;pn_add_test;/root/repo/go/examples/CMakeLists.txt;0;")
@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  ".timestamp.copied_pysrc"
+  "CMakeFiles/pypkg_src_copied"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/pypkg_src_copied.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
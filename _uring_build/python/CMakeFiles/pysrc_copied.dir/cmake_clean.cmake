@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pysrc_copied"
+  "MANIFEST.in"
+  "README.rst"
+  "VERSION.txt"
+  "cproton.h"
+  "cproton.py"
+  "cproton_ext.c"
+  "docs/conf.py"
+  "docs/index.rst"
+  "docs/overview.rst"
+  "docs/tutorial.rst"
+  "ext_build.py"
+  "ext_build_devtree.py"
+  "ext_build_unbundled.py"
+  "proton/__init__.py"
+  "proton/_common.py"
+  "proton/_condition.py"
+  "proton/_data.py"
+  "proton/_delivery.py"
+  "proton/_endpoints.py"
+  "proton/_events.py"
+  "proton/_exceptions.py"
+  "proton/_handler.py"
+  "proton/_handlers.py"
+  "proton/_io.py"
+  "proton/_message.py"
+  "proton/_reactor.py"
+  "proton/_selectable.py"
+  "proton/_tracing.py"
+  "proton/_transport.py"
+  "proton/_url.py"
+  "proton/_utils.py"
+  "proton/_wrapper.py"
+  "proton/handlers.py"
+  "proton/py.typed"
+  "proton/reactor.py"
+  "proton/tracing.py"
+  "proton/utils.py"
+  "pyproject.toml"
+  "setup.py"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/pysrc_copied.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
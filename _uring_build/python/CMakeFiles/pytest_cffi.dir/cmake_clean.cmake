@@ -0,0 +1,10 @@
+file(REMOVE_RECURSE
+  ".timestamp.test_env"
+  "CMakeFiles/pytest_cffi"
+  "pytest_env/bin/python"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/pytest_cffi.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/python
+# Build directory: /root/repo/_uring_build/python
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(python-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "PATH=/root/repo/_uring_build/c/tools::/root/.rbenv/bin:/root/.rbenv/shims:/root/.dotnet:/usr/local/go/bin:/root/go/bin:/root/.pyenv/bin:/root/.pyenv/shims:/root/.cargo/bin:/root/miniconda/bin:/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin" "PYTHONPATH=." "SASLPASSWD=" "/root/repo/_uring_build/python/pytest_env/bin/python" "--" "/root/repo/python/tests/proton-test")
+set_tests_properties(python-test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/python/CMakeLists.txt;278;pn_add_test;/root/repo/python/CMakeLists.txt;0;")
+add_test(python-integration-test "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "PATH=/root/repo/_uring_build/c/tools::/root/.rbenv/bin:/root/.rbenv/shims:/root/.dotnet:/usr/local/go/bin:/root/go/bin:/root/.pyenv/bin:/root/.pyenv/shims:/root/.cargo/bin:/root/miniconda/bin:/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin" "PYTHONPATH=.:/root/repo/python/tests:/root/repo/python:/root/repo/_uring_build/python:/root/repo/python/../tests/py" "SASLPASSWD=" "/root/repo/_uring_build/python/pytest_env/bin/python" "-m" "unittest" "discover" "-v" "-s" "/root/repo/python/tests/integration")
+set_tests_properties(python-integration-test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/python/CMakeLists.txt;288;pn_add_test;/root/repo/python/CMakeLists.txt;0;")
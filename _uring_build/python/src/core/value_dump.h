@@ -0,0 +1,40 @@
+#ifndef PROTON_VALUE_DUMP_H
+#define PROTON_VALUE_DUMP_H 1
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "proton/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pn_fixed_string_t;
+size_t pni_value_dump(pn_bytes_t frame, struct pn_fixed_string_t *output);
+
+PN_EXTERN size_t pn_value_dump(pn_bytes_t frame, char *output, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROTON_VALUE_DUMP_H
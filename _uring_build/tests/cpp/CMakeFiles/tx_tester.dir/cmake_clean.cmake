@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tx_tester.dir/tx_tester.cpp.o"
+  "CMakeFiles/tx_tester.dir/tx_tester.cpp.o.d"
+  "tx_tester"
+  "tx_tester.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tx_tester.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests/cpp
+# Build directory: /root/repo/_uring_build/tests/cpp
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(cpp-tx-tests "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "PATH=/root/.rbenv/bin:/root/.rbenv/shims:/root/.dotnet:/usr/local/go/bin:/root/go/bin:/root/.pyenv/bin:/root/.pyenv/shims:/root/.cargo/bin:/root/miniconda/bin:/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin" "TX_TESTER=/root/repo/_uring_build/tests/cpp/tx_tester" "TX_TESTER_PYTHON=/root/repo/_uring_build/python/pytest_env/bin/python" "TX_TESTER_BROKER=/root/repo/python/examples/broker.py" "TX_TESTER_SCRIPTS=/root/repo/tests/cpp/tx_tests" "/root/repo/_uring_build/python/pytest_env/bin/python" "-m" "unittest" "discover" "-v" "-s" "/root/repo/tests/cpp" "-p" "tx_tester.py")
+set_tests_properties(cpp-tx-tests PROPERTIES  RESOURCE_LOCK "amqp_5672" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/tests/cpp/CMakeLists.txt;44;pn_add_test;/root/repo/tests/cpp/CMakeLists.txt;0;")
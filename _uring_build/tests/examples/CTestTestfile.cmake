@@ -0,0 +1,12 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests/examples
+# Build directory: /root/repo/_uring_build/tests/examples
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(c-example-tests "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "PATH=/root/repo/_uring_build/c/examples:/root/.rbenv/bin:/root/.rbenv/shims:/root/.dotnet:/usr/local/go/bin:/root/go/bin:/root/.pyenv/bin:/root/.pyenv/shims:/root/.cargo/bin:/root/miniconda/bin:/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin" "SSL_CERT_DIR=/root/repo/tests/ssl-certs" "PYTHONPATH=/root/repo/tests/py" "/root/.pyenv/shims/python3" "testme" "-v")
+set_tests_properties(c-example-tests PROPERTIES  WORKING_DIRECTORY "/root/repo/c/examples" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/tests/examples/CMakeLists.txt;37;pn_add_test;/root/repo/tests/examples/CMakeLists.txt;0;")
+add_test(cpp-example-container "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "PATH=/root/repo/_uring_build/cpp/examples:/root/.rbenv/bin:/root/.rbenv/shims:/root/.dotnet:/usr/local/go/bin:/root/go/bin:/root/.pyenv/bin:/root/.pyenv/shims:/root/.cargo/bin:/root/miniconda/bin:/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "PYTHONPATH=/root/repo/tests/py" "/root/.pyenv/shims/python3" "/root/repo/cpp/examples/testme" "-v" "ContainerExampleTest")
+set_tests_properties(cpp-example-container PROPERTIES  WORKING_DIRECTORY "/root/repo/tests/examples" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/tests/examples/CMakeLists.txt;57;pn_add_test;/root/repo/tests/examples/CMakeLists.txt;0;")
+add_test(cpp-example-container-ssl "/root/.pyenv/shims/python3" "/root/repo/scripts/env.py" "--" "PATH=/root/repo/_uring_build/cpp/examples:/root/.rbenv/bin:/root/.rbenv/shims:/root/.dotnet:/usr/local/go/bin:/root/go/bin:/root/.pyenv/bin:/root/.pyenv/shims:/root/.cargo/bin:/root/miniconda/bin:/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin" "TEST_CERT_DIR=/root/repo/tests/ssl-certs" "PYTHONPATH=/root/repo/tests/py" "/root/.pyenv/shims/python3" "testme" "-v" "ContainerExampleSSLTest")
+set_tests_properties(cpp-example-container-ssl PROPERTIES  WORKING_DIRECTORY "/root/repo/cpp/examples" _BACKTRACE_TRIPLES "/root/repo/tests/PNAddTest.cmake;54;add_test;/root/repo/tests/examples/CMakeLists.txt;65;pn_add_test;/root/repo/tests/examples/CMakeLists.txt;0;")
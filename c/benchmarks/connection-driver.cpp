@@ -177,10 +177,31 @@ static void BM_EstablishConnection(benchmark::State &state) {
 
 BENCHMARK(BM_EstablishConnection)->Unit(benchmark::kMicrosecond);
 
+// Allocator that counts the calls that reach it. Allocations served from the
+// per-thread caches are not counted.
+static uint64_t allocations = 0;
+
+static void *counting_allocate(void *, size_t size) {
+  ++allocations;
+  return malloc(size);
+}
+
+static void *counting_reallocate(void *, void *ptr, size_t, size_t size) {
+  ++allocations;
+  return realloc(ptr, size);
+}
+
+static void counting_deallocate(void *, void *ptr, size_t) { free(ptr); }
+
+static const pn_allocator_t counting_allocator = {
+    counting_allocate, counting_reallocate, counting_deallocate, NULL};
+
 static void BM_SendReceiveMessages(benchmark::State &state) {
   if (VERBOSE)
     printf("BEGIN BM_SendReceiveMessages\n");
 
+  pn_set_allocator(&counting_allocator);
+
   app_data_t app = {};
   app.message_count = -1; // unlimited
   app.message = pn_message();
@@ -200,6 +221,7 @@ static void BM_SendReceiveMessages(benchmark::State &state) {
     exit(1);
   }
 
+  uint64_t start_allocations = allocations;
   for (auto _ : state) {
     pn_event_t *event;
     while ((event = pn_connection_driver_next_event(&sender)) != NULL) {
@@ -211,6 +233,7 @@ static void BM_SendReceiveMessages(benchmark::State &state) {
     }
     shovel(receiver, sender);
   }
+  uint64_t loop_allocations = allocations - start_allocations;
 
   pn_connection_driver_close(&receiver);
   pn_connection_driver_close(&sender);
@@ -222,8 +245,13 @@ static void BM_SendReceiveMessages(benchmark::State &state) {
   pn_connection_driver_destroy(&receiver);
   pn_connection_driver_destroy(&sender);
 
+  pn_message_free(app.message);
+  pn_set_allocator(NULL);
+
   state.SetLabel("messages");
   state.SetItemsProcessed(app.acknowledged);
+  state.counters["allocs/msg"] =
+      app.acknowledged ? double(loop_allocations) / app.acknowledged : 0;
 
   if (VERBOSE)
     printf("END BM_SendReceiveMessages\n");
@@ -293,6 +321,7 @@ static void handle_sender(app_data_t *app, pn_event_t *event) {
     /* We received acknowledgement from the peer that a message was delivered. */
     pn_delivery_t *d = pn_event_delivery(event);
     if (pn_delivery_remote_state(d) == PN_ACCEPTED) {
+      pn_delivery_settle(d);
       if (VERBOSE)
         printf("got PN_ACCEPTED\n");
       if (++app->acknowledged == app->message_count) {
@@ -0,0 +1,212 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "proton/condition.h"
+#include "proton/connection_driver.h"
+#include "proton/delivery.h"
+#include "proton/engine.h"
+#include "proton/link.h"
+#include "proton/session.h"
+#include "proton/transport.h"
+
+// Transfer large pre-settled messages between two in-memory connection drivers.
+//
+// The sender output is taken either as one contiguous write buffer (every
+// payload byte is copied out of the delivery into the transport buffers) or as
+// segments from pn_connection_driver_write_buffers() (payloads are referenced
+// in place). Either way the bytes are copied once into the receiver, standing in
+// for the socket.
+
+namespace {
+
+struct large_app_t {
+  std::vector<char> payload;
+  std::vector<char> rbuf;
+  int credit_window = 2; // Stay within the receiver's max buffered delivery bytes
+  uint64_t sent = 0;
+  uint64_t received = 0;
+};
+
+void handle_sender(large_app_t &app, pn_event_t *event) {
+  switch (pn_event_type(event)) {
+  case PN_CONNECTION_INIT: {
+    pn_connection_t *c = pn_event_connection(event);
+    pn_connection_open(c);
+    pn_session_t *s = pn_session(c);
+    pn_session_open(s);
+    pn_link_t *l = pn_sender(s, "large_sender");
+    pn_terminus_set_address(pn_link_target(l), "example");
+    pn_link_set_snd_settle_mode(l, PN_SND_SETTLED);
+    pn_link_open(l);
+  } break;
+
+  case PN_LINK_FLOW: {
+    pn_link_t *l = pn_event_link(event);
+    while (pn_link_credit(l) > 0) {
+      ++app.sent;
+      pn_delivery_t *d = pn_delivery(l, pn_dtag((const char *)&app.sent, sizeof(app.sent)));
+      pn_link_send(l, app.payload.data(), app.payload.size());
+      pn_link_advance(l);
+      pn_delivery_settle(d);
+    }
+  } break;
+
+  default:
+    break;
+  }
+}
+
+void handle_receiver(large_app_t &app, pn_event_t *event) {
+  switch (pn_event_type(event)) {
+  case PN_CONNECTION_REMOTE_OPEN:
+    pn_connection_open(pn_event_connection(event));
+    break;
+
+  case PN_SESSION_REMOTE_OPEN:
+    pn_session_open(pn_event_session(event));
+    break;
+
+  case PN_LINK_REMOTE_OPEN: {
+    pn_link_t *l = pn_event_link(event);
+    pn_terminus_set_address(pn_link_target(l), pn_terminus_get_address(pn_link_remote_target(l)));
+    pn_link_open(l);
+    pn_link_flow(l, app.credit_window);
+  } break;
+
+  case PN_DELIVERY: {
+    pn_delivery_t *d = pn_event_delivery(event);
+    pn_link_t *l = pn_delivery_link(d);
+    pn_link_recv(l, app.rbuf.data(), app.rbuf.size());
+    if (!pn_delivery_partial(d)) {
+      ++app.received;
+      pn_link_advance(l);
+      pn_delivery_settle(d);
+      pn_link_flow(l, app.credit_window - pn_link_credit(l));
+    }
+  } break;
+
+  default:
+    break;
+  }
+}
+
+// Copy bytes into the receiver, which only takes up to a max-frame at a time
+void push(pn_connection_driver_t &receiver, const char *bytes, size_t size) {
+  while (size) {
+    pn_rwbytes_t rbuf = pn_connection_driver_read_buffer(&receiver);
+    if (rbuf.size == 0) {
+      pn_condition_t *c = pn_transport_condition(receiver.transport);
+      fprintf(stderr, "push: no read buffer: %s\n", pn_condition_get_description(c));
+      exit(1);
+    }
+    size_t n = rbuf.size < size ? rbuf.size : size;
+    memcpy(rbuf.start, bytes, n);
+    pn_connection_driver_read_done(&receiver, n);
+    bytes += n;
+    size -= n;
+  }
+}
+
+void shovel_contiguous(pn_connection_driver_t &from, pn_connection_driver_t &to) {
+  pn_bytes_t wbuf;
+  while ((wbuf = pn_connection_driver_write_buffer(&from)).size) {
+    push(to, wbuf.start, wbuf.size);
+    pn_connection_driver_write_done(&from, wbuf.size);
+  }
+}
+
+void shovel_segments(pn_connection_driver_t &from, pn_connection_driver_t &to) {
+  pn_bytes_t segs[64];
+  size_t n;
+  while ((n = pn_connection_driver_write_buffers(&from, segs, 64))) {
+    size_t written = 0;
+    for (size_t i = 0; i < n; ++i) {
+      push(to, segs[i].start, segs[i].size);
+      written += segs[i].size;
+    }
+    pn_connection_driver_write_done(&from, written);
+  }
+}
+
+void run_large_messages(benchmark::State &state, bool segments) {
+  large_app_t app;
+  app.payload.assign(state.range(0), 'x');
+  app.rbuf.resize(state.range(0));
+
+  pn_connection_driver_t sender;
+  pn_connection_driver_t receiver;
+  if (pn_connection_driver_init(&sender, NULL, NULL) != 0 ||
+      pn_connection_driver_init(&receiver, NULL, NULL) != 0) {
+    fprintf(stderr, "pn_connection_driver_init failed\n");
+    exit(1);
+  }
+  pn_transport_set_server(receiver.transport);
+
+  for (auto _ : state) {
+    pn_event_t *event;
+    while ((event = pn_connection_driver_next_event(&sender)) != NULL) {
+      handle_sender(app, event);
+    }
+    if (segments) shovel_segments(sender, receiver);
+    else shovel_contiguous(sender, receiver);
+    while ((event = pn_connection_driver_next_event(&receiver)) != NULL) {
+      handle_receiver(app, event);
+    }
+    shovel_contiguous(receiver, sender);
+  }
+
+  pn_connection_driver_destroy(&receiver);
+  pn_connection_driver_destroy(&sender);
+
+  state.SetLabel("messages");
+  state.SetItemsProcessed(app.received);
+  state.SetBytesProcessed(app.received * app.payload.size());
+}
+
+} // namespace
+
+static void BM_LargeMessagesContiguous(benchmark::State &state) {
+  run_large_messages(state, false);
+}
+
+BENCHMARK(BM_LargeMessagesContiguous)
+    ->ArgName("size")
+    ->Arg(64 * 1024)
+    ->Arg(1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_LargeMessagesSegments(benchmark::State &state) {
+  run_large_messages(state, true);
+}
+
+BENCHMARK(BM_LargeMessagesSegments)
+    ->ArgName("size")
+    ->Arg(64 * 1024)
+    ->Arg(1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,202 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "proton/connection.h"
+#include "proton/delivery.h"
+#include "proton/event.h"
+#include "proton/link.h"
+#include "proton/listener.h"
+#include "proton/netaddr.h"
+#include "proton/proactor.h"
+#include "proton/proactor_ext.h"
+#include "proton/session.h"
+
+// Round trip latency over loopback between a client and a server proactor,
+// each with its own thread: the client sends one unsettled message at a time
+// and times it until the server's settlement arrives.  Both proactors either
+// block in epoll_wait as usual or busy poll for a while first.
+
+namespace {
+
+const int MESSAGES = 5000;
+const char PAYLOAD[64] = {0};
+
+typedef std::chrono::steady_clock clock_type;
+
+struct server_t {
+  pn_proactor_t *proactor = pn_proactor();
+  std::atomic<bool> listening{false};
+
+  void run() {
+    bool running = true;
+    while (running) {
+      pn_event_batch_t *b = pn_proactor_wait(proactor);
+      while (pn_event_t *e = pn_event_batch_next(b)) {
+        switch (pn_event_type(e)) {
+        case PN_LISTENER_OPEN:
+          listening = true;
+          break;
+        case PN_LISTENER_ACCEPT:
+          pn_listener_accept2(pn_event_listener(e), NULL, NULL);
+          break;
+        case PN_CONNECTION_REMOTE_OPEN:
+          pn_connection_open(pn_event_connection(e));
+          break;
+        case PN_CONNECTION_REMOTE_CLOSE:
+          pn_connection_close(pn_event_connection(e));
+          break;
+        case PN_SESSION_REMOTE_OPEN:
+          pn_session_open(pn_event_session(e));
+          break;
+        case PN_LINK_REMOTE_OPEN: {
+          pn_link_t *l = pn_event_link(e);
+          pn_link_open(l);
+          pn_link_flow(l, MESSAGES);
+          break;
+        }
+        case PN_DELIVERY: {
+          pn_delivery_t *d = pn_event_delivery(e);
+          pn_link_t *l = pn_delivery_link(d);
+          if (!pn_delivery_partial(d)) {
+            char buf[sizeof(PAYLOAD)];
+            while (pn_link_recv(l, buf, sizeof(buf)) > 0) {}
+            pn_delivery_update(d, PN_ACCEPTED);
+            pn_delivery_settle(d);
+          }
+          break;
+        }
+        case PN_PROACTOR_INACTIVE:
+          running = false;
+          break;
+        default:
+          break;
+        }
+      }
+      pn_proactor_done(proactor, b);
+    }
+  }
+};
+
+struct client_t {
+  int sent = 0;
+  bool done = false;
+  clock_type::time_point start;
+  std::vector<double> rtt_us;
+
+  void send(pn_link_t *l) {
+    pn_delivery(l, pn_dtag((const char *)&sent, sizeof(sent)));
+    pn_link_send(l, PAYLOAD, sizeof(PAYLOAD));
+    pn_link_advance(l);
+    ++sent;
+    start = clock_type::now();
+  }
+
+  void handle(pn_event_t *e) {
+    switch (pn_event_type(e)) {
+    case PN_LINK_FLOW: {
+      pn_link_t *l = pn_event_link(e);
+      if (sent == 0 && pn_link_credit(l) > 0) send(l);
+      break;
+    }
+    case PN_DELIVERY: {
+      pn_delivery_t *d = pn_event_delivery(e);
+      if (pn_delivery_settled(d)) {
+        rtt_us.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - start).count());
+        pn_link_t *l = pn_delivery_link(d);
+        pn_delivery_settle(d);
+        if (sent < MESSAGES)
+          send(l);
+        else
+          pn_connection_close(pn_event_connection(e));
+      }
+      break;
+    }
+    case PN_TRANSPORT_CLOSED:
+      done = true;
+      break;
+    default:
+      break;
+    }
+  }
+};
+
+double percentile(std::vector<double> &v, double p) {
+  size_t i = std::min(v.size() - 1, (size_t)(p * v.size()));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+} // namespace
+
+static void BM_ProactorRTT(benchmark::State &state) {
+  unsigned busy_poll = state.range(0);
+  std::vector<double> rtt_us;
+  for (auto _ : state) {
+    server_t s;
+    pn_proactor_set_busy_poll(s.proactor, busy_poll);
+    pn_listener_t *l = pn_listener();
+    pn_proactor_listen(s.proactor, l, "127.0.0.1:0", 1);
+    std::thread server(&server_t::run, &s);
+    while (!s.listening) std::this_thread::yield();
+    char port[PN_MAX_ADDR];
+    pn_netaddr_host_port(pn_listener_addr(l), NULL, 0, port, sizeof(port));
+    std::string addr = std::string("127.0.0.1:") + port;
+
+    client_t h;
+    pn_proactor_t *p = pn_proactor();
+    pn_proactor_set_busy_poll(p, busy_poll);
+    pn_connection_t *c = pn_connection();
+    pn_connection_open(c);
+    pn_session_t *ssn = pn_session(c);
+    pn_session_open(ssn);
+    pn_link_open(pn_sender(ssn, "x"));
+    pn_proactor_connect2(p, c, NULL, addr.c_str());
+    while (!h.done) {
+      pn_event_batch_t *b = pn_proactor_wait(p);
+      while (pn_event_t *e = pn_event_batch_next(b)) h.handle(e);
+      pn_proactor_done(p, b);
+    }
+    pn_proactor_free(p);
+    pn_listener_close(l);
+    server.join();
+    pn_proactor_free(s.proactor);
+    rtt_us.insert(rtt_us.end(), h.rtt_us.begin(), h.rtt_us.end());
+  }
+  state.counters["p50_us"] = percentile(rtt_us, 0.50);
+  state.counters["p99_us"] = percentile(rtt_us, 0.99);
+  state.SetItemsProcessed(state.iterations() * MESSAGES);
+}
+
+BENCHMARK(BM_ProactorRTT)
+    ->ArgName("busy_poll_us")
+    ->Arg(0)
+    ->Arg(50)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,220 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "proton/connection.h"
+#include "proton/delivery.h"
+#include "proton/event.h"
+#include "proton/link.h"
+#include "proton/listener.h"
+#include "proton/netaddr.h"
+#include "proton/proactor.h"
+#include "proton/proactor_ext.h"
+#include "proton/session.h"
+
+// Many connections sending small pre-settled messages over loopback, served
+// either by one proactor with several threads or by several single threaded
+// proactors (shards) with connections spread over them.  Shards either share
+// one listener or each have their own on a shared (SO_REUSEPORT) port.
+
+namespace {
+
+const int CONNECTIONS = 16;
+const int MESSAGES = 2000;  // per connection
+const int CREDIT = 500;
+const char PAYLOAD[64] = {0};
+
+struct sender_t {
+  int sent = 0;
+};
+
+struct shards_t {
+  std::vector<pn_proactor_t *> proactors;
+  bool reuse_port = false;
+  std::atomic<unsigned> next{0};
+  std::atomic<int> received{0};
+  std::atomic<int> listening{0};
+
+  pn_proactor_t *pick() { return proactors[next++ % proactors.size()]; }
+
+  void stop() {
+    for (pn_proactor_t *p : proactors) pn_proactor_interrupt(p);
+  }
+
+  void send(pn_link_t *l) {
+    sender_t *s = (sender_t *)pn_link_get_context(l);
+    while (pn_link_credit(l) > 0 && s->sent < MESSAGES) {
+      pn_delivery_t *d = pn_delivery(l, pn_dtag((const char *)&s->sent, sizeof(s->sent)));
+      pn_link_send(l, PAYLOAD, sizeof(PAYLOAD));
+      pn_link_advance(l);
+      pn_delivery_settle(d);
+      ++s->sent;
+    }
+  }
+
+  // Returns false when the thread should stop
+  bool handle(pn_event_t *e) {
+    switch (pn_event_type(e)) {
+    case PN_LISTENER_OPEN:
+      ++listening;
+      break;
+    case PN_LISTENER_ACCEPT:
+      if (reuse_port)
+        pn_listener_accept2(pn_event_listener(e), NULL, NULL);
+      else
+        pn_proactor_accept(pick(), pn_event_listener(e), NULL, NULL);
+      break;
+    case PN_CONNECTION_REMOTE_OPEN:
+      pn_connection_open(pn_event_connection(e));
+      break;
+    case PN_SESSION_REMOTE_OPEN:
+      pn_session_open(pn_event_session(e));
+      break;
+    case PN_LINK_REMOTE_OPEN: {
+      pn_link_t *l = pn_event_link(e);
+      if (pn_link_is_receiver(l)) {
+        pn_link_open(l);
+        pn_link_flow(l, CREDIT);
+      }
+      break;
+    }
+    case PN_LINK_FLOW: {
+      pn_link_t *l = pn_event_link(e);
+      if (pn_link_is_sender(l)) send(l);
+      break;
+    }
+    case PN_DELIVERY: {
+      pn_delivery_t *d = pn_event_delivery(e);
+      pn_link_t *l = pn_delivery_link(d);
+      if (pn_link_is_receiver(l) && !pn_delivery_partial(d)) {
+        char buf[sizeof(PAYLOAD)];
+        while (pn_link_recv(l, buf, sizeof(buf)) > 0) {}
+        pn_delivery_settle(d);
+        pn_link_flow(l, 1);
+        if (++received == CONNECTIONS * MESSAGES) stop();
+      }
+      break;
+    }
+    case PN_PROACTOR_INTERRUPT:
+      // Interrupts can coalesce: pass it along to the other threads
+      pn_proactor_interrupt(pn_event_proactor(e));
+      return false;
+    default:
+      break;
+    }
+    return true;
+  }
+
+  void run(pn_proactor_t *p) {
+    bool running = true;
+    while (running) {
+      pn_event_batch_t *b = pn_proactor_wait(p);
+      pn_event_t *e;
+      while (running && (e = pn_event_batch_next(b))) running = handle(e);
+      pn_proactor_done(p, b);
+    }
+  }
+};
+
+pn_listener_t *listen(shards_t &s, pn_proactor_t *p, const char *addr) {
+  pn_listener_t *l = pn_listener();
+  pn_listener_set_reuse_port(l, s.reuse_port);
+  int listening = s.listening;
+  pn_proactor_listen(p, l, addr, CONNECTIONS);
+  while (s.listening == listening) std::this_thread::yield();
+  return l;
+}
+
+void run_shards(benchmark::State &state, int shards, int threads_per_shard, bool reuse_port = false) {
+  for (auto _ : state) {
+    shards_t s;
+    s.reuse_port = reuse_port;
+    for (int i = 0; i < shards; ++i) s.proactors.push_back(pn_proactor());
+
+    std::vector<std::thread> threads;
+    for (pn_proactor_t *p : s.proactors)
+      for (int i = 0; i < threads_per_shard; ++i) threads.emplace_back(&shards_t::run, &s, p);
+
+    pn_listener_t *listener = listen(s, s.proactors[0], "127.0.0.1:0");
+    char port[PN_MAX_ADDR];
+    pn_netaddr_host_port(pn_listener_addr(listener), NULL, 0, port, sizeof(port));
+    std::string addr = std::string("127.0.0.1:") + port;
+    if (reuse_port)
+      for (int i = 1; i < shards; ++i) listen(s, s.proactors[i], addr.c_str());
+
+    std::vector<sender_t> senders(CONNECTIONS);
+    for (int i = 0; i < CONNECTIONS; ++i) {
+      pn_connection_t *c = pn_connection();
+      pn_connection_open(c);
+      pn_session_t *ssn = pn_session(c);
+      pn_session_open(ssn);
+      pn_link_t *snd = pn_sender(ssn, "x");
+      pn_link_set_snd_settle_mode(snd, PN_SND_SETTLED);
+      pn_link_set_context(snd, &senders[i]);
+      pn_link_open(snd);
+      pn_proactor_connect2(s.pick(), c, NULL, addr.c_str());
+    }
+
+    for (std::thread &t : threads) t.join();
+    for (pn_proactor_t *p : s.proactors) pn_proactor_free(p);
+  }
+  state.SetItemsProcessed(state.iterations() * CONNECTIONS * MESSAGES);
+}
+
+} // namespace
+
+static void BM_ProactorOneShard(benchmark::State &state) {
+  run_shards(state, 1, state.range(0));
+}
+
+BENCHMARK(BM_ProactorOneShard)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_ProactorShards(benchmark::State &state) {
+  run_shards(state, state.range(0), 1);
+}
+
+BENCHMARK(BM_ProactorShards)
+    ->ArgName("shards")
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_ProactorShardsReusePort(benchmark::State &state) {
+  run_shards(state, state.range(0), 1, true);
+}
+
+BENCHMARK(BM_ProactorShardsReusePort)
+    ->ArgName("shards")
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,229 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+#include <dlfcn.h>
+#include <sys/types.h>
+
+#include <benchmark/benchmark.h>
+
+#include "proton/connection.h"
+#include "proton/delivery.h"
+#include "proton/event.h"
+#include "proton/import_export.h"
+#include "proton/link.h"
+#include "proton/listener.h"
+#include "proton/netaddr.h"
+#include "proton/proactor.h"
+#include "proton/session.h"
+
+// Count the system calls the epoll proactor makes per message when a
+// sender and receiver on one proactor pass messages one at a time over
+// loopback (every message waits for a credit refill), with sockets armed
+// one-shot (rearmed on every wakeup) or edge triggered.
+//
+// The calls are counted by defining (and exporting) them here: the proactor
+// library resolves them to the executable's definitions before libc's.
+
+struct epoll_event;
+struct msghdr;
+
+namespace {
+
+std::atomic<unsigned long> epoll_ctl_calls{0};
+std::atomic<unsigned long> syscalls{0};
+
+template <class F> F real(const char *name) {
+  return (F)dlsym(RTLD_NEXT, name);
+}
+
+} // namespace
+
+extern "C" {
+
+PN_EXPORT int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
+  static auto f = real<int (*)(int, int, int, struct epoll_event *)>("epoll_ctl");
+  ++epoll_ctl_calls;
+  ++syscalls;
+  return f(epfd, op, fd, event);
+}
+
+PN_EXPORT int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout) {
+  static auto f = real<int (*)(int, struct epoll_event *, int, int)>("epoll_wait");
+  ++syscalls;
+  return f(epfd, events, maxevents, timeout);
+}
+
+PN_EXPORT ssize_t recv(int fd, void *buf, size_t len, int flags) {
+  static auto f = real<ssize_t (*)(int, void *, size_t, int)>("recv");
+  ++syscalls;
+  return f(fd, buf, len, flags);
+}
+
+PN_EXPORT ssize_t sendmsg(int fd, const struct msghdr *msg, int flags) {
+  static auto f = real<ssize_t (*)(int, const struct msghdr *, int)>("sendmsg");
+  ++syscalls;
+  return f(fd, msg, flags);
+}
+
+PN_EXPORT ssize_t read(int fd, void *buf, size_t count) {
+  static auto f = real<ssize_t (*)(int, void *, size_t)>("read");
+  ++syscalls;
+  return f(fd, buf, count);
+}
+
+PN_EXPORT ssize_t write(int fd, const void *buf, size_t count) {
+  static auto f = real<ssize_t (*)(int, const void *, size_t)>("write");
+  ++syscalls;
+  return f(fd, buf, count);
+}
+
+} // extern "C"
+
+namespace {
+
+const int MESSAGES = 10000;
+const char PAYLOAD[64] = {0};
+
+struct pingpong_t {
+  int sent = 0;
+  int received = 0;
+  bool done = false;
+
+  void handle(pn_event_t *e) {
+    switch (pn_event_type(e)) {
+    case PN_LISTENER_ACCEPT:
+      pn_listener_accept2(pn_event_listener(e), NULL, NULL);
+      break;
+    case PN_CONNECTION_REMOTE_OPEN:
+      pn_connection_open(pn_event_connection(e));
+      break;
+    case PN_CONNECTION_REMOTE_CLOSE:
+      pn_connection_close(pn_event_connection(e));
+      break;
+    case PN_SESSION_REMOTE_OPEN:
+      pn_session_open(pn_event_session(e));
+      break;
+    case PN_LINK_REMOTE_OPEN: {
+      pn_link_t *l = pn_event_link(e);
+      if (pn_link_is_receiver(l)) {
+        pn_link_open(l);
+        pn_link_flow(l, 1);
+      }
+      break;
+    }
+    case PN_LINK_FLOW: {
+      pn_link_t *l = pn_event_link(e);
+      while (pn_link_is_sender(l) && pn_link_credit(l) > 0 && sent < MESSAGES) {
+        pn_delivery_t *d = pn_delivery(l, pn_dtag((const char *)&sent, sizeof(sent)));
+        pn_link_send(l, PAYLOAD, sizeof(PAYLOAD));
+        pn_link_advance(l);
+        pn_delivery_settle(d);
+        ++sent;
+      }
+      break;
+    }
+    case PN_DELIVERY: {
+      pn_delivery_t *d = pn_event_delivery(e);
+      pn_link_t *l = pn_delivery_link(d);
+      if (pn_link_is_receiver(l) && !pn_delivery_partial(d)) {
+        char buf[sizeof(PAYLOAD)];
+        while (pn_link_recv(l, buf, sizeof(buf)) > 0) {}
+        pn_delivery_settle(d);
+        if (++received == MESSAGES)
+          pn_connection_close(pn_event_connection(e));
+        else
+          pn_link_flow(l, 1);
+      }
+      break;
+    }
+    case PN_TRANSPORT_CLOSED:
+      done = true;
+      break;
+    default:
+      break;
+    }
+  }
+};
+
+void run_pingpong(benchmark::State &state, bool edge) {
+  if (edge)
+    setenv("PNI_EPOLL_EDGE", "1", 1);
+  else
+    unsetenv("PNI_EPOLL_EDGE");
+  unsigned long ctl = 0, calls = 0;
+  for (auto _ : state) {
+    pingpong_t h;
+    pn_proactor_t *p = pn_proactor();
+    pn_listener_t *l = pn_listener();
+    pn_proactor_listen(p, l, "127.0.0.1:0", 1);
+    bool listening = false;
+    while (!listening) {
+      pn_event_batch_t *b = pn_proactor_wait(p);
+      while (pn_event_t *e = pn_event_batch_next(b))
+        listening |= (pn_event_type(e) == PN_LISTENER_OPEN);
+      pn_proactor_done(p, b);
+    }
+    char port[PN_MAX_ADDR];
+    pn_netaddr_host_port(pn_listener_addr(l), NULL, 0, port, sizeof(port));
+    std::string addr = std::string("127.0.0.1:") + port;
+
+    pn_connection_t *c = pn_connection();
+    pn_connection_open(c);
+    pn_session_t *ssn = pn_session(c);
+    pn_session_open(ssn);
+    pn_link_t *snd = pn_sender(ssn, "x");
+    pn_link_set_snd_settle_mode(snd, PN_SND_SETTLED);
+    pn_link_open(snd);
+
+    unsigned long ctl0 = epoll_ctl_calls, calls0 = syscalls;
+    pn_proactor_connect2(p, c, NULL, addr.c_str());
+    while (!h.done) {
+      pn_event_batch_t *b = pn_proactor_wait(p);
+      while (pn_event_t *e = pn_event_batch_next(b)) h.handle(e);
+      pn_proactor_done(p, b);
+    }
+    ctl += epoll_ctl_calls - ctl0;
+    calls += syscalls - calls0;
+    pn_proactor_free(p);
+  }
+  unsetenv("PNI_EPOLL_EDGE");
+  double messages = (double)state.iterations() * MESSAGES;
+  state.counters["epoll_ctl/msg"] = ctl / messages;
+  state.counters["syscalls/msg"] = calls / messages;
+  state.SetItemsProcessed(state.iterations() * MESSAGES);
+}
+
+} // namespace
+
+static void BM_ProactorSyscalls(benchmark::State &state) {
+  run_pingpong(state, state.range(0));
+}
+
+BENCHMARK(BM_ProactorSyscalls)
+    ->ArgName("edge")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,138 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "proton/connection.h"
+#include "proton/event.h"
+#include "proton/listener.h"
+#include "proton/netaddr.h"
+#include "proton/proactor.h"
+
+// Application threads waking connections as fast as they can, as many
+// threads adding work to their own connection's work queue would: each
+// producer thread wakes one connection while a single proactor thread
+// handles the wakes.  Measures how schedule() copes with the contention.
+
+namespace {
+
+const int WAKES = 20000;  // per producer
+
+struct wake_t {
+  pn_proactor_t *proactor = pn_proactor();
+  std::atomic<int> opened{0};
+  std::atomic<long> woken{0};
+  std::atomic<bool> listening{false};
+
+  void run() {
+    bool running = true;
+    while (running) {
+      pn_event_batch_t *b = pn_proactor_wait(proactor);
+      while (pn_event_t *e = pn_event_batch_next(b)) {
+        switch (pn_event_type(e)) {
+        case PN_LISTENER_OPEN:
+          listening = true;
+          break;
+        case PN_LISTENER_ACCEPT:
+          pn_listener_accept2(pn_event_listener(e), NULL, NULL);
+          break;
+        case PN_CONNECTION_REMOTE_OPEN:
+          if (pn_connection_state(pn_event_connection(e)) & PN_LOCAL_UNINIT)
+            pn_connection_open(pn_event_connection(e));
+          else
+            ++opened;
+          break;
+        case PN_CONNECTION_REMOTE_CLOSE:
+          pn_connection_close(pn_event_connection(e));
+          break;
+        case PN_CONNECTION_WAKE:
+          ++woken;
+          break;
+        case PN_PROACTOR_INACTIVE:
+          running = false;
+          break;
+        default:
+          break;
+        }
+      }
+      pn_proactor_done(proactor, b);
+    }
+  }
+};
+
+} // namespace
+
+static void BM_ProactorWakeContention(benchmark::State &state) {
+  int producers = state.range(0);
+  long woken = 0;
+  for (auto _ : state) {
+    wake_t w;
+    pn_listener_t *l = pn_listener();
+    pn_proactor_listen(w.proactor, l, "127.0.0.1:0", producers);
+    std::thread runner(&wake_t::run, &w);
+    while (!w.listening) std::this_thread::yield();
+    char port[PN_MAX_ADDR];
+    pn_netaddr_host_port(pn_listener_addr(l), NULL, 0, port, sizeof(port));
+    std::string addr = std::string("127.0.0.1:") + port;
+
+    std::vector<pn_connection_t *> connections;
+    for (int i = 0; i < producers; ++i) {
+      pn_connection_t *c = pn_connection();
+      pn_connection_open(c);
+      connections.push_back(c);
+      pn_proactor_connect2(w.proactor, c, NULL, addr.c_str());
+    }
+    while (w.opened < producers) std::this_thread::yield();
+
+    std::vector<std::thread> threads;
+    for (pn_connection_t *c : connections)
+      threads.emplace_back([c]() {
+        for (int i = 0; i < WAKES; ++i) pn_connection_wake(c);
+      });
+    for (std::thread &t : threads) t.join();
+
+    state.PauseTiming();
+    woken += w.woken;
+    for (pn_connection_t *c : connections) {
+      pn_connection_close(c);
+      pn_connection_wake(c);
+    }
+    pn_listener_close(l);
+    runner.join();
+    pn_proactor_free(w.proactor);
+    state.ResumeTiming();
+  }
+  state.counters["wake_events"] = benchmark::Counter(woken, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * producers * WAKES);
+}
+
+BENCHMARK(BM_ProactorWakeContention)
+    ->ArgName("producers")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
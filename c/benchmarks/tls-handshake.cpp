@@ -0,0 +1,157 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "proton/condition.h"
+#include "proton/connection.h"
+#include "proton/connection_driver.h"
+#include "proton/ssl.h"
+#include "proton/transport.h"
+
+// A storm of short lived TLS connections between in-memory connection drivers:
+// each iteration handshakes, opens and closes one AMQP connection.  With a
+// session id the client resumes the previous TLS session instead of doing a
+// full handshake.  The certificates are the test ones, found in TEST_CERT_DIR.
+
+namespace {
+
+[[noreturn]] void fail(const char *what, pn_transport_t *t = NULL) {
+  fprintf(stderr, "%s%s%s\n", what, t ? ": " : "",
+          t ? pn_condition_get_description(pn_transport_condition(t)) : "");
+  exit(1);
+}
+
+std::string cert_file(const char *name) {
+  const char *dir = getenv("TEST_CERT_DIR");
+  return std::string(dir ? dir : "ssl-certs") + "/" + name;
+}
+
+// Client opens then closes as soon as the server answers, server mirrors it
+void handle(pn_event_t *event) {
+  pn_connection_t *c = pn_event_connection(event);
+  switch (pn_event_type(event)) {
+  case PN_CONNECTION_REMOTE_OPEN:
+    if (pn_connection_state(c) & PN_LOCAL_ACTIVE) pn_connection_close(c);
+    else pn_connection_open(c);
+    break;
+  case PN_CONNECTION_REMOTE_CLOSE:
+    pn_connection_close(c);
+    break;
+  default:
+    break;
+  }
+}
+
+// Move bytes in one direction, returns the number moved
+size_t shovel(pn_connection_driver_t &from, pn_connection_driver_t &to) {
+  size_t moved = 0;
+  pn_bytes_t wbuf;
+  while ((wbuf = pn_connection_driver_write_buffer(&from)).size) {
+    pn_rwbytes_t rbuf = pn_connection_driver_read_buffer(&to);
+    size_t n = rbuf.size < wbuf.size ? rbuf.size : wbuf.size;
+    if (n == 0) break;
+    memcpy(rbuf.start, wbuf.start, n);
+    pn_connection_driver_read_done(&to, n);
+    pn_connection_driver_write_done(&from, n);
+    moved += n;
+  }
+  if (pn_connection_driver_write_closed(&from) && !pn_connection_driver_read_closed(&to)) {
+    pn_connection_driver_read_close(&to);
+  }
+  return moved;
+}
+
+void dispatch(pn_connection_driver_t &d) {
+  pn_event_t *event;
+  while ((event = pn_connection_driver_next_event(&d)) != NULL) handle(event);
+}
+
+void connect(pn_ssl_domain_t *client_domain, pn_ssl_domain_t *server_domain, const char *session_id) {
+  pn_connection_driver_t client;
+  pn_connection_driver_t server;
+  if (pn_connection_driver_init(&client, NULL, NULL) != 0 ||
+      pn_connection_driver_init(&server, NULL, NULL) != 0) {
+    fail("pn_connection_driver_init failed");
+  }
+  pn_transport_set_server(server.transport);
+  pn_ssl_t *ssl = pn_ssl(client.transport);
+  if (pn_ssl_init(ssl, client_domain, session_id) != 0 ||
+      pn_ssl_init(pn_ssl(server.transport), server_domain, NULL) != 0) {
+    fail("pn_ssl_init failed");
+  }
+  pn_ssl_set_peer_hostname(ssl, "test_server");
+  pn_connection_open(client.connection);
+
+  size_t moved;
+  do {
+    dispatch(client);
+    moved = shovel(client, server);
+    dispatch(server);
+    moved += shovel(server, client);
+  } while (moved);
+  if (!pn_connection_driver_finished(&client) || !pn_connection_driver_finished(&server)) {
+    fail("connection did not close", client.transport);
+  }
+  if (pn_condition_is_set(pn_transport_condition(client.transport))) fail("client", client.transport);
+
+  pn_connection_driver_destroy(&client);
+  pn_connection_driver_destroy(&server);
+}
+
+} // namespace
+
+static void BM_TLSHandshakeStorm(benchmark::State &state) {
+  const char *session_id = state.range(0) ? "tls-handshake-storm" : NULL;
+
+  pn_ssl_domain_t *server_domain = pn_ssl_domain(PN_SSL_MODE_SERVER);
+  pn_ssl_domain_t *client_domain = pn_ssl_domain(PN_SSL_MODE_CLIENT);
+  if (pn_ssl_domain_set_credentials(server_domain, cert_file("tserver-certificate.pem").c_str(),
+                                    cert_file("tserver-private-key.pem").c_str(), "tserverpw") != 0 ||
+      pn_ssl_domain_set_peer_authentication(client_domain, PN_SSL_ANONYMOUS_PEER, NULL) != 0) {
+    fail("cannot set up TLS, is TEST_CERT_DIR set?");
+  }
+
+  for (auto _ : state) {
+    connect(client_domain, server_domain, session_id);
+  }
+
+  uint64_t hits = 0, misses = 0;
+  pn_ssl_domain_get_session_stats(client_domain, &hits, &misses);
+  pn_ssl_domain_free(client_domain);
+  pn_ssl_domain_free(server_domain);
+
+  state.SetLabel("connections");
+  state.SetItemsProcessed(state.iterations());
+  state.counters["resumed"] = hits;
+  state.counters["full"] = misses;
+}
+
+BENCHMARK(BM_TLSHandshakeStorm)
+    ->ArgName("resume")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
@@ -151,6 +151,18 @@ PN_EXTERN pn_connection_t *pn_connection_driver_release_connection(pn_connection
  */
 PN_EXTERN pn_rwbytes_t pn_connection_driver_read_buffer_sized(pn_connection_driver_t *, size_t n);
 
+/**
+ * **Unsettled API**: Shrink the driver's read and write buffers to n bytes.
+ *
+ * For connections that have gone quiet after needing large buffers: frees
+ * buffer space beyond n bytes that holds no pending data. Buffers grow again
+ * as needed. Buffers may move, so do not call this while writing segments
+ * from pn_connection_driver_write_buffers().
+ *
+ * @return the number of bytes freed.
+ */
+PN_EXTERN size_t pn_connection_driver_shrink_buffers(pn_connection_driver_t *, size_t n);
+
 /**
  * Get the read buffer.
  *
@@ -187,12 +199,54 @@ PN_EXTERN bool pn_connection_driver_read_closed(pn_connection_driver_t *);
  */
  PN_EXTERN pn_bytes_t pn_connection_driver_write_buffer(pn_connection_driver_t *);
 
+/**
+ * Get the pending output as a sequence of up to n segments.
+ *
+ * Unlike pn_connection_driver_write_buffer() large message payloads are not
+ * copied into the write buffer, segments refer directly to the delivery
+ * data. Write the segments in order (e.g. with writev()) and call
+ * pn_connection_driver_write_done() with the total number of bytes written.
+ * The segments are only valid until then.
+ *
+ * Once this has been called pn_connection_driver_write_done() returns the first
+ * pending segment rather than the whole of the pending output.
+ *
+ * @return the number of segments filled in, 0 means there is nothing to write.
+ */
+PN_EXTERN size_t pn_connection_driver_write_buffers(pn_connection_driver_t *, pn_bytes_t *segs, size_t n);
+
 /**
  * Call when the first n bytes of pn_connection_driver_write_buffer() have been
  * written to IO. Reclaims the buffer space and reset the write buffer.
  */
 PN_EXTERN pn_bytes_t pn_connection_driver_write_done(pn_connection_driver_t *, size_t n);
 
+/**
+ * **Unsettled API**: Keep a segment from pn_connection_driver_write_buffers()
+ * after it has been written, for IO that lets the OS go on reading written
+ * memory (e.g. MSG_ZEROCOPY).
+ *
+ * Only segments referring to message payload in place can be kept, the
+ * transport's own buffers are reused as soon as they are written. Once the
+ * segment is finished with by pn_connection_driver_write_done() its payload
+ * is kept until pn_connection_driver_write_release() is called with tag, or
+ * a later tag. Holding the same payload again with a later tag replaces the
+ * earlier one. Payload finished with while earlier segments are held is
+ * kept until they are released.
+ *
+ * @param[in] segment a pending segment, or what is left of it
+ * @param[in] tag identifies the write, tags are compared with wrap around
+ * @return true if the segment will be kept, false if it must be copied by
+ * the write.
+ */
+PN_EXTERN bool pn_connection_driver_write_hold(pn_connection_driver_t *, pn_bytes_t segment, uint32_t tag);
+
+/**
+ * **Unsettled API**: Release the payload kept by pn_connection_driver_write_hold()
+ * for tag and any earlier tags.
+ */
+PN_EXTERN void pn_connection_driver_write_release(pn_connection_driver_t *, uint32_t tag);
+
 /**
  * Close the write side. Call when IO can no longer be written to.
  */
@@ -167,6 +167,83 @@ PN_EXTERN bool pn_delivery_settled(pn_delivery_t *delivery);
  */
 PN_EXTERN size_t pn_delivery_pending(pn_delivery_t *delivery);
 
+/**
+ * **Unsettled API**: Get the pending message data for a delivery in place.
+ *
+ * The data is moved together within the delivery if necessary so it
+ * can be returned as one contiguous block, nothing is copied out of
+ * the delivery. For a received delivery the bytes stay where they are
+ * until more data arrives for the delivery or it is settled, even if
+ * they are discarded by pn_link_advance().
+ *
+ * @param[in] delivery a delivery object
+ * @return the pending message data
+ */
+PN_EXTERN pn_bytes_t pn_delivery_bytes(pn_delivery_t *delivery);
+
+/**
+ * **Unsettled API**: Get the pending message data for a delivery in
+ * place, without moving it.
+ *
+ * The data is described by one span, or two if it wraps around the
+ * end of the delivery's buffer, in which case the second span follows
+ * on from the first. The spans are valid until more data arrives for
+ * the delivery or data is read or consumed from it.
+ *
+ * @param[in] delivery a delivery object
+ * @param[out] spans set to the spans of pending data
+ * @return the number of spans set, 0 if there is no pending data
+ */
+PN_EXTERN size_t pn_delivery_peek_bytes(pn_delivery_t *delivery, pn_bytes_t spans[2]);
+
+/**
+ * **Unsettled API**: Discard pending message data from the front of a
+ * received delivery.
+ *
+ * Use with pn_delivery_peek_bytes() or pn_delivery_bytes() instead of
+ * copying the data out with pn_link_recv(). As with pn_link_recv(),
+ * the consumed bytes no longer count against the session incoming
+ * capacity so more transfers may be allowed.
+ *
+ * @param[in] delivery a received delivery
+ * @param[in] size the number of bytes to consume
+ * @return the number of bytes consumed, at most pn_delivery_pending(),
+ * or an error code: PN_ABORTED if the delivery was aborted, PN_STATE_ERR
+ * if it is not a received delivery.
+ */
+PN_EXTERN ssize_t pn_delivery_consume(pn_delivery_t *delivery, size_t size);
+
+/**
+ * **Unsettled API**: Forward the message data of a received delivery
+ * to the current delivery of a sender link without copying or
+ * re-encoding it.
+ *
+ * The received data is handed over to the sender's current delivery,
+ * as if written with pn_link_send(), and is consumed from the received
+ * delivery as if read with pn_link_recv(). Any views of the received
+ * data, such as from pn_delivery_bytes(), are no longer valid. The
+ * sender's current delivery still has to be advanced with
+ * pn_link_advance(), and the received delivery settled, as usual.
+ *
+ * If annotations is not NULL the message-annotations section of the
+ * message is replaced with it, or removed if it is empty; the rest of
+ * the message is left as it is.
+ *
+ * The sender may be on another connection, but the caller must be
+ * allowed to use both connections, for instance by forwarding only
+ * between connections handled by the same thread.
+ *
+ * @param[in] delivery a complete received delivery
+ * @param[in] sender a sender link with a current delivery that has no data
+ * @param[in] annotations new message annotations, or NULL to keep them
+ * @return the number of bytes forwarded, or an error code: PN_EOS if the
+ * sender has no current delivery, PN_ABORTED if the received delivery was
+ * aborted, PN_STATE_ERR if it is not complete or the sender's current
+ * delivery already has data, PN_ARG_ERR if the links are the wrong way
+ * round.
+ */
+PN_EXTERN ssize_t pn_delivery_forward(pn_delivery_t *delivery, pn_link_t *sender, pn_data_t *annotations);
+
 /**
  * Check if a delivery only has partial message data.
  *
@@ -470,7 +470,14 @@ typedef enum {
    *
    * Events of this type point to a @ref pn_raw_connection_t
    */
-  PN_RAW_CONNECTION_DRAIN_BUFFERS
+  PN_RAW_CONNECTION_DRAIN_BUFFERS,
+
+  /**
+   * Deliveries on a link with coalesced remote settlement have been
+   * settled by the remote peer. Use pn_link_remote_settled_next() to
+   * retrieve them. Events of this type point to the relevant link.
+   */
+  PN_LINK_REMOTE_SETTLED
 
 } pn_event_type_t;
 
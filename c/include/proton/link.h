@@ -566,6 +566,55 @@ PN_EXTERN pn_delivery_t *pn_unsettled_head(pn_link_t *link);
  */
 PN_EXTERN pn_delivery_t *pn_unsettled_next(pn_delivery_t *delivery);
 
+/**
+ * **Unsettled API** - Coalesce deliveries settled by the remote peer.
+ *
+ * By default every delivery settled by the peer is reported with its
+ * own ::PN_DELIVERY event. When coalescing is enabled, a delivery that
+ * the peer settles while it is still locally unsettled is instead added
+ * to the link's remote settled list, and a single
+ * ::PN_LINK_REMOTE_SETTLED event is raised for each batch. Use
+ * ::pn_link_remote_settled_next to retrieve the deliveries and then
+ * settle them locally.
+ *
+ * This avoids an event per delivery for senders that have many
+ * deliveries settled by a single disposition.
+ *
+ * @param[in] link a link object
+ * @param[in] coalesce true to coalesce remote settlement
+ */
+PN_EXTERN void pn_link_set_coalesce_settled(pn_link_t *link, bool coalesce);
+
+/**
+ * **Unsettled API** - Check if remote settlement is coalesced for a link.
+ *
+ * @param[in] link a link object
+ * @return true if remote settlement is coalesced
+ */
+PN_EXTERN bool pn_link_get_coalesce_settled(pn_link_t *link);
+
+/**
+ * **Unsettled API** - Get the number of deliveries in the remote settled list.
+ *
+ * @param[in] link a link object
+ * @return the number of deliveries settled by the remote peer that have
+ * not yet been retrieved or locally settled
+ */
+PN_EXTERN size_t pn_link_remote_settled(pn_link_t *link);
+
+/**
+ * **Unsettled API** - Take the next delivery from the remote settled list.
+ *
+ * Deliveries are returned in the order the peer settled them. The
+ * delivery remains locally unsettled until ::pn_delivery_settle is
+ * called. Only links with coalescing enabled (see
+ * ::pn_link_set_coalesce_settled) populate this list.
+ *
+ * @param[in] link a link object
+ * @return the next remotely settled delivery or NULL if there is none
+ */
+PN_EXTERN pn_delivery_t *pn_link_remote_settled_next(pn_link_t *link);
+
 /**
  * Signal the availability of deliveries for a link.
  *
@@ -585,6 +634,46 @@ PN_EXTERN void pn_link_offered(pn_link_t *sender, int credit);
  */
 PN_EXTERN ssize_t pn_link_send(pn_link_t *sender, const char *bytes, size_t n);
 
+/**
+ * **Unsettled API**: Called when proton has finished with bytes lent
+ * to it by pn_link_sendv().
+ *
+ * @param[in] context the context given to pn_link_sendv()
+ */
+typedef void (*pn_send_complete_t)(void *context);
+
+/**
+ * **Unsettled API**: Send message data made up of several segments
+ * for the current delivery on a link.
+ *
+ * If complete is NULL the segments are copied, in one go, as if by
+ * pn_link_send().
+ *
+ * Otherwise the segments are lent to proton rather than copied: their
+ * memory must stay valid and unchanged until complete is called with
+ * context. This happens exactly once when proton no longer needs any
+ * of the segments: once they have been written out by the transport,
+ * or copied because they could not be referenced in place, or the
+ * delivery has been aborted or freed. It is called on the thread
+ * using the connection, from within proton, and must not call back
+ * into this connection. Lent bytes are only written out without
+ * copying for a complete delivery (see pn_link_advance()) on a
+ * connection driven through the segmented output of the proactor, and
+ * sending more data with a copy after lending some copies the lent
+ * data first to keep it in order.
+ *
+ * @param[in] sender a sender link object
+ * @param[in] segs the message data segments, in order
+ * @param[in] n the number of segments
+ * @param[in] complete called when lent segments are finished with, or
+ * NULL to copy the segments
+ * @param[in] context passed to complete
+ * @return the number of bytes sent, or an error code, in which case
+ * nothing was sent and complete is not called
+ */
+PN_EXTERN ssize_t pn_link_sendv(pn_link_t *sender, const pn_bytes_t *segs, size_t n,
+                                pn_send_complete_t complete, void *context);
+
 /**
  * Grant credit for incoming deliveries on a receiver.
  *
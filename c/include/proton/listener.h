@@ -122,6 +122,24 @@ PNP_EXTERN pn_record_t *pn_listener_attachments(pn_listener_t *listener);
  */
 PNP_EXTERN void pn_listener_close(pn_listener_t *l);
 
+/**
+ * **Unsettled API** - Let the listener share its address with other listeners.
+ *
+ * Call before pn_proactor_listen().  Listeners that set this may listen on the
+ * same address and port.  Each has its own listening socket and accept queue,
+ * and the operating system spreads incoming connections over them
+ * (SO_REUSEPORT).  Use one listener per thread, or per proactor when sharding
+ * with pn_proactor_accept(), so that connections are accepted and handshaken in
+ * parallel.
+ *
+ * To share a dynamically assigned port, listen on port 0 with the first listener
+ * and find the port for the others with pn_listener_addr().
+ *
+ * Ignored where the platform has no equivalent, in which case listening on an
+ * address that is already in use fails as usual.
+ */
+PNP_EXTERN void pn_listener_set_reuse_port(pn_listener_t *listener, bool reuse);
+
 /**
  * The proactor associated with a listener.
  */
@@ -712,6 +712,22 @@ PN_EXTERN pn_data_t *pn_message_properties(pn_message_t *msg);
  */
 PN_EXTERN pn_data_t *pn_message_body(pn_message_t *msg);
 
+/**
+ * **Unsettled API**: Get the body of a message as bytes without
+ * copying or decoding it.
+ *
+ * If the body is a single binary, string or symbol value this returns
+ * its bytes in place, otherwise it returns empty bytes. It also returns
+ * empty bytes once the body has been accessed with pn_message_body().
+ * The bytes are valid until the message is next modified, and for a
+ * message decoded with pn_message_decode_borrowed() only as long as
+ * the decoded bytes.
+ *
+ * @param[in] msg a message object
+ * @return the bytes of the body or empty bytes
+ */
+PN_EXTERN pn_bytes_t pn_message_get_body_bytes(pn_message_t *msg);
+
 /**
  * Decode/load message content from AMQP formatted binary data.
  *
@@ -726,6 +742,25 @@ PN_EXTERN pn_data_t *pn_message_body(pn_message_t *msg);
  */
 PN_EXTERN int pn_message_decode(pn_message_t *msg, const char *bytes, size_t size);
 
+/**
+ * **Unsettled API**: Decode message content without copying its sections.
+ *
+ * Like pn_message_decode() but the annotation, property and body
+ * sections refer to the encoded data in place instead of being copied
+ * into the message. The data must stay valid and unchanged until the
+ * message is cleared, freed or decoded again. Sections accessed as
+ * ::pn_data_t are decoded out of the data and no longer refer to it.
+ *
+ * The received bytes of a delivery, see pn_delivery_bytes(), may be
+ * decoded this way until the delivery is settled.
+ *
+ * @param[in] msg a message object
+ * @param[in] bytes the start of the encoded AMQP data
+ * @param[in] size the size of the encoded AMQP data
+ * @return zero on success or an error code on failure
+ */
+PN_EXTERN int pn_message_decode_borrowed(pn_message_t *msg, const char *bytes, size_t size);
+
 /**
  * Encode a message as AMQP formatted binary data.
  *
@@ -741,9 +776,25 @@ PN_EXTERN int pn_message_decode(pn_message_t *msg, const char *bytes, size_t siz
  */
 PN_EXTERN int pn_message_encode(pn_message_t *msg, char *bytes, size_t *size);
 
+/**
+ * **Unsettled API**: The exact number of bytes pn_message_encode()
+ * needs to encode a message.
+ *
+ * Sections set through pn_data_t objects are converted to their
+ * encoded form as a side effect, just as they would be by encoding.
+ *
+ * @param[in] msg A message object.
+ * @return The encoded size of the message or an error code (<0).
+ * On error pn_message_error(msg) will provide more information.
+ */
+PN_EXTERN ssize_t pn_message_encoded_size(pn_message_t *msg);
+
 /**
  * **Unsettled API**: Encode a message, allocating space if necessary
  *
+ * The message is measured with pn_message_encoded_size() first so it
+ * is encoded in a single pass.
+ *
  * @param[in] msg A message object.
  * @param[inout] buf Used to encode msg.
  *   If buf->start == NULL memory is allocated with malloc().
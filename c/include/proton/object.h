@@ -84,6 +84,38 @@ PN_EXTERN void *pn_record_get(pn_record_t *record, pn_handle_t key);
 PN_EXTERN void pn_record_set(pn_record_t *record, pn_handle_t key, void *value);
 PN_EXTERN void pn_record_clear(pn_record_t *record);
 
+/**
+ * Memory allocator used for proton objects and their internal buffers.
+ *
+ * Small allocations are served from per-thread caches of size-classed
+ * blocks; the allocator is only called to fill and drain those caches
+ * and for large allocations. The sizes passed to reallocate and
+ * deallocate are the sizes originally requested from the allocator.
+ */
+typedef struct pn_allocator_t {
+  void *(*allocate)(void *context, size_t size);
+  void *(*reallocate)(void *context, void *ptr, size_t old_size, size_t size);
+  void (*deallocate)(void *context, void *ptr, size_t size);
+  void *context;
+} pn_allocator_t;
+
+/**
+ * Install the allocator used for all subsequent proton allocations.
+ *
+ * Passing NULL restores the default malloc based allocator. This must
+ * be called before any proton objects are created, or after they have
+ * all been freed, as memory is always returned to the allocator that
+ * provided it.
+ */
+PN_EXTERN void pn_set_allocator(const pn_allocator_t *allocator);
+
+/**
+ * Release the calling thread's cached blocks back to the allocator.
+ *
+ * Caches are released automatically when a thread exits.
+ */
+PN_EXTERN void pn_allocator_flush(void);
+
 /**
  * @endcond
  */
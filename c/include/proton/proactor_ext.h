@@ -63,6 +63,194 @@ extern "C" {
  */
 PNP_EXTERN void pn_proactor_import_socket(pn_proactor_t *proactor, pn_connection_t *connection, pn_transport_t *transport, pn_socket_t fd);
 
+/**
+ * **Unsettled API** - Accept a connection from @p listener to be served by @p proactor.
+ *
+ * Like pn_listener_accept2(), which it must replace in the handling of a
+ * @ref PN_LISTENER_ACCEPT event, except that the connection's events are
+ * returned by pn_proactor_wait() on @p proactor rather than on the
+ * listener's own proactor.
+ *
+ * This lets an application shard its connections over several proactors,
+ * each with its own poller and scheduler, for example one proactor per
+ * thread with a single listener handing out connections round robin.
+ * Connections made with pn_proactor_connect2() are sharded by choosing the
+ * proactor to connect from.  Wakes, timers and interrupts stay within the
+ * proactor that serves a connection, so shards never contend with each other.
+ *
+ * Proactors that cannot move a socket between instances serve the
+ * connection from the listener's proactor.
+ *
+ * @note Thread-safe
+ *
+ * @param[in] proactor   The proactor to serve the connection.
+ * @param[in] listener   The listener with a pending accept.
+ * @param[in] connection The connection object, or NULL to create a new one.
+ * @param[in] transport  The transport object, or NULL to create a new one.
+ */
+PNP_EXTERN void pn_proactor_accept(pn_proactor_t *proactor, pn_listener_t *listener, pn_connection_t *connection, pn_transport_t *transport);
+
+/**
+ * **Unsettled API** - Limits on how long a connection keeps a thread.
+ *
+ * A batch of connection events runs on one thread from pn_proactor_wait()
+ * until pn_proactor_done().  A connection that uses up any of these limits
+ * ends its batch early, even if it has more events, and is rescheduled
+ * behind the connections already waiting.  Low limits favour tail latency
+ * across many connections, high ones the throughput of a busy connection.
+ *
+ * @see pn_proactor_set_sched_limit(), pn_connection_set_sched_weight()
+ */
+typedef enum {
+  /**
+   * The number of times a batch may read more input when its events run
+   * out, rather than end, while other work may be waiting.  Default 1.
+   */
+  PN_SCHED_REPLENISH,
+  /** Events returned by a batch.  Default 0, no limit. */
+  PN_SCHED_EVENTS,
+  /** Bytes read and written during a batch.  Default 0, no limit. */
+  PN_SCHED_BYTES,
+  /** Milliseconds a batch runs for.  Default 0, no limit. */
+  PN_SCHED_TIME
+} pn_sched_limit_t;
+
+/**
+ * **Unsettled API** - Set a scheduling limit for connections served by @p proactor.
+ *
+ * Each connection's limits are multiplied by its weight, see
+ * pn_connection_set_sched_weight().  Proactors that do not share threads
+ * between connections ignore the limits.
+ *
+ * @note Thread-safe, takes effect from the next batch.
+ */
+PNP_EXTERN void pn_proactor_set_sched_limit(pn_proactor_t *proactor, pn_sched_limit_t limit, uint64_t value);
+
+/**
+ * **Unsettled API** - Get a scheduling limit, 0 if the proactor does not use it.
+ */
+PNP_EXTERN uint64_t pn_proactor_get_sched_limit(pn_proactor_t *proactor, pn_sched_limit_t limit);
+
+/**
+ * **Unsettled API** - The number of batches a limit has ended early.
+ *
+ * For @ref PN_SCHED_REPLENISH, the number of times a batch ended rather
+ * than read more input.  Counts only ever increase, compare samples to
+ * tune the limits.
+ *
+ * @note Thread-safe
+ */
+PNP_EXTERN uint64_t pn_proactor_sched_limit_hits(pn_proactor_t *proactor, pn_sched_limit_t limit);
+
+/**
+ * **Unsettled API** - Weight the scheduling limits of a connection.
+ *
+ * A connection with weight N gets N times the limits set by
+ * pn_proactor_set_sched_limit() for each batch, so it gets a larger share
+ * of a busy proactor's threads.  The default weight is 1, 0 is treated as 1.
+ *
+ * Only applies to a connection being served by a proactor, from
+ * pn_proactor_connect2() or pn_listener_accept2() on.
+ *
+ * @note Thread-safe, takes effect from the connection's next batch.
+ */
+PNP_EXTERN void pn_connection_set_sched_weight(pn_connection_t *connection, unsigned weight);
+
+/**
+ * **Unsettled API** - Spin rather than sleep when waiting for work.
+ *
+ * A thread with nothing to do polls for IO and scheduled work without
+ * blocking for up to @p usec microseconds before it sleeps in the kernel.
+ * Work that arrives while a thread is spinning is picked up without a
+ * wakeup, which saves a system call or two and a thread switch on each
+ * message of a lightly loaded request/response exchange, at the cost of
+ * CPU time.  Only worth it with a core to spare for each spinning thread.
+ *
+ * Proactors that cannot spin ignore the setting.
+ *
+ * @note Thread-safe
+ *
+ * @param[in] proactor The proactor.
+ * @param[in] usec     How long to spin, 0 (the default) never to spin.
+ */
+PNP_EXTERN void pn_proactor_set_busy_poll(pn_proactor_t *proactor, unsigned usec);
+
+/**
+ * **Unsettled API** - Get the time set by pn_proactor_set_busy_poll().
+ */
+PNP_EXTERN unsigned pn_proactor_get_busy_poll(pn_proactor_t *proactor);
+
+/**
+ * **Unsettled API** - Ask the kernel to busy poll connection sockets.
+ *
+ * Sets SO_BUSY_POLL to @p usec on the sockets of connections the proactor
+ * serves from now on, where the platform supports it.  The kernel may
+ * refuse values above its net.core.busy_read setting to unprivileged
+ * processes, in which case the socket is left as it is.
+ *
+ * @note Thread-safe
+ *
+ * @param[in] proactor The proactor.
+ * @param[in] usec     The SO_BUSY_POLL time, 0 (the default) to leave it unset.
+ */
+PNP_EXTERN void pn_proactor_set_socket_busy_poll(pn_proactor_t *proactor, unsigned usec);
+
+/**
+ * **Unsettled API** - Run TLS handshakes on a separate pool of threads.
+ *
+ * While a connection's TLS handshake is in progress, the input it reads is
+ * handed to a pool of @p threads dedicated threads, which do the public key
+ * work and prepare the reply.  The connection is rescheduled when they are
+ * done, so a storm of new connections does not hold up the threads serving
+ * established ones.  With a non-zero @p threshold, reads of at least that
+ * many bytes on established TLS connections are decrypted on the pool too.
+ *
+ * The pool only grows, @p threads of 0 stops handing it new work.  Only
+ * connections using pn_ssl() are affected.  Proactors that cannot offload
+ * ignore the setting.
+ *
+ * @note Thread-safe
+ *
+ * @param[in] proactor  The proactor.
+ * @param[in] threads   Threads in the pool, 0 (the default) for none.
+ * @param[in] threshold Smallest read to offload after the handshake, 0 for none.
+ */
+PNP_EXTERN void pn_proactor_set_crypto_offload(pn_proactor_t *proactor, unsigned threads, size_t threshold);
+
+/**
+ * **Unsettled API** - The number of reads handed to the crypto offload pool.
+ *
+ * Counts only ever increase, see pn_proactor_set_crypto_offload().
+ *
+ * @note Thread-safe
+ */
+PNP_EXTERN uint64_t pn_proactor_crypto_offloads(pn_proactor_t *proactor);
+
+struct pn_tls_config_t;
+
+/**
+ * **Unsettled API** - Secure a proactor connection with pn_tls instead of pn_ssl.
+ *
+ * Call before passing @p transport to pn_proactor_connect2() or
+ * pn_listener_accept2(), in place of pn_ssl_init().  The proactor runs the
+ * pn_tls session itself: records are decrypted straight into the transport's
+ * input buffer and its output, message payloads included, is encrypted in
+ * place into the proactor's own pool of socket buffers, rather than being
+ * copied through the transport's SSL layer.
+ *
+ * @p config must be a client or server configuration matching the way the
+ * connection is made, and must outlive the connection.  @p peer_hostname is
+ * the name the server certificate is checked against, if verified, and the
+ * name sent with SNI.  Setting a transport up with both pn_ssl and pn_tls is
+ * an error.
+ *
+ * @param[in] transport     The transport, not yet bound to a connection.
+ * @param[in] config        The pn_tls configuration.
+ * @param[in] peer_hostname Expected name of the peer, NULL for none.
+ * @return 0 on success, PN_ERR if the proactor was built without pn_tls.
+ */
+PNP_EXTERN int pn_transport_set_tls(pn_transport_t *transport, struct pn_tls_config_t *config, const char *peer_hostname);
+
 #ifdef __cplusplus
 }
 #endif
@@ -273,6 +273,53 @@ PN_EXTERN int pn_ssl_domain_set_ciphers(pn_ssl_domain_t *domain, const char *cip
  */
 PN_EXTERN int pn_ssl_domain_allow_unsecured_client(pn_ssl_domain_t *domain);
 
+/**
+ * **Unsettled API** - Configure the TLS session cache of a domain.
+ *
+ * A client domain keeps up to @p size sessions, saved under the session_id
+ * given to ::pn_ssl_init() and the peer hostname, and drops the least recently
+ * used when full. A server domain keeps up to @p size sessions for clients to
+ * resume, for @p timeout seconds. A @p size of 0 disables the cache, a @p
+ * timeout of 0 keeps the current timeout. @p timeout is ignored by clients:
+ * the server decides how long its sessions may be resumed.
+ *
+ * The cache is safe to share between connections running in different threads.
+ *
+ * @param[in] domain the ssl domain to configure.
+ * @param[in] size maximum number of sessions to keep.
+ * @param[in] timeout seconds a server session can be resumed for.
+ * @return 0 on success
+ */
+PN_EXTERN int pn_ssl_domain_set_session_cache(pn_ssl_domain_t *domain, size_t size, unsigned timeout);
+
+/**
+ * **Unsettled API** - Set the keys a server domain uses to encrypt session tickets.
+ *
+ * Session tickets let clients resume sessions the server no longer caches,
+ * for example after a restart. By default each domain uses random keys, so
+ * tickets are only accepted by the domain that issued them. Servers given the
+ * same keys accept each other's tickets. The keys must be kept secret and
+ * should be changed regularly.
+ *
+ * @param[in] domain the ssl domain (server) to configure.
+ * @param[in] keys the key material, or NULL to stop issuing session tickets.
+ * @param[in] size size of @p keys, which must be the size required by the
+ * SSL implementation (80 bytes with OpenSSL 1.1 and later).
+ * @return 0 on success
+ */
+PN_EXTERN int pn_ssl_domain_set_session_ticket_keys(pn_ssl_domain_t *domain, const char *keys, size_t size);
+
+/**
+ * **Unsettled API** - Get session resumption statistics for a domain.
+ *
+ * Counts the handshakes completed by connections using the domain.
+ *
+ * @param[in] domain the ssl domain.
+ * @param[out] hits if not NULL, set to the number of handshakes that resumed a session.
+ * @param[out] misses if not NULL, set to the number of full handshakes.
+ */
+PN_EXTERN void pn_ssl_domain_get_session_stats(pn_ssl_domain_t *domain, uint64_t *hits, uint64_t *misses);
+
 /**
  * Create a new SSL session object associated with a transport.
  *
@@ -524,6 +524,49 @@ PN_TLS_EXTERN size_t pn_tls_get_session_error_string(pn_tls_t* tls, char *buf, s
 */
 PN_TLS_EXTERN int pn_tls_config_set_alpn_protocols(pn_tls_config_t *domain, const char **protocols, size_t protocol_count);
 
+/**
+ * Configure the session cache of a server config.
+ *
+ * Up to @p size sessions are kept for clients to resume, for @p timeout
+ * seconds. A @p size of 0 disables the cache, a @p timeout of 0 keeps the
+ * current timeout. The cache is safe to share between pn_tls_t objects used
+ * in different threads.
+ *
+ * @param[in] domain the tls config (server) to configure.
+ * @param[in] size maximum number of sessions to keep.
+ * @param[in] timeout seconds a session can be resumed for.
+ * @return 0 on success, PN_ARG_ERR if the config is not for a server.
+ */
+PN_TLS_EXTERN int pn_tls_config_set_session_cache(pn_tls_config_t *domain, size_t size, unsigned timeout);
+
+/**
+ * Set the keys a server config uses to encrypt session tickets.
+ *
+ * Session tickets let clients resume sessions the server no longer caches,
+ * for example after a restart. By default each config uses random keys, so
+ * tickets are only accepted by the config that issued them. Servers given the
+ * same keys accept each other's tickets. The keys must be kept secret and
+ * should be changed regularly.
+ *
+ * @param[in] domain the tls config (server) to configure.
+ * @param[in] keys the key material, or NULL to stop issuing session tickets.
+ * @param[in] size size of @p keys, which must be the size required by the
+ * TLS implementation (80 bytes with OpenSSL 1.1 and later).
+ * @return 0 on success, PN_ARG_ERR if the config is not for a server or the size is wrong.
+ */
+PN_TLS_EXTERN int pn_tls_config_set_session_ticket_keys(pn_tls_config_t *domain, const char *keys, size_t size);
+
+/**
+ * Get session resumption statistics for a config.
+ *
+ * Counts the handshakes completed by pn_tls_t objects using the config.
+ *
+ * @param[in] domain the tls config.
+ * @param[out] hits if not NULL, set to the number of handshakes that resumed a session.
+ * @param[out] misses if not NULL, set to the number of full handshakes.
+ */
+PN_TLS_EXTERN void pn_tls_config_get_session_stats(pn_tls_config_t *domain, uint64_t *hits, uint64_t *misses);
+
 /**
  * Get the name of the negotiated application protocol.
  *
@@ -445,6 +445,33 @@ PN_EXTERN uint32_t pn_transport_get_max_frame(pn_transport_t *transport);
  */
 PN_EXTERN void pn_transport_set_max_frame(pn_transport_t *transport, uint32_t size);
 
+/**
+ * **Unsettled API**: Send large message payloads without copying them
+ * into the kernel.
+ *
+ * Where the IO integration supports it (the epoll proactor, using
+ * MSG_ZEROCOPY), output segments of at least min_size bytes that refer
+ * to message payload in place are sent zero-copy. The payload (and any
+ * lent bytes, see pn_link_sendv()) is then kept until the kernel
+ * reports that it has finished with it, rather than until it has been
+ * written. This only pays for large transfers: each one costs a
+ * completion notification, and the maximum frame size bounds how big
+ * a segment can be.
+ *
+ * @param[in] transport a transport object
+ * @param[in] min_size the smallest segment to send zero-copy, 0 (the
+ * default) to always copy
+ */
+PN_EXTERN void pn_transport_set_zerocopy(pn_transport_t *transport, size_t min_size);
+
+/**
+ * **Unsettled API**: Get the smallest output segment sent zero-copy.
+ *
+ * @param[in] transport a transport object
+ * @return the size set by pn_transport_set_zerocopy(), 0 if disabled
+ */
+PN_EXTERN size_t pn_transport_get_zerocopy(pn_transport_t *transport);
+
 /**
  * Get the maximum frame size of a transport's remote peer.
  *
@@ -38,6 +38,7 @@ struct pn_buffer_t {
   uint32_t capacity;
   uint32_t start;
   uint32_t size;
+  bool embedded; // bytes live in the same allocation as the buffer
 };
 
 PN_STRUCT_CLASSDEF(pn_buffer)
@@ -49,6 +50,7 @@ pn_buffer_t *pn_buffer(size_t capacity)
     buf->capacity = capacity;
     buf->start = 0;
     buf->size = 0;
+    buf->embedded = false;
     if (capacity > 0) {
         buf->bytes = (char *) pni_mem_suballocate(PN_CLASSCLASS(pn_buffer), buf, capacity);
         if (buf->bytes == NULL) {
@@ -63,10 +65,25 @@ pn_buffer_t *pn_buffer(size_t capacity)
   return buf;
 }
 
+// A buffer whose first capacity bytes are allocated along with it. It only
+// needs a separate allocation once it has to grow past them.
+pn_buffer_t *pni_buffer_inline(size_t capacity)
+{
+  pn_buffer_t *buf = (pn_buffer_t *) pni_mem_allocate(PN_CLASSCLASS(pn_buffer), sizeof(pn_buffer_t) + capacity);
+  if (buf != NULL) {
+    buf->capacity = capacity;
+    buf->start = 0;
+    buf->size = 0;
+    buf->embedded = capacity > 0;
+    buf->bytes = capacity > 0 ? (char *) (buf + 1) : NULL;
+  }
+  return buf;
+}
+
 void pn_buffer_free(pn_buffer_t *buf)
 {
   if (buf) {
-    pni_mem_subdeallocate(PN_CLASSCLASS(pn_buffer), buf, buf->bytes);
+    if (!buf->embedded) pni_mem_subdeallocate(PN_CLASSCLASS(pn_buffer), buf, buf->bytes);
     pni_mem_deallocate(PN_CLASSCLASS(pn_buffer), buf);
   }
 }
@@ -119,12 +136,28 @@ int pn_buffer_ensure(pn_buffer_t *buf, size_t size)
 
   size_t old_capacity = buf->capacity;
   size_t old_head = pni_buffer_head(buf);
-  bool wrapped = pni_buffer_wrapped(buf);
+  // Contents that end exactly at the end of the space are not really wrapped,
+  // and moving them to the end of the new space would only cost a rotate later
+  bool wrapped = buf->start + buf->size > buf->capacity;
 
   uint32_t needed = (uint32_t)(buf->size + size);
   if (needed < 32) needed = 32;
   uint32_t new_capacity = pni_round_up_pow2(needed);
 
+  if (buf->embedded) {
+    // Spill out of the embedded bytes, unwrapping the contents on the way
+    char *new_bytes = (char *) pni_mem_suballocate(PN_CLASSCLASS(pn_buffer), buf, new_capacity);
+    if (!new_bytes) {
+      return PN_OUT_OF_MEMORY;
+    }
+    pn_buffer_get(buf, 0, buf->size, new_bytes);
+    buf->bytes = new_bytes;
+    buf->capacity = new_capacity;
+    buf->start = 0;
+    buf->embedded = false;
+    return 0;
+  }
+
   char* new_bytes = (char *) pni_mem_subreallocate(PN_CLASSCLASS(pn_buffer), buf, buf->bytes, new_capacity);
   if (!new_bytes) {
     return PN_OUT_OF_MEMORY;
@@ -141,6 +174,23 @@ int pn_buffer_ensure(pn_buffer_t *buf, size_t size)
   return 0;
 }
 
+// Give back the space of an empty buffer beyond capacity (rounded up as
+// pn_buffer_ensure() would). Returns the number of bytes freed.
+size_t pni_buffer_shrink(pn_buffer_t *buf, size_t capacity)
+{
+  if (buf->size || buf->embedded) return 0;
+  uint32_t new_capacity = pni_round_up_pow2((uint32_t)pn_max(capacity, 32));
+  if (new_capacity >= buf->capacity) return 0;
+
+  char* new_bytes = (char *) pni_mem_subreallocate(PN_CLASSCLASS(pn_buffer), buf, buf->bytes, new_capacity);
+  if (!new_bytes) return 0;
+  size_t freed = buf->capacity - new_capacity;
+  buf->bytes = new_bytes;
+  buf->capacity = new_capacity;
+  buf->start = 0;
+  return freed;
+}
+
 int pn_buffer_append(pn_buffer_t *buf, const char *bytes, size_t size)
 {
   if (!size) return 0;
@@ -217,6 +267,22 @@ void pn_buffer_clear(pn_buffer_t *buf)
   buf->size = 0;
 }
 
+// Describe [offset, offset+size) of the buffer contents in place: returns the
+// number of slices (0, 1 or 2 if the range wraps) without defragmenting.
+size_t pn_buffer_slices(pn_buffer_t *buf, size_t offset, size_t size, pn_bytes_t slices[2])
+{
+  if (offset >= buf->size) return 0;
+  size = pn_min(size, buf->size - offset);
+  if (size == 0) return 0;
+
+  size_t start = pni_buffer_index(buf, offset);
+  size_t sz1 = pn_min(size, buf->capacity - start);
+  slices[0] = (pn_bytes_t){.size=sz1, .start=buf->bytes + start};
+  if (sz1 == size) return 1;
+  slices[1] = (pn_bytes_t){.size=size - sz1, .start=buf->bytes};
+  return 2;
+}
+
 static void pn_buffer_rotate (pn_buffer_t *buf, size_t sz) {
   if (sz == 0) return;
 
@@ -260,3 +326,20 @@ pn_rwbytes_t pn_buffer_memory(pn_buffer_t *buf)
   pn_buffer_defrag(buf);
   return (pn_rwbytes_t){.size=buf->size, .start=buf->bytes};
 }
+
+// Replace [offset, offset+remove) of the contents with size bytes, moving
+// only the contents that follow the range.
+int pni_buffer_splice(pn_buffer_t *buf, size_t offset, size_t remove, const char *bytes, size_t size)
+{
+  if (offset + remove > buf->size) return PN_ARG_ERR;
+  if (size > remove) {
+    int err = pn_buffer_ensure(buf, size - remove);
+    if (err) return err;
+  }
+  pn_buffer_defrag(buf);
+  size_t rest = buf->size - offset - remove;
+  if (size != remove) memmove(buf->bytes + offset + size, buf->bytes + offset + remove, rest);
+  if (size) memcpy(buf->bytes + offset, bytes, size);
+  buf->size = offset + size + rest;
+  return 0;
+}
@@ -34,6 +34,7 @@ extern "C" {
 typedef struct pn_buffer_t pn_buffer_t;
 
 pn_buffer_t *pn_buffer(size_t capacity);
+pn_buffer_t *pni_buffer_inline(size_t capacity);
 void pn_buffer_free(pn_buffer_t *buf);
 size_t pn_buffer_size(pn_buffer_t *buf);
 size_t pn_buffer_capacity(pn_buffer_t *buf);
@@ -45,6 +46,9 @@ int pn_buffer_trim(pn_buffer_t *buf, size_t left, size_t right);
 void pn_buffer_clear(pn_buffer_t *buf);
 pn_bytes_t pn_buffer_bytes(pn_buffer_t *buf);
 pn_rwbytes_t pn_buffer_memory(pn_buffer_t *buf);
+size_t pn_buffer_slices(pn_buffer_t *buf, size_t offset, size_t size, pn_bytes_t slices[2]);
+int pni_buffer_splice(pn_buffer_t *buf, size_t offset, size_t remove, const char *bytes, size_t size);
+size_t pni_buffer_shrink(pn_buffer_t *buf, size_t capacity);
 
 #ifdef __cplusplus
 }
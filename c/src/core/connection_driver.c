@@ -92,6 +92,10 @@ pn_rwbytes_t pn_connection_driver_read_buffer_sized(pn_connection_driver_t *d, s
   return (cap > 0) ?  pn_rwbytes(cap, pn_transport_tail(d->transport)) : pn_rwbytes(0, 0);
 }
 
+size_t pn_connection_driver_shrink_buffers(pn_connection_driver_t *d, size_t n) {
+  return pni_transport_shrink_buffers(d->transport, n);
+}
+
 pn_rwbytes_t pn_connection_driver_read_buffer(pn_connection_driver_t *d) {
   ssize_t cap = pn_transport_capacity(d->transport);
   return (cap > 0) ?  pn_rwbytes(cap, pn_transport_tail(d->transport)) : pn_rwbytes(0, 0);
@@ -117,13 +121,31 @@ pn_bytes_t pn_connection_driver_write_buffer(pn_connection_driver_t *d) {
     pn_bytes(pending, pn_transport_head(d->transport)) : pn_bytes_null;
 }
 
+size_t pn_connection_driver_write_buffers(pn_connection_driver_t *d, pn_bytes_t *segs, size_t n) {
+  ssize_t count = pni_transport_pending_segments(d->transport, segs, n);
+  return (count > 0) ? (size_t)count : 0;
+}
+
 pn_bytes_t pn_connection_driver_write_done(pn_connection_driver_t *d, size_t n) {
+  if (d->transport->output_segments) {
+    pni_transport_pop_segments(d->transport, n);
+    pn_bytes_t seg;
+    return (pni_transport_pending_segments(d->transport, &seg, 1) > 0) ? seg : pn_bytes_null;
+  }
   pn_transport_pop(d->transport, n);
   ssize_t pending = d->transport->output_pending;
   return (pending > 0) ?
     pn_bytes(pending, pn_transport_head(d->transport)) : pn_bytes_null;
 }
 
+bool pn_connection_driver_write_hold(pn_connection_driver_t *d, pn_bytes_t segment, uint32_t tag) {
+  return segment.size && pni_transport_output_hold(d->transport, segment.start, tag);
+}
+
+void pn_connection_driver_write_release(pn_connection_driver_t *d, uint32_t tag) {
+  pni_transport_output_release(d->transport, tag);
+}
+
 bool pn_connection_driver_write_closed(pn_connection_driver_t *d) {
   return pn_transport_head_closed(d->transport);
 }
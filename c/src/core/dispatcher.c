@@ -183,8 +183,6 @@ ssize_t pn_dispatcher_sasl_input(pn_transport_t *transport, const char *bytes, s
 
 ssize_t pn_dispatcher_output(pn_transport_t *transport, char *bytes, size_t size)
 {
-    int n = pn_buffer_get(transport->output_buffer, 0, size, bytes);
-    pn_buffer_trim(transport->output_buffer, n, 0);
-    // XXX: need to check for errors
-    return n;
+    // Copies any referenced delivery payload along with the framing
+    return pni_transport_output_consume(transport, bytes, size);
 }
@@ -68,9 +68,22 @@ typedef struct {
   bool init;
 } pn_delivery_state_t;
 
+/* Unsettled deliveries indexed by delivery id.
+ *
+ * Ids are assigned densely, so the ids in [base, next) live in a power of two
+ * sized ring indexed by id & (capacity-1). base is always the oldest unsettled
+ * id still in the ring. If the ring reaches PN_DELIVERY_MAP_RING_MAX the oldest
+ * delivery is moved to the sparse hash rather than growing the ring further.
+ */
+#define PN_DELIVERY_MAP_RING_MIN (16)
+#define PN_DELIVERY_MAP_RING_MAX (64*1024)
+
 typedef struct {
+  pn_delivery_t **ring;
+  pn_hash_t *sparse;
+  size_t capacity;
+  pn_sequence_t base;
   pn_sequence_t next;
-  pn_hash_t *deliveries;
 } pn_delivery_map_t;
 
 typedef struct {
@@ -129,6 +142,45 @@ typedef uint8_t pn_io_layer_flags_t;
 typedef struct pni_sasl_t pni_sasl_t;
 typedef struct pni_ssl_t pni_ssl_t;
 
+/* Payload referenced from the output stream rather than copied into
+ * output_buffer. The inline bytes preceding it are still in output_buffer. */
+/* Shared by the bytes lent in one pn_link_sendv() call */
+typedef struct {
+  pn_send_complete_t complete;
+  void *context;
+  size_t refs;  // lent segments still in use
+} pni_send_completion_t;
+
+/* Bytes lent to a sending delivery, they follow the contents of its buffer */
+typedef struct {
+  pn_bytes_t bytes;
+  pni_send_completion_t *completion;
+} pni_lent_bytes_t;
+
+typedef struct {
+  pn_bytes_t bytes;
+  pn_buffer_t *owner;    // freed when this segment has been written, may be NULL
+  pni_send_completion_t *completion;  // released when this segment has been written, may be NULL
+  size_t inline_before;  // output_buffer bytes to be written before this segment
+  uint32_t hold_tag;     // if held, kept after being written until this tag is released
+  bool held;
+} pni_output_ref_t;
+
+// A written output_ref kept until the IO layer releases its tag
+typedef struct {
+  pn_buffer_t *owner;
+  pni_send_completion_t *completion;
+  uint32_t tag;
+} pni_output_held_t;
+
+// Only reference payloads at least this big, smaller ones are cheaper to copy
+#define PN_OUTPUT_REF_MIN_SIZE (4*1024)
+
+// Delivery tags up to this size are kept in the delivery itself
+#define PN_DELIVERY_INLINE_TAG (32)
+// Payload bytes held in the delivery buffer's own allocation before it spills
+#define PN_DELIVERY_INLINE_PAYLOAD (256)
+
 struct pn_transport_t {
   pn_logger_t logger;
   pn_tracer_t tracer;
@@ -176,6 +228,18 @@ struct pn_transport_t {
   // Temporary - ??
   pn_buffer_t *output_buffer;
 
+  /* delivery payloads interleaved with output_buffer, see pni_transport_pending_segments */
+  pni_output_ref_t *output_refs;
+  size_t output_refs_capacity;
+  size_t output_refs_head;
+  size_t output_refs_count;
+  size_t output_refs_bytes;   // sum of referenced payload bytes
+  size_t output_refs_inline;  // sum of inline_before
+  pni_output_held_t *output_held;  // written but still in use by the IO layer, oldest first
+  size_t output_held_capacity;
+  size_t output_held_count;
+  size_t zerocopy_min;        // see pn_transport_set_zerocopy()
+
   /* statistics */
   uint64_t bytes_input;
   uint64_t bytes_output;
@@ -226,6 +290,7 @@ struct pn_transport_t {
   bool auth_required;
   bool authenticated;
   bool encryption_required;
+  bool output_segments;   // output consumed as segments, payloads may be referenced
 
   bool referenced;
 };
@@ -314,6 +379,8 @@ struct pn_link_t {
   pn_session_t *session;  // reference counted
   pn_delivery_t *unsettled_head;
   pn_delivery_t *unsettled_tail;
+  pn_delivery_t *rsettled_head; // settled by the remote, waiting for the application
+  pn_delivery_t *rsettled_tail;
   pn_delivery_t *current;
   pn_record_t *context;
   pn_data_t *properties;
@@ -321,6 +388,7 @@ struct pn_link_t {
   pn_data_t *remote_properties;
   pn_bytes_t remote_properties_raw;
   size_t unsettled_count;
+  size_t rsettled_count;
   uint64_t max_message_size;
   uint64_t remote_max_message_size;
   pn_sequence_t available;
@@ -336,6 +404,7 @@ struct pn_link_t {
   bool drain;
   bool detached;
   bool more_pending;
+  bool coalesce_settled;
 };
 
 typedef enum pn_disposition_type_t {
@@ -397,7 +466,8 @@ struct pn_disposition_t {
 struct pn_delivery_t {
   pn_disposition_t local;
   pn_disposition_t remote;
-  pn_delivery_tag_t tag;
+  pn_delivery_tag_t tag;  // points at tag_inline for small tags
+  char tag_inline[PN_DELIVERY_INLINE_TAG];
   pn_link_t *link;  // reference counted
   pn_delivery_t *unsettled_next;
   pn_delivery_t *unsettled_prev;
@@ -405,13 +475,19 @@ struct pn_delivery_t {
   pn_delivery_t *work_prev;
   pn_delivery_t *tpwork_next;
   pn_delivery_t *tpwork_prev;
+  pn_delivery_t *rsettled_next;
+  pn_delivery_t *rsettled_prev;
   pn_delivery_state_t state;
   pn_buffer_t *bytes;
+  pni_lent_bytes_t *lent;  // sent after bytes, see pn_link_sendv
+  size_t lent_count;
+  size_t lent_capacity;
   pn_record_t *context;
   bool updated;
   bool settled; // tracks whether we're in the unsettled list or not
   bool work;
   bool tpwork;
+  bool rsettled; // tracks whether we're in the link's remote settled list
   bool done;
   bool referenced;
   bool aborted;
@@ -435,7 +511,12 @@ void pn_condition_tini(pn_condition_t *condition);
 void pn_modified(pn_connection_t *connection, pn_endpoint_t *endpoint, bool emit);
 void pn_real_settle(pn_delivery_t *delivery);  // will free delivery if link is freed
 void pn_clear_tpwork(pn_delivery_t *delivery);
+void pni_send_completion_release(pni_send_completion_t *completion);
+size_t pni_delivery_lent_size(pn_delivery_t *delivery);
+int pni_delivery_copy_lent(pn_delivery_t *delivery);
+void pni_delivery_drop_lent(pn_delivery_t *delivery, size_t count);
 void pn_work_update(pn_connection_t *connection, pn_delivery_t *delivery);
+void pni_add_rsettled(pn_delivery_t *delivery);
 void pn_clear_modified(pn_connection_t *connection, pn_endpoint_t *endpoint);
 void pn_connection_bound(pn_connection_t *conn);
 void pn_connection_unbound(pn_connection_t *conn);
@@ -448,6 +529,16 @@ void pn_ep_incref(pn_endpoint_t *endpoint);
 void pn_ep_decref(pn_endpoint_t *endpoint);
 
 ssize_t pni_transport_grow_capacity(pn_transport_t *transport, size_t n);
+size_t pni_transport_shrink_buffers(pn_transport_t *transport, size_t n);
+size_t pni_transport_output_buffered(pn_transport_t *transport);
+bool pni_output_refs_allowed(pn_transport_t *transport);
+int pni_transport_output_ref(pn_transport_t *transport, pn_bytes_t bytes, pn_buffer_t *owner,
+                             pni_send_completion_t *completion);
+size_t pni_transport_output_consume(pn_transport_t *transport, char *dst, size_t size);
+ssize_t pni_transport_pending_segments(pn_transport_t *transport, pn_bytes_t *segs, size_t n);
+void pni_transport_pop_segments(pn_transport_t *transport, size_t size);
+bool pni_transport_output_hold(pn_transport_t *transport, const char *start, uint32_t tag);
+void pni_transport_output_release(pn_transport_t *transport, uint32_t tag);
   void pni_session_update_incoming_lwm(pn_session_t *ssn);
 
 #if __cplusplus
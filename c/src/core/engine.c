@@ -36,6 +36,7 @@
 #include "platform/platform_fmt.h"
 #include "protocol.h"
 #include "transport.h"
+#include "util.h"
 
 #include <assert.h>
 #include <stdarg.h>
@@ -813,6 +814,30 @@ void pn_clear_tpwork(pn_delivery_t *delivery)
   }
 }
 
+void pni_add_rsettled(pn_delivery_t *delivery)
+{
+  pn_link_t *link = delivery->link;
+  if (!delivery->rsettled)
+  {
+    LL_ADD(link, rsettled, delivery);
+    delivery->rsettled = true;
+    link->rsettled_count++;
+  }
+}
+
+static void pni_clear_rsettled(pn_delivery_t *delivery)
+{
+  pn_link_t *link = delivery->link;
+  if (delivery->rsettled)
+  {
+    LL_REMOVE(link, rsettled, delivery);
+    delivery->rsettled_next = NULL;
+    delivery->rsettled_prev = NULL;
+    delivery->rsettled = false;
+    link->rsettled_count--;
+  }
+}
+
 void pn_dump(pn_connection_t *conn)
 {
   pn_endpoint_t *endpoint = conn->transport_head;
@@ -1297,7 +1322,9 @@ pn_link_t *pn_link_new(int type, pn_session_t *session, pn_string_t *name)
   pni_terminus_init(&link->remote_source, PN_UNSPECIFIED);
   pni_terminus_init(&link->remote_target, PN_UNSPECIFIED);
   link->unsettled_head = link->unsettled_tail = link->current = NULL;
+  link->rsettled_head = link->rsettled_tail = NULL;
   link->unsettled_count = 0;
+  link->rsettled_count = 0;
   link->max_message_size = 0;
   link->remote_max_message_size = 0;
   link->available = 0;
@@ -1314,6 +1341,7 @@ pn_link_t *pn_link_new(int type, pn_session_t *session, pn_string_t *name)
   link->remote_rcv_settle_mode = PN_RCV_FIRST;
   link->detached = false;
   link->more_pending = false;
+  link->coalesce_settled = false;
   link->properties = 0;
   link->properties_raw = (pn_bytes_t){0, NULL};
   link->remote_properties = 0;
@@ -1636,6 +1664,25 @@ static bool pni_preserve_delivery(pn_delivery_t *delivery)
   return !delivery->local.settled || (conn->transport && (delivery->state.init || delivery->tpwork));
 }
 
+// Small tags are copied into the delivery, only larger ones need allocating
+static void pni_delivery_set_tag(pn_delivery_t *delivery, pn_delivery_tag_t tag)
+{
+  if (tag.size <= PN_DELIVERY_INLINE_TAG) {
+    if (tag.size) memcpy(delivery->tag_inline, tag.start, tag.size);
+    delivery->tag = (pn_delivery_tag_t){tag.size, tag.size ? delivery->tag_inline : NULL};
+  } else {
+    delivery->tag = pn_bytes_dup(tag);
+  }
+}
+
+static void pni_delivery_free_tag(pn_delivery_t *delivery)
+{
+  if (delivery->tag.start != delivery->tag_inline) {
+    pn_bytes_free(delivery->tag);
+  }
+  delivery->tag = (pn_delivery_tag_t){0, NULL};
+}
+
 static void pn_delivery_finalize(void *object)
 {
   pn_delivery_t *delivery = (pn_delivery_t *) object;
@@ -1654,14 +1701,15 @@ static void pn_delivery_finalize(void *object)
     referenced = delivery->referenced;
 
     pn_clear_tpwork(delivery);
+    pni_clear_rsettled(delivery);
     LL_REMOVE(link, unsettled, delivery);
     pn_delivery_map_del(pn_link_is_sender(link)
                         ? &link->session->state.outgoing
                         : &link->session->state.incoming,
                         delivery);
-    pn_bytes_free(delivery->tag);
-    delivery->tag = (pn_delivery_tag_t){0, NULL};
+    pni_delivery_free_tag(delivery);
     pn_buffer_clear(delivery->bytes);
+    pni_delivery_drop_lent(delivery, delivery->lent_count);
     pn_record_clear(delivery->context);
     delivery->settled = true;
     pn_connection_t *conn = link->session->connection;
@@ -1677,9 +1725,10 @@ static void pn_delivery_finalize(void *object)
 
   if (!pooled) {
     pn_free(delivery->context);
-    pn_bytes_free(delivery->tag);
-    delivery->tag = (pn_delivery_tag_t){0, NULL};
+    pni_delivery_free_tag(delivery);
     pn_buffer_free(delivery->bytes);
+    pni_delivery_drop_lent(delivery, delivery->lent_count);
+    free(delivery->lent);
     pn_disposition_finalize(&delivery->local);
     pn_disposition_finalize(&delivery->remote);
   }
@@ -1725,7 +1774,10 @@ pn_delivery_t *pn_delivery(pn_link_t *link, pn_delivery_tag_t tag)
   if (!delivery) {
     delivery = (pn_delivery_t *) pn_class_new(&PN_CLASSCLASS(pn_delivery), sizeof(pn_delivery_t));
     if (!delivery) return NULL;
-    delivery->bytes = pn_buffer(64);
+    delivery->bytes = pni_buffer_inline(PN_DELIVERY_INLINE_PAYLOAD);
+    delivery->lent = NULL;
+    delivery->lent_count = 0;
+    delivery->lent_capacity = 0;
     pn_disposition_init(&delivery->local);
     pn_disposition_init(&delivery->remote);
     delivery->context = pn_record();
@@ -1734,7 +1786,7 @@ pn_delivery_t *pn_delivery(pn_link_t *link, pn_delivery_tag_t tag)
   }
   delivery->link = link;
   pn_incref(delivery->link);  // keep link until finalized
-  delivery->tag = pn_bytes_dup(tag);
+  pni_delivery_set_tag(delivery, tag);
   pn_disposition_clear(&delivery->local);
   pn_disposition_clear(&delivery->remote);
   delivery->updated = false;
@@ -1747,6 +1799,9 @@ pn_delivery_t *pn_delivery(pn_link_t *link, pn_delivery_tag_t tag)
   delivery->tpwork_next = NULL;
   delivery->tpwork_prev = NULL;
   delivery->tpwork = false;
+  delivery->rsettled_next = NULL;
+  delivery->rsettled_prev = NULL;
+  delivery->rsettled = false;
   pn_buffer_clear(delivery->bytes);
   delivery->done = false;
   delivery->aborted = false;
@@ -1780,7 +1835,7 @@ bool pn_delivery_buffered(pn_delivery_t *delivery)
     if (state->sent) {
       return false;
     } else {
-      return delivery->done || (pn_buffer_size(delivery->bytes) > 0);
+      return delivery->done || (pn_buffer_size(delivery->bytes) > 0) || delivery->lent_count;
     }
   } else {
     return false;
@@ -1810,6 +1865,34 @@ pn_delivery_t *pn_unsettled_next(pn_delivery_t *delivery)
   return d;
 }
 
+void pn_link_set_coalesce_settled(pn_link_t *link, bool coalesce)
+{
+  assert(link);
+  link->coalesce_settled = coalesce;
+}
+
+bool pn_link_get_coalesce_settled(pn_link_t *link)
+{
+  assert(link);
+  return link->coalesce_settled;
+}
+
+size_t pn_link_remote_settled(pn_link_t *link)
+{
+  assert(link);
+  return link->rsettled_count;
+}
+
+pn_delivery_t *pn_link_remote_settled_next(pn_link_t *link)
+{
+  assert(link);
+  pn_delivery_t *d = link->rsettled_head;
+  if (d) {
+    pni_clear_rsettled(d);
+  }
+  return d;
+}
+
 bool pn_delivery_current(pn_delivery_t *delivery)
 {
   pn_link_t *link = delivery->link;
@@ -2215,6 +2298,21 @@ static void pni_advance_sender(pn_link_t *link)
   link->current = link->current->unsettled_next;
 }
 
+// Account for received bytes the application is done with, which may open
+// up the session incoming window
+static void pni_delivery_release_bytes(pn_delivery_t *delivery, size_t size)
+{
+  if (!size) return;
+  pn_session_t *ssn = delivery->link->session;
+  ssn->incoming_bytes -= size;
+  pn_transport_t *t = ssn->connection->transport;
+  if (t) t->buffered_delivery_bytes -= size;
+  if (!ssn->check_flow && ssn->state.incoming_window < ssn->incoming_window_lwm) {
+    ssn->check_flow = true;
+    pni_add_tpwork(delivery);
+  }
+}
+
 static void pni_advance_receiver(pn_link_t *link)
 {
   link->credit--;
@@ -2223,18 +2321,9 @@ static void pni_advance_receiver(pn_link_t *link)
 
   pn_delivery_t *current = link->current;
   size_t drop_count = pn_buffer_size(current->bytes);
+  // Only forgets the bytes: views from pn_delivery_bytes() stay valid until settled
   pn_buffer_clear(current->bytes);
-
-  if (drop_count) {
-    pn_session_t *ssn = link->session;
-    ssn->incoming_bytes -= drop_count;
-    pn_transport_t *t = ssn->connection->transport;
-    if (t) t->buffered_delivery_bytes -= drop_count;
-    if (!ssn->check_flow && ssn->state.incoming_window < ssn->incoming_window_lwm) {
-      ssn->check_flow = true;
-      pni_add_tpwork(current);
-    }
-  }
+  pni_delivery_release_bytes(current, drop_count);
 
   link->current = link->current->unsettled_next;
 }
@@ -2328,6 +2417,7 @@ void pn_delivery_settle(pn_delivery_t *delivery)
     }
 
     link->unsettled_count--;
+    pni_clear_rsettled(delivery);
     delivery->local.settled = true;
     pni_add_tpwork(delivery);
     pn_work_update(delivery->link->session->connection, delivery);
@@ -2341,18 +2431,118 @@ void pn_link_offered(pn_link_t *sender, int credit)
   sender->available = credit;
 }
 
+void pni_send_completion_release(pni_send_completion_t *completion)
+{
+  if (completion && --completion->refs == 0) {
+    completion->complete(completion->context);
+    free(completion);
+  }
+}
+
+size_t pni_delivery_lent_size(pn_delivery_t *delivery)
+{
+  size_t size = 0;
+  for (size_t i = 0; i < delivery->lent_count; ++i) {
+    size += delivery->lent[i].bytes.size;
+  }
+  return size;
+}
+
+// Forget the first count lent segments, releasing any that are still held
+void pni_delivery_drop_lent(pn_delivery_t *delivery, size_t count)
+{
+  if (!count) return;
+  for (size_t i = 0; i < count; ++i) {
+    pni_send_completion_release(delivery->lent[i].completion);
+  }
+  delivery->lent_count -= count;
+  memmove(delivery->lent, delivery->lent + count, delivery->lent_count * sizeof(pni_lent_bytes_t));
+}
+
+// Copy the lent bytes onto the end of the delivery buffer so they can be released
+int pni_delivery_copy_lent(pn_delivery_t *delivery)
+{
+  if (!delivery->lent_count) return 0;
+  int err = pn_buffer_ensure(delivery->bytes, pni_delivery_lent_size(delivery));
+  if (err) return err;
+  for (size_t i = 0; i < delivery->lent_count; ++i) {
+    pn_buffer_append(delivery->bytes, delivery->lent[i].bytes.start, delivery->lent[i].bytes.size);
+  }
+  pni_delivery_drop_lent(delivery, delivery->lent_count);
+  return 0;
+}
+
 ssize_t pn_link_send(pn_link_t *sender, const char *bytes, size_t n)
 {
   pn_delivery_t *current = pn_link_current(sender);
   if (!current) return PN_EOS;
   if (!bytes || !n) return 0;
-  int err = pn_buffer_append(current->bytes, bytes, n);
+  int err = pni_delivery_copy_lent(current);
+  if (err) return err;
+  err = pn_buffer_append(current->bytes, bytes, n);
   if (err) return err;
   sender->session->outgoing_bytes += n;
   pni_add_tpwork(current);
   return n;
 }
 
+static int pni_delivery_lend(pn_delivery_t *delivery, const pn_bytes_t *segs, size_t n,
+                             pn_send_complete_t complete, void *context)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (segs[i].size) count++;
+  }
+  if (!count) {
+    complete(context);
+    return 0;
+  }
+  if (delivery->lent_count + count > delivery->lent_capacity) {
+    size_t capacity = pn_max(2*delivery->lent_capacity, delivery->lent_count + count);
+    pni_lent_bytes_t *lent = (pni_lent_bytes_t *) realloc(delivery->lent, capacity * sizeof(pni_lent_bytes_t));
+    if (!lent) return PN_OUT_OF_MEMORY;
+    delivery->lent = lent;
+    delivery->lent_capacity = capacity;
+  }
+  pni_send_completion_t *completion = (pni_send_completion_t *) malloc(sizeof(pni_send_completion_t));
+  if (!completion) return PN_OUT_OF_MEMORY;
+  *completion = (pni_send_completion_t){.complete=complete, .context=context, .refs=count};
+  for (size_t i = 0; i < n; ++i) {
+    if (segs[i].size) {
+      delivery->lent[delivery->lent_count++] = (pni_lent_bytes_t){.bytes=segs[i], .completion=completion};
+    }
+  }
+  return 0;
+}
+
+ssize_t pn_link_sendv(pn_link_t *sender, const pn_bytes_t *segs, size_t n,
+                      pn_send_complete_t complete, void *context)
+{
+  pn_delivery_t *current = pn_link_current(sender);
+  if (!current) return PN_EOS;
+  size_t size = 0;
+  for (size_t i = 0; i < n; ++i) {
+    size += segs[i].size;
+  }
+  int err;
+  if (complete) {
+    err = pni_delivery_lend(current, segs, n, complete, context);
+    if (err) return err;
+  } else {
+    // Make room for everything first so there is at most one reallocation
+    err = pni_delivery_copy_lent(current);
+    if (!err) err = pn_buffer_ensure(current->bytes, size);
+    if (err) return err;
+    for (size_t i = 0; i < n; ++i) {
+      pn_buffer_append(current->bytes, segs[i].start, segs[i].size);
+    }
+  }
+  if (!size) return 0;
+  sender->session->outgoing_bytes += size;
+  pni_add_tpwork(current);
+  return size;
+}
+
 int pn_link_drained(pn_link_t *link)
 {
   assert(link);
@@ -2382,20 +2572,102 @@ ssize_t pn_link_recv(pn_link_t *receiver, char *bytes, size_t n)
   size_t size = pn_buffer_get(delivery->bytes, 0, n, bytes);
   pn_buffer_trim(delivery->bytes, size, 0);
   if (size) {
-    pn_session_t *ssn = receiver->session;
-    ssn->incoming_bytes -= size;
-    pn_transport_t *t = ssn->connection->transport;
-    if (t) t->buffered_delivery_bytes -= size;
-    if (!ssn->check_flow && ssn->state.incoming_window < ssn->incoming_window_lwm) {
-      ssn->check_flow = true;
-      pni_add_tpwork(delivery);
-    }
+    pni_delivery_release_bytes(delivery, size);
     return size;
   } else {
     return delivery->done ? PN_EOS : 0;
   }
 }
 
+size_t pn_delivery_peek_bytes(pn_delivery_t *delivery, pn_bytes_t spans[2])
+{
+  assert(delivery);
+  if (delivery->aborted) return 0;
+  return pn_buffer_slices(delivery->bytes, 0, pn_buffer_size(delivery->bytes), spans);
+}
+
+ssize_t pn_delivery_consume(pn_delivery_t *delivery, size_t size)
+{
+  if (!delivery) return PN_ARG_ERR;
+  if (!pn_link_is_receiver(delivery->link)) return PN_STATE_ERR;
+  if (delivery->aborted) return PN_ABORTED;
+  size = pn_min(size, pn_buffer_size(delivery->bytes));
+  pn_buffer_trim(delivery->bytes, size, 0);
+  pni_delivery_release_bytes(delivery, size);
+  return size;
+}
+
+// Replace the message-annotations section of the encoded message in buf, or
+// insert it after any header and delivery-annotations if it is missing. Empty
+// annotations remove the section.
+static int pni_message_bytes_set_annotations(pn_buffer_t *buf, pn_data_t *annotations)
+{
+  pn_bytes_t msg = pn_buffer_bytes(buf);
+  size_t offset = 0;
+  size_t old_size = 0;
+  while (offset < msg.size) {
+    bool scanned;
+    uint64_t desc;
+    pn_bytes_t rest = {.size=msg.size-offset, .start=msg.start+offset};
+    size_t section_size = pn_amqp_decode_described_type_anything(rest, &scanned, &desc);
+    if (!scanned) break;
+    if (desc == AMQP_DESC_MESSAGE_ANNOTATIONS) {
+      old_size = section_size;
+      break;
+    }
+    if (desc != AMQP_DESC_HEADER && desc != AMQP_DESC_DELIVERY_ANNOTATIONS) break;
+    offset += section_size;
+  }
+
+  if (!pn_data_size(annotations)) {
+    return pni_buffer_splice(buf, offset, old_size, NULL, 0);
+  }
+
+  pn_bytes_t map;
+  int err = pni_data_encode_raw(annotations, &map);
+  if (err) return err;
+  size_t size = pn_amqp_encode_bytes_described_type_raw(NULL, 0, AMQP_DESC_MESSAGE_ANNOTATIONS, map);
+  char *section = (char *) malloc(size);
+  if (section) {
+    pn_amqp_encode_bytes_described_type_raw(section, size, AMQP_DESC_MESSAGE_ANNOTATIONS, map);
+    err = pni_buffer_splice(buf, offset, old_size, section, size);
+    free(section);
+  } else {
+    err = PN_OUT_OF_MEMORY;
+  }
+  pn_bytes_free(map);
+  return err;
+}
+
+ssize_t pn_delivery_forward(pn_delivery_t *delivery, pn_link_t *sender, pn_data_t *annotations)
+{
+  if (!delivery || !sender) return PN_ARG_ERR;
+  if (!pn_link_is_receiver(delivery->link) || !pn_link_is_sender(sender)) return PN_ARG_ERR;
+  pn_delivery_t *current = pn_link_current(sender);
+  if (!current) return PN_EOS;
+  if (delivery->aborted) return PN_ABORTED;
+  if (!delivery->done || pn_buffer_size(current->bytes) || current->lent_count) return PN_STATE_ERR;
+
+  size_t received = pn_buffer_size(delivery->bytes);
+  if (annotations) {
+    int err = pni_message_bytes_set_annotations(delivery->bytes, annotations);
+    if (err) return err;
+  }
+
+  // Swap buffers so the received delivery keeps an empty one for reuse
+  pn_buffer_t *bytes = current->bytes;
+  current->bytes = delivery->bytes;
+  delivery->bytes = bytes;
+  pni_delivery_release_bytes(delivery, received);
+
+  size_t n = pn_buffer_size(current->bytes);
+  if (n) {
+    sender->session->outgoing_bytes += n;
+    pni_add_tpwork(current);
+  }
+  return n;
+}
+
 
 void pn_link_flow(pn_link_t *receiver, int credit)
 {
@@ -2578,7 +2850,14 @@ size_t pn_delivery_pending(pn_delivery_t *delivery)
      the PN_ABORTED error return code.
   */
   if (delivery->aborted) return 1;
-  return pn_buffer_size(delivery->bytes);
+  return pn_buffer_size(delivery->bytes) + pni_delivery_lent_size(delivery);
+}
+
+pn_bytes_t pn_delivery_bytes(pn_delivery_t *delivery)
+{
+  assert(delivery);
+  if (delivery->aborted) return (pn_bytes_t){0, NULL};
+  return pn_buffer_bytes(delivery->bytes);
 }
 
 bool pn_delivery_partial(pn_delivery_t *delivery)
@@ -2590,8 +2869,9 @@ void pn_delivery_abort(pn_delivery_t *delivery) {
   if (!delivery->local.settled) { /* Can't abort a settled delivery */
     delivery->aborted = true;
     pn_delivery_settle(delivery);
-    delivery->link->session->outgoing_bytes -= pn_buffer_size(delivery->bytes);
+    delivery->link->session->outgoing_bytes -= pn_buffer_size(delivery->bytes) + pni_delivery_lent_size(delivery);
     pn_buffer_clear(delivery->bytes);
+    pni_delivery_drop_lent(delivery, delivery->lent_count);
   }
 }
 
@@ -84,6 +84,15 @@ ssize_t pn_read_frame(pn_frame_t *frame, const char *bytes, size_t available, ui
   return size;
 }
 
+static inline void pn_frame_header(char bytes[AMQP_HEADER_SIZE], size_t size, size_t extended, uint8_t type, uint16_t channel)
+{
+  pni_write32(&bytes[0], size);
+  int doff = (extended + AMQP_HEADER_SIZE - 1)/4 + 1;
+  bytes[4] = doff;
+  bytes[5] = type;
+  pni_write16(&bytes[6], channel);
+}
+
 size_t pn_write_frame(pn_buffer_t* buffer, pn_frame_t frame, pn_logger_t *logger)
 {
   size_t size = AMQP_HEADER_SIZE + frame.extended.size + frame.frame_payload0.size + frame.frame_payload1.size;
@@ -91,11 +100,7 @@ size_t pn_write_frame(pn_buffer_t* buffer, pn_frame_t frame, pn_logger_t *logger
   {
     // Prepare header
     char bytes[8];
-    pni_write32(&bytes[0], size);
-    int doff = (frame.extended.size + AMQP_HEADER_SIZE - 1)/4 + 1;
-    bytes[4] = doff;
-    bytes[5] = frame.type;
-    pni_write16(&bytes[6], frame.channel);
+    pn_frame_header(bytes, size, frame.extended.size, frame.type, frame.channel);
 
     // Write header then rest of frame
     pn_buffer_append(buffer, bytes, 8);
@@ -160,6 +165,25 @@ int pn_framing_send_amqp_with_payload(pn_transport_t *transport, uint16_t ch, pn
   return 0;
 }
 
+// Like pn_framing_send_amqp_with_payload but the payload_size bytes of payload
+// are referenced by the transport output rather than copied: they must follow
+// with pni_transport_output_ref(), in as many pieces as needed.
+int pn_framing_begin_amqp_with_payload_refs(pn_transport_t *transport, uint16_t ch, pn_bytes_t performative, size_t payload_size)
+{
+  if (!performative.start)
+    return PN_ERR;
+
+  pn_buffer_t *output = transport->output_buffer;
+  char bytes[AMQP_HEADER_SIZE];
+  pn_frame_header(bytes, AMQP_HEADER_SIZE+performative.size+payload_size, 0, AMQP_FRAME_TYPE, ch);
+  int err = pn_buffer_ensure(output, AMQP_HEADER_SIZE+performative.size);
+  if (err) return err;
+  pn_buffer_append(output, bytes, AMQP_HEADER_SIZE);
+  pn_buffer_append(output, performative.start, performative.size);
+  transport->output_frames_ct += 1;
+  return 0;
+}
+
 int pn_framing_send_sasl(pn_transport_t *transport, pn_bytes_t performative)
 {
   if (!performative.start)
@@ -50,6 +50,7 @@ size_t pn_write_frame(pn_buffer_t* buffer, pn_frame_t frame, pn_logger_t *logger
 
 int pn_framing_send_amqp(pn_transport_t *transport, uint16_t ch, pn_bytes_t performative);
 int pn_framing_send_amqp_with_payload(pn_transport_t *transport, uint16_t ch, pn_bytes_t performative, pn_bytes_t payload);
+int pn_framing_begin_amqp_with_payload_refs(pn_transport_t *transport, uint16_t ch, pn_bytes_t performative, size_t payload_size);
 int pn_framing_send_sasl(pn_transport_t *transport, pn_bytes_t performative);
 
 ssize_t pn_framing_recv_amqp(pn_data_t *args, pn_logger_t  *logger, const pn_bytes_t frame_payload);
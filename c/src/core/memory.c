@@ -21,33 +21,213 @@
 
 #include "core/memory.h"
 
-#ifdef PN_MEMDEBUG
-#include "logger_private.h"
-
 #include "proton/object.h"
 #include "proton/cid.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
-#include <signal.h>
+#if !defined(_WIN32) && defined(__GNUC__)
+#include <pthread.h>
+#define PNI_THREAD_CACHE 1
+#endif
+
+// The installed allocator, malloc based by default
+
+static void *pni_libc_allocate(void *context, size_t size) { return malloc(size); }
+static void *pni_libc_reallocate(void *context, void *ptr, size_t old_size, size_t size) { return realloc(ptr, size); }
+static void pni_libc_deallocate(void *context, void *ptr, size_t size) { free(ptr); }
+
+static const pn_allocator_t pni_libc_allocator = {
+  pni_libc_allocate, pni_libc_reallocate, pni_libc_deallocate, NULL
+};
+
+static pn_allocator_t allocator = {
+  pni_libc_allocate, pni_libc_reallocate, pni_libc_deallocate, NULL
+};
+
+// Every allocation is preceded by a header recording the requested size,
+// padded to keep the following memory suitably aligned.
+typedef union {
+  size_t size;
+  void *next;
+  char pad[16];
+} pni_mem_head_t;
+
+#define pni_mem_head(PTR) (((pni_mem_head_t *) (PTR)) - 1)
+
+// Small allocations are rounded up to a size class. Freed blocks are kept on
+// a per-thread free list for their class (up to PNI_SLAB_DEPTH of them) so a
+// steady state of allocate/free cycles doesn't call the allocator at all.
+#define PNI_SLAB_GRANULE (16)
+#define PNI_SLAB_MAX (512)
+#define PNI_SLAB_CLASSES (PNI_SLAB_MAX/PNI_SLAB_GRANULE)
+#define PNI_SLAB_DEPTH (256)
+
+static inline size_t pni_slab_class(size_t size)
+{
+  return size ? (size-1)/PNI_SLAB_GRANULE : 0;
+}
+
+// Size of the underlying block for a requested size
+static inline size_t pni_mem_block_size(size_t size)
+{
+  if (size > PNI_SLAB_MAX) return sizeof(pni_mem_head_t) + size;
+  return sizeof(pni_mem_head_t) + (pni_slab_class(size)+1)*PNI_SLAB_GRANULE;
+}
+
+#ifdef PNI_THREAD_CACHE
+
+typedef struct {
+  pni_mem_head_t *free[PNI_SLAB_CLASSES];
+  unsigned count[PNI_SLAB_CLASSES];
+  bool registered;
+} pni_slab_cache_t;
+
+static __thread pni_slab_cache_t slab_cache;
+
+static pthread_key_t slab_key;
+static pthread_once_t slab_key_once = PTHREAD_ONCE_INIT;
+
+static void pni_slab_flush(pni_slab_cache_t *cache)
+{
+  for (size_t c = 0; c < PNI_SLAB_CLASSES; ++c) {
+    size_t block = sizeof(pni_mem_head_t) + (c+1)*PNI_SLAB_GRANULE;
+    pni_mem_head_t *head = cache->free[c];
+    while (head) {
+      pni_mem_head_t *next = (pni_mem_head_t *) head->next;
+      allocator.deallocate(allocator.context, head, block);
+      head = next;
+    }
+    cache->free[c] = NULL;
+    cache->count[c] = 0;
+  }
+}
+
+static void pni_slab_thread_exit(void *cache)
+{
+  pni_slab_flush((pni_slab_cache_t *) cache);
+}
+
+static void pni_slab_key_init(void)
+{
+  pthread_key_create(&slab_key, pni_slab_thread_exit);
+}
+
+static inline pni_slab_cache_t *pni_slab_cache(void)
+{
+  pni_slab_cache_t *cache = &slab_cache;
+  if (!cache->registered) {
+    pthread_once(&slab_key_once, pni_slab_key_init);
+    pthread_setspecific(slab_key, cache);
+    cache->registered = true;
+  }
+  return cache;
+}
+
+static inline pni_mem_head_t *pni_slab_get(size_t size)
+{
+  if (size > PNI_SLAB_MAX) return NULL;
+  pni_slab_cache_t *cache = pni_slab_cache();
+  size_t c = pni_slab_class(size);
+  pni_mem_head_t *head = cache->free[c];
+  if (head) {
+    cache->free[c] = (pni_mem_head_t *) head->next;
+    cache->count[c]--;
+  }
+  return head;
+}
+
+static inline bool pni_slab_put(pni_mem_head_t *head, size_t size)
+{
+  if (size > PNI_SLAB_MAX) return false;
+  pni_slab_cache_t *cache = pni_slab_cache();
+  size_t c = pni_slab_class(size);
+  if (cache->count[c] >= PNI_SLAB_DEPTH) return false;
+  head->next = cache->free[c];
+  cache->free[c] = head;
+  cache->count[c]++;
+  return true;
+}
+
+void pn_allocator_flush(void)
+{
+  pni_slab_flush(&slab_cache);
+}
 
-// Non portable actual size of allocated block
-// malloc_usable_size() for glibc
-// _msize() for MSCRT
-// malloc_size() for BSDs
-#ifdef __GLIBC__
-#include <malloc.h>
-#define msize malloc_usable_size
-#elif defined(_WIN32)
-#include <malloc.h>
-#define msize _msize
-#elif defined(__APPLE__) || defined(__FreeBSD__)
-#include <malloc/malloc.h>
-#define msize malloc_size
 #else
-#define msize(x) (0)
+
+static inline pni_mem_head_t *pni_slab_get(size_t size) { return NULL; }
+static inline bool pni_slab_put(pni_mem_head_t *head, size_t size) { return false; }
+
+void pn_allocator_flush(void) {}
+
 #endif
 
+void pn_set_allocator(const pn_allocator_t *a)
+{
+  pn_allocator_flush();
+  allocator = a ? *a : pni_libc_allocator;
+}
+
+static void *pni_mem_raw_allocate(size_t size)
+{
+  pni_mem_head_t *head = pni_slab_get(size);
+  if (!head) {
+    head = (pni_mem_head_t *) allocator.allocate(allocator.context, pni_mem_block_size(size));
+    if (!head) return NULL;
+  }
+  head->size = size;
+  return head + 1;
+}
+
+static void pni_mem_raw_deallocate(void *object)
+{
+  if (!object) return;
+  pni_mem_head_t *head = pni_mem_head(object);
+  size_t size = head->size;
+  if (!pni_slab_put(head, size)) {
+    allocator.deallocate(allocator.context, head, pni_mem_block_size(size));
+  }
+}
+
+static void *pni_mem_raw_reallocate(void *object, size_t size)
+{
+  if (!object) return pni_mem_raw_allocate(size);
+  pni_mem_head_t *head = pni_mem_head(object);
+  size_t old_size = head->size;
+  size_t old_block = pni_mem_block_size(old_size);
+  size_t block = pni_mem_block_size(size);
+  if (old_block == block) {
+    head->size = size;
+    return object;
+  }
+  if (old_size > PNI_SLAB_MAX && size > PNI_SLAB_MAX) {
+    head = (pni_mem_head_t *) allocator.reallocate(allocator.context, head, old_block, block);
+    if (!head) return NULL;
+    head->size = size;
+    return head + 1;
+  }
+  void *o = pni_mem_raw_allocate(size);
+  if (!o) return NULL;
+  memcpy(o, object, old_size < size ? old_size : size);
+  pni_mem_raw_deallocate(object);
+  return o;
+}
+
+// Memory from pn_strdup() is released with free() by its users so it can't
+// come from the allocator.
+static inline bool pni_mem_libc(const pn_class_t *clazz)
+{
+  return clazz->cid == CID_pn_strdup;
+}
+
+#ifdef PN_MEMDEBUG
+#include "logger_private.h"
+
+#include <signal.h>
+
 static struct stats {
   const char* name;
   size_t count_alloc;
@@ -152,11 +332,18 @@ void pni_fini_memory(void)
   *logger = save;
 }
 
+// Actual size of the block holding an allocation
+static inline size_t pni_mem_size(const pn_class_t *clazz, void *o)
+{
+  if (!o || pni_mem_libc(clazz)) return 0;
+  return pni_mem_block_size(pni_mem_head(o)->size);
+}
+
 static inline struct stats *pni_track_common(const pn_class_t *clazz, void *o, size_t *size)
 {
   struct stats *entry = &stats[pn_class_id(clazz)];
   if (!entry->name) {entry->name = pn_class_name(clazz);}
-  *size = msize(o);
+  *size = pni_mem_size(clazz, o);
   return entry;
 }
 
@@ -216,14 +403,15 @@ static void pni_track_subrealloc(const pn_class_t *clazz, void *o, size_t oldsiz
 
 void *pni_mem_zallocate(const pn_class_t *clazz, size_t size)
 {
-  void *o = calloc(1, size);
+  void *o = pni_mem_libc(clazz) ? malloc(size) : pni_mem_raw_allocate(size);
+  if (o) memset(o, 0, size);
   pni_track_alloc(clazz, o, size);
   return o;
 }
 
 void *pni_mem_allocate(const pn_class_t *clazz, size_t size)
 {
-  void * o = malloc(size);
+  void *o = pni_mem_libc(clazz) ? malloc(size) : pni_mem_raw_allocate(size);
   pni_track_alloc(clazz, o, size);
   return o;
 }
@@ -232,20 +420,21 @@ void pni_mem_deallocate(const pn_class_t *clazz, void *object)
 {
   if (!object) return;
   pni_track_dealloc(clazz, object);
-  free(object);
+  if (pni_mem_libc(clazz)) free(object);
+  else pni_mem_raw_deallocate(object);
 }
 
 void *pni_mem_suballocate(const pn_class_t *clazz, void *object, size_t size)
 {
-  void * o = malloc(size);
+  void * o = pni_mem_raw_allocate(size);
   pni_track_suballoc(clazz, o, size);
   return o;
 }
 
 void *pni_mem_subreallocate(const pn_class_t *clazz, void *object, void *buffer, size_t size)
 {
-  size_t oldsize = buffer ? msize(buffer) : 0;
-  void *o = realloc(buffer, size);
+  size_t oldsize = pni_mem_size(clazz, buffer);
+  void *o = pni_mem_raw_reallocate(buffer, size);
   pni_track_subrealloc(clazz, o, oldsize, size);
   return o;
 }
@@ -254,25 +443,37 @@ void pni_mem_subdeallocate(const pn_class_t *clazz, void *object, void *buffer)
 {
   if (!buffer) return;
   pni_track_subdealloc(clazz, buffer);
-  free(buffer);
+  pni_mem_raw_deallocate(buffer);
 }
 #else
 
 // Versions with no memory debugging - so we can compile with no performance penalty
 
-#include <stdlib.h>
-
 void pni_init_memory(void) {}
 void pni_fini_memory(void) {}
 
 void pni_mem_setup_logging(void) {}
 
-void *pni_mem_allocate(const pn_class_t *clazz, size_t size) { return malloc(size); }
-void *pni_mem_zallocate(const pn_class_t *clazz, size_t size) { return calloc(1, size); }
-void pni_mem_deallocate(const pn_class_t *clazz, void *object) { free(object); }
+void *pni_mem_allocate(const pn_class_t *clazz, size_t size)
+{
+  return pni_mem_libc(clazz) ? malloc(size) : pni_mem_raw_allocate(size);
+}
+
+void *pni_mem_zallocate(const pn_class_t *clazz, size_t size)
+{
+  void *o = pni_mem_allocate(clazz, size);
+  if (o) memset(o, 0, size);
+  return o;
+}
+
+void pni_mem_deallocate(const pn_class_t *clazz, void *object)
+{
+  if (pni_mem_libc(clazz)) free(object);
+  else pni_mem_raw_deallocate(object);
+}
 
-void *pni_mem_suballocate(const pn_class_t *clazz, void *object, size_t size) { return malloc(size); }
-void *pni_mem_subreallocate(const pn_class_t *clazz, void *object, void *buffer, size_t size) { return realloc(buffer, size); }
-void pni_mem_subdeallocate(const pn_class_t *clazz, void *object, void *buffer) { free(buffer); }
+void *pni_mem_suballocate(const pn_class_t *clazz, void *object, size_t size) { return pni_mem_raw_allocate(size); }
+void *pni_mem_subreallocate(const pn_class_t *clazz, void *object, void *buffer, size_t size) { return pni_mem_raw_reallocate(buffer, size); }
+void pni_mem_subdeallocate(const pn_class_t *clazz, void *object, void *buffer) { pni_mem_raw_deallocate(buffer); }
 
 #endif
@@ -34,6 +34,9 @@ PN_EXTERN pn_message_t * pni_message_with_extra(size_t extra);
 /** Pointer to extra space allocated by pn_message_with_extra(). */
 PN_EXTERN void* pni_message_get_extra(pn_message_t *msg);
 
+/** Copy any sections referring to bytes given to pn_message_decode_borrowed() */
+PN_EXTERN void pni_message_own(pn_message_t *msg);
+
 /** @endcond */
 
 #ifdef __cplusplus
@@ -21,6 +21,7 @@
 
 #include "platform/platform_fmt.h"
 
+#include "consumers.h"
 #include "data.h"
 #include "encodings.h"
 #include "max_align.h"
@@ -50,6 +51,7 @@ struct pn_message_t {
   pn_bytes_t annotations_raw;
   pn_bytes_t properties_raw;
   pn_bytes_t body_raw;
+  pn_bytes_t borrowed; // decoded bytes that raw sections refer into rather than own
   pn_timestamp_t expiry_time;
   pn_timestamp_t creation_time;
   pn_string_t *user_id;
@@ -80,6 +82,43 @@ struct pn_message_t {
   bool inferred;
 };
 
+static inline bool pni_message_borrows(pn_message_t *msg, pn_bytes_t raw)
+{
+  return raw.start && msg->borrowed.start &&
+    raw.start >= msg->borrowed.start && raw.start < msg->borrowed.start + msg->borrowed.size;
+}
+
+static void pni_message_free_raw(pn_message_t *msg, pn_bytes_t *raw)
+{
+  if (!pni_message_borrows(msg, *raw)) pn_bytes_free(*raw);
+  *raw = (pn_bytes_t){0, NULL};
+}
+
+static void pni_message_own_raw(pn_message_t *msg, pn_bytes_t *raw)
+{
+  if (pni_message_borrows(msg, *raw)) *raw = pn_bytes_dup(*raw);
+}
+
+void pni_message_own(pn_message_t *msg)
+{
+  pni_message_own_raw(msg, &msg->instructions_raw);
+  pni_message_own_raw(msg, &msg->annotations_raw);
+  pni_message_own_raw(msg, &msg->properties_raw);
+  pni_message_own_raw(msg, &msg->body_raw);
+  msg->borrowed = (pn_bytes_t){0, NULL};
+}
+
+// Like pni_switch_to_data() but leaves borrowed bytes alone
+static void pni_message_switch_to_data(pn_message_t *msg, pn_bytes_t *raw, pn_data_t **data, size_t max_nodes)
+{
+  if (pni_message_borrows(msg, *raw)) {
+    pni_decode_to_data(*raw, data, max_nodes);
+    *raw = (pn_bytes_t){0, NULL};
+  } else {
+    pni_switch_to_data(raw, data, max_nodes);
+  }
+}
+
 void pni_msgid_clear(pn_atom_t* msgid) {
   switch (msgid->type) {
     case PN_BINARY:
@@ -156,10 +195,10 @@ void pn_message_finalize(void *obj)
   pn_free(msg->reply_to_group_id);
   pni_msgid_clear(&msg->id);
   pni_msgid_clear(&msg->correlation_id);
-  pn_bytes_free(msg->instructions_raw);
-  pn_bytes_free(msg->annotations_raw);
-  pn_bytes_free(msg->properties_raw);
-  pn_bytes_free(msg->body_raw);
+  pni_message_free_raw(msg, &msg->instructions_raw);
+  pni_message_free_raw(msg, &msg->annotations_raw);
+  pni_message_free_raw(msg, &msg->properties_raw);
+  pni_message_free_raw(msg, &msg->body_raw);
   pn_data_free(msg->id_deprecated);
   pn_data_free(msg->correlation_id_deprecated);
   pn_data_free(msg->instructions_deprecated);
@@ -359,6 +398,7 @@ static pn_message_t *pni_message_new(size_t size)
   msg->annotations_raw = (pn_bytes_t){0, 0};
   msg->properties_raw = (pn_bytes_t){0, 0};
   msg->body_raw = (pn_bytes_t){0, 0};
+  msg->borrowed = (pn_bytes_t){0, 0};
 
   msg->inferred = false;
   msg->id_deprecated = NULL;
@@ -416,14 +456,11 @@ void pn_message_clear(pn_message_t *msg)
   msg->group_sequence = 0;
   pn_string_clear(msg->reply_to_group_id);
   msg->inferred = false;
-  pn_bytes_free(msg->annotations_raw);
-  pn_bytes_free(msg->instructions_raw);
-  pn_bytes_free(msg->properties_raw);
-  pn_bytes_free(msg->body_raw);
-  msg->instructions_raw = (pn_bytes_t){0, NULL};
-  msg->annotations_raw = (pn_bytes_t){0, NULL};
-  msg->properties_raw = (pn_bytes_t){0, NULL};
-  msg->body_raw = (pn_bytes_t){0, NULL};
+  pni_message_free_raw(msg, &msg->annotations_raw);
+  pni_message_free_raw(msg, &msg->instructions_raw);
+  pni_message_free_raw(msg, &msg->properties_raw);
+  pni_message_free_raw(msg, &msg->body_raw);
+  msg->borrowed = (pn_bytes_t){0, NULL};
   pn_data_clear(msg->id_deprecated);
   pn_data_clear(msg->correlation_id_deprecated);
   pn_data_clear(msg->instructions_deprecated);
@@ -728,7 +765,7 @@ int pn_message_set_reply_to_group_id(pn_message_t *msg, const char *reply_to_gro
   return pn_string_set(msg->reply_to_group_id, reply_to_group_id);
 }
 
-int pn_message_decode(pn_message_t *msg, const char *bytes, size_t size)
+static int pni_message_decode(pn_message_t *msg, const char *bytes, size_t size, bool borrow)
 {
   assert(msg);
 
@@ -830,34 +867,67 @@ int pn_message_decode(pn_message_t *msg, const char *bytes, size_t size)
     }
     msg_bytes = (pn_bytes_t){.size=msg_bytes.size-section_size, .start=msg_bytes.start+section_size};
   }
-  pn_bytes_free(msg->instructions_raw);
-  msg->instructions_raw = pn_bytes_dup(instructions_bytes);
-  pn_bytes_free(msg->annotations_raw);
-  msg->annotations_raw = pn_bytes_dup(annotations_bytes);
-  pn_bytes_free(msg->properties_raw);
-  msg->properties_raw = pn_bytes_dup(properties_bytes);
-  pn_bytes_free(msg->body_raw);
-  msg->body_raw = pn_bytes_dup(body_bytes);
+  pni_message_free_raw(msg, &msg->instructions_raw);
+  pni_message_free_raw(msg, &msg->annotations_raw);
+  pni_message_free_raw(msg, &msg->properties_raw);
+  pni_message_free_raw(msg, &msg->body_raw);
+  if (borrow) {
+    msg->borrowed = (pn_bytes_t){.size=size, .start=bytes};
+    msg->instructions_raw = instructions_bytes;
+    msg->annotations_raw = annotations_bytes;
+    msg->properties_raw = properties_bytes;
+    msg->body_raw = body_bytes;
+  } else {
+    msg->borrowed = (pn_bytes_t){0, NULL};
+    msg->instructions_raw = pn_bytes_dup(instructions_bytes);
+    msg->annotations_raw = pn_bytes_dup(annotations_bytes);
+    msg->properties_raw = pn_bytes_dup(properties_bytes);
+    msg->body_raw = pn_bytes_dup(body_bytes);
+  }
   return 0;
 }
 
-int pn_message_encode(pn_message_t *msg, char *bytes, size_t *isize)
+int pn_message_decode(pn_message_t *msg, const char *bytes, size_t size)
 {
-  pn_rwbytes_t scratch = (pn_rwbytes_t){.size=*isize, .start=bytes};
-  if (!pni_switch_to_raw_bytes(scratch, &msg->instructions_deprecated, &msg->instructions_raw)) {
-    return PN_OVERFLOW;
-  }
-  if (!pni_switch_to_raw_bytes(scratch, &msg->annotations_deprecated, &msg->annotations_raw)) {
-    return PN_OVERFLOW;
-  }
-  if (!pni_switch_to_raw_bytes(scratch, &msg->properties_deprecated, &msg->properties_raw)) {
-    return PN_OVERFLOW;
-  }
-  if (!pni_switch_to_raw_bytes(scratch, &msg->body_deprecated, &msg->body_raw)) {
-    return PN_OVERFLOW;
+  return pni_message_decode(msg, bytes, size, false);
+}
+
+int pn_message_decode_borrowed(pn_message_t *msg, const char *bytes, size_t size)
+{
+  return pni_message_decode(msg, bytes, size, true);
+}
+
+// Move any sections held as pn_data_t into their raw encoded form
+static int pni_message_switch_to_raw(pn_message_t *msg)
+{
+  int err = pni_switch_to_raw_bytes(&msg->instructions_deprecated, &msg->instructions_raw);
+  if (err) return pn_error_format(msg->error, err, "error encoding delivery annotations");
+  err = pni_switch_to_raw_bytes(&msg->annotations_deprecated, &msg->annotations_raw);
+  if (err) return pn_error_format(msg->error, err, "error encoding message annotations");
+  err = pni_switch_to_raw_bytes(&msg->properties_deprecated, &msg->properties_raw);
+  if (err) return pn_error_format(msg->error, err, "error encoding application properties");
+  err = pni_switch_to_raw_bytes(&msg->body_deprecated, &msg->body_raw);
+  if (err) return pn_error_format(msg->error, err, "error encoding body");
+  return 0;
+}
+
+static inline void pni_message_encode_advance(char **bytes, size_t *remaining, size_t size)
+{
+  if (size > *remaining) {
+    // Out of space, so only measure from here on
+    *remaining = 0;
+    return;
   }
+  *bytes += size;
+  *remaining -= size;
+}
 
-  size_t remaining = *isize;
+// Encode the raw sections of msg into as much of bytes as fits. The emitters
+// keep counting past the end of the space, so this always returns the full
+// encoded size: calling it with no space at all just measures the message.
+static size_t pni_message_encode_raw(pn_message_t *msg, char *bytes, size_t size)
+{
+  size_t remaining = size;
   size_t total = 0;
 
   /* "DL[?o?B?I?o?I]!" */
@@ -867,29 +937,19 @@ int pn_message_encode(pn_message_t *msg, char *bytes, size_t *isize)
                          (bool)msg->ttl, msg->ttl,
                          msg->first_acquirer, msg->first_acquirer,
                          (bool)msg->delivery_count, msg->delivery_count);
-  if (last_size > remaining) return PN_OVERFLOW;
-
-  remaining -= last_size;
-  bytes += last_size;
   total += last_size;
-
+  pni_message_encode_advance(&bytes, &remaining, last_size);
 
   if (msg->instructions_raw.size>0) {
     last_size = pn_amqp_encode_bytes_described_type_raw(bytes, remaining, AMQP_DESC_DELIVERY_ANNOTATIONS, msg->instructions_raw);
-    if (last_size > remaining) return PN_OVERFLOW;
-
-    remaining -= last_size;
-    bytes += last_size;
     total += last_size;
+    pni_message_encode_advance(&bytes, &remaining, last_size);
   }
 
   if (msg->annotations_raw.size>0) {
     last_size = pn_amqp_encode_bytes_described_type_raw(bytes, remaining, AMQP_DESC_MESSAGE_ANNOTATIONS, msg->annotations_raw);
-    if (last_size > remaining) return PN_OVERFLOW;
-
-    remaining -= last_size;
-    bytes += last_size;
     total += last_size;
+    pni_message_encode_advance(&bytes, &remaining, last_size);
   }
 
   /* "DL[azSSSass?t?tS?IS]!" */
@@ -914,19 +974,13 @@ int pn_message_encode(pn_message_t *msg, char *bytes, size_t *isize)
                       */
                      (bool)pn_string_get(msg->group_id) || (bool)msg->group_sequence , msg->group_sequence,
                      pn_string_bytes(msg->reply_to_group_id));
-  if (last_size > remaining) return PN_OVERFLOW;
-
-  remaining -= last_size;
-  bytes += last_size;
   total += last_size;
+  pni_message_encode_advance(&bytes, &remaining, last_size);
 
   if (msg->properties_raw.size>0) {
     last_size = pn_amqp_encode_bytes_described_type_raw(bytes, remaining, AMQP_DESC_APPLICATION_PROPERTIES, msg->properties_raw);
-    if (last_size > remaining) return PN_OVERFLOW;
-
-    remaining -= last_size;
-    bytes += last_size;
     total += last_size;
+    pni_message_encode_advance(&bytes, &remaining, last_size);
   }
 
   if (msg->body_raw.size>0) {
@@ -945,22 +999,32 @@ int pn_message_encode(pn_message_t *msg, char *bytes, size_t *isize)
       }
     }
     last_size = pn_amqp_encode_bytes_described_type_raw(bytes, remaining, descriptor, msg->body_raw);
-    if (last_size > remaining) return PN_OVERFLOW;
-
-    remaining -= last_size;
-    bytes += last_size;
     total += last_size;
   } else {
     // AMQP requires a body, so encode a null body if none present
     static const char null_byte = PNE_NULL;
     last_size = pn_amqp_encode_bytes_described_type_raw(bytes, remaining, AMQP_DESC_AMQP_VALUE, (pn_bytes_t){.size=1, .start=&null_byte});
-    if (last_size > remaining) return PN_OVERFLOW;
-
-    remaining -= last_size;
-    bytes += last_size;
     total += last_size;
   }
 
+  return total;
+}
+
+ssize_t pn_message_encoded_size(pn_message_t *msg)
+{
+  int err = pni_message_switch_to_raw(msg);
+  if (err) return err;
+  return pni_message_encode_raw(msg, NULL, 0);
+}
+
+int pn_message_encode(pn_message_t *msg, char *bytes, size_t *isize)
+{
+  int err = pni_message_switch_to_raw(msg);
+  if (err) return err;
+
+  size_t total = pni_message_encode_raw(msg, bytes, *isize);
+  if (total > *isize) return PN_OVERFLOW;
+
   *isize = total;
   return 0;
 }
@@ -1058,24 +1122,24 @@ int pn_message_data(pn_message_t *msg, pn_data_t *data)
 pn_data_t *pn_message_instructions(pn_message_t *msg)
 {
   if (!msg) return NULL;
-  pni_switch_to_data(&msg->instructions_raw, &msg->instructions_deprecated,
-                     PNI_DATA_DEFAULT_MAX_NODES);
+  pni_message_switch_to_data(msg, &msg->instructions_raw, &msg->instructions_deprecated,
+                             PNI_DATA_DEFAULT_MAX_NODES);
   return msg->instructions_deprecated;
 }
 
 pn_data_t *pn_message_annotations(pn_message_t *msg)
 {
   if (!msg) return NULL;
-  pni_switch_to_data(&msg->annotations_raw, &msg->annotations_deprecated,
-                     PNI_DATA_DEFAULT_MAX_NODES);
+  pni_message_switch_to_data(msg, &msg->annotations_raw, &msg->annotations_deprecated,
+                             PNI_DATA_DEFAULT_MAX_NODES);
   return msg->annotations_deprecated;
 }
 
 pn_data_t *pn_message_properties(pn_message_t *msg)
 {
   if (!msg) return NULL;
-  pni_switch_to_data(&msg->properties_raw, &msg->properties_deprecated,
-                     PNI_DATA_DEFAULT_MAX_NODES);
+  pni_message_switch_to_data(msg, &msg->properties_raw, &msg->properties_deprecated,
+                             PNI_DATA_DEFAULT_MAX_NODES);
   return msg->properties_deprecated;
 }
 
@@ -1084,29 +1148,41 @@ pn_data_t *pn_message_body(pn_message_t *msg)
   if (!msg) return NULL;
   /* No node limit - application body values could be complex,
      and the backing buffer is already limited*/
-  pni_switch_to_data(&msg->body_raw, &msg->body_deprecated,
-                     PNI_DATA_BODY_MAX_NODES);
+  pni_message_switch_to_data(msg, &msg->body_raw, &msg->body_deprecated,
+                             PNI_DATA_BODY_MAX_NODES);
   return msg->body_deprecated;
 }
 
-ssize_t pn_message_encode2(pn_message_t *msg, pn_rwbytes_t *buffer) {
-  static const size_t initial_size = 256;
-  int err = 0;
-  size_t size = 0;
-
-  if (buffer->start == NULL) {
-    buffer->start = (char*)malloc(initial_size);
-    buffer->size = initial_size;
+pn_bytes_t pn_message_get_body_bytes(pn_message_t *msg)
+{
+  assert(msg);
+  pni_consumer_t consumer = make_consumer_from_bytes(msg->body_raw);
+  pn_atom_t body;
+  if (!consume_atom(&consumer, &body) || consumer.position != consumer.size) {
+    return (pn_bytes_t){0, NULL};
+  }
+  switch (body.type) {
+    case PN_BINARY:
+    case PN_STRING:
+    case PN_SYMBOL:
+      return body.u.as_bytes;
+    default:
+      return (pn_bytes_t){0, NULL};
   }
-  if (buffer->start == NULL) return PN_OUT_OF_MEMORY;
-  size = buffer->size;
-  while ((err = pn_message_encode(msg, buffer->start, &size)) == PN_OVERFLOW) {
-    buffer->size *= 2;
-    buffer->start = (char*)realloc(buffer->start, buffer->size);
-    if (buffer->start == NULL) return PN_OUT_OF_MEMORY;
-    size = buffer->size;
+}
+
+ssize_t pn_message_encode2(pn_message_t *msg, pn_rwbytes_t *buffer) {
+  ssize_t size = pn_message_encoded_size(msg);
+  if (size < 0) return size;
+
+  if (buffer->start == NULL || buffer->size < (size_t)size) {
+    char *start = (char*)realloc(buffer->start, size);
+    if (start == NULL) return PN_OUT_OF_MEMORY;
+    buffer->start = start;
+    buffer->size = size;
   }
-  return err == 0 ? (ssize_t)size : err;
+  pni_message_encode_raw(msg, buffer->start, size);
+  return size;
 }
 
 ssize_t pn_message_send(pn_message_t *msg, pn_link_t *sender, pn_rwbytes_t *buffer) {
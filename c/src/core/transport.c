@@ -79,13 +79,17 @@ static void pni_calculate_channel_max(pn_transport_t *transport) {
 
 void pn_delivery_map_init(pn_delivery_map_t *db, pn_sequence_t next)
 {
-  db->deliveries = pn_hash(PN_WEAKREF, 0, 0.75);
+  db->ring = NULL;
+  db->sparse = NULL;
+  db->capacity = 0;
+  db->base = next;
   db->next = next;
 }
 
 void pn_delivery_map_free(pn_delivery_map_t *db)
 {
-  pn_free(db->deliveries);
+  pni_mem_subdeallocate(PN_VOID, db, db->ring);
+  pn_free(db->sparse);
 }
 
 static inline uintptr_t pni_sequence_make_hash ( pn_sequence_t i )
@@ -93,10 +97,56 @@ static inline uintptr_t pni_sequence_make_hash ( pn_sequence_t i )
   return i & 0x00000000FFFFFFFFUL;
 }
 
+static inline pn_delivery_t **pni_delivery_map_slot(pn_delivery_map_t *db, pn_sequence_t id)
+{
+  return &db->ring[id & (db->capacity-1)];
+}
+
+// Is id in [base, next), ie in the ring window
+static inline bool pni_delivery_map_in_ring(pn_delivery_map_t *db, pn_sequence_t id)
+{
+  return (pn_sequence_t)(id - db->base) < (pn_sequence_t)(db->next - db->base);
+}
 
-static pn_delivery_t *pni_delivery_map_get(pn_delivery_map_t *db, pn_sequence_t id)
+// Skip settled slots at the front of the ring window
+static void pni_delivery_map_trim(pn_delivery_map_t *db)
 {
-  return (pn_delivery_t *) pn_hash_get(db->deliveries, pni_sequence_make_hash(id) );
+  while (db->base != db->next && !*pni_delivery_map_slot(db, db->base)) {
+    db->base++;
+  }
+}
+
+// Make room in the ring for one more id
+static void pni_delivery_map_reserve(pn_delivery_map_t *db)
+{
+  size_t used = (pn_sequence_t)(db->next - db->base);
+  if (used < db->capacity) return;
+
+  if (db->capacity < PN_DELIVERY_MAP_RING_MAX) {
+    size_t capacity = db->capacity ? 2*db->capacity : PN_DELIVERY_MAP_RING_MIN;
+    pn_delivery_t **ring = (pn_delivery_t **) pni_mem_suballocate(PN_VOID, db, capacity*sizeof(pn_delivery_t *));
+    if (ring) {
+      memset(ring, 0, capacity*sizeof(pn_delivery_t *));
+      for (pn_sequence_t id = db->base; id != db->next; ++id) {
+        ring[id & (capacity-1)] = *pni_delivery_map_slot(db, id);
+      }
+      pni_mem_subdeallocate(PN_VOID, db, db->ring);
+      db->ring = ring;
+      db->capacity = capacity;
+      return;
+    }
+    if (!db->capacity) return;
+  }
+
+  // Ring is as big as it gets: the oldest delivery is long lived, so move it aside
+  if (!db->sparse) {
+    db->sparse = pn_hash(PN_WEAKREF, 0, 0.75);
+  }
+  pn_delivery_t **slot = pni_delivery_map_slot(db, db->base);
+  pn_hash_put(db->sparse, pni_sequence_make_hash(db->base), *slot);
+  *slot = NULL;
+  db->base++;
+  pni_delivery_map_trim(db);
 }
 
 static void pn_delivery_state_init(pn_delivery_state_t *ds, pn_delivery_t *delivery, pn_sequence_t id)
@@ -110,8 +160,19 @@ static void pn_delivery_state_init(pn_delivery_state_t *ds, pn_delivery_t *deliv
 static pn_delivery_state_t *pni_delivery_map_push(pn_delivery_map_t *db, pn_delivery_t *delivery)
 {
   pn_delivery_state_t *ds = &delivery->state;
-  pn_delivery_state_init(ds, delivery, db->next++);
-  pn_hash_put(db->deliveries, pni_sequence_make_hash(ds->id), delivery);
+  pni_delivery_map_reserve(db);
+  pn_delivery_state_init(ds, delivery, db->next);
+  if (db->capacity) {
+    *pni_delivery_map_slot(db, db->next) = delivery;
+    db->next++;
+  } else {
+    // Couldn't allocate a ring at all
+    if (!db->sparse) {
+      db->sparse = pn_hash(PN_WEAKREF, 0, 0.75);
+    }
+    pn_hash_put(db->sparse, pni_sequence_make_hash(db->next), delivery);
+    db->base = ++db->next;
+  }
   return ds;
 }
 
@@ -121,20 +182,44 @@ void pn_delivery_map_del(pn_delivery_map_t *db, pn_delivery_t *delivery)
     delivery->state.init = false;
     delivery->state.sending = false;
     delivery->state.sent = false;
-    pn_hash_del(db->deliveries, pni_sequence_make_hash(delivery->state.id) );
+    pn_sequence_t id = delivery->state.id;
+    if (pni_delivery_map_in_ring(db, id)) {
+      pn_delivery_t **slot = pni_delivery_map_slot(db, id);
+      if (*slot == delivery) {
+        *slot = NULL;
+        if (id == db->base) pni_delivery_map_trim(db);
+        return;
+      }
+    }
+    if (db->sparse) {
+      pn_hash_del(db->sparse, pni_sequence_make_hash(id));
+    }
   }
 }
 
+// Start numbering from the first delivery-id received on the session
+static void pni_delivery_map_set_next(pn_delivery_map_t *db, pn_sequence_t next)
+{
+  assert(db->base == db->next);
+  db->base = next;
+  db->next = next;
+}
+
 static void pni_delivery_map_clear(pn_delivery_map_t *dm)
 {
-  pn_hash_t *hash = dm->deliveries;
-  for (pn_handle_t entry = pn_hash_head(hash);
-       entry;
-       entry = pn_hash_next(hash, entry))
-  {
-    pn_delivery_t *dlv = (pn_delivery_t *) pn_hash_value(hash, entry);
-    pn_delivery_map_del(dm, dlv);
+  for (pn_sequence_t id = dm->base; id != dm->next; ++id) {
+    pn_delivery_t *dlv = *pni_delivery_map_slot(dm, id);
+    if (dlv) pn_delivery_map_del(dm, dlv);
+  }
+  pn_hash_t *hash = dm->sparse;
+  if (hash) {
+    pn_handle_t entry;
+    while ((entry = pn_hash_head(hash))) {
+      pn_delivery_t *dlv = (pn_delivery_t *) pn_hash_value(hash, entry);
+      pn_delivery_map_del(dm, dlv);
+    }
   }
+  dm->base = 0;
   dm->next = 0;
 }
 
@@ -479,6 +564,18 @@ static void pn_transport_initialize(void *object)
   transport->input_pending = 0;
   transport->output_pending = 0;
 
+  transport->output_refs = NULL;
+  transport->output_refs_capacity = 0;
+  transport->output_refs_head = 0;
+  transport->output_refs_count = 0;
+  transport->output_refs_bytes = 0;
+  transport->output_refs_inline = 0;
+  transport->output_held = NULL;
+  transport->output_held_capacity = 0;
+  transport->output_held_count = 0;
+  transport->zerocopy_min = 0;
+  transport->output_segments = false;
+
   transport->done_processing = false;
 
   transport->posted_idle_timeout = false;
@@ -665,6 +762,17 @@ static void pn_transport_finalize(void *object)
   pni_mem_subdeallocate(pn_class(transport), transport, transport->output_buf);
   pn_rwbytes_free(transport->scratch_space);
   pn_free(transport->context);
+  for (size_t i = 0; i < transport->output_refs_count; ++i) {
+    size_t r = (transport->output_refs_head + i) % transport->output_refs_capacity;
+    pn_buffer_free(transport->output_refs[r].owner);
+    pni_send_completion_release(transport->output_refs[r].completion);
+  }
+  pni_mem_subdeallocate(pn_class(transport), transport, transport->output_refs);
+  for (size_t i = 0; i < transport->output_held_count; ++i) {
+    pn_buffer_free(transport->output_held[i].owner);
+    pni_send_completion_release(transport->output_held[i].completion);
+  }
+  pni_mem_subdeallocate(pn_class(transport), transport, transport->output_held);
   pn_buffer_free(transport->output_buffer);
   pni_logger_fini(&transport->logger);
 }
@@ -851,10 +959,61 @@ bool pni_disposition_batchable(pn_disposition_t *disposition)
   }
 }
 
+// The payload of an outgoing transfer: bytes from the delivery buffer then any
+// lent bytes. If the buffer has been handed over as owner or there are lent
+// bytes the payload is referenced by the output rather than copied.
+typedef struct {
+  pn_bytes_t bytes;
+  pn_buffer_t *owner;
+  pni_lent_bytes_t *lent;
+  size_t lent_count;
+  size_t size;  // total remaining
+} pni_transfer_payload_t;
+
+// Reference the next size bytes of payload from the output of a frame, last
+// if no more frames will reference it this time round
+static int pni_post_payload_refs(pn_transport_t *transport, pni_transfer_payload_t *payload, size_t size, bool last)
+{
+  while (size) {
+    int err;
+    size_t n;
+    if (payload->bytes.size) {
+      n = pn_min(size, payload->bytes.size);
+      pn_bytes_t piece = {.size=n, .start=payload->bytes.start};
+      payload->bytes.start += n;
+      payload->bytes.size -= n;
+      // The owner must outlive every frame referencing it, so give it to the last one
+      pn_buffer_t *owner = (!payload->bytes.size || (last && n == size)) ? payload->owner : NULL;
+      err = pni_transport_output_ref(transport, piece, owner, NULL);
+      if (!err && owner) payload->owner = NULL;
+    } else {
+      pni_lent_bytes_t *lent = payload->lent;
+      n = pn_min(size, lent->bytes.size);
+      pn_bytes_t piece = {.size=n, .start=lent->bytes.start};
+      lent->bytes.start += n;
+      lent->bytes.size -= n;
+      // The segment is finished with once its last piece is written
+      pni_send_completion_t *completion = NULL;
+      if (!lent->bytes.size) {
+        completion = lent->completion;
+        lent->completion = NULL;
+        payload->lent++;
+        payload->lent_count--;
+      }
+      err = pni_transport_output_ref(transport, piece, NULL, completion);
+      if (err) pni_send_completion_release(completion);
+    }
+    if (err) return err;
+    size -= n;
+    payload->size -= n;
+  }
+  return 0;
+}
+
 static int pni_post_amqp_transfer_frame(pn_transport_t *transport, uint16_t ch,
                                         uint32_t handle,
                                         pn_sequence_t id,
-                                        pn_bytes_t *full_payload,
+                                        pni_transfer_payload_t *full_payload,
                                         const pn_bytes_t tag,
                                         uint32_t message_format,
                                         bool settled,
@@ -867,6 +1026,7 @@ static int pni_post_amqp_transfer_frame(pn_transport_t *transport, uint16_t ch,
 {
   bool more_flag = more;
   unsigned framecount = 0;
+  bool refs = full_payload->owner || full_payload->lent_count;
 
   // create performative, assuming 'more' flag need not change
  compute_performatives:;
@@ -906,11 +1066,18 @@ static int pni_post_amqp_transfer_frame(pn_transport_t *transport, uint16_t ch,
         goto compute_performatives;
       }
     }
-    pn_bytes_t payload = {.size = available, .start = full_payload->start};
-    pn_framing_send_amqp_with_payload(transport, ch, performative, payload);
-
-    full_payload->start += available;
-    full_payload->size -= available;
+    if (refs) {
+      bool last = available == full_payload->size || framecount + 1 == frame_limit;
+      int err = pn_framing_begin_amqp_with_payload_refs(transport, ch, performative, available);
+      if (!err) err = pni_post_payload_refs(transport, full_payload, available, last);
+      if (err) return err;
+    } else {
+      pn_bytes_t payload = {.size = available, .start = full_payload->bytes.start};
+      pn_framing_send_amqp_with_payload(transport, ch, performative, payload);
+      full_payload->bytes.start += available;
+      full_payload->bytes.size -= available;
+      full_payload->size -= available;
+    }
     framecount++;
   } while (full_payload->size > 0 && framecount < frame_limit);
 
@@ -1405,7 +1572,7 @@ int pn_do_transfer(pn_transport_t *transport, uint8_t frame_type, uint16_t chann
       if (!id_present) {
         return pn_do_error(transport, "amqp:invalid-field", "delivery-id required on initial transfer of session");
       }
-      incoming->next = id;
+      pni_delivery_map_set_next(incoming, id);
       ssn->state.incoming_init = true;
       ssn->incoming_deliveries++;
     }
@@ -1656,6 +1823,16 @@ static int pni_do_delivery_disposition(pn_transport_t * transport, pn_delivery_t
 
   remote->settled = settled;
   delivery->updated = true;
+
+  // Coalesce remote settlement into one event for the link (consecutive
+  // identical events are dropped by the collector)
+  pn_link_t *link = delivery->link;
+  if (settled && link->coalesce_settled && !delivery->local.settled) {
+    pni_add_rsettled(delivery);
+    pn_collector_put_object(transport->connection->collector, link, PN_LINK_REMOTE_SETTLED);
+    return 0;
+  }
+
   pn_work_update(transport->connection, delivery);
 
   pn_collector_put_object(transport->connection->collector, delivery, PN_DELIVERY);
@@ -1690,27 +1867,37 @@ int pn_do_disposition(pn_transport_t *transport, uint8_t frame_type, uint16_t ch
     deliveries = &ssn->state.incoming;
   }
 
-  // Do some validation of received first and last values
-  // TODO: We should really also clamp the first value here, but we're not keeping track of the earliest
-  // unsettled delivery sequence no
+  // Do some validation of received first and last values: ids before the ring
+  // base can only be in the sparse hash, which is checked separately below
   last = sequence_lte(last, deliveries->next) ? last : deliveries->next;
 
-  // If there are fewer deliveries in the session than the range then look at every delivery in the session
-  // otherwise look at every delivery_id in the disposition performative
-  pn_hash_t *dh = deliveries->deliveries;
-  if (last-first+1 >= pn_hash_size(dh)) {
-    for (pn_handle_t entry = pn_hash_head(dh); entry!=0 ; entry = pn_hash_next(dh, entry)) {
-      pn_sequence_t key = pn_hash_key(dh, entry);
-      if (sequence_lte(first, key) && sequence_lte(key, last)) {
-        pn_delivery_t *delivery = (pn_delivery_t*) pn_hash_value(dh, entry);
-        pni_do_delivery_disposition(transport, delivery, settled, type_init, type, disp_data);
+  // Deliveries still in the ring are indexed directly by id
+  pn_sequence_t id = sequence_lte(deliveries->base, first) ? first : deliveries->base;
+  for (; id != deliveries->next && sequence_lte(id, last); ++id) {
+    pn_delivery_t *delivery = *pni_delivery_map_slot(deliveries, id);
+    if (delivery) {
+      pni_do_delivery_disposition(transport, delivery, settled, type_init, type, disp_data);
+    }
+  }
+
+  // Long lived deliveries moved out of the ring: if there are fewer of these
+  // than the range then look at each of them, otherwise look up every id in the range
+  pn_hash_t *dh = deliveries->sparse;
+  if (dh && pn_hash_size(dh) && sequence_lte(first, deliveries->base)) {
+    if (last-first+1 >= pn_hash_size(dh)) {
+      for (pn_handle_t entry = pn_hash_head(dh); entry!=0 ; entry = pn_hash_next(dh, entry)) {
+        pn_sequence_t key = pn_hash_key(dh, entry);
+        if (sequence_lte(first, key) && sequence_lte(key, last)) {
+          pn_delivery_t *delivery = (pn_delivery_t*) pn_hash_value(dh, entry);
+          pni_do_delivery_disposition(transport, delivery, settled, type_init, type, disp_data);
+        }
       }
-    }
-  } else {
-    for (pn_sequence_t id = first; sequence_lte(id, last); ++id) {
-      pn_delivery_t *delivery = pni_delivery_map_get(deliveries, id);
-      if (delivery) {
-        pni_do_delivery_disposition(transport, delivery, settled, type_init, type, disp_data);
+    } else {
+      for (pn_sequence_t id = first; sequence_lte(id, last) && id != deliveries->base; ++id) {
+        pn_delivery_t *delivery = (pn_delivery_t *) pn_hash_get(dh, pni_sequence_make_hash(id));
+        if (delivery) {
+          pni_do_delivery_disposition(transport, delivery, settled, type_init, type, disp_data);
+        }
       }
     }
   }
@@ -2249,18 +2436,43 @@ static int pni_process_tpwork_sender(pn_transport_t *transport, pn_delivery_t *d
   pn_link_state_t *link_state = &link->state;
   bool xfr_posted = false;
   if ((int16_t) ssn_state->local_channel >= 0 && (int32_t) link_state->local_handle >= 0) {
-    if (!state->sent && (delivery->done || pn_buffer_size(delivery->bytes) > 0) &&
+    if (!state->sent && (delivery->done || pn_buffer_size(delivery->bytes) > 0 || delivery->lent_count) &&
         ssn_state->remote_incoming_window > 0 && link_state->link_credit > 0) {
       if (!state->init) {
         state = pni_delivery_map_push(&ssn_state->outgoing, delivery);
       }
 
-      pn_bytes_t bytes = pn_buffer_bytes(delivery->bytes);
-      size_t full_size = bytes.size;
+      bool refs = delivery->done && pni_output_refs_allowed(transport);
+      pn_buffer_t *owner = NULL;
+      size_t buffered = pn_buffer_size(delivery->bytes);
+      if (refs && buffered && (buffered >= PN_OUTPUT_REF_MIN_SIZE || delivery->lent_count)) {
+        // Hand the payload over to the output instead of copying it into the frames
+        pn_buffer_t *empty = pni_buffer_inline(PN_DELIVERY_INLINE_PAYLOAD);
+        if (empty) {
+          owner = delivery->bytes;
+          delivery->bytes = empty;
+        } else {
+          refs = false;
+        }
+      }
+      if (!refs) {
+        // Lent bytes can only be referenced once the delivery is complete
+        int err = pni_delivery_copy_lent(delivery);
+        if (err) return err;
+      }
+      pni_transfer_payload_t payload = {
+        .bytes = owner ? pn_buffer_bytes(owner) : pn_buffer_bytes(delivery->bytes),
+        .owner = owner,
+        .lent = delivery->lent,
+        .lent_count = delivery->lent_count,
+      };
+      payload.size = payload.bytes.size + pni_delivery_lent_size(delivery);
+      size_t full_size = payload.size;
+      size_t full_bytes = payload.bytes.size;
       int count = pni_post_amqp_transfer_frame(transport,
                                                ssn_state->local_channel,
                                                link_state->local_handle,
-                                               state->id, &bytes, delivery->tag,
+                                               state->id, &payload, delivery->tag,
                                                0, // message-format
                                                delivery->local.settled,
                                                !delivery->done,
@@ -2270,16 +2482,30 @@ static int pni_process_tpwork_sender(pn_transport_t *transport, pn_delivery_t *d
                                                delivery->aborted,
                                                false /* Batchable */
       );
-      if (count < 0) return count;
+      if (count < 0) {
+        if (payload.owner) {
+          pn_buffer_free(delivery->bytes);
+          delivery->bytes = payload.owner;
+        }
+        return count;
+      }
       state->sending = true;
       xfr_posted = true;
       ssn_state->outgoing_transfer_count += count;
       ssn_state->remote_incoming_window -= count;
 
-      int sent = full_size - bytes.size;
-      pn_buffer_trim(delivery->bytes, sent, 0);
+      int sent = full_size - payload.size;
+      if (owner) {
+        // Out of window: the unsent remainder goes back to the delivery
+        pn_buffer_append(delivery->bytes, payload.bytes.start, payload.bytes.size);
+        pn_buffer_free(payload.owner);
+      } else {
+        pn_buffer_trim(delivery->bytes, full_bytes - payload.bytes.size, 0);
+      }
+      // Lent segments that were fully referenced now belong to the output
+      pni_delivery_drop_lent(delivery, delivery->lent_count - payload.lent_count);
       link->session->outgoing_bytes -= sent;
-      if (!pn_buffer_size(delivery->bytes) && delivery->done) {
+      if (!pn_buffer_size(delivery->bytes) && !delivery->lent_count && delivery->done) {
         state->sent = true;
         link_state->delivery_count++;
         link_state->link_credit--;
@@ -2664,7 +2890,7 @@ static int64_t pn_tick_amqp(pn_transport_t* transport, unsigned int layer, int64
       transport->last_bytes_output = transport->bytes_output;
     } else if (transport->keepalive_deadline <= now) {
       transport->keepalive_deadline = now + (pn_timestamp_t)(transport->remote_idle_timeout/2.0);
-      if (pn_buffer_size(transport->output_buffer) == 0) {    // no outbound data pending
+      if (pni_transport_output_buffered(transport) == 0) {    // no outbound data pending
         // so send empty frame (and account for it!)
         pn_bytes_t buf = pn_bytes(0,"");
         pn_framing_send_amqp(transport, 0, buf);
@@ -2696,7 +2922,8 @@ static ssize_t pn_output_write_amqp_header(pn_transport_t* transport, unsigned i
   return 8;
 }
 
-static ssize_t pn_output_write_amqp(pn_transport_t* transport, unsigned int layer, char* bytes, size_t available)
+// Generate AMQP frames for outstanding work, returns true at end of output
+static bool pni_output_amqp(pn_transport_t* transport)
 {
   if (transport->connection && !transport->done_processing) {
     int err = pni_process(transport);
@@ -2709,7 +2936,12 @@ static ssize_t pn_output_write_amqp(pn_transport_t* transport, unsigned int laye
   // write out any buffered data _before_ returning PN_EOS, else we
   // could truncate an outgoing Close frame containing a useful error
   // status
-  if (!pn_buffer_size(transport->output_buffer) && transport->close_sent) {
+  return !pni_transport_output_buffered(transport) && transport->close_sent;
+}
+
+static ssize_t pn_output_write_amqp(pn_transport_t* transport, unsigned int layer, char* bytes, size_t available)
+{
+  if (pni_output_amqp(transport)) {
     return PN_EOS;
   }
 
@@ -2984,6 +3216,32 @@ ssize_t pni_transport_grow_capacity(pn_transport_t *transport, size_t n) {
   return transport->input_size-transport->input_pending;
 }
 
+// Give back buffer space beyond n bytes that holds no pending data
+size_t pni_transport_shrink_buffers(pn_transport_t *transport, size_t n) {
+  size_t freed = 0;
+  n = pn_max(n, AMQP_MIN_MAX_FRAME_SIZE);
+  size_t size = pn_max(n, transport->input_pending);
+  if (size < transport->input_size) {
+    char *newbuf = (char *) pni_mem_subreallocate(pn_class(transport), transport, transport->input_buf, size);
+    if (newbuf) {
+      freed += transport->input_size - size;
+      transport->input_buf = newbuf;
+      transport->input_size = size;
+    }
+  }
+  size = pn_max(n, transport->output_pending);
+  if (size < transport->output_size) {
+    char *newbuf = (char *) pni_mem_subreallocate(pn_class(transport), transport, transport->output_buf, size);
+    if (newbuf) {
+      freed += transport->output_size - size;
+      transport->output_buf = newbuf;
+      transport->output_size = size;
+    }
+  }
+  freed += pni_buffer_shrink(transport->output_buffer, n);
+  return freed;
+}
+
 // input
 ssize_t pn_transport_capacity(pn_transport_t *transport)  /* <0 == done */
 {
@@ -3089,24 +3347,249 @@ ssize_t pn_transport_peek(pn_transport_t *transport, char *dst, size_t size)
   return size;
 }
 
+static void pni_output_buf_pop(pn_transport_t *transport, size_t size)
+{
+  assert( transport->output_pending >= size );
+  transport->output_pending -= size;
+  transport->bytes_output += size;
+  if (transport->output_pending) {
+    // TODO: This could be potentially inefficient if we often pop the output without emptying it
+    // TODO: as we rotate the buffer here if we have any bytes left to write.
+    memmove( transport->output_buf,  &transport->output_buf[size],
+             transport->output_pending );
+  }
+}
+
 void pn_transport_pop(pn_transport_t *transport, size_t size)
 {
   if (transport) {
-    assert( transport->output_pending >= size );
-    transport->output_pending -= size;
-    transport->bytes_output += size;
-    if (transport->output_pending) {
-      // TODO: This could be potentially inefficient if we often pop the output without emptying it
-      // TODO: as we rotate the buffer here if we have any bytes left to write.
-      memmove( transport->output_buf,  &transport->output_buf[size],
-               transport->output_pending );
-    } else {
+    pni_output_buf_pop(transport, size);
+    if (!transport->output_pending) {
       // If we emptied the output buffer then see if there's more output pending
       pn_transport_pending(transport);
     }
   }
 }
 
+// Segmented output
+//
+// Frames are still assembled in output_buffer but large delivery payloads are
+// referenced in place (see pn_framing_send_amqp_with_payload_ref) so the
+// output is a sequence of: output_buffer bytes, payload, output_buffer bytes...
+// Each reference records how many output_buffer bytes precede it.
+
+size_t pni_transport_output_buffered(pn_transport_t *transport)
+{
+  return pn_buffer_size(transport->output_buffer) + transport->output_refs_bytes;
+}
+
+bool pni_output_refs_allowed(pn_transport_t *transport)
+{
+  // Tracing wants to see the whole frame in one place
+  return transport->output_segments &&
+    !PN_SHOULD_LOG(&transport->logger, PN_SUBSYSTEM_AMQP, PN_LEVEL_FRAME) &&
+    !PN_SHOULD_LOG(&transport->logger, PN_SUBSYSTEM_IO, PN_LEVEL_RAW);
+}
+
+int pni_transport_output_ref(pn_transport_t *transport, pn_bytes_t bytes, pn_buffer_t *owner,
+                             pni_send_completion_t *completion)
+{
+  if (transport->output_refs_count == transport->output_refs_capacity) {
+    size_t old_capacity = transport->output_refs_capacity;
+    size_t capacity = old_capacity ? 2*old_capacity : 16;
+    pni_output_ref_t *refs = (pni_output_ref_t *)
+      pni_mem_subreallocate(pn_class(transport), transport, transport->output_refs, capacity*sizeof(pni_output_ref_t));
+    if (!refs) return PN_OUT_OF_MEMORY;
+    // Unwrap the ring into the new space
+    size_t wrapped = transport->output_refs_head + transport->output_refs_count;
+    if (wrapped > old_capacity) {
+      memmove(&refs[old_capacity], &refs[0], (wrapped - old_capacity)*sizeof(pni_output_ref_t));
+    }
+    transport->output_refs = refs;
+    transport->output_refs_capacity = capacity;
+  }
+  size_t i = (transport->output_refs_head + transport->output_refs_count) % transport->output_refs_capacity;
+  pni_output_ref_t *ref = &transport->output_refs[i];
+  ref->bytes = bytes;
+  ref->owner = owner;
+  ref->completion = completion;
+  ref->held = false;
+  ref->inline_before = pn_buffer_size(transport->output_buffer) - transport->output_refs_inline;
+  transport->output_refs_inline += ref->inline_before;
+  transport->output_refs_bytes += bytes.size;
+  transport->output_refs_count++;
+  return 0;
+}
+
+// Keep a written output_ref until its hold tag is released
+static bool pni_output_keep(pn_transport_t *transport, pni_output_ref_t *ref)
+{
+  if (transport->output_held_count == transport->output_held_capacity) {
+    size_t capacity = transport->output_held_capacity ? 2*transport->output_held_capacity : 16;
+    pni_output_held_t *held = (pni_output_held_t *)
+      pni_mem_subreallocate(pn_class(transport), transport, transport->output_held, capacity*sizeof(pni_output_held_t));
+    if (!held) return false;
+    transport->output_held = held;
+    transport->output_held_capacity = capacity;
+  }
+  pni_output_held_t *h = &transport->output_held[transport->output_held_count++];
+  h->owner = ref->owner;
+  h->completion = ref->completion;
+  h->tag = ref->hold_tag;
+  return true;
+}
+
+static void pni_output_buffer_consume(pn_transport_t *transport, char *dst, size_t size)
+{
+  if (dst) pn_buffer_get(transport->output_buffer, 0, size, dst);
+  pn_buffer_trim(transport->output_buffer, size, 0);
+}
+
+// Remove up to size bytes from the front of the output, copying them to dst
+// unless it is NULL. Returns the number of bytes removed.
+size_t pni_transport_output_consume(pn_transport_t *transport, char *dst, size_t size)
+{
+  size_t done = 0;
+  while (transport->output_refs_count) {
+    pni_output_ref_t *ref = &transport->output_refs[transport->output_refs_head];
+    if (ref->inline_before) {
+      if (done == size) break;
+      size_t n = pn_min(size - done, ref->inline_before);
+      pni_output_buffer_consume(transport, dst ? dst + done : NULL, n);
+      ref->inline_before -= n;
+      transport->output_refs_inline -= n;
+      done += n;
+      continue;
+    }
+    size_t n = pn_min(size - done, ref->bytes.size);
+    if (dst) memcpy(dst + done, ref->bytes.start, n);
+    ref->bytes.start += n;
+    ref->bytes.size -= n;
+    transport->output_refs_bytes -= n;
+    done += n;
+    if (ref->bytes.size) break;
+    // Payload released by a ref may back earlier pieces that are still held
+    if (!ref->held && transport->output_held_count && (ref->owner || ref->completion)) {
+      ref->hold_tag = transport->output_held[transport->output_held_count-1].tag;
+      ref->held = true;
+    }
+    if (!ref->held || !pni_output_keep(transport, ref)) {
+      pn_buffer_free(ref->owner);
+      pni_send_completion_release(ref->completion);
+    }
+    transport->output_refs_head = (transport->output_refs_head + 1) % transport->output_refs_capacity;
+    transport->output_refs_count--;
+  }
+  if (!transport->output_refs_count) {
+    size_t n = pn_min(size - done, pn_buffer_size(transport->output_buffer));
+    pni_output_buffer_consume(transport, dst ? dst + done : NULL, n);
+    done += n;
+  }
+  return done;
+}
+
+static size_t pni_output_add_slices(pn_transport_t *transport, size_t offset, size_t size,
+                                    pn_bytes_t *segs, size_t count, size_t n)
+{
+  pn_bytes_t slices[2];
+  size_t k = pn_buffer_slices(transport->output_buffer, offset, size, slices);
+  for (size_t i = 0; i < k && count < n; ++i) {
+    segs[count++] = slices[i];
+  }
+  return count;
+}
+
+// Like pn_transport_pending() but describe the output as up to n segments
+// rather than copying it into one contiguous buffer. Returns the number of
+// segments, 0 if there is nothing to write or PN_EOS.
+ssize_t pni_transport_pending_segments(pn_transport_t *transport, pn_bytes_t *segs, size_t n)
+{
+  transport->output_segments = true;
+  if (transport->head_closed) return PN_EOS;
+
+  if (transport->io_layers[0]->process_output != pn_output_write_amqp) {
+    // Other layers transform the output so it can only be produced contiguously
+    ssize_t pending = transport_produce(transport);
+    if (pending <= 0) return pending;
+    if (!n) return 0;
+    segs[0] = pn_bytes(pending, transport->output_buf);
+    return 1;
+  }
+
+  size_t count = 0;
+  if (transport->output_pending && count < n) {
+    segs[count++] = pn_bytes(transport->output_pending, transport->output_buf);
+  }
+  if (pni_output_amqp(transport) && !transport->output_pending) {
+    PN_LOG(&transport->logger, PN_SUBSYSTEM_AMQP | PN_SUBSYSTEM_IO, PN_LEVEL_FRAME | PN_LEVEL_RAW, "  -> EOS");
+    pni_close_head(transport);
+    return PN_EOS;
+  }
+
+  size_t offset = 0;
+  for (size_t i = 0; i < transport->output_refs_count && count < n; ++i) {
+    pni_output_ref_t *ref = &transport->output_refs[(transport->output_refs_head + i) % transport->output_refs_capacity];
+    count = pni_output_add_slices(transport, offset, ref->inline_before, segs, count, n);
+    offset += ref->inline_before;
+    if (ref->bytes.size && count < n) {
+      segs[count++] = ref->bytes;
+    }
+  }
+  if (count < n) {
+    count = pni_output_add_slices(transport, offset, pn_buffer_size(transport->output_buffer) - offset, segs, count, n);
+  }
+  return count;
+}
+
+// Like pn_transport_pop() for output taken with pni_transport_pending_segments()
+void pni_transport_pop_segments(pn_transport_t *transport, size_t size)
+{
+  size_t n = pn_min(size, transport->output_pending);
+  pni_output_buf_pop(transport, n);
+  if (size > n) {
+    size_t m = pni_transport_output_consume(transport, NULL, size - n);
+    assert(m == size - n);
+    transport->bytes_output += m;
+  }
+}
+
+// Hold the output_ref containing start, see pn_connection_driver_write_hold()
+bool pni_transport_output_hold(pn_transport_t *transport, const char *start, uint32_t tag)
+{
+  for (size_t i = 0; i < transport->output_refs_count; ++i) {
+    pni_output_ref_t *ref = &transport->output_refs[(transport->output_refs_head + i) % transport->output_refs_capacity];
+    if (start >= ref->bytes.start && start < ref->bytes.start + ref->bytes.size) {
+      ref->hold_tag = tag;
+      ref->held = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Release held output with tags up to and including tag
+void pni_transport_output_release(pn_transport_t *transport, uint32_t tag)
+{
+  size_t n = 0;
+  while (n < transport->output_held_count && (int32_t)(transport->output_held[n].tag - tag) <= 0) {
+    pn_buffer_free(transport->output_held[n].owner);
+    pni_send_completion_release(transport->output_held[n].completion);
+    ++n;
+  }
+  transport->output_held_count -= n;
+  memmove(transport->output_held, transport->output_held + n, transport->output_held_count*sizeof(pni_output_held_t));
+}
+
+void pn_transport_set_zerocopy(pn_transport_t *transport, size_t min_size)
+{
+  transport->zerocopy_min = min_size;
+}
+
+size_t pn_transport_get_zerocopy(pn_transport_t *transport)
+{
+  return transport->zerocopy_min;
+}
+
 int pn_transport_close_head(pn_transport_t *transport)
 {
   ssize_t pending = pn_transport_pending(transport);
@@ -66,19 +66,25 @@ static inline void pn_bytes_free(pn_bytes_t in) {
   free((void*)in.start);
 }
 
-static inline void pni_switch_to_data(pn_bytes_t *bytes, pn_data_t **data,
-                                       size_t max_nodes) {
+static inline void pni_decode_to_data(pn_bytes_t bytes, pn_data_t **data,
+                                      size_t max_nodes) {
   if (*data == NULL) {
     *data = pn_data(0);
   }
-  if (bytes->start) {
+  if (bytes.start) {
     pn_data_clear(*data);
-    /* Intern buffer capped at bytes->size: the interned bytes must come from
+    /* Intern buffer capped at bytes.size: the interned bytes must come from
        the input bytes so tight 1:1 bound without an artificial ceiling. */
-    pn_data_set_decode_limits(*data, max_nodes, bytes->size);
-    pn_data_decode(*data, bytes->start, bytes->size);
+    pn_data_set_decode_limits(*data, max_nodes, bytes.size);
+    pn_data_decode(*data, bytes.start, bytes.size);
     pn_data_rewind(*data);
+  }
+}
 
+static inline void pni_switch_to_data(pn_bytes_t *bytes, pn_data_t **data,
+                                       size_t max_nodes) {
+  pni_decode_to_data(*bytes, data, max_nodes);
+  if (bytes->start) {
     pn_bytes_free(*bytes);
     *bytes = (pn_bytes_t){0, NULL};
   }
@@ -101,18 +107,52 @@ static inline void pn_rwbytes_free(pn_rwbytes_t in) {
   free((void*)in.start);
 }
 
-static inline bool pni_switch_to_raw_bytes(pn_rwbytes_t scratch, pn_data_t **data, pn_bytes_t *bytes)
+// The encoder writes each open list or map with a 32 bit header and only
+// shrinks it once closed, so it transiently needs up to 6 bytes per level of
+// nesting beyond the final encoded size.
+#define PNI_ENCODE_HEADROOM (64)
+
+// Encode data into a new raw copy sized from pn_data_encoded_size()
+static inline int pni_data_encode_raw(pn_data_t *data, pn_bytes_t *bytes)
 {
-  if (pn_data_size(*data)) {
-    pn_data_rewind(*data);
-    ssize_t size = pn_data_encode(*data, scratch.start, scratch.size);
-    if (size == PN_OVERFLOW) return false;
+  pn_data_rewind(data);
+  ssize_t size = pn_data_encoded_size(data);
+  if (size < 0) return size;
+  size_t capacity = size + PNI_ENCODE_HEADROOM;
+  char *raw = (char *) malloc(capacity);
+  if (!raw) return PN_OUT_OF_MEMORY;
+  pn_data_rewind(data);
+  while ((size = pn_data_encode(data, raw, capacity)) == PN_OVERFLOW) {
+    // Only very deeply nested data gets here
+    capacity *= 2;
+    char *more = (char *) realloc(raw, capacity);
+    if (!more) {
+      size = PN_OUT_OF_MEMORY;
+      break;
+    }
+    raw = more;
+    pn_data_rewind(data);
+  }
+  if (size < 0) {
+    free(raw);
+    return size;
+  }
+  *bytes = (pn_bytes_t){.size=size, .start=raw};
+  return 0;
+}
 
+// Encode data into a raw copy sized from pn_data_encoded_size(), leaving data empty
+static inline int pni_switch_to_raw_bytes(pn_data_t **data, pn_bytes_t *bytes)
+{
+  if (pn_data_size(*data)) {
+    pn_bytes_t raw;
+    int err = pni_data_encode_raw(*data, &raw);
+    if (err) return err;
     pn_bytes_free(*bytes);
-    *bytes = pn_bytes_dup((pn_bytes_t){.size=size, .start=scratch.start});
+    *bytes = raw;
     pn_data_clear(*data);
   }
-  return true;
+  return 0;
 }
 
 static inline void pni_switch_to_raw(pn_rwbytes_t *scratch, pn_data_t **data, pn_bytes_t *bytes) {
@@ -39,10 +39,12 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 
 #include <proton/connection_driver.h>
 #include <proton/proactor.h>
+#include <proton/proactor_ext.h>
 
 #include "netaddr-internal.h"
 #include "proactor-internal.h"
@@ -55,6 +57,8 @@ typedef struct acceptor_t acceptor_t;
 typedef struct tslot_t tslot_t;
 typedef pthread_mutex_t pmutex;
 typedef struct pni_timer_t pni_timer_t;
+typedef struct pni_uring_t pni_uring_t;
+typedef struct pni_ptls_t pni_ptls_t;
 
 typedef enum {
   EVENT_FD,   /* schedule() or pn_proactor_interrupt() */
@@ -71,6 +75,7 @@ typedef struct epoll_extended_t {
   epoll_type_t type;   // io/timer/eventfd
   uint32_t wanted;     // events to poll for
   bool polling;
+  uint32_t uring_slot; // io_uring poller only: 1 + index of the poll request, 0 if none
   pmutex barrier_mutex;
 } epoll_extended_t;
 
@@ -90,8 +95,8 @@ typedef struct task_t {
   bool working;
   bool ready;                // ready to run and on ready list.  Poller notified by eventfd.
   bool waking;
-  unsigned int ready_generation;
-  struct task_t *ready_next; // ready list, guarded by proactor eventfd_mutex
+  unsigned int ready_generation; // atomic access
+  struct task_t *ready_next; // ready list, pushed by schedule(), taken by the poller
   struct task_t *resched_next; // resched list, guarded by sched mutex
   bool closing;
   // Next 4 are protected by the proactor mutex
@@ -134,12 +139,25 @@ struct tslot_t {
   unsigned int earmark_override_gen;
 };
 
+// Connection timers are kept on a hierarchical timing wheel of millisecond ticks, see epoll_timer.c
+#define PNI_TIMER_WHEEL_BITS 6
+#define PNI_TIMER_WHEEL_SLOTS (1 << PNI_TIMER_WHEEL_BITS)
+#define PNI_TIMER_WHEEL_LEVELS 4
+
+typedef struct pni_timer_link_t {
+  struct pni_timer_link_t *next;
+  struct pni_timer_link_t *prev;
+} pni_timer_link_t;
+
 typedef struct pni_timer_manager_t {
   task_t task;
   epoll_extended_t epoll_timer;
   pmutex deletion_mutex;
   pni_timer_t *proactor_timer;
-  pn_list_t *timers_heap;
+  pni_timer_link_t wheel[PNI_TIMER_WHEEL_LEVELS][PNI_TIMER_WHEEL_SLOTS];
+  uint64_t wheel_occupied[PNI_TIMER_WHEEL_LEVELS];  // bitmaps of non-empty slots
+  uint64_t wheel_time;       // tick the wheel has been advanced to
+  pni_timer_link_t due;      // expired connection timers not yet handed to their connections
   uint64_t timerfd_deadline;
   bool sched_timeout;
 } pni_timer_manager_t;
@@ -171,12 +189,8 @@ struct pn_proactor_t {
 
   // ready list subsystem
   int eventfd;
-  pmutex eventfd_mutex;
-  bool ready_list_active;
-  task_t *ready_list_first;
-  task_t *ready_list_last;
-  unsigned int ready_list_count;
-  unsigned int ready_list_generation; // protected by both eventfd_mutex and a single p->poller instance
+  task_t *ready_list_head;            // lock-free LIFO, see schedule().  Atomic access.
+  unsigned int ready_list_generation; // protected by a single p->poller instance
   // Interrupts have a dedicated eventfd because they must be async-signal safe.
   int interruptfd;
   // If the process runs out of file descriptors, disarm listening sockets temporarily and save them here.
@@ -198,6 +212,8 @@ struct pn_proactor_t {
   int suspend_list_count;
   tslot_t *poller;
   bool poller_suspended;
+  unsigned int poll_generation;   // incremented before each poller wait
+  unsigned int posted_generation; // poll_generation of the last wait whose events are posted
   tslot_t *last_earmark;
   task_t *sched_ready_first;
   task_t *sched_ready_last;
@@ -222,7 +238,30 @@ struct pn_proactor_t {
   tslot_t **resume_list;
   pn_hash_t *tslot_map;
   struct epoll_event *kevents;
-  int epollfd;
+  int epollfd;           // epoll fd, or the io_uring fd if uring is set
+  pni_uring_t *uring;    // io_uring poller, NULL when polling with epoll
+  bool edge_triggered;   // connected sockets stay armed with EPOLLET instead of EPOLLONESHOT
+  unsigned busy_poll_usec;          // see pn_proactor_set_busy_poll().  Atomic access, no lock.
+  unsigned socket_busy_poll_usec;   // see pn_proactor_set_socket_busy_poll().  Atomic access, no lock.
+  // Connection batch limits, see pn_proactor_set_sched_limit().  Atomic access, no lock.
+#define PNI_SCHED_LIMITS (PN_SCHED_TIME + 1)
+  uint64_t sched_limit[PNI_SCHED_LIMITS];
+  uint64_t sched_limit_hits[PNI_SCHED_LIMITS];
+  // Crypto offload pool, see pn_proactor_set_crypto_offload()
+  pmutex offload_mutex;
+  pthread_cond_t offload_cond;
+  pthread_t *offload_threads;
+  unsigned offload_thread_count;
+  struct pconnection_t *offload_first;  // connections waiting for the pool, protected by offload_mutex
+  struct pconnection_t *offload_last;
+  bool offload_stopping;
+  bool offload_enabled;        // Atomic access, no lock.
+  size_t offload_threshold;    // Atomic access, no lock.
+  uint64_t offloads;           // Atomic access, no lock.
+  // Wire buffers of pn_tls connections, see pn_transport_set_tls()
+  pmutex tls_pool_mutex;
+  void *tls_pool;              // idle buffers, protected by tls_pool_mutex
+  size_t tls_pool_count;
   int thread_count;
   int thread_capacity;
   int runnables_capacity;
@@ -236,6 +275,9 @@ typedef struct psocket_t {
   epoll_extended_t epoll_io;
   uint32_t sched_io_events;
   uint32_t working_io_events;
+  // Edge triggered sockets only: deregistered, waiting for the poller to catch up
+  bool unpolling;
+  unsigned int unpoll_generation;
 } psocket_t;
 
 typedef struct pconnection_t {
@@ -256,12 +298,28 @@ typedef struct pconnection_t {
   bool write_blocked;
   bool disconnected;
   int hog_count; // thread hogging limiter
+  unsigned sched_weight;       /* see pn_connection_set_sched_weight(), changed with task lock */
+  unsigned batch_weight;       /* sched_weight for the current batch */
+  size_t batch_events;
+  size_t batch_bytes;
+  size_t read_recent;          /* decaying high water mark of bytes read per batch */
+  int64_t batch_start;         /* only kept with a PN_SCHED_TIME limit */
+  bool batch_spent;            /* a limit ended the current batch */
   pn_event_batch_t batch;
   pn_connection_driver_t driver;
   bool output_drained;
-  const char *wbuf_current;
+  // Transport output segments being written, see pn_connection_driver_write_buffers()
+#define PCONNECTION_WBUF_MAX 64
+  struct iovec wbuf[PCONNECTION_WBUF_MAX];
+  size_t wbuf_first;
+  size_t wbuf_count;
   size_t wbuf_remaining;
   size_t wbuf_completed;
+  // MSG_ZEROCOPY sends, see pn_transport_set_zerocopy()
+  size_t zerocopy_min;               /* 0 until SO_ZEROCOPY is set on the socket */
+  uint32_t zerocopy_next;            /* Kernel's id for the next zero-copy send */
+  bool zerocopy_failed;              /* SO_ZEROCOPY not supported */
+  bool zerocopy_pending;             /* Completions to collect from the socket error queue */
   pn_event_type_t current_event_type;/* Sole use for debugging, i.e. crash analysis of optimized code. */
   uint32_t process_args;             /* Sole use for debugging */
   uint32_t process_events;           /* Sole use for debugging */
@@ -272,6 +330,11 @@ typedef struct pconnection_t {
   bool io_doublecheck;               /* callbacks made and new IO may have arrived */
   uint64_t expected_timeout;
   bool name_lookup_pending;
+  // Crypto offload: the pool owns the transport, task.working stays set meanwhile
+  bool offloading;                   /* protected by task.mutex */
+  size_t offload_bytes;              /* read but not yet given to the transport */
+  struct pconnection_t *offload_next;
+  pni_ptls_t *tls;                   /* pn_tls session, NULL unless pn_transport_set_tls() */
   char addr_buf[1];
 } pconnection_t;
 
@@ -314,6 +377,7 @@ struct pn_listener_t {
   size_t pending_count;              /* number of pending accepted connections */
   size_t backlog;                 /* size of pending accepted array */
   bool close_dispatched;
+  bool reuse_port;                /* SO_REUSEPORT: share the address with other listeners */
   int overflow_count;
   uint32_t sched_io_events;
 };
@@ -383,9 +447,31 @@ void notify_poller(pn_proactor_t *p);
 void schedule_done(task_t *tsk);
 
 void psocket_init(psocket_t* ps, epoll_type_t type);
-bool start_polling(epoll_extended_t *ee, int epollfd);
-void stop_polling(epoll_extended_t *ee, int epollfd);
-void rearm_polling(epoll_extended_t *ee, int epollfd);
+bool start_polling(epoll_extended_t *ee, pn_proactor_t *p);
+void stop_polling(epoll_extended_t *ee, pn_proactor_t *p);
+void rearm_polling(epoll_extended_t *ee, pn_proactor_t *p);
+bool psocket_edge_unpolled(psocket_t *ps, pn_proactor_t *p);
+
+// Optional io_uring poller (epoll_uring.c), built with ENABLE_IO_URING.
+// pni_uring() returns NULL if the running kernel cannot support it.
+struct epoll_event;
+pni_uring_t *pni_uring(unsigned entries);
+void pni_uring_free(pni_uring_t *u);
+int pni_uring_fd(pni_uring_t *u);
+bool pni_uring_start_polling(pni_uring_t *u, epoll_extended_t *ee);
+void pni_uring_stop_polling(pni_uring_t *u, epoll_extended_t *ee);
+void pni_uring_rearm_polling(pni_uring_t *u, epoll_extended_t *ee);
+int pni_uring_wait(pni_uring_t *u, struct epoll_event *events, int maxevents, bool block);
+
+// Optional pn_tls connections (epoll_tls.c), built with BUILD_TLS.
+struct pn_tls_config_t;
+pni_ptls_t *pni_ptls(pn_proactor_t *p, struct pn_tls_config_t *config, const char *peer_hostname);
+void pni_ptls_free(pni_ptls_t *pt);
+ssize_t pni_ptls_recv(pni_ptls_t *pt, pn_connection_driver_t *driver, int fd, char *buf, size_t size);
+size_t pni_ptls_encrypt(pni_ptls_t *pt, pn_connection_driver_t *driver, struct iovec *iov, size_t max);
+bool pni_ptls_write_closed(pni_ptls_t *pt);
+void pni_ptls_abandon(pni_ptls_t *pt);
+void pni_ptls_pool_free(pn_proactor_t *p);
 
 void configure_socket(int sock);
 
@@ -408,7 +494,7 @@ bool pni_timer_set(pni_timer_t *timer, uint64_t deadline);
 bool pni_timer_manager_init(pni_timer_manager_t *tm);
 void pni_timer_manager_finalize(pni_timer_manager_t *tm);
 pn_event_batch_t *pni_timer_manager_process(pni_timer_manager_t *tm, bool timeout, bool sched_ready);
-void pni_pconnection_timeout(pconnection_t *pc);
+bool pni_pconnection_timeout(pconnection_t *pc, uint64_t now);
 void pni_proactor_timeout(pn_proactor_t *p);
 void pni_resume(pn_proactor_t *p, tslot_t *ts);
 
@@ -67,6 +67,7 @@
 #include "proactor-internal.h"
 #include "core/engine-internal.h"
 #include "core/logger_private.h"
+#include "core/object_private.h"
 #include "core/util.h"
 
 #include <proton/condition.h>
@@ -77,6 +78,7 @@
 #include <proton/proactor.h>
 #include <proton/proactor_ext.h>
 #include <proton/raw_connection.h>
+#include <proton/ssl.h>
 #include <proton/transport.h>
 
 #include <assert.h>
@@ -93,7 +95,12 @@
 #include <netdb.h>
 #include <fcntl.h>
 #include <netinet/tcp.h>
+#ifndef SO_REUSEPORT
+#include <asm/socket.h>     /* SO_REUSEPORT is not POSIX */
+#endif
 #include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
 #include <limits.h>
 #include <time.h>
 #include <alloca.h>
@@ -145,55 +152,89 @@ static uint64_t read_uint64(int fd) {
 const char *AMQP_PORT = "5672";
 const char *AMQP_PORT_NAME = "amqp";
 
-// The number of times a connection event batch may be replenished for
-// a thread between calls to wait().  Some testing shows that
-// increasing this value above 1 actually slows performance slightly
-// and increases latency.
+// The default number of times a connection event batch may be replenished
+// for a thread between calls to wait(), see PN_SCHED_REPLENISH.  Some
+// testing shows that increasing this value above 1 actually slows
+// performance slightly and increases latency.
 #define HOG_MAX 1
 
+// Connection buffer sizing.  A read that fills the input buffer grows it
+// READ_GROWTH times for the next read, so bulk input needs few reads.  Once
+// recent reads are below BUFFER_FLOOR bytes and the connection has nothing
+// pending, its buffers are shrunk back to the floor: most of a quiet
+// connection's memory goes back to the allocator for busier ones to use.
+#define READ_GROWTH 4
+#define BUFFER_FLOOR 1024
+
 /* pn_proactor_t and pn_listener_t are plain C structs with normal memory management.
    Class definitions are for identification as pn_event_t context only.
 */
 PN_STRUCT_CLASSDEF(pn_proactor)
 PN_STRUCT_CLASSDEF(pn_listener)
 
-bool start_polling(epoll_extended_t *ee, int epollfd) {
+bool start_polling(epoll_extended_t *ee, pn_proactor_t *p) {
   if (ee->polling)
     return false;
   ee->polling = true;
+  memory_barrier(ee);
+#ifdef PN_EPOLL_IO_URING
+  if (p->uring)
+    return pni_uring_start_polling(p->uring, ee);
+#endif
   struct epoll_event ev = {0};
   ev.data.ptr = ee;
-  ev.events = ee->wanted | EPOLLONESHOT;
-  memory_barrier(ee);
-  return (epoll_ctl(epollfd, EPOLL_CTL_ADD, ee->fd, &ev) == 0);
+  ev.events = ee->wanted | ((ee->wanted & EPOLLET) ? 0 : EPOLLONESHOT);
+  return (epoll_ctl(p->epollfd, EPOLL_CTL_ADD, ee->fd, &ev) == 0);
 }
 
-void stop_polling(epoll_extended_t *ee, int epollfd) {
+void stop_polling(epoll_extended_t *ee, pn_proactor_t *p) {
   // TODO: check for error, return bool or just log?
   // TODO: is EPOLL_CTL_DEL ever needed beyond auto de-register when ee->fd is closed?
-  if (ee->fd == -1 || !ee->polling || epollfd == -1)
+  if (ee->fd == -1 || !ee->polling || p->epollfd == -1)
     return;
-  struct epoll_event ev = {0};
-  ev.data.ptr = ee;
-  ev.events = 0;
   memory_barrier(ee);
-  if (epoll_ctl(epollfd, EPOLL_CTL_DEL, ee->fd, &ev) == -1)
-    EPOLL_FATAL("EPOLL_CTL_DEL", errno);
+#ifdef PN_EPOLL_IO_URING
+  if (p->uring) {
+    pni_uring_stop_polling(p->uring, ee);
+  } else
+#endif
+  {
+    struct epoll_event ev = {0};
+    ev.data.ptr = ee;
+    ev.events = 0;
+    if (epoll_ctl(p->epollfd, EPOLL_CTL_DEL, ee->fd, &ev) == -1)
+      EPOLL_FATAL("EPOLL_CTL_DEL", errno);
+  }
   ee->fd = -1;
   ee->polling = false;
 }
 
-void rearm_polling(epoll_extended_t *ee, int epollfd) {
+void rearm_polling(epoll_extended_t *ee, pn_proactor_t *p) {
+  memory_barrier(ee);
+#ifdef PN_EPOLL_IO_URING
+  if (p->uring) {
+    pni_uring_rearm_polling(p->uring, ee);
+    return;
+  }
+#endif
   struct epoll_event ev = {0};
   ev.data.ptr = ee;
-  ev.events = ee->wanted | EPOLLONESHOT;
-  memory_barrier(ee);
-  if (epoll_ctl(epollfd, EPOLL_CTL_MOD, ee->fd, &ev) == -1)
+  ev.events = ee->wanted | ((ee->wanted & EPOLLET) ? 0 : EPOLLONESHOT);
+  if (epoll_ctl(p->epollfd, EPOLL_CTL_MOD, ee->fd, &ev) == -1)
     EPOLL_FATAL("arming polled file descriptor", errno);
 }
 
+/* Wait for events on the epoll fd or the io_uring poller */
+static int poller_wait(pn_proactor_t *p, bool block) {
+#ifdef PN_EPOLL_IO_URING
+  if (p->uring)
+    return pni_uring_wait(p->uring, p->kevents, p->kevents_capacity, block);
+#endif
+  return epoll_wait(p->epollfd, p->kevents, p->kevents_capacity, block ? -1 : 0);
+}
+
 static void rearm(pn_proactor_t *p, epoll_extended_t *ee) {
-  rearm_polling(ee, p->epollfd);
+  rearm_polling(ee, p);
 }
 
 /*
@@ -222,6 +263,7 @@ static void rearm(pn_proactor_t *p, epoll_extended_t *ee) {
 
 // Fake thread for temporarily disabling the scheduling of a task.
 static struct tslot_t *RESCHEDULE_PLACEHOLDER = (struct tslot_t*) -1;
+static task_t *READY_LIST_AWAKE = (task_t*) -1;  // Empty ready list, poller needs no eventfd wakeup
 
 void task_init(task_t *tsk, task_type_t t, pn_proactor_t *p) {
   memset(tsk, 0, sizeof(*tsk));
@@ -233,7 +275,10 @@ void task_init(task_t *tsk, task_type_t t, pn_proactor_t *p) {
 /*
  * schedule() strategy with eventfd:
  *  - tasks can be in the ready list only once
- *  - a scheduling thread will only activate the eventfd if ready_list_active is false
+ *  - scheduling threads push onto ready_list_head without a lock (compare and swap)
+ *  - ready_list_head is NULL when the poller may be asleep in epoll_wait(), else
+ *    READY_LIST_AWAKE or a list ending in one of the two
+ *  - a scheduling thread will only activate the eventfd if it pushes onto NULL
  * There is a single rearm between ready list empty and non-empty
  *
  * There can potentially be many tasks with work pending.
@@ -246,10 +291,9 @@ void task_init(task_t *tsk, task_type_t t, pn_proactor_t *p) {
  * The task must be actually running to absorb task_t->ready.
  *
  * The ready list can keep growing while popping ready tasks.  The list between
- * sched_ready_first and sched_ready_last are protected by the sched
- * lock (for pop operations), sched_ready_last to ready_list_last are
- * protected by the eventfd mutex (for add operations).  Both locks
- * are needed to cross or reconcile the two portions of the list.
+ * sched_ready_first and sched_ready_last is protected by the sched
+ * lock.  The poller takes the whole of the lock-free part at once and
+ * appends it, oldest first, with the sched lock held.
  */
 
 // Call with sched lock held and sched_ready_count > 0.
@@ -263,7 +307,7 @@ static task_t *sched_ready_pop_front(pn_proactor_t *p) {
   //
   // !ready .. schedule() .. on ready_list .. on sched_ready_list .. working task .. !sched_ready && !ready
   //
-  // Intervening locks at each transition ensures ready_next has memory coherence throughout the ready task scheduling cycle.
+  // The push/take atomics and the sched lock ensure ready_next has memory coherence throughout the ready task scheduling cycle.
   assert (p->sched_ready_count);
   task_t *tsk = p->sched_ready_first;
   p->sched_ready_count--;
@@ -281,11 +325,12 @@ static task_t *sched_ready_pop_front(pn_proactor_t *p) {
 
 // Call only as the poller task that has already called schedule_ready_list() and already
 // incremented p->ready_list_generation.  All list elements before sched_ready_last have
-// correct generation from mutex barrier and cannot have tsk->ready_generation set to a
+// the generation stamped there (tasks still on ready_list_head have none) and cannot have tsk->ready_generation set to a
 // new generation until after the poller task releases the sched lock and allows tsk to
 // run again.
 inline static bool on_sched_ready_list(task_t *tsk, pn_proactor_t *p) {
-  return tsk->ready_generation && (tsk->ready_generation != p->ready_list_generation);
+  unsigned int generation = __atomic_load_n(&tsk->ready_generation, __ATOMIC_RELAXED);
+  return generation && (generation != p->ready_list_generation);
 }
 
 // part1: call with tsk->owner lock held, return true if notify_poller required by caller.
@@ -297,23 +342,13 @@ bool schedule(task_t *tsk) {
     if (!tsk->working) {
       tsk->ready = true;
       pn_proactor_t *p = tsk->proactor;
-      lock(&p->eventfd_mutex);
-      assert(tsk->ready_generation == 0);  // Can't be on list twice
-      tsk->ready_next = NULL;
-      tsk->ready_generation = p->ready_list_generation;
-      p->ready_list_count++;
-      if (!p->ready_list_first) {
-        p->ready_list_first = p->ready_list_last = tsk;
-      } else {
-        p->ready_list_last->ready_next = tsk;
-        p->ready_list_last = tsk;
-      }
-      if (!p->ready_list_active) {
-        // unblock poller via the eventfd
-        p->ready_list_active = true;
-        notify = true;
-      }
-      unlock(&p->eventfd_mutex);
+      assert(__atomic_load_n(&tsk->ready_generation, __ATOMIC_RELAXED) == 0);  // Can't be on list twice
+      task_t *head = __atomic_load_n(&p->ready_list_head, __ATOMIC_RELAXED);
+      do {
+        tsk->ready_next = head;
+      } while (!__atomic_compare_exchange_n(&p->ready_list_head, &head, tsk, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+      // unblock poller via the eventfd, once per empty to non-empty transition
+      notify = (head == NULL);
     }
   }
 
@@ -330,10 +365,8 @@ void notify_poller(pn_proactor_t *p) {
 // call with task lock held from xxx_process().
 void schedule_done(task_t *tsk) {
   assert(tsk->ready);
-  lock(&tsk->proactor->eventfd_mutex);
-  assert(tsk->ready_generation != 0);
-  tsk->ready_generation = 0;
-  unlock(&tsk->proactor->eventfd_mutex);
+  assert(__atomic_load_n(&tsk->ready_generation, __ATOMIC_RELAXED) != 0);
+  __atomic_store_n(&tsk->ready_generation, 0, __ATOMIC_RELAXED);
   tsk->ready = false;
 }
 
@@ -347,6 +380,10 @@ void schedule_done(task_t *tsk) {
 static int pni_spins = 0;
 /* Prefer immediate running by poller over warm running by suspended thread */
 static bool pni_immediate = false;
+#ifdef PN_EPOLL_IO_URING
+// Set PNI_EPOLL_NO_URING to poll with epoll even where io_uring is available.
+static bool pni_use_uring = true;
+#endif
 /* Toggle use of warm scheduling */
 static int pni_warm_sched = true;
 
@@ -367,6 +404,16 @@ static void suspend_list_insert_head(pn_proactor_t *p, tslot_t *ts) {
   p->suspend_list_head = ts;
 }
 
+static inline unsigned busy_poll_usec(pn_proactor_t *p) {
+  return __atomic_load_n(&p->busy_poll_usec, __ATOMIC_RELAXED);
+}
+
+static int64_t now_usec(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return ((int64_t)t.tv_sec * 1000000) + (t.tv_nsec / 1000);
+}
+
 // Call with sched lock
 static void suspend(pn_proactor_t *p, tslot_t *ts) {
   if (ts->state == NEW)
@@ -397,6 +444,14 @@ static void suspend(pn_proactor_t *p, tslot_t *ts) {
     if (!locked)
       lock(&ts->mutex);
   }
+  unsigned busy_poll = busy_poll_usec(p);
+  if (busy_poll && !ts->scheduled) {
+    // Busy poll.  resume() does not signal while the thread is not yet marked suspended.
+    unlock(&ts->mutex);
+    int64_t until = now_usec() + busy_poll;
+    while (!__atomic_load_n(&ts->scheduled, __ATOMIC_ACQUIRE) && now_usec() < until) {}
+    lock(&ts->mutex);
+  }
 
   ts->suspended = true;
   while (!ts->scheduled) {
@@ -495,12 +550,9 @@ bool unassign_thread(pn_proactor_t *p, tslot_t *ts, tslot_state new_state, tslot
       }
       p->resched_count++;
       if (p->poller_suspended) {
-        lock(&p->eventfd_mutex);
-        if (!p->ready_list_active) {
-          p->ready_list_active = true;
+        task_t *empty = NULL;
+        if (__atomic_compare_exchange_n(&p->ready_list_head, &empty, READY_LIST_AWAKE, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
           notify = true;
-        }
-        unlock(&p->eventfd_mutex);
       }
     }
   }
@@ -579,6 +631,36 @@ void psocket_init(psocket_t* ps, epoll_type_t type)
   ps->epoll_io.type = type;
   ps->epoll_io.wanted = 0;
   ps->epoll_io.polling = false;
+  ps->unpolling = false;
+  ps->unpoll_generation = 0;
+}
+
+/* Call from the working task of an edge triggered socket that is closing.
+
+   A one-shot socket is known to be finished with the poller once its
+   outstanding arm has been delivered.  An edge triggered socket stays
+   registered, so instead stop polling it (leaving the fd open for the
+   owner's cleanup) and return true once the poller has posted the events of
+   any wait that was in progress at the time.  The caller must schedule itself
+   to check again while this returns false.
+*/
+bool psocket_edge_unpolled(psocket_t *ps, pn_proactor_t *p) {
+  bool unpolled;
+  if (!ps->unpolling) {
+    int fd = ps->epoll_io.fd;  /* Save fd, it will be set to -1 by stop_polling */
+    stop_polling(&ps->epoll_io, p);
+    ps->epoll_io.fd = fd;
+    ps->unpolling = true;
+    lock(&p->sched_mutex);
+    ps->unpoll_generation = p->poll_generation;
+    unpolled = (p->posted_generation == p->poll_generation);
+    unlock(&p->sched_mutex);
+  } else {
+    lock(&p->sched_mutex);
+    unpolled = (p->posted_generation != ps->unpoll_generation - 1);
+    unlock(&p->sched_mutex);
+  }
+  return unpolled;
 }
 
 
@@ -675,6 +757,9 @@ static void psocket_error_str(psocket_t *ps, const char *msg, const char* what)
     pn_connection_driver_t *driver = &pc->driver;
     pn_connection_driver_bind(driver); /* Bind so errors will be reported */
     pni_proactor_set_cond(pn_transport_condition(driver->transport), what, pc->host, pc->port, msg);
+#ifdef PN_EPOLL_TLS
+    if (pc->tls) pni_ptls_abandon(pc->tls);  // No TLS closure over a failed socket
+#endif
     pn_connection_driver_close(driver);
     return;
   }
@@ -783,6 +868,24 @@ int pclosefd(pn_proactor_t *p, int fd) {
 
 static void pconnection_tick(pconnection_t *pc);
 
+#ifdef PN_EPOLL_TLS
+// pn_transport_set_tls() settings, kept with the transport until it is bound
+PN_HANDLE(PNI_PTLS_CONFIG)
+PN_HANDLE(PNI_PTLS_HOSTNAME)
+
+// Start the pn_tls session of a transport set up with pn_transport_set_tls()
+static void pconnection_tls_init(pconnection_t *pc, pn_proactor_t *p) {
+  pn_record_t *r = pn_transport_attachments(pc->driver.transport);
+  struct pn_tls_config_t *config = (struct pn_tls_config_t *)pn_record_get(r, PNI_PTLS_CONFIG);
+  if (!config) return;
+  pn_string_t *host = (pn_string_t *)pn_record_get(r, PNI_PTLS_HOSTNAME);
+  if (!(pc->tls = pni_ptls(p, config, host ? pn_string_get(host) : NULL))) {
+    pn_connection_driver_errorf(&pc->driver, "proton:io", "TLS session setup failed");
+    pn_connection_driver_close(&pc->driver);
+  }
+}
+#endif
+
 static const char *pconnection_setup(pconnection_t *pc, pn_proactor_t *p, pn_connection_t *c, pn_transport_t *t, bool server, const char *addr, size_t addrlen)
 {
   memset(pc, 0, sizeof(*pc));
@@ -813,14 +916,19 @@ static const char *pconnection_setup(pconnection_t *pc, pn_proactor_t *p, pn_con
   pc->output_drained = false;
   pc->wbuf_completed = 0;
   pc->wbuf_remaining = 0;
-  pc->wbuf_current = NULL;
+  pc->wbuf_first = 0;
+  pc->wbuf_count = 0;
   pc->hog_count = 0;
+  pc->sched_weight = 1;
   pc->batch.next_event = pconnection_batch_next;
   pc->first_schedule = false;
 
   if (server) {
     pn_transport_set_server(pc->driver.transport);
   }
+#ifdef PN_EPOLL_TLS
+  pconnection_tls_init(pc, p);
+#endif
 
   pmutex_init(&pc->rearm_mutex);
 
@@ -836,6 +944,8 @@ static const char *pconnection_setup(pconnection_t *pc, pn_proactor_t *p, pn_con
 // Call with lock held and closing == true (i.e. pn_connection_driver_finished() == true), no pending timer.
 // Return true when all possible outstanding epoll events associated with this pconnection have been processed.
 static inline bool pconnection_is_final(pconnection_t *pc) {
+  if ((pc->current_arm & EPOLLET) && psocket_edge_unpolled(&pc->psocket, pc->task.proactor))
+    pc->current_arm = 0;
   return !pc->current_arm && !pc->task.ready && !pc->tick_pending && !pc->name_lookup_pending;
 }
 
@@ -851,6 +961,9 @@ static void pconnection_final_free(pconnection_t *pc) {
   }
   pmutex_finalize(&pc->rearm_mutex);
   pn_condition_free(pc->disconnect_condition);
+#ifdef PN_EPOLL_TLS
+  pni_ptls_free(pc->tls);
+#endif
   pn_connection_driver_destroy(&pc->driver);
   pni_timer_free(pc->timer);
   task_finalize(&pc->task);
@@ -862,7 +975,7 @@ static void pconnection_final_free(pconnection_t *pc) {
 static void pconnection_cleanup(pconnection_t *pc) {
   assert(pconnection_is_final(pc));
   int fd = pc->psocket.epoll_io.fd;
-  stop_polling(&pc->psocket.epoll_io, pc->task.proactor->epollfd);
+  stop_polling(&pc->psocket.epoll_io, pc->task.proactor);
   if (fd != -1)
     pclosefd(pc->task.proactor, fd);
 
@@ -874,30 +987,67 @@ static void pconnection_cleanup(pconnection_t *pc) {
   // else proactor_disconnect logic owns psocket and its final free
 }
 
-static void set_wbuf(pconnection_t *pc, const char *start, size_t sz) {
-  pc->wbuf_completed = 0;
-  pc->wbuf_current = start;
-  pc->wbuf_remaining = sz;
-}
-
 // Never call with any locks held.
 static void ensure_wbuf(pconnection_t *pc) {
+#ifdef PN_EPOLL_TLS
+  if (pc->tls) {
+    // Encrypted output in pool buffers, the transport's output is done with already
+    size_t n = pni_ptls_encrypt(pc->tls, &pc->driver, pc->wbuf, PCONNECTION_WBUF_MAX);
+    pc->wbuf_completed = 0;
+    pc->wbuf_remaining = 0;
+    pc->wbuf_first = 0;
+    pc->wbuf_count = n;
+    for (size_t i = 0; i < n; ++i)
+      pc->wbuf_remaining += pc->wbuf[i].iov_len;
+    if (pc->wbuf_remaining == 0)
+      pc->output_drained = true;
+    return;
+  }
+#endif
   // next connection_driver call is the expensive output generator
-  pn_bytes_t bytes = pn_connection_driver_write_buffer(&pc->driver);
-  set_wbuf(pc, bytes.start, bytes.size);
-  if (bytes.size == 0)
+  pn_bytes_t segs[PCONNECTION_WBUF_MAX];
+  size_t n = pn_connection_driver_write_buffers(&pc->driver, segs, PCONNECTION_WBUF_MAX);
+  pc->wbuf_completed = 0;
+  pc->wbuf_remaining = 0;
+  pc->wbuf_first = 0;
+  pc->wbuf_count = n;
+  for (size_t i = 0; i < n; ++i) {
+    pc->wbuf[i].iov_base = (void *)segs[i].start;
+    pc->wbuf[i].iov_len = segs[i].size;
+    pc->wbuf_remaining += segs[i].size;
+  }
+  if (pc->wbuf_remaining == 0)
     pc->output_drained = true;
 }
 
+// Step past n bytes written from the front of wbuf
+static void wbuf_advance(pconnection_t *pc, size_t n) {
+  pc->wbuf_completed += n;
+  pc->wbuf_remaining -= n;
+  while (n) {
+    struct iovec *iov = &pc->wbuf[pc->wbuf_first];
+    if (n < iov->iov_len) {
+      iov->iov_base = (char *)iov->iov_base + n;
+      iov->iov_len -= n;
+      break;
+    }
+    n -= iov->iov_len;
+    pc->wbuf_first++;
+  }
+}
+
 // Call with lock held or from forced_shutdown
 static void pconnection_begin_close(pconnection_t *pc) {
   if (!pc->task.closing) {
     pc->task.closing = true;
     pc->tick_pending = false;
-    if (pc->current_arm) {
-      // Force EPOLLHUP callback(s)
+    if (pc->current_arm && !(pc->current_arm & EPOLLET)) {
+      // Force EPOLLHUP callback(s).  Edge triggered sockets are unpolled by pconnection_is_final().
       shutdown(pc->psocket.epoll_io.fd, SHUT_RDWR);
     }
+#ifdef PN_EPOLL_TLS
+    if (pc->tls) pni_ptls_abandon(pc->tls);
+#endif
     pn_connection_driver_close(&pc->driver);
   }
 }
@@ -915,10 +1065,9 @@ static void pconnection_forced_shutdown(pconnection_t *pc) {
 }
 
 // Called from timer_manager with no locks.
-void pni_pconnection_timeout(pconnection_t  *pc) {
+// Return true if notify_poller() needed.
+bool pni_pconnection_timeout(pconnection_t  *pc, uint64_t now) {
   bool notify = false;
-  pn_proactor_t *p = pc->task.proactor;
-  uint64_t now = pn_proactor_now_64();
   lock(&pc->task.mutex);
   if (!pc->task.closing) {
     // confirm no simultaneous timeout change from another thread.
@@ -929,13 +1078,68 @@ void pni_pconnection_timeout(pconnection_t  *pc) {
     }
   }
   unlock(&pc->task.mutex);
-  if (notify)
-    notify_poller(p);
+  return notify;
+}
+
+/* Shortcuts */
+static inline bool pconnection_rclosed(pconnection_t  *pc) {
+  return pn_connection_driver_read_closed(&pc->driver);
+}
+
+static inline bool pconnection_wclosed(pconnection_t  *pc) {
+#ifdef PN_EPOLL_TLS
+  // The TLS closure and any encrypted output still to go follow the transport's output
+  if (pc->tls && !(pc->wbuf_remaining == 0 && pni_ptls_write_closed(pc->tls)))
+    return false;
+#endif
+  return pn_connection_driver_write_closed(&pc->driver);
+}
+
+static inline bool pconnection_finished(pconnection_t *pc) {
+  return pn_connection_driver_finished(&pc->driver) && pconnection_wclosed(pc);
+}
+
+static inline uint64_t sched_limit(pn_proactor_t *p, pn_sched_limit_t limit) {
+  return __atomic_load_n(&p->sched_limit[limit], __ATOMIC_RELAXED);
+}
+
+static inline void sched_limit_hit(pn_proactor_t *p, pn_sched_limit_t limit) {
+  __atomic_fetch_add(&p->sched_limit_hits[limit], 1, __ATOMIC_RELAXED);
+}
+
+static void pconnection_batch_start(pconnection_t *pc) {
+  pc->batch_weight = pc->sched_weight;
+  pc->batch_events = 0;
+  pc->batch_bytes = 0;
+  pc->batch_start = sched_limit(pc->task.proactor, PN_SCHED_TIME) ? pn_proactor_now_64() : 0;
+  pc->batch_spent = false;
+}
+
+// Return true if the current batch has used up one of its limits and must end.
+static bool pconnection_batch_spent(pconnection_t *pc) {
+  if (pc->batch_spent) return true;
+  pn_proactor_t *p = pc->task.proactor;
+  uint64_t w = pc->batch_weight;
+  uint64_t limit;
+  pn_sched_limit_t hit;
+  if ((limit = sched_limit(p, PN_SCHED_EVENTS)) && pc->batch_events >= limit * w)
+    hit = PN_SCHED_EVENTS;
+  else if ((limit = sched_limit(p, PN_SCHED_BYTES)) && pc->batch_bytes >= limit * w)
+    hit = PN_SCHED_BYTES;
+  else if ((limit = sched_limit(p, PN_SCHED_TIME)) && pc->batch_start &&
+           (uint64_t)(pn_proactor_now_64() - pc->batch_start) >= limit * w)
+    hit = PN_SCHED_TIME;
+  else
+    return false;
+  sched_limit_hit(p, hit);
+  pc->batch_spent = true;
+  return true;
 }
 
 static pn_event_t *pconnection_batch_next(pn_event_batch_t *batch) {
   pconnection_t *pc = batch_pconnection(batch);
   if (!pc->driver.connection) return NULL;
+  if (pconnection_batch_spent(pc)) return NULL;  // Remaining work is rescheduled by pconnection_done()
   pn_event_t *e = pn_connection_driver_next_event(&pc->driver);
   if (!e) {
     pn_proactor_t *p = pc->task.proactor;
@@ -951,28 +1155,24 @@ static pn_event_t *pconnection_batch_next(pn_event_batch_t *batch) {
     else {
       write_flush(pc);  // May generate transport event
       e = pn_connection_driver_next_event(&pc->driver);
-      if (!e && pc->hog_count < HOG_MAX) {
-        pconnection_process(pc, 0, false, true);
-        e = pn_connection_driver_next_event(&pc->driver);
+      if (!e) {
+        if ((uint64_t)pc->hog_count < sched_limit(p, PN_SCHED_REPLENISH) * pc->batch_weight) {
+          pconnection_process(pc, 0, false, true);
+          e = pn_connection_driver_next_event(&pc->driver);
+        } else if (!pc->read_blocked && !pconnection_rclosed(pc)) {
+          sched_limit_hit(p, PN_SCHED_REPLENISH);  // Input left for a later batch
+        }
       }
     }
   }
   if (e) {
     pc->output_drained = false;
     pc->current_event_type = pn_event_type(e);
+    pc->batch_events++;
   }
   return e;
 }
 
-/* Shortcuts */
-static inline bool pconnection_rclosed(pconnection_t  *pc) {
-  return pn_connection_driver_read_closed(&pc->driver);
-}
-
-static inline bool pconnection_wclosed(pconnection_t  *pc) {
-  return pn_connection_driver_write_closed(&pc->driver);
-}
-
 /* Call only from working task (no competitor for pc->current_arm or
    connection driver).  If true returned, caller must do
    pconnection_rearm().
@@ -983,8 +1183,18 @@ static inline bool pconnection_wclosed(pconnection_t  *pc) {
    close/shutdown.
 
    Normally, let send()/recv() return 0 or -1 to trigger cleanup logic.
+
+   Once connected, an edge triggered proactor arms the socket a last time
+   with EPOLLET and never again: read_blocked/write_blocked are only set
+   when recv()/send() leave the socket drained or full, so the next edge
+   is certain to schedule the task.
 */
 static int pconnection_rearm_check(pconnection_t *pc) {
+  if ((pc->current_arm & EPOLLET) && pc->task.closing) {
+    // Keep running until pconnection_is_final() sees the socket unpolled.
+    schedule(&pc->task); // unassign_thread handles notify_poller requirement.
+    return 0;
+  }
   if ((pconnection_rclosed(pc) && pconnection_wclosed(pc)) || pc->psocket.epoll_io.fd == -1) {
     return 0;
   } else if (pc->disconnected) {
@@ -1001,6 +1211,10 @@ static int pconnection_rearm_check(pconnection_t *pc) {
     schedule(&pc->task); // unassign_thread handles notify_poller requirement.
     return 0;
   }
+  if (pc->current_arm & EPOLLET)
+    return 0;
+  if (pc->task.proactor->edge_triggered && pc->connected && !pc->task.closing)
+    return EPOLLIN | EPOLLOUT | EPOLLET;
 
   uint32_t wanted_now = (pc->read_blocked && !pconnection_rclosed(pc)) ? EPOLLIN : 0;
   if (!pconnection_wclosed(pc)) {
@@ -1036,10 +1250,18 @@ static inline bool pconnection_work_pending(pconnection_t *pc) {
 }
 
 /* Call with no locks. */
+// Shrink the buffers of a connection that has gone quiet, see BUFFER_FLOOR.
+// Not while written segments are outstanding, they point into the buffers.
+static inline void pconnection_buffer_trim(pconnection_t *pc) {
+  if (pc->read_blocked && pc->read_recent < BUFFER_FLOOR && !pc->wbuf_remaining)
+    pn_connection_driver_shrink_buffers(&pc->driver, BUFFER_FLOOR);
+}
+
 static void pconnection_done(pconnection_t *pc) {
   pn_proactor_t *p = pc->task.proactor;
   tslot_t *ts = pc->task.runner;
   write_flush(pc);
+  pconnection_buffer_trim(pc);
   bool notify = false;
   bool self_sched = false;
   lock(&pc->task.mutex);
@@ -1049,7 +1271,7 @@ static void pconnection_done(pconnection_t *pc) {
 
   if (pconnection_work_pending(pc)) {
     self_sched = true;
-  } else if (pn_connection_driver_finished(&pc->driver)) {
+  } else if (pconnection_finished(pc)) {
     pconnection_begin_close(pc);
     if (pconnection_is_final(pc)) {
       unlock(&pc->task.mutex);
@@ -1081,25 +1303,105 @@ static void pconnection_done(pconnection_t *pc) {
   return;
 }
 
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+
+// Smallest segment to send zero-copy, 0 to copy everything.
+static size_t pconnection_zerocopy_min(pconnection_t *pc) {
+  if (!pc->zerocopy_min && !pc->zerocopy_failed) {
+    size_t min = pn_transport_get_zerocopy(pc->driver.transport);
+    if (min) {
+      int on = 1;
+      if (setsockopt(pc->psocket.epoll_io.fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) == 0)
+        pc->zerocopy_min = min;
+      else
+        pc->zerocopy_failed = true;
+    }
+  }
+  return pc->zerocopy_min;
+}
+
+// Limit msg to what can be sent in one go: either a single payload segment
+// sent zero-copy, or the segments before the next one.  Returns the send flags.
+static int pconnection_zerocopy_split(pconnection_t *pc, struct msghdr *msg) {
+  size_t min = pconnection_zerocopy_min(pc);
+  if (!min) return 0;
+  for (size_t i = 0; i < msg->msg_iovlen; ++i) {
+    struct iovec *iov = &msg->msg_iov[i];
+    if (iov->iov_len >= min &&
+        pn_connection_driver_write_hold(&pc->driver, pn_bytes(iov->iov_len, (const char *)iov->iov_base), pc->zerocopy_next)) {
+      if (i == 0) {
+        msg->msg_iovlen = 1;
+        return MSG_ZEROCOPY;
+      }
+      msg->msg_iovlen = i;
+      return MSG_MORE;
+    }
+  }
+  return 0;
+}
+
+// Release payload the kernel has finished with.  The notifications are
+// ranges of send ids; TCP completes them in order.
+static void pconnection_zerocopy_done(pconnection_t *pc) {
+  char control[128];
+  struct msghdr msg = {0};
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  while (recvmsg(pc->psocket.epoll_io.fd, &msg, MSG_ERRQUEUE) >= 0) {
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+      if ((cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_RECVERR) ||
+          (cm->cmsg_level == IPPROTO_IPV6 && cm->cmsg_type == IPV6_RECVERR)) {
+        struct sock_extended_err *err = (struct sock_extended_err *)CMSG_DATA(cm);
+        if (err->ee_origin == SO_EE_ORIGIN_ZEROCOPY && err->ee_errno == 0) {
+          pn_connection_driver_write_release(&pc->driver, err->ee_data);
+          if (err->ee_data == pc->zerocopy_next - 1)
+            pc->zerocopy_pending = false;
+        }
+      }
+    }
+    msg.msg_controllen = sizeof(control);
+  }
+}
+
+#else
+
+static int pconnection_zerocopy_split(pconnection_t *pc, struct msghdr *msg) { (void)pc; (void)msg; return 0; }
+static void pconnection_zerocopy_done(pconnection_t *pc) { (void)pc; }
+
+#endif
+
 // Return true unless error
 static bool pconnection_write(pconnection_t *pc) {
-  size_t wbuf_size = pc->wbuf_remaining;
-  ssize_t n = send(pc->psocket.epoll_io.fd, pc->wbuf_current, wbuf_size, MSG_NOSIGNAL);
+  // Gather write header and payload segments straight from the transport
+  struct msghdr msg = {0};
+  msg.msg_iov = &pc->wbuf[pc->wbuf_first];
+  msg.msg_iovlen = pc->wbuf_count - pc->wbuf_first;
+  int flags = pc->tls ? 0 : pconnection_zerocopy_split(pc, &msg);  // Ciphertext is ours to copy
+  size_t size = pc->wbuf_remaining;
+  if (flags) {
+    size = 0;
+    for (size_t i = 0; i < msg.msg_iovlen; ++i) size += msg.msg_iov[i].iov_len;
+  }
+  ssize_t n = sendmsg(pc->psocket.epoll_io.fd, &msg, flags | MSG_NOSIGNAL);
   if (n > 0) {
-    pc->wbuf_completed += n;
-    pc->wbuf_remaining -= n;
+#ifdef MSG_ZEROCOPY
+    if (flags & MSG_ZEROCOPY) {
+      pc->zerocopy_next++;
+      pc->zerocopy_pending = true;
+    }
+#endif
+    wbuf_advance(pc, n);
+    pc->batch_bytes += n;
     pc->io_doublecheck = false;
     if (pc->wbuf_remaining) {
-      pc->write_blocked = true;
-      pc->wbuf_current += n;
+      if ((size_t)n < size)  // Otherwise more to send after a zero-copy split
+        pc->write_blocked = true;
     }
     else {
       // write_done also calls pn_transport_pending(), so the transport knows all current output
-      pn_bytes_t bytes = pn_connection_driver_write_done(&pc->driver, pc->wbuf_completed);
-      set_wbuf(pc, bytes.start, bytes.size);
-      if (bytes.size == 0)
-        pc->output_drained = true;
-      // TODO: revise transport API to allow similar efficient access to transport output
+      if (!pc->tls)  // TLS output was done with when encrypted
+        pn_connection_driver_write_done(&pc->driver, pc->wbuf_completed);
+      ensure_wbuf(pc);
     }
   } else if (errno == EWOULDBLOCK) {
     pc->write_blocked = true;
@@ -1119,7 +1421,7 @@ static void write_flush(pconnection_t *pc) {
       ensure_wbuf(pc);
     } else {
       // Check if we are doing multiple small writes in a row, possibly worth growing the transport output buffer.
-      if (prev_wbuf_remaining
+      if (prev_wbuf_remaining && !pc->tls
           && prev_wbuf_remaining == pc->wbuf_remaining         // two max outputs in a row
           && pc->wbuf_remaining < 131072) {
         ensure_wbuf(pc);  // second call -> unchanged wbuf or transport buffer size doubles and more bytes added
@@ -1135,7 +1437,7 @@ static void write_flush(pconnection_t *pc) {
       // pconnection_write side effect: wbuf may be replenished, and if not, output_drained may be set.
     }
     else {
-      if (pn_connection_driver_write_closed(&pc->driver)) {
+      if (pconnection_wclosed(pc)) {
         shutdown(pc->psocket.epoll_io.fd, SHUT_WR);
         pc->write_blocked = true;
       }
@@ -1143,14 +1445,80 @@ static void write_flush(pconnection_t *pc) {
   }
 }
 
+// Read into the transport's buffer, decrypted when using pn_tls
+static inline ssize_t pconnection_recv(pconnection_t *pc, char *buf, size_t size) {
+#ifdef PN_EPOLL_TLS
+  if (pc->tls) {
+    pc->output_drained = false;  // The handshake or an alert may want to reply
+    return pni_ptls_recv(pc->tls, &pc->driver, pc->psocket.epoll_io.fd, buf, size);
+  }
+#endif
+  return recv(pc->psocket.epoll_io.fd, buf, size, 0);
+}
+
 static void pconnection_connected_lh(pconnection_t *pc);
 static void pconnection_maybe_connect_lh(pconnection_t *pc);
 static bool pconnection_first_connect_lh(pconnection_t *pc);
 
+// Hand the TLS work on nread bytes to the crypto offload pool?  Always while
+// the handshake is running, then only for reads above the threshold.
+static bool pconnection_offload_wanted(pconnection_t *pc, size_t nread) {
+  pn_proactor_t *p = pc->task.proactor;
+  pn_transport_t *t = pc->driver.transport;
+  if (!t->ssl || !__atomic_load_n(&p->offload_enabled, __ATOMIC_RELAXED))
+    return false;
+  char cipher[64];
+  if (!pn_ssl_get_cipher_name(pn_ssl(t), cipher, sizeof(cipher)))
+    return true;                // No cipher until the handshake has negotiated one
+  size_t threshold = __atomic_load_n(&p->offload_threshold, __ATOMIC_RELAXED);
+  return threshold && nread >= threshold;
+}
+
+/* Call with no locks, from the working task. */
+// The pool takes over as working task, pc must not be touched after this.
+static void pconnection_offload(pconnection_t *pc, size_t nread) {
+  pn_proactor_t *p = pc->task.proactor;
+  pc->offload_bytes = nread;
+  pc->offload_next = NULL;
+  pc->hog_count = 0;
+  lock(&pc->task.mutex);
+  pc->offloading = true;
+  unlock(&pc->task.mutex);
+  __atomic_fetch_add(&p->offloads, 1, __ATOMIC_RELAXED);
+  lock(&p->offload_mutex);
+  if (p->offload_last)
+    p->offload_last->offload_next = pc;
+  else
+    p->offload_first = pc;
+  p->offload_last = pc;
+  pthread_cond_signal(&p->offload_cond);
+  unlock(&p->offload_mutex);
+}
+
+// Called on a pool thread: do the work the IO thread would have done after
+// the read, including any output it provokes, then reschedule the connection.
+static void pconnection_offload_run(pconnection_t *pc) {
+  pn_connection_driver_read_done(&pc->driver, pc->offload_bytes);
+  pc->offload_bytes = 0;
+  pconnection_tick(pc);
+  pc->output_drained = false;
+  pc->io_doublecheck = false;
+  (void)pn_connection_driver_write_buffer(&pc->driver);  // Handshake replies are generated here
+
+  pn_proactor_t *p = pc->task.proactor;
+  lock(&pc->task.mutex);
+  pc->offloading = false;
+  pc->task.working = false;
+  bool notify = schedule(&pc->task);
+  unlock(&pc->task.mutex);
+  if (notify) notify_poller(p);
+}
+
 static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events, bool sched_ready, bool topup) {
   bool waking = false;
   bool tick_required = false;
   bool immediate_write = false;
+  bool zerocopy_done = false;
   lock(&pc->task.mutex);
   if (!topup) { // Save some state in case of crash investigation.
     pc->process_events = events;
@@ -1158,7 +1526,8 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
   }
   if (events) {
     pc->new_os_events = events;
-    pc->current_arm = 0;
+    if (!(pc->current_arm & EPOLLET))
+      pc->current_arm = 0;
     events = 0;
   }
   if (sched_ready) schedule_done(&pc->task);
@@ -1174,6 +1543,13 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
     }
   }
 
+  if (pc->offloading) {
+    // The pool has the transport and will reschedule us.  Events wait in pc until then.
+    assert(!topup);
+    unlock(&pc->task.mutex);
+    return NULL;
+  }
+
   if (topup) {
     // Only called by the batch owner.  Does not loop, just "tops up"
     // once.  May be back depending on hog_count.
@@ -1185,6 +1561,7 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
       EPOLL_FATAL("internal epoll proactor error: two worker threads", 0);
     }
     pc->task.working = true;
+    pconnection_batch_start(pc);
   }
 
   // Confirmed as working thread.  Review state and unlock ASAP.
@@ -1217,9 +1594,15 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
 
   if (pc->new_os_events) {
     uint32_t update_events = pc->new_os_events;
-    pc->current_arm = 0;
+    if (!(pc->current_arm & EPOLLET))
+      pc->current_arm = 0;
     pc->new_os_events = 0;
     if (!pc->task.closing) {
+      if ((update_events & EPOLLERR) && pc->zerocopy_pending) {
+        // Completions are queued as socket errors.  A real error is still reported by the next read or write.
+        zerocopy_done = true;
+        update_events &= ~EPOLLERR;
+      }
       if ((update_events & (EPOLLHUP | EPOLLERR)) && !pconnection_rclosed(pc) && !pconnection_wclosed(pc))
         pconnection_maybe_connect_lh(pc);
       else
@@ -1243,6 +1626,11 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
   unlock(&pc->task.mutex);
   pc->hog_count++; // working task doing work
 
+  if (zerocopy_done) {
+    zerocopy_done = false;
+    pconnection_zerocopy_done(pc);
+  }
+
   if (waking) {
     pn_connection_t *c = pc->driver.connection;
     pn_collector_put_object(pn_connection_collector(c), c, PN_CONNECTION_WAKE);
@@ -1257,19 +1645,30 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
   if (!pconnection_rclosed(pc)) {
     pn_rwbytes_t rbuf = pn_connection_driver_read_buffer(&pc->driver);
     if (rbuf.size > 0 && !pc->read_blocked) {
-      ssize_t n = recv(pc->psocket.epoll_io.fd, rbuf.start, rbuf.size, 0);
+      size_t nread = 0;
+      ssize_t n = pconnection_recv(pc, rbuf.start, rbuf.size);
+      if (n > 0 && !topup && pconnection_offload_wanted(pc, n)) {
+        pc->batch_bytes += n;
+        pc->read_blocked = (size_t)n < rbuf.size;
+        pc->read_recent = pn_max((size_t)n, pc->read_recent / 4);
+        pconnection_offload(pc, n);  // Ticks the transport too
+        return NULL;
+      }
       if (n > 0) {
         pn_connection_driver_read_done(&pc->driver, n);
+        nread = n;
         // If n == rbuf.size then we should enlarge the buffer and see if there is more to read
         if ((size_t)n==rbuf.size) {
-          rbuf = pn_connection_driver_read_buffer_sized(&pc->driver, n*2);
+          rbuf = pn_connection_driver_read_buffer_sized(&pc->driver, n*READ_GROWTH);
           if (rbuf.size > 0) {
-            n = recv(pc->psocket.epoll_io.fd, rbuf.start, rbuf.size, 0);
+            n = pconnection_recv(pc, rbuf.start, rbuf.size);
             if (n > 0) {
               pn_connection_driver_read_done(&pc->driver, n);
+              nread += n;
             }
           }
         }
+        pc->batch_bytes += nread;
         // If we didn't read a full buffer (either in the first or second read) then we are blocked
         if ((size_t)n < rbuf.size && !pn_connection_driver_read_closed(&pc->driver)) {
           pc->read_blocked = true;
@@ -1290,6 +1689,7 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
           psocket_error(&pc->psocket, errno, pc->disconnected ? "disconnected" : "on read from");
         }
       }
+      pc->read_recent = pn_max(nread, pc->read_recent / 4);
     }
   } else {
     pc->read_blocked = true;
@@ -1312,6 +1712,7 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
   }
 
   write_flush(pc);
+  pconnection_buffer_trim(pc);
 
   lock(&pc->task.mutex);
   if (pc->task.closing && pconnection_is_final(pc)) {
@@ -1328,7 +1729,7 @@ static pn_event_batch_t *pconnection_process(pconnection_t *pc, uint32_t events,
 
   pc->task.working = false;
   pc->hog_count = 0;
-  if (pn_connection_driver_finished(&pc->driver)) {
+  if (pconnection_finished(pc)) {
     pconnection_begin_close(pc);
     if (pconnection_is_final(pc)) {
       unlock(&pc->task.mutex);
@@ -1383,7 +1784,7 @@ void pconnection_connected_lh(pconnection_t *pc) {
 
 /* multi-address connections may call pconnection_start multiple times with diffferent FDs  */
 static void pconnection_start(pconnection_t *pc, int fd) {
-  int efd = pc->task.proactor->epollfd;
+  pn_proactor_t *p = pc->task.proactor;
   /* Get the local socket name now, get the peer name in pconnection_connected */
   socklen_t len = sizeof(pc->local.ss);
   (void)getsockname(fd, (struct sockaddr*)&pc->local.ss, &len);
@@ -1391,12 +1792,17 @@ static void pconnection_start(pconnection_t *pc, int fd) {
   epoll_extended_t *ee = &pc->psocket.epoll_io;
   if (ee->polling) {     /* This is not the first attempt, stop polling and close the old FD */
     int fd = ee->fd;     /* Save fd, it will be set to -1 by stop_polling */
-    stop_polling(ee, efd);
-    pclosefd(pc->task.proactor, fd);
+    stop_polling(ee, p);
+    pclosefd(p, fd);
   }
   ee->fd = fd;
+#ifdef SO_BUSY_POLL
+  int busy_poll = __atomic_load_n(&p->socket_busy_poll_usec, __ATOMIC_RELAXED);
+  if (busy_poll)
+    (void)setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll));  // Best effort, may need privilege
+#endif
   pc->current_arm = ee->wanted = EPOLLIN | EPOLLOUT;
-  start_polling(ee, efd);  // TODO: check for error
+  start_polling(ee, p);  // TODO: check for error
 }
 
 /* Called on initial connect, and if connection fails to try another address */
@@ -1572,6 +1978,15 @@ void pn_connection_wake(pn_connection_t* c) {
   }
 }
 
+void pn_connection_set_sched_weight(pn_connection_t *c, unsigned weight) {
+  pconnection_t *pc = get_pconnection(c);
+  if (pc) {
+    lock(&pc->task.mutex);
+    pc->sched_weight = weight ? weight : 1;
+    unlock(&pc->task.mutex);
+  }
+}
+
 void pn_proactor_release_connection(pn_connection_t *c) {
   pconnection_t *pc = get_pconnection(c);
   if (pc) {
@@ -1612,6 +2027,10 @@ pn_listener_t *pn_listener(void) {
   return l;
 }
 
+void pn_listener_set_reuse_port(pn_listener_t *l, bool reuse) {
+  l->reuse_port = reuse;
+}
+
 void pn_proactor_listen(pn_proactor_t *p, pn_listener_t *l, const char *addr, int backlog)
 {
   // TODO: check listener not already listening for this or another proactor
@@ -1645,6 +2064,7 @@ void pn_proactor_listen(pn_proactor_t *p, pn_listener_t *l, const char *addr, in
       if (fd >= 0) {
         configure_socket(fd);
         if (!setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) &&
+            (!l->reuse_port || !setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on))) &&
             /* We listen to v4/v6 on separate sockets, don't let v6 listen for v4 */
             (ai->ai_family != AF_INET6 ||
              !setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on))) &&
@@ -1667,7 +2087,7 @@ void pn_proactor_listen(pn_proactor_t *p, pn_listener_t *l, const char *addr, in
           ps->epoll_io.fd = fd;
           ps->epoll_io.wanted = EPOLLIN;
           ps->epoll_io.polling = false;
-          start_polling(&ps->epoll_io, l->task.proactor->epollfd);  // TODO: check for error
+          start_polling(&ps->epoll_io, l->task.proactor);  // TODO: check for error
           l->active_count++;
           acceptor->armed = true;
         } else {
@@ -1747,7 +2167,7 @@ static void listener_begin_close(pn_listener_t* l) {
           shutdown(ps->epoll_io.fd, SHUT_RD);  // Force epoll event and callback
         } else {
           int fd = ps->epoll_io.fd;
-          stop_polling(&ps->epoll_io, l->task.proactor->epollfd);
+          stop_polling(&ps->epoll_io, l->task.proactor);
           close(fd);
           l->active_count--;
         }
@@ -1829,7 +2249,7 @@ static pn_event_batch_t *listener_process(pn_listener_t *l, int n_events, bool t
         if (l->task.closing) {
           l->acceptors[i].armed = false;
           int fd = ps->epoll_io.fd;
-          stop_polling(&ps->epoll_io, l->task.proactor->epollfd);
+          stop_polling(&ps->epoll_io, l->task.proactor);
           close(fd);
           l->active_count--;
         } else {
@@ -1961,9 +2381,14 @@ pn_record_t *pn_listener_attachments(pn_listener_t *l) {
 }
 
 void pn_listener_accept2(pn_listener_t *l, pn_connection_t *c, pn_transport_t *t) {
+  pn_proactor_accept(pn_listener_proactor(l), l, c, t);
+}
+
+/* The connection is served by proactor p, which need not be the listener's */
+void pn_proactor_accept(pn_proactor_t *p, pn_listener_t *l, pn_connection_t *c, pn_transport_t *t) {
   pconnection_t *pc = (pconnection_t*) malloc(sizeof(pconnection_t));
-  pn_proactor_t *p = pn_listener_proactor(l);
-  assert(pc && p); // TODO: memory safety
+  pn_proactor_t *lp = pn_listener_proactor(l);
+  assert(pc && p && lp); // TODO: memory safety
   const char *err = pconnection_setup(pc, p, c, t, true, "", 0);
   if (err) {
     PN_LOG_DEFAULT(PN_SUBSYSTEM_EVENT, PN_LEVEL_ERROR, "pn_listener_accept failure: %s", err);
@@ -1999,7 +2424,84 @@ void pn_listener_accept2(pn_listener_t *l, pn_connection_t *c, pn_transport_t *t
     notify = schedule(&l->task);
   unlock(&pc->task.mutex);
   unlock(&l->task.mutex);
-  if (notify) notify_poller(p);
+  if (notify) notify_poller(lp);
+}
+
+void pn_proactor_set_sched_limit(pn_proactor_t *p, pn_sched_limit_t limit, uint64_t value) {
+  if ((unsigned)limit < PNI_SCHED_LIMITS)
+    __atomic_store_n(&p->sched_limit[limit], value, __ATOMIC_RELAXED);
+}
+
+uint64_t pn_proactor_get_sched_limit(pn_proactor_t *p, pn_sched_limit_t limit) {
+  return ((unsigned)limit < PNI_SCHED_LIMITS) ? sched_limit(p, limit) : 0;
+}
+
+uint64_t pn_proactor_sched_limit_hits(pn_proactor_t *p, pn_sched_limit_t limit) {
+  return ((unsigned)limit < PNI_SCHED_LIMITS) ? __atomic_load_n(&p->sched_limit_hits[limit], __ATOMIC_RELAXED) : 0;
+}
+
+void pn_proactor_set_busy_poll(pn_proactor_t *p, unsigned usec) {
+  __atomic_store_n(&p->busy_poll_usec, usec, __ATOMIC_RELAXED);
+}
+
+unsigned pn_proactor_get_busy_poll(pn_proactor_t *p) {
+  return busy_poll_usec(p);
+}
+
+void pn_proactor_set_socket_busy_poll(pn_proactor_t *p, unsigned usec) {
+  __atomic_store_n(&p->socket_busy_poll_usec, usec, __ATOMIC_RELAXED);
+}
+
+static void *offload_thread(void *arg) {
+  pn_proactor_t *p = (pn_proactor_t *) arg;
+  lock(&p->offload_mutex);
+  while (!p->offload_stopping) {
+    pconnection_t *pc = p->offload_first;
+    if (!pc) {
+      pthread_cond_wait(&p->offload_cond, &p->offload_mutex);
+      continue;
+    }
+    p->offload_first = pc->offload_next;
+    if (!p->offload_first) p->offload_last = NULL;
+    unlock(&p->offload_mutex);
+    pconnection_offload_run(pc);
+    lock(&p->offload_mutex);
+  }
+  unlock(&p->offload_mutex);
+  return NULL;
+}
+
+// Connections still queued are left to pconnection_forced_shutdown()
+static void offload_stop(pn_proactor_t *p) {
+  lock(&p->offload_mutex);
+  p->offload_stopping = true;
+  pthread_cond_broadcast(&p->offload_cond);
+  unlock(&p->offload_mutex);
+  for (unsigned i = 0; i < p->offload_thread_count; ++i)
+    pthread_join(p->offload_threads[i], NULL);
+  free(p->offload_threads);
+  p->offload_threads = NULL;
+  p->offload_thread_count = 0;
+}
+
+void pn_proactor_set_crypto_offload(pn_proactor_t *p, unsigned threads, size_t threshold) {
+  lock(&p->offload_mutex);
+  if (threads > p->offload_thread_count && !p->offload_stopping) {
+    pthread_t *tv = (pthread_t *) realloc(p->offload_threads, threads * sizeof(pthread_t));
+    if (tv) {
+      p->offload_threads = tv;
+      while (p->offload_thread_count < threads &&
+             pthread_create(&tv[p->offload_thread_count], NULL, offload_thread, p) == 0)
+        ++p->offload_thread_count;
+    }
+  }
+  __atomic_store_n(&p->offload_threshold, threshold, __ATOMIC_RELAXED);
+  __atomic_store_n(&p->offload_enabled, threads && p->offload_thread_count, __ATOMIC_RELAXED);
+  unlock(&p->offload_mutex);
+}
+
+uint64_t pn_proactor_crypto_offloads(pn_proactor_t *p) {
+  return __atomic_load_n(&p->offloads, __ATOMIC_RELAXED);
 }
 
 
@@ -2033,7 +2535,7 @@ static void grow_poller_bufs(pn_proactor_t* p) {
 }
 
 /* Set up an epoll_extended_t to be used for ready list schedule() or interrupts */
- static void epoll_eventfd_init(epoll_extended_t *ee, int eventfd, int epollfd, bool always_set) {
+ static void epoll_eventfd_init(epoll_extended_t *ee, int eventfd, pn_proactor_t *p, bool always_set) {
   ee->fd = eventfd;
   ee->type = EVENT_FD;
   if (always_set) {
@@ -2046,34 +2548,65 @@ static void grow_poller_bufs(pn_proactor_t* p) {
     ee->wanted = EPOLLIN;
   }
   ee->polling = false;
-  start_polling(ee, epollfd);  // TODO: check for error
+  start_polling(ee, p);  // TODO: check for error
   if (always_set)
     ee->wanted = EPOLLIN;      // for all subsequent rearms
 }
 
+/* Poll with io_uring if built with it and the kernel supports it, else with epoll */
+static int poller_create(pn_proactor_t *p) {
+#ifdef PN_EPOLL_IO_URING
+  if (pni_use_uring && (p->uring = pni_uring(256)) != NULL)
+    return pni_uring_fd(p->uring);
+#endif
+  return epoll_create(1);
+}
+
+static void poller_close(pn_proactor_t *p) {
+#ifdef PN_EPOLL_IO_URING
+  if (p->uring) {
+    pni_uring_free(p->uring);   // Closes the fd
+    p->uring = NULL;
+    p->epollfd = -1;
+    return;
+  }
+#endif
+  if (p->epollfd >= 0) close(p->epollfd);
+  p->epollfd = -1;
+}
+
 pn_proactor_t *pn_proactor(void) {
   if (getenv("PNI_EPOLL_NOWARM")) pni_warm_sched = false;
   if (getenv("PNI_EPOLL_IMMEDIATE")) pni_immediate = true;
   if (getenv("PNI_EPOLL_SPINS")) pni_spins = atoi(getenv("PNI_EPOLL_SPINS"));
+#ifdef PN_EPOLL_IO_URING
+  if (getenv("PNI_EPOLL_NO_URING")) pni_use_uring = false;
+#endif
   pn_proactor_t *p = (pn_proactor_t*)calloc(1, sizeof(*p));
   if (!p) return NULL;
   p->epollfd = p->eventfd = -1;
+  p->sched_limit[PN_SCHED_REPLENISH] = HOG_MAX;
   task_init(&p->task, PROACTOR, p);
-  pmutex_init(&p->eventfd_mutex);
   pmutex_init(&p->sched_mutex);
   pmutex_init(&p->tslot_mutex);
   pmutex_init(&p->timeout_mutex);
-
-  if ((p->epollfd = epoll_create(1)) >= 0) {
+  pmutex_init(&p->offload_mutex);
+  pthread_cond_init(&p->offload_cond, NULL);
+  pmutex_init(&p->tls_pool_mutex);
+
+  if ((p->epollfd = poller_create(p)) >= 0) {
+    // Set PNI_EPOLL_EDGE to keep connected sockets armed edge triggered (io_uring polls are one-shot).
+    p->edge_triggered = getenv("PNI_EPOLL_EDGE") && !p->uring;
+    if (getenv("PNI_EPOLL_BUSY_POLL")) p->busy_poll_usec = atoi(getenv("PNI_EPOLL_BUSY_POLL"));
     if ((p->eventfd = eventfd(0, EFD_NONBLOCK)) >= 0) {
       if ((p->interruptfd = eventfd(0, EFD_NONBLOCK)) >= 0) {
         if (pni_timer_manager_init(&p->timer_manager)) {
           if (pni_name_lookup_init(&p->name_lookup, p)) {
             if ((p->collector = pn_collector()) != NULL) {
               p->batch.next_event = &proactor_batch_next;
-              start_polling(&p->timer_manager.epoll_timer, p->epollfd);  // TODO: check for error
-              epoll_eventfd_init(&p->epoll_schedule, p->eventfd, p->epollfd, true);
-              epoll_eventfd_init(&p->epoll_interrupt, p->interruptfd, p->epollfd, false);
+              start_polling(&p->timer_manager.epoll_timer, p);  // TODO: check for error
+              epoll_eventfd_init(&p->epoll_schedule, p->eventfd, p, true);
+              epoll_eventfd_init(&p->epoll_interrupt, p->interruptfd, p, false);
               p->tslot_map = pn_hash(PN_VOID, 0, 0.75);
               grow_poller_bufs(p);
               p->ready_list_generation = 1;
@@ -2084,15 +2617,17 @@ pn_proactor_t *pn_proactor(void) {
       }
     }
   }
-  if (p->epollfd >= 0) close(p->epollfd);
+  poller_close(p);
   if (p->eventfd >= 0) close(p->eventfd);
   if (p->interruptfd >= 0) close(p->interruptfd);
   pni_name_lookup_cleanup(&p->name_lookup, p);
   pni_timer_manager_finalize(&p->timer_manager);
+  pmutex_finalize(&p->tls_pool_mutex);
+  pthread_cond_destroy(&p->offload_cond);
+  pmutex_finalize(&p->offload_mutex);
   pmutex_finalize(&p->timeout_mutex);
   pmutex_finalize(&p->tslot_mutex);
   pmutex_finalize(&p->sched_mutex);
-  pmutex_finalize(&p->eventfd_mutex);
   if (p->collector) pn_free(p->collector);
   assert(p->thread_count == 0);
   free (p);
@@ -2101,9 +2636,9 @@ pn_proactor_t *pn_proactor(void) {
 
 void pn_proactor_free(pn_proactor_t *p) {
   //  No competing threads, not even a pending timer
+  offload_stop(p);   // Lets an offloaded step finish, it may still schedule its connection
   p->shutting_down = true;
-  close(p->epollfd);
-  p->epollfd = -1;
+  poller_close(p);
   close(p->eventfd);
   p->eventfd = -1;
   close(p->interruptfd);
@@ -2132,10 +2667,15 @@ void pn_proactor_free(pn_proactor_t *p) {
   pni_name_lookup_cleanup(&p->name_lookup, p);
   pni_timer_manager_finalize(&p->timer_manager);
   pn_collector_free(p->collector);
+#ifdef PN_EPOLL_TLS
+  pni_ptls_pool_free(p);  // After the connections have given their buffers back
+#endif
+  pmutex_finalize(&p->tls_pool_mutex);
+  pthread_cond_destroy(&p->offload_cond);
+  pmutex_finalize(&p->offload_mutex);
   pmutex_finalize(&p->timeout_mutex);
   pmutex_finalize(&p->tslot_mutex);
   pmutex_finalize(&p->sched_mutex);
-  pmutex_finalize(&p->eventfd_mutex);
   task_finalize(&p->task);
   for (pn_handle_t entry = pn_hash_head(p->tslot_map); entry; entry = pn_hash_next(p->tslot_map, entry)) {
     tslot_t *ts = (tslot_t *) pn_hash_value(p->tslot_map, entry);
@@ -2376,25 +2916,44 @@ static pn_event_batch_t *process(task_t *tsk) {
 }
 
 
-// Call with both sched_mutex and eventfd_mutex held
+// Call with sched_mutex held
 static void schedule_ready_list(pn_proactor_t *p) {
-  // Append ready_list_first..ready_list_last to end of sched_ready_last
+  // Take everything schedule() pushed and append it to the end of sched_ready_last.
+  // The poller is running, so leave the list marked awake.
   // May see several in single do_epoll() if EINTR.
-  if (p->ready_list_first) {
+  task_t *tsk = __atomic_exchange_n(&p->ready_list_head, READY_LIST_AWAKE, __ATOMIC_ACQUIRE);
+  task_t *first = NULL;
+  task_t *last = NULL;
+  unsigned int count = 0;
+  // Pushed newest first: reverse into arrival order.
+  while (tsk && tsk != READY_LIST_AWAKE) {
+    task_t *next = tsk->ready_next;
+    tsk->ready_next = first;
+    if (!first)
+      last = tsk;
+    first = tsk;
+    __atomic_store_n(&tsk->ready_generation, p->ready_list_generation, __ATOMIC_RELAXED);
+    count++;
+    tsk = next;
+  }
+  if (first) {
     if (p->sched_ready_last)
-      p->sched_ready_last->ready_next = p->ready_list_first;  // join them
+      p->sched_ready_last->ready_next = first;  // join them
     if (!p->sched_ready_first)
-      p->sched_ready_first = p->ready_list_first;
-    p->sched_ready_last = p->ready_list_last;
-    p->ready_list_first = p->ready_list_last = NULL;
+      p->sched_ready_first = first;
+    p->sched_ready_last = last;
 
     // Track sched_ready_count to know how many threads may be needed.
-    p->sched_ready_count += p->ready_list_count;
-    p->ready_list_count = 0;
+    p->sched_ready_count += count;
   }
 }
 
-// Call with schedule lock and eventfd lock held.  Called only by poller thread.
+static inline bool ready_list_pending(pn_proactor_t *p) {
+  task_t *head = __atomic_load_n(&p->ready_list_head, __ATOMIC_RELAXED);
+  return head && head != READY_LIST_AWAKE;
+}
+
+// Call with schedule lock held.  Called only by poller thread.
 // Needs to be quick.
 static task_t *post_event(pn_proactor_t *p, struct epoll_event *evp) {
   epoll_extended_t *ee = (epoll_extended_t *) evp->data.ptr;
@@ -2419,7 +2978,7 @@ static task_t *post_event(pn_proactor_t *p, struct epoll_event *evp) {
     pconnection_t *pc = psocket_pconnection(ps);
     assert(pc);
     tsk = &pc->task;
-    ps->sched_io_events = evp->events;
+    ps->sched_io_events |= evp->events;  // Edge triggered events may arrive before the last is taken
     tsk->sched_pending = true;
     break;
   }
@@ -2435,7 +2994,7 @@ static task_t *post_event(pn_proactor_t *p, struct epoll_event *evp) {
   case RAW_CONNECTION_IO: {
     psocket_t *ps = containerof(ee, psocket_t, epoll_io);
     tsk = pni_psocket_raw_task(ps);
-    ps->sched_io_events = evp->events;
+    ps->sched_io_events |= evp->events;
     tsk->sched_pending = true;
     break;
   }
@@ -2522,7 +3081,7 @@ static task_t *next_runnable(pn_proactor_t *p, tslot_t *ts) {
   // sched_ready list tasks deferred in poller_do_epoll()
   while (p->sched_ready_pending) {
     tsk = sched_ready_pop_front(p);
-    assert(tsk->ready); // eventfd_mutex required post ready set and pre move to sched_ready_list
+    assert(tsk->ready); // ready set before the push onto ready_list_head
     if (post_ready(p, tsk)) {
       assert(!tsk->runnables_idx && !tsk->runner);
       assign_thread(ts, tsk);
@@ -2632,26 +3191,45 @@ static bool poller_do_epoll(struct pn_proactor_t* p, tslot_t *ts, bool can_block
       unpolled_work = true;
     bool epoll_immediate = unpolled_work || !can_block;
 
-    // Determine if notify_poller() can be avoided.
-    if (!epoll_immediate) {
-      lock(&p->eventfd_mutex);
-      if (p->ready_list_first) {
-        unpolled_work = true;
-        epoll_immediate = true;
-      } else {
-        // Poller may sleep.  Enable eventfd wakeup.
-        p->ready_list_active = false;
+    // Busy poll before sleeping.  The ready list stays active meanwhile, so schedule() needs no eventfd wakeup.
+    bool spun = false;
+    unsigned busy_poll = epoll_immediate ? 0 : busy_poll_usec(p);
+    if (busy_poll) {
+      p->poll_generation++;
+      unlock(&p->sched_mutex);
+      int64_t until = now_usec() + busy_poll;
+      do {
+        n_events = poller_wait(p, false);
+        spun = n_events != 0 || ready_list_pending(p);
+      } while (!spun && now_usec() < until);
+      lock(&p->sched_mutex);
+      if (!spun)
+        p->posted_generation = p->poll_generation;
+    }
+
+    if (!spun) {
+      // Determine if notify_poller() can be avoided.
+      if (!epoll_immediate) {
+        // Poller may sleep if nothing is pending.  Enable eventfd wakeup.
+        task_t *awake = READY_LIST_AWAKE;
+        if (!__atomic_compare_exchange_n(&p->ready_list_head, &awake, NULL, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) &&
+            awake != NULL) {
+          unpolled_work = true;
+          epoll_immediate = true;
+        }
       }
-      unlock(&p->eventfd_mutex);
-    }
 
-    p->poller_suspended = !epoll_immediate;
-    unlock(&p->sched_mutex);
+      p->poller_suspended = !epoll_immediate;
+      p->poll_generation++;
+      unlock(&p->sched_mutex);
 
-    n_events = epoll_wait(p->epollfd, p->kevents, p->kevents_capacity, epoll_immediate ? 0 : -1);
+      n_events = poller_wait(p, !epoll_immediate);
 
-    lock(&p->sched_mutex);
-    p->poller_suspended = false;
+      lock(&p->sched_mutex);
+      p->poller_suspended = false;
+    }
+    if (n_events <= 0)
+      p->posted_generation = p->poll_generation;
 
     if (p->resched_first) {
       // Defer future resched tasks until next do_epoll()
@@ -2666,13 +3244,11 @@ static bool poller_do_epoll(struct pn_proactor_t* p, tslot_t *ts, bool can_block
       unpolled_work = true;
     }
     // Take stock of ready list before any post_event()
-    lock(&p->eventfd_mutex);
     schedule_ready_list(p);
     if (p->sched_ready_first)
       unpolled_work = true;
     if (++p->ready_list_generation == 0) // wrapping OK, but 0 means unset
       p->ready_list_generation = 1;
-    unlock(&p->eventfd_mutex);
 
     if (n_events < 0) {
       if (errno != EINTR) {
@@ -2686,7 +3262,7 @@ static bool poller_do_epoll(struct pn_proactor_t* p, tslot_t *ts, bool can_block
       if (!can_block && !unpolled_work)
         return true;
       else {
-        if (!epoll_immediate) {
+        if (!epoll_immediate && !spun) {
           perror("epoll_wait unexpected timeout"); // TODO: proper log
         }
         if (!unpolled_work)
@@ -2700,16 +3276,14 @@ static bool poller_do_epoll(struct pn_proactor_t* p, tslot_t *ts, bool can_block
   // We have unpolled work or at least one new epoll event.
   // Remember tasks that together constitute new work.  See note at beginning about duplicates.
 
-  lock(&p->eventfd_mutex);
-
-  // Longest hold of eventfd_mutex.  The following must be quick with no external calls:
+  // The following must be quick with no external calls:
   // post_event(), make_runnable(), assign_thread(), earmark_thread().
   for (int i = 0; i < n_events; i++) {
     tsk = post_event(p, &p->kevents[i]);
     if (tsk)
       make_runnable(tsk);
   }
-  unlock(&p->eventfd_mutex);
+  p->posted_generation = p->poll_generation;
 
   if (n_events > 0)
     memset(p->kevents, 0, sizeof(struct epoll_event) * n_events);
@@ -3052,6 +3626,23 @@ const pn_netaddr_t *pn_transport_remote_addr(pn_transport_t *t) {
   return pc ? &pc->remote : NULL;
 }
 
+int pn_transport_set_tls(pn_transport_t *t, struct pn_tls_config_t *config, const char *peer_hostname) {
+#ifdef PN_EPOLL_TLS
+  if (!t || !config) return PN_ARG_ERR;
+  pn_record_t *r = pn_transport_attachments(t);
+  pn_record_def(r, PNI_PTLS_CONFIG, PN_VOID);
+  pn_record_set(r, PNI_PTLS_CONFIG, config);
+  pn_string_t *host = peer_hostname ? pn_string(peer_hostname) : NULL;
+  pn_record_def(r, PNI_PTLS_HOSTNAME, PN_OBJECT);
+  pn_record_set(r, PNI_PTLS_HOSTNAME, host);
+  if (host) pn_decref(host);
+  return 0;
+#else
+  (void)t; (void)config; (void)peer_hostname;
+  return PN_ERR;  // Built without pn_tls
+#endif
+}
+
 const pn_netaddr_t *pn_listener_addr(pn_listener_t *l) {
   return l->acceptors_size > 0 ? &l->acceptors[0].addr : NULL;
 }
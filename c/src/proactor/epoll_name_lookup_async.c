@@ -244,7 +244,7 @@ bool pni_name_lookup_init(pname_lookup_t *nl, pn_proactor_t *p)
   nl->epoll_name_lookup.wanted = EPOLLIN;
   nl->epoll_name_lookup.polling = false;
   pmutex_init(&nl->epoll_name_lookup.barrier_mutex);
-  if (!start_polling(&nl->epoll_name_lookup, p->epollfd)) {
+  if (!start_polling(&nl->epoll_name_lookup, p)) {
     if (ctx->timerfd >= 0) {
       close(ctx->timerfd);
       ctx->timerfd = -1;
@@ -267,7 +267,7 @@ void pni_name_lookup_cleanup(pname_lookup_t *nl, pn_proactor_t *p)
   pni_nl_async_ctx_t *ctx = (pni_nl_async_ctx_t *)nl->impl;
   if (!ctx) return;
   if (nl->epoll_name_lookup.fd >= 0) {
-    stop_polling(&nl->epoll_name_lookup, p->epollfd);
+    stop_polling(&nl->epoll_name_lookup, p);
     if (ctx->timerfd >= 0) {
       close(ctx->timerfd);
       ctx->timerfd = -1;
@@ -393,5 +393,5 @@ void pni_name_lookup_process_events(pname_lookup_t *nl)
 #endif
   nl_update_ares_timer(nl);
   if (nl->epoll_name_lookup.polling)
-    rearm_polling(&nl->epoll_name_lookup, nl->task.proactor->epollfd);
+    rearm_polling(&nl->epoll_name_lookup, nl->task.proactor);
 }
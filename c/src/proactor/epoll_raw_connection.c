@@ -55,6 +55,7 @@ struct praw_connection_t {
   bool disconnected;
   bool hup_detected;
   bool read_check;
+  bool read_ready;                   /* Edge triggered: readable until recv() would block */
   bool first_schedule;
   bool name_lookup_pending;
   char *taddr;
@@ -92,7 +93,7 @@ static void praw_connection_connected_lh(praw_connection_t *prc) {
 
 /* multi-address connections may call pconnection_start multiple times with diffferent FDs  */
 static void praw_connection_start(praw_connection_t *prc, int fd) {
-  int efd = prc->task.proactor->epollfd;
+  pn_proactor_t *p = prc->task.proactor;
 
   /* Get the local socket name now, get the peer name in pconnection_connected */
   socklen_t len = sizeof(prc->local.ss);
@@ -101,13 +102,13 @@ static void praw_connection_start(praw_connection_t *prc, int fd) {
   epoll_extended_t *ee = &prc->psocket.epoll_io;
   if (ee->polling) {     /* This is not the first attempt, stop polling and close the old FD */
     int fd = ee->fd;     /* Save fd, it will be set to -1 by stop_polling */
-    stop_polling(ee, efd);
-    pclosefd(prc->task.proactor, fd);
+    stop_polling(ee, p);
+    pclosefd(p, fd);
   }
   ee->fd = fd;
   prc->current_arm = ee->wanted = EPOLLIN | EPOLLOUT;
   prc->armed = true;
-  start_polling(ee, efd);  // TODO: check for error
+  start_polling(ee, p);  // TODO: check for error
 }
 
 /* Called on initial connect, and if connection fails to try another address */
@@ -201,7 +202,7 @@ static void praw_connection_init(praw_connection_t *prc, pn_proactor_t *p, pn_ra
 
 static void praw_connection_cleanup(praw_connection_t *prc) {
   int fd = prc->psocket.epoll_io.fd;
-  stop_polling(&prc->psocket.epoll_io, prc->task.proactor->epollfd);
+  stop_polling(&prc->psocket.epoll_io, prc->task.proactor);
   if (fd != -1)
     pclosefd(prc->task.proactor, fd);
 
@@ -219,6 +220,19 @@ static void praw_connection_cleanup(praw_connection_t *prc) {
 }
 
 static void praw_initiate_cleanup(praw_connection_t *prc) {
+  if (prc->armed && (prc->current_arm & EPOLLET)) {
+    // Edge triggered: stay armed until the poller can no longer post an event for the socket.
+    pn_proactor_t *p = prc->task.proactor;
+    lock(&prc->task.mutex);
+    bool unpolled = psocket_edge_unpolled(&prc->psocket, p);
+    bool notify = !unpolled && schedule(&prc->task);
+    unlock(&prc->task.mutex);
+    if (!unpolled) {
+      if (notify) notify_poller(p);
+      return;
+    }
+    prc->armed = false;
+  }
   if (prc->armed) {
     // Possible race with epoll event.  Wait for it to clear.
     // Force EPOLLHUP callback if not already pending.
@@ -456,7 +470,7 @@ pn_event_batch_t *pni_raw_connection_process(task_t *t, uint32_t io_events, bool
     else
       pni_task_wake_done(&rc->task);  // Complete task wake without event.
   }
-  if (io_events) {
+  if (io_events && !(rc->current_arm & EPOLLET)) {
     rc->armed = false;
     rc->current_arm = 0;
   }
@@ -515,6 +529,19 @@ pn_event_batch_t *pni_raw_connection_process(task_t *t, uint32_t io_events, bool
     unlock(&rc->task.mutex);
     return &rc->batch;
   }
+  if ((rc->current_arm & EPOLLET) && !sched_ready && !task_wake && !(events & EPOLLERR)) {
+    // Edge triggered events can find nothing to do, e.g. writable with nothing to
+    // write.  Note any readiness that cannot be used yet and stay idle.
+    bool readable = (events & (EPOLLIN | EPOLLRDHUP)) || rc->read_ready || rc->read_check;
+    if (!(readable && pni_raw_can_read(&rc->raw_connection)) &&
+        !((events & EPOLLOUT) && pni_raw_can_write(&rc->raw_connection))) {
+      if (events & (EPOLLIN | EPOLLRDHUP)) rc->read_ready = true;
+      if (events & EPOLLHUP) rc->hup_detected = true;
+      t->working = false;
+      unlock(&rc->task.mutex);
+      return NULL;
+    }
+  }
   unlock(&rc->task.mutex);
 
   if (events & EPOLLERR) {
@@ -532,9 +559,11 @@ pn_event_batch_t *pni_raw_connection_process(task_t *t, uint32_t io_events, bool
     rc->hup_detected = true;
   }
 
-  if (events & (EPOLLIN | EPOLLRDHUP) || rc->read_check) {
+  if (events & (EPOLLIN | EPOLLRDHUP) || rc->read_check || rc->read_ready) {
     pni_raw_read(&rc->raw_connection, fd, rcv, set_error);
     rc->read_check = false;
+    // Reading stops at EWOULDBLOCK unless it runs out of buffers first
+    rc->read_ready = (rc->current_arm & EPOLLET) && !pni_raw_can_read(&rc->raw_connection);
   }
   if (events & EPOLLOUT) pni_raw_write(&rc->raw_connection, fd, snd, set_error);
   return &rc->batch;
@@ -560,7 +589,9 @@ void pni_raw_connection_done(praw_connection_t *rc) {
   rc->task.working = false;
   // The task may be in the ready state even if we've got no raw connection
   // wakes outstanding because we dealt with it already in pni_raw_batch_next()
-  notify = (wake_pending || have_event) && schedule(&rc->task);
+  // An edge triggered socket left readable for lack of buffers will not signal again.
+  bool read_pending = rc->read_ready && pni_raw_can_read(raw);
+  notify = (wake_pending || have_event || read_pending) && schedule(&rc->task);
   ready = rc->task.ready;  // No need to poll.  Already scheduled.
   bool praw_finished = pni_raw_finished(&rc->raw_connection) && !rc->name_lookup_pending;
   unlock(&rc->task.mutex);
@@ -573,9 +604,11 @@ void pni_raw_connection_done(praw_connection_t *rc) {
     rc->read_check = pni_raw_can_read(raw);
   } else if (!rc->connected) {
     // Connect logic has already armed the socket.
+  } else if (rc->current_arm & EPOLLET) {
+    // Edge triggered: armed once for good.
   } else {
     // Must poll for IO.
-    int wanted =
+    int wanted = p->edge_triggered ? (EPOLLIN | EPOLLRDHUP | EPOLLOUT | EPOLLET) :
       (pni_raw_can_read(raw)  ? (EPOLLIN | EPOLLRDHUP) : 0) |
       (pni_raw_can_write(raw) ? EPOLLOUT : 0);
 
@@ -587,7 +620,7 @@ void pni_raw_connection_done(praw_connection_t *rc) {
       if (!rc->armed || (wanted != rc->current_arm)) {
         rc->psocket.epoll_io.wanted = rc->current_arm = wanted;
         rc->armed = true;
-        rearm_polling(&rc->psocket.epoll_io, p->epollfd);  // TODO: check for error
+        rearm_polling(&rc->psocket.epoll_io, p);  // TODO: check for error
       }
     }
   }
@@ -32,23 +32,25 @@
  * Epoll proactor subsystem for timers.
  *
  * Two types of timers: (1) connection timers, one per connection, active if at least one of the peers has set a heartbeat,
- * timers move forward in time (but see replace_timer_deadline() note below), latency not critical; (2) a single proactor
- * timer, can move forwards or backwards, can be canceled.
+ * timers mostly move forward in time, latency not critical; (2) a single proactor timer, can move forwards or backwards,
+ * can be canceled.
  *
- * A single timerfd is shared by all the timers.  Connection timers are tracked on a heap ordered list.  The proactor timer is
- * tracked separately.  The next timerfd_deadline is the earliest of all the timers, in this case the earliest of the first
- * connection timer and the poactor timer.
+ * A single timerfd is shared by all the timers.  Connection timers are kept on a hierarchical timing wheel with millisecond
+ * ticks, so that setting, moving and cancelling one is a constant time list operation however many connections there are.
+ * The proactor timer is tracked separately.  The next timerfd_deadline is the earliest of the next tick the wheel needs
+ * attention and the proactor timer.
  *
- * If a connection timer is changed to a later time, it is not moved.  It is kept in place but marked with the new deadline.  On
- * expiry, depending on whether the deadline was extended, the decision is made to either generate a timeout or replace the
- * timer on the ordered list.
+ * The wheel has PNI_TIMER_WHEEL_LEVELS levels of PNI_TIMER_WHEEL_SLOTS slots, a slot on level L spanning SLOTS^L ticks.  A
+ * timer goes on the lowest level whose slots reach as far as its deadline: on level 0 its slot expires exactly at the
+ * deadline, on higher levels the slot is cascaded (its timers are re-placed on lower levels) when the wheel reaches the
+ * start of its span.  Deadlines beyond the top level wait in its furthest slot and are re-placed from there.  A bitmap of
+ * occupied slots per level finds the next tick that needs attention without stepping through empty ones.
  *
- * When a timerfd read event is generated, the proactor invokes pni_timer_manager_process() to generate timeouts for each
- * expired timer and to do housekeeping on the rest.
+ * If a connection timer is changed to a later time, it is not moved.  It is kept in place with the new deadline, and is
+ * re-placed instead of expired when its slot comes round.  Moving a timer earlier moves it straight away.
  *
- * replace_timer_deadline(): a connection timer can go backwards in time at most once if: both peers have heartbeats and the
- * second AMQP open frame results in a shorter periodic transport timer than the first open frame.  In this case, the
- * existing timer_deadline is immediately orphaned and a new one created for the rest of the connection's life.
+ * When a timerfd read event is generated, the proactor invokes pni_timer_manager_process() to advance the wheel, which
+ * moves expired timers to the due list, then hands the due connections to the scheduler a batch at a time.
  *
  * Lock ordering: tm->task_mutex --> tm->deletion_mutex.
  */
@@ -71,123 +73,194 @@ static void timerfd_drain(int fd) {
   }
 }
 
-// Struct to manage the ordering of timers on the heap ordered list and manage the lifecycle if
-// the parent timer is self-deleting.
-// This needs a Proton class definition to provide a custom compare() function.  It otherwise
-// remains private to this file and opts out of the general object machinery.
-// This works because the pn_list class is already meant to work with non-Proton objects using a
-// different compare operator (pn_void_compare).
-typedef struct timer_deadline_t {
-  uint64_t list_deadline;      // Heap ordering deadline.  Must not change while on list.
-  pni_timer_t *timer;          // Parent timer.  NULL means orphaned and to be deleted.
-  bool resequenced;            // An out-of-order connection timeout caught and handled.
-} timer_deadline_t;
-
-// The pn_list_t calls this to maintain its sorted heap.
-static intptr_t timer_deadline_compare(void *oa, void *ob) {
-  timer_deadline_t *a = (timer_deadline_t *) oa;
-  timer_deadline_t *b = (timer_deadline_t *) ob;
-  return a->list_deadline - b->list_deadline;
+struct pni_timer_t {
+  pni_timer_link_t link;     // On a wheel slot or the due list if link.next is set
+  uint64_t deadline;
+  uint64_t wheel_deadline;   // Deadline the timer was placed for, deadline may have moved later since
+  int level;                 // Wheel slot if on the wheel, level is -1 if on the due list
+  int slot;
+  pni_timer_manager_t *manager;
+  pconnection_t *connection;
+};
+
+// Connections handed to the scheduler per release of the timer_manager lock
+#define TIMER_BATCH 64
+
+static inline void timer_list_init(pni_timer_link_t *head) {
+  head->next = head->prev = head;
 }
 
-#define CID_timer_deadline CID_pn_void
-#define timer_deadline_new NULL
-#define timer_deadline_initialize NULL
-#define timer_deadline_incref pn_void_incref
-#define timer_deadline_decref pn_void_decref
-#define timer_deadline_refcount pn_void_refcount
-#define timer_deadline_finalize NULL
-#define timer_deadline_free NULL
-#define timer_deadline_hashcode NULL
-#define timer_deadline_inspect NULL
-
-static const pn_class_t timer_deadline_clazz = PN_METACLASS(timer_deadline);
-
-static timer_deadline_t* timer_deadline_t_new(void) {
-  // Just the struct.  Not a Proton class based object.
-  return (timer_deadline_t *) calloc(1, sizeof(timer_deadline_t));
+static inline bool timer_list_empty(pni_timer_link_t *head) {
+  return head->next == head;
 }
 
-static void timer_deadline_t_free(timer_deadline_t* td) {
-  assert(td->list_deadline == 0);
-  free(td);
+static inline void timer_list_append(pni_timer_link_t *head, pni_timer_link_t *l) {
+  l->prev = head->prev;
+  l->next = head;
+  head->prev->next = l;
+  head->prev = l;
 }
 
-struct pni_timer_t {
-  uint64_t deadline;
-  timer_deadline_t *timer_deadline;
-  pni_timer_manager_t *manager;
-  pconnection_t *connection;
-};
+// Move all of from onto the empty list to.
+static inline void timer_list_take(pni_timer_link_t *to, pni_timer_link_t *from) {
+  if (timer_list_empty(from)) {
+    timer_list_init(to);
+  } else {
+    *to = *from;
+    to->next->prev = to->prev->next = to;
+    timer_list_init(from);
+  }
+}
+
+static inline pni_timer_t *timer_list_first(pni_timer_link_t *head) {
+  return timer_list_empty(head) ? NULL : (pni_timer_t *) containerof(head->next, pni_timer_t, link);
+}
+
+static inline unsigned level_shift(int level) {
+  return level * PNI_TIMER_WHEEL_BITS;
+}
+
+// Call with timer_manager lock held.
+static void timer_unlink(pni_timer_manager_t *tm, pni_timer_t *timer) {
+  pni_timer_link_t *l = &timer->link;
+  l->prev->next = l->next;
+  l->next->prev = l->prev;
+  l->next = l->prev = NULL;
+  if (timer->level >= 0 && timer_list_empty(&tm->wheel[timer->level][timer->slot]))
+    tm->wheel_occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+}
+
+// Call with timer_manager lock held.  Place a timer that is on no list by its deadline, relative to the wheel's time.
+static void timer_place(pni_timer_manager_t *tm, pni_timer_t *timer) {
+  uint64_t deadline = timer->deadline;
+  uint64_t now = tm->wheel_time;
+  timer->wheel_deadline = deadline;
+  if (deadline <= now) {
+    timer->level = -1;
+    timer_list_append(&tm->due, &timer->link);
+    return;
+  }
+  // Lowest level with a slot for the deadline other than the current one.  Every lower level was too short, so it is ahead of
+  // the current slot on this one.
+  int level = 0;
+  while (level < PNI_TIMER_WHEEL_LEVELS && (deadline >> level_shift(level)) - (now >> level_shift(level)) >= PNI_TIMER_WHEEL_SLOTS)
+    ++level;
+  uint64_t slot_time = deadline;
+  if (level == PNI_TIMER_WHEEL_LEVELS) {
+    // Beyond the wheel: wait in the furthest slot of the top level.
+    level = PNI_TIMER_WHEEL_LEVELS - 1;
+    slot_time = ((now >> level_shift(level)) + PNI_TIMER_WHEEL_SLOTS - 1) << level_shift(level);
+  }
+  timer->level = level;
+  timer->slot = (slot_time >> level_shift(level)) & (PNI_TIMER_WHEEL_SLOTS - 1);
+  timer_list_append(&tm->wheel[level][timer->slot], &timer->link);
+  tm->wheel_occupied[level] |= (uint64_t)1 << timer->slot;
+}
+
+// Call with timer_manager lock held.  Next tick after wheel_time needing attention, 0 if the wheel is empty.
+static uint64_t wheel_next_tick(pni_timer_manager_t *tm) {
+  uint64_t next = 0;
+  for (int level = 0; level < PNI_TIMER_WHEEL_LEVELS; ++level) {
+    uint64_t occupied = tm->wheel_occupied[level];
+    if (!occupied) continue;
+    uint64_t span = tm->wheel_time >> level_shift(level);
+    // Rotate so bit 0 is the slot after the current one, the current one is never occupied.
+    unsigned after = (span + 1) & (PNI_TIMER_WHEEL_SLOTS - 1);
+    uint64_t rotated = after ? (occupied >> after) | (occupied << (PNI_TIMER_WHEEL_SLOTS - after)) : occupied;
+    uint64_t tick = (span + 1 + __builtin_ctzll(rotated)) << level_shift(level);
+    if (!next || tick < next) next = tick;
+  }
+  return next;
+}
+
+// Call with timer_manager lock held.  Move the wheel on to tick, cascading higher level slots that start there and
+// expiring the level 0 slot.
+static void wheel_tick(pni_timer_manager_t *tm, uint64_t tick) {
+  tm->wheel_time = tick;
+  for (int level = PNI_TIMER_WHEEL_LEVELS - 1; level >= 0; --level) {
+    if (tick & (((uint64_t)1 << level_shift(level)) - 1))
+      continue;  // Not the start of a slot on this level
+    int slot = (tick >> level_shift(level)) & (PNI_TIMER_WHEEL_SLOTS - 1);
+    if (!(tm->wheel_occupied[level] & ((uint64_t)1 << slot)))
+      continue;
+    tm->wheel_occupied[level] &= ~((uint64_t)1 << slot);
+    pni_timer_link_t timers;
+    timer_list_take(&timers, &tm->wheel[level][slot]);
+    pni_timer_t *timer;
+    while ((timer = timer_list_first(&timers))) {
+      pni_timer_link_t *l = &timer->link;
+      l->prev->next = l->next;
+      l->next->prev = l->prev;
+      timer_place(tm, timer);  // Due, or lower down
+    }
+  }
+}
+
+// Call with timer_manager lock held.  Expire the wheel's timers up to now onto the due list.
+static void wheel_advance(pni_timer_manager_t *tm, uint64_t now) {
+  while (tm->wheel_time < now) {
+    uint64_t tick = wheel_next_tick(tm);
+    if (!tick || tick > now) {
+      tm->wheel_time = now;
+      break;
+    }
+    wheel_tick(tm, tick);
+  }
+}
+
+static bool wheel_empty(pni_timer_manager_t *tm) {
+  for (int level = 0; level < PNI_TIMER_WHEEL_LEVELS; ++level)
+    if (tm->wheel_occupied[level]) return false;
+  return timer_list_empty(&tm->due);
+}
 
 pni_timer_t *pni_timer(pni_timer_manager_t *tm, pconnection_t *c) {
-  timer_deadline_t *td = NULL;
   pni_timer_t *timer = NULL;
   assert(c || !tm->task.proactor->timer);  // Proactor timer.  Can only be one.
-  timer = (pni_timer_t *) malloc(sizeof(pni_timer_t));
+  timer = (pni_timer_t *) calloc(1, sizeof(pni_timer_t));
   if (!timer) return NULL;
-  if (c) {
-    // Connections are tracked on the timer_heap.  Allocate the tracking struct.
-    td = timer_deadline_t_new();
-    if (!td) {
-      free(timer);
-      return NULL;
-    }
-  }
 
   lock(&tm->task.mutex);
   timer->connection = c;
   timer->manager = tm;
-  timer->timer_deadline = td;
   timer->deadline = 0;
-  if (c)
-    td->timer = timer;
   unlock(&tm->task.mutex);
   return timer;
 }
 
 // Call with no locks.
 void pni_timer_free(pni_timer_t *timer) {
-  timer_deadline_t *td = timer->timer_deadline;
-  bool can_free_td = false;
   bool notify = false;
-  if (td)
+  if (timer->connection)
     notify = pni_timer_set(timer, 0);
   pni_timer_manager_t *tm = timer->manager;
   lock(&tm->task.mutex);
-  lock(&tm->deletion_mutex);
-  if (td) {
-    if (td->list_deadline)
-      td->timer = NULL;  // Orphan.  timer_manager does eventual timer_deadline_t_free() in process().
-    else
-      can_free_td = true;
-  }
+  lock(&tm->deletion_mutex);  // Wait out any timeout being delivered to the connection.
+  if (timer->link.next)
+    timer_unlink(tm, timer);
   unlock(&tm->deletion_mutex);
   unlock(&tm->task.mutex);
   if (notify)
     notify_poller(tm->task.proactor);
-  if (can_free_td) {
-    timer_deadline_t_free(td);
-  }
   free(timer);
 }
 
-static timer_deadline_t *replace_timer_deadline(pni_timer_manager_t *tm, pni_timer_t *timer);
-
 // Return true if initialization succeeds.  Called once at proactor creation.
 bool pni_timer_manager_init(pni_timer_manager_t *tm) {
   tm->epoll_timer.fd = -1;
   tm->timerfd_deadline = 0;
-  tm->timers_heap = NULL;
   tm->proactor_timer = NULL;
   pn_proactor_t *p = containerof(tm, pn_proactor_t, timer_manager);
   task_init(&tm->task, TIMER_MANAGER, p);
   pmutex_init(&tm->deletion_mutex);
 
-  // Heap sorted pn_list_t using timer_deadline_compare() to determine ordering.
-  tm->timers_heap = pn_list(&timer_deadline_clazz, 0);
-  if (!tm->timers_heap)
-    return false;
+  for (int level = 0; level < PNI_TIMER_WHEEL_LEVELS; ++level) {
+    for (int slot = 0; slot < PNI_TIMER_WHEEL_SLOTS; ++slot)
+      timer_list_init(&tm->wheel[level][slot]);
+    tm->wheel_occupied[level] = 0;
+  }
+  timer_list_init(&tm->due);
+  tm->wheel_time = pn_proactor_now_64();
   tm->proactor_timer = pni_timer(tm, NULL);
   if (!tm->proactor_timer)
     return false;
@@ -206,17 +279,8 @@ void pni_timer_manager_finalize(pni_timer_manager_t *tm) {
   lock(&tm->task.mutex);
   unlock(&tm->task.mutex);  // Memory barrier
   if (tm->epoll_timer.fd >= 0) close(tm->epoll_timer.fd);
+  // Connection timers belong to their connections, which free them.
   pni_timer_free(tm->proactor_timer);
-  if (tm->timers_heap) {
-    size_t sz = pn_list_size(tm->timers_heap);
-    // On teardown there is no need to preserve the heap.  Traverse the list ignoring minpop().
-    for (size_t idx = 0; idx < sz; idx++) {
-      timer_deadline_t *td = (timer_deadline_t *) pn_list_get(tm->timers_heap, idx);
-      td->list_deadline = 0;
-      timer_deadline_t_free(td);
-    }
-    pn_free(tm->timers_heap);
-  }
   pmutex_finalize(&tm->deletion_mutex);
   task_finalize(&tm->task);
 }
@@ -228,12 +292,9 @@ static bool adjust_deadline(pni_timer_manager_t *tm) {
     return false;  // timer_manager task will adjust the timer when it stops working
   bool notify = false;
   uint64_t new_deadline = tm->proactor_timer->deadline;
-  if (pn_list_size(tm->timers_heap)) {
-    // First element of timers_heap has earliest deadline on the heap.
-    timer_deadline_t *heap0 = (timer_deadline_t *) pn_list_get(tm->timers_heap, 0);
-    assert(heap0->list_deadline != 0);
-    new_deadline = new_deadline ? pn_min(new_deadline, heap0->list_deadline) : heap0->list_deadline;
-  }
+  uint64_t wheel_deadline = timer_list_empty(&tm->due) ? wheel_next_tick(tm) : tm->wheel_time;
+  if (wheel_deadline)
+    new_deadline = new_deadline ? pn_min(new_deadline, wheel_deadline) : wheel_deadline;
   // Only change target deadline if new_deadline is in future but earlier than old timerfd_deadline.
   if (new_deadline) {
     if (tm->timerfd_deadline == 0 || new_deadline < tm->timerfd_deadline) {
@@ -265,29 +326,20 @@ bool pni_timer_set(pni_timer_t *timer, uint64_t deadline) {
     return false;  // No change.
   }
 
-  if (timer == tm->proactor_timer) {
-    assert(!timer->connection);
-    timer->deadline = deadline;
-  } else {
+  timer->deadline = deadline;
+  if (timer != tm->proactor_timer) {
     // Connection
-    timer_deadline_t *td = timer->timer_deadline;
-    // A connection timer can go backwards at most once.  Check here.
-    if (deadline && td->list_deadline && deadline < td->list_deadline) {
-      if (td->resequenced)
-        EPOLL_FATAL("idle timeout sequencing error", 0);  //
-      else {
-        // replace drops the lock for malloc.  Safe because there can be no competing call to
-        // the timer set function by the same pconnection from another thread.
-        td = replace_timer_deadline(tm, timer);
-      }
-    }
-
-    timer->deadline = deadline;
-    // Put on list if not already there.
-    if (deadline && !td->list_deadline) {
-      td->list_deadline = deadline;
-      pn_list_minpush(tm->timers_heap, td);
+    if (!deadline) {
+      if (timer->link.next)
+        timer_unlink(tm, timer);
+    } else if (!timer->link.next || deadline < timer->wheel_deadline) {
+      if (timer->link.next)
+        timer_unlink(tm, timer);
+      else if (!tm->task.working && wheel_empty(tm))
+        tm->wheel_time = pn_max(tm->wheel_time, (uint64_t) pn_proactor_now_64());  // Nothing to expire, catch up for free.
+      timer_place(tm, timer);
     }
+    // Otherwise a later deadline: left in place until its slot comes round.
   }
 
   // Skip a cancelled timer (deadline == 0) since it doesn't change the timerfd deadline.
@@ -300,8 +352,10 @@ bool pni_timer_set(pni_timer_t *timer, uint64_t deadline) {
 
 pn_event_batch_t *pni_timer_manager_process(pni_timer_manager_t *tm, bool timeout, bool sched_ready) {
   uint64_t now = pn_proactor_now_64();
+  bool notify = false;
   lock(&tm->task.mutex);
   tm->task.working = true;
+  now = pn_max(now, tm->wheel_time);  // The wheel may have been moved on since now was read
   if (timeout)
     tm->timerfd_deadline = 0;
   if (sched_ready)
@@ -318,51 +372,38 @@ pn_event_batch_t *pni_timer_manager_process(pni_timer_manager_t *tm, bool timeou
     // here with the event batch, and schedule the timer manager task to process the connection timers.
   }
 
-  // Next, find all expired connection timers at front of the ordered heap.
-  while (pn_list_size(tm->timers_heap)) {
-    timer_deadline_t *td = (timer_deadline_t *) pn_list_get(tm->timers_heap, 0);
-    if (td->list_deadline > now)
-      break;
-
-    // Expired. Remove from list.
-    timer_deadline_t *min = (timer_deadline_t *) pn_list_minpop(tm->timers_heap);
-    assert (min == td);
-    min->list_deadline = 0;
-
-    // Three possibilities to act on:
-    //   timer expired -> pni_connection_timeout()
-    //   timer deadline extended -> minpush back on list to new spot
-    //   timer freed -> free the associated timer_deadline popped off the list
-    if (!td->timer) {
+  // Next, expire the connection timers and hand them to their connections in batches.
+  wheel_advance(tm, now);
+  while (!timer_list_empty(&tm->due)) {
+    pconnection_t *batch[TIMER_BATCH];
+    size_t n = 0;
+    pni_timer_t *timer;
+    while (n < TIMER_BATCH && (timer = timer_list_first(&tm->due))) {
+      timer_unlink(tm, timer);
+      if (timer->deadline > now) {
+        timer_place(tm, timer);  // Moved later since it was placed
+      } else {
+        timer->deadline = 0;
+        batch[n++] = timer->connection;
+      }
+    }
+    if (n) {
+      lock(&tm->deletion_mutex);     // Prevent connections from deleting themselves when tm->task.mutex dropped.
       unlock(&tm->task.mutex);
-      timer_deadline_t_free(td);
+      for (size_t i = 0; i < n; ++i)
+        notify |= pni_pconnection_timeout(batch[i], now);
+      unlock(&tm->deletion_mutex);
       lock(&tm->task.mutex);
-    } else {
-      uint64_t deadline = td->timer->deadline;
-      if (deadline) {
-        if (deadline <= now) {
-          td->timer->deadline = 0;
-          pconnection_t *pc = td->timer->connection;
-          lock(&tm->deletion_mutex);     // Prevent connection from deleting itself when tm->task.mutex dropped.
-          unlock(&tm->task.mutex);
-          pni_pconnection_timeout(pc);
-          unlock(&tm->deletion_mutex);
-          lock(&tm->task.mutex);
-        } else {
-          td->list_deadline = deadline;
-          pn_list_minpush(tm->timers_heap, td);
-        }
-      }
     }
   }
 
   if (timeout) {
     // TODO: query whether perf gain by doing these system calls outside the lock, perhaps with additional set_reset_mutex.
     timerfd_drain(tm->epoll_timer.fd);
-    rearm_polling(&tm->epoll_timer, tm->task.proactor->epollfd);
+    rearm_polling(&tm->epoll_timer, tm->task.proactor);
   }
   tm->task.working = false;  // must be false for adjust_deadline to do adjustment
-  bool notify = adjust_deadline(tm);
+  notify |= adjust_deadline(tm);
   unlock(&tm->task.mutex);
 
   if (notify)
@@ -371,26 +412,3 @@ pn_event_batch_t *pni_timer_manager_process(pni_timer_manager_t *tm, bool timeou
   return NULL;
   // TODO: perhaps become task of one of the timed out timers (if otherwise idle) and process() that task.
 }
-
-// Call with timer_manager lock held.
-// There can be no competing call to this and timer_set() from the same connection.
-static timer_deadline_t *replace_timer_deadline(pni_timer_manager_t *tm, pni_timer_t *timer) {
-  assert(timer->connection);
-  timer_deadline_t *old_td = timer->timer_deadline;
-  assert(old_td);
-  // Mark old struct for deletion.  No parent timer.
-  old_td->timer = NULL;
-
-  unlock(&tm->task.mutex);
-  // Create replacement timer for life of connection.
-  timer_deadline_t *new_td = timer_deadline_t_new();
-  if (!new_td)
-    EPOLL_FATAL("replacement timer deadline allocation", errno);
-  lock(&tm->task.mutex);
-
-  new_td->list_deadline = 0;
-  new_td->timer = timer;
-  new_td->resequenced = true;
-  timer->timer_deadline = new_td;
-  return new_td;
-}
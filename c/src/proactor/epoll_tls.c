@@ -0,0 +1,314 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "epoll-internal.h"
+#include "core/util.h"
+
+#include <proton/raw_connection.h>
+#include <proton/tls.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+/*
+ * AMQP connections of the epoll proactor secured with pn_tls instead of the
+ * transport's own SSL layer, see pn_transport_set_tls().
+ *
+ * The transport never sees ciphertext.  Its read buffer is handed to pn_tls as
+ * the decrypt output buffer, so records are decrypted straight into it, and its
+ * pending output segments (including referenced message payloads) are handed
+ * to pn_tls as encrypt input.  Ciphertext only ever lives in fixed size wire
+ * buffers from a pool owned by the proactor: one per recv(), returned as soon
+ * as pn_tls has consumed it, and a few per connection holding encrypted output
+ * until the socket has taken it.
+ *
+ * Transport memory is never left inside pn_tls between calls: the read buffer
+ * is only given when decrypted bytes are ready and taken back straight away,
+ * and no more output is given than the blank wire buffers can hold.
+ */
+
+#define PTLS_BUFFER_SIZE (32*1024)   /* Wire buffer size */
+#define PTLS_RECORD_MAX (16*1024)    /* Largest TLS record payload */
+#define PTLS_WIRE_MAX 4              /* Wire buffers of output per write */
+#define PTLS_WIRE_SLOTS (2*PTLS_WIRE_MAX)
+#define PTLS_SEGMENTS 16             /* Transport output segments per write */
+#define PTLS_INPUT_MAX 4             /* Wire buffers of input inside pn_tls */
+#define PTLS_POOL_MAX 256            /* Idle wire buffers kept by the proactor */
+
+struct pni_ptls_t {
+  pn_proactor_t *proactor;
+  pn_tls_t *tls;
+  pn_raw_buffer_t wire[PTLS_WIRE_SLOTS];  /* Encrypted output being sent */
+  size_t wire_count;
+  size_t blanks;                          /* Empty wire buffers given to pn_tls */
+  bool output_closed;
+  bool abandoned;
+  bool failed;
+};
+
+// ========================================================================
+// Wire buffer pool, shared by all the proactor's TLS connections.
+// Idle buffers are linked through their first bytes.
+// ========================================================================
+
+static char *pool_get(pn_proactor_t *p) {
+  lock(&p->tls_pool_mutex);
+  char *b = (char *)p->tls_pool;
+  if (b) {
+    memcpy(&p->tls_pool, b, sizeof(void *));
+    p->tls_pool_count--;
+  }
+  unlock(&p->tls_pool_mutex);
+  return b ? b : (char *)malloc(PTLS_BUFFER_SIZE);
+}
+
+static void pool_put(pn_proactor_t *p, char *b) {
+  lock(&p->tls_pool_mutex);
+  if (p->tls_pool_count < PTLS_POOL_MAX) {
+    memcpy(b, &p->tls_pool, sizeof(void *));
+    p->tls_pool = b;
+    p->tls_pool_count++;
+    b = NULL;
+  }
+  unlock(&p->tls_pool_mutex);
+  free(b);
+}
+
+void pni_ptls_pool_free(pn_proactor_t *p) {
+  while (p->tls_pool) {
+    char *b = (char *)p->tls_pool;
+    memcpy(&p->tls_pool, b, sizeof(void *));
+    free(b);
+  }
+  p->tls_pool_count = 0;
+}
+
+static void pool_put_raw(pn_proactor_t *p, pn_raw_buffer_t *bufs, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    pool_put(p, bufs[i].bytes);
+}
+
+// ========================================================================
+// pni_ptls_t
+// ========================================================================
+
+pni_ptls_t *pni_ptls(pn_proactor_t *p, pn_tls_config_t *config, const char *peer_hostname) {
+  pni_ptls_t *pt = (pni_ptls_t *)calloc(1, sizeof(*pt));
+  if (!pt) return NULL;
+  pt->proactor = p;
+  if (!(pt->tls = pn_tls(config))) {
+    free(pt);
+    return NULL;
+  }
+  pn_tls_set_encrypt_input_buffer_max_capacity(pt->tls, PTLS_SEGMENTS);
+  pn_tls_set_encrypt_output_buffer_max_capacity(pt->tls, PTLS_WIRE_SLOTS);
+  pn_tls_set_decrypt_input_buffer_max_capacity(pt->tls, PTLS_INPUT_MAX);
+  pn_tls_set_decrypt_output_buffer_max_capacity(pt->tls, 1);
+  if ((peer_hostname && pn_tls_set_peer_hostname(pt->tls, peer_hostname) != 0) ||
+      pn_tls_start(pt->tls) != 0) {
+    pn_tls_free(pt->tls);
+    free(pt);
+    return NULL;
+  }
+  return pt;
+}
+
+static void ptls_release_wire(pni_ptls_t *pt) {
+  pool_put_raw(pt->proactor, pt->wire, pt->wire_count);
+  pt->wire_count = 0;
+}
+
+void pni_ptls_free(pni_ptls_t *pt) {
+  if (!pt) return;
+  pn_tls_t *tls = pt->tls;
+  pn_tls_stop(tls);  // Releases every buffer still inside
+  pn_raw_buffer_t bufs[PTLS_WIRE_SLOTS];
+  size_t n;
+  while ((n = pn_tls_take_encrypt_output_buffers(tls, bufs, PTLS_WIRE_SLOTS)))
+    pool_put_raw(pt->proactor, bufs, n);
+  while ((n = pn_tls_take_decrypt_input_buffers(tls, bufs, PTLS_WIRE_SLOTS)))
+    pool_put_raw(pt->proactor, bufs, n);
+  // Transport memory: nothing to give back
+  while (pn_tls_take_encrypt_input_buffers(tls, bufs, PTLS_WIRE_SLOTS));
+  while (pn_tls_take_decrypt_output_buffers(tls, bufs, PTLS_WIRE_SLOTS));
+  ptls_release_wire(pt);
+  pn_tls_free(tls);
+  free(pt);
+}
+
+void pni_ptls_abandon(pni_ptls_t *pt) {
+  pt->abandoned = true;
+}
+
+bool pni_ptls_write_closed(pni_ptls_t *pt) {
+  return pt->abandoned || (pt->output_closed && !pn_tls_is_encrypt_output_pending(pt->tls));
+}
+
+// Report a TLS session error on the transport, once.
+static void ptls_fail(pni_ptls_t *pt, pn_connection_driver_t *driver) {
+  if (pt->failed) return;
+  pt->failed = true;
+  char msg[256] = "";
+  pn_tls_get_session_error_string(pt->tls, msg, sizeof(msg));
+  pn_connection_driver_errorf(driver, "amqp:connection:framing-error", "TLS failure: %s",
+                              *msg ? msg : "session error");
+}
+
+static void ptls_recycle_input(pni_ptls_t *pt) {
+  pn_raw_buffer_t bufs[PTLS_INPUT_MAX];
+  size_t n;
+  while ((n = pn_tls_take_decrypt_input_buffers(pt->tls, bufs, PTLS_INPUT_MAX)))
+    pool_put_raw(pt->proactor, bufs, n);
+}
+
+ssize_t pni_ptls_recv(pni_ptls_t *pt, pn_connection_driver_t *driver, int fd, char *buf, size_t size) {
+  pn_tls_t *tls = pt->tls;
+  size_t n = 0;
+  bool eof = false;
+  int err = EAGAIN;
+  while (!pt->failed) {
+    // Decrypt straight into the transport's read buffer
+    while (n < size && pn_tls_need_decrypt_output_buffers(tls)) {
+      pn_raw_buffer_t out = {.bytes = buf, .capacity = size, .offset = n};
+      pn_tls_give_decrypt_output_buffers(tls, &out, 1);
+      int e = pn_tls_process(tls);
+      if (pn_tls_take_decrypt_output_buffers(tls, &out, 1))
+        n += out.size;
+      if (e) break;
+    }
+    if (pn_tls_get_session_error(tls)) {
+      ptls_fail(pt, driver);
+      break;
+    }
+    if (n == size || pn_tls_is_input_closed(tls) || !pn_tls_get_decrypt_input_buffer_capacity(tls))
+      break;
+
+    char *wire = pool_get(pt->proactor);
+    if (!wire) {
+      err = ENOMEM;
+      break;
+    }
+    ssize_t r = recv(fd, wire, PTLS_BUFFER_SIZE, 0);
+    if (r <= 0) {
+      pool_put(pt->proactor, wire);
+      if (r == 0) eof = true;
+      else err = errno;
+      break;
+    }
+    pn_raw_buffer_t in = {.bytes = wire, .capacity = PTLS_BUFFER_SIZE, .size = r};
+    pn_tls_give_decrypt_input_buffers(tls, &in, 1);
+    pn_tls_process(tls);  // Errors are picked up above
+    ptls_recycle_input(pt);
+  }
+  if (n) return n;
+  if (eof || pt->failed || pn_tls_is_input_closed(tls)) return 0;
+  errno = err;
+  return -1;
+}
+
+// Give pn_tls blank wire buffers up to limit in total.
+static void ptls_give_blanks(pni_ptls_t *pt, size_t limit) {
+  while (pt->blanks + pt->wire_count < limit && pn_tls_get_encrypt_output_buffer_capacity(pt->tls)) {
+    char *b = pool_get(pt->proactor);
+    if (!b) return;
+    pn_raw_buffer_t blank = {.bytes = b, .capacity = PTLS_BUFFER_SIZE};
+    pn_tls_give_encrypt_output_buffers(pt->tls, &blank, 1);
+    pt->blanks++;
+  }
+}
+
+// Drop transport output that can no longer be sent.
+static void ptls_discard_output(pn_connection_driver_t *driver) {
+  pn_bytes_t segs[PTLS_SEGMENTS];
+  size_t n;
+  while ((n = pn_connection_driver_write_buffers(driver, segs, PTLS_SEGMENTS))) {
+    size_t size = 0;
+    for (size_t i = 0; i < n; ++i) size += segs[i].size;
+    pn_connection_driver_write_done(driver, size);
+  }
+}
+
+size_t pni_ptls_encrypt(pni_ptls_t *pt, pn_connection_driver_t *driver, struct iovec *iov, size_t max) {
+  pn_tls_t *tls = pt->tls;
+  ptls_release_wire(pt);  // Sent by now
+
+  pn_raw_buffer_t in[PTLS_SEGMENTS];
+  size_t given = 0;
+  if (pt->failed || (!pn_tls_is_secure(tls) && pn_connection_driver_read_closed(driver))) {
+    ptls_discard_output(driver);
+  } else if (pn_tls_is_secure(tls) && !pt->output_closed) {
+    // Encrypt no more than the wire buffers are sure to hold
+    pn_bytes_t segs[PTLS_SEGMENTS];
+    size_t n = pn_connection_driver_write_buffers(driver, segs, PTLS_SEGMENTS);
+    size_t budget = PTLS_WIRE_MAX * PTLS_RECORD_MAX;
+    for (size_t i = 0; i < n && budget; ++i) {
+      size_t s = pn_min(segs[i].size, budget);
+      in[given++] = (pn_raw_buffer_t){.bytes = (char *)segs[i].start, .capacity = s, .size = s};
+      budget -= s;
+    }
+    pn_tls_give_encrypt_input_buffers(tls, in, given);
+  }
+  if (!pt->output_closed && pn_connection_driver_write_closed(driver)) {
+    pn_tls_close_output(tls);
+    pt->output_closed = true;
+  }
+
+  size_t taken = 0;
+  size_t consumed = 0;
+  for (;;) {
+    ptls_give_blanks(pt, taken < given ? PTLS_WIRE_SLOTS : PTLS_WIRE_MAX);
+    int err = pn_tls_process(tls);
+    bool progress = false;
+    size_t n = pn_tls_take_encrypt_output_buffers(tls, &pt->wire[pt->wire_count], PTLS_WIRE_SLOTS - pt->wire_count);
+    if (n) {
+      pt->wire_count += n;
+      pt->blanks -= n;
+      progress = true;
+    }
+    while ((n = pn_tls_take_encrypt_input_buffers(tls, in, PTLS_SEGMENTS))) {
+      for (size_t i = 0; i < n; ++i) consumed += in[i].size;
+      taken += n;
+      progress = true;
+    }
+    if (err) {
+      ptls_fail(pt, driver);
+      break;
+    }
+    if (!progress || (taken == given && !pn_tls_need_encrypt_output_buffers(tls)))
+      break;
+  }
+  if (taken < given) {
+    // Never expected: stop rather than leave the transport's memory inside pn_tls
+    pn_tls_stop(tls);
+    ptls_fail(pt, driver);
+    while (pn_tls_take_encrypt_input_buffers(tls, in, PTLS_SEGMENTS)) {}
+  }
+  if (consumed)
+    pn_connection_driver_write_done(driver, consumed);
+
+  size_t count = pn_min(pt->wire_count, max);
+  for (size_t i = 0; i < count; ++i) {
+    iov[i].iov_base = pt->wire[i].bytes + pt->wire[i].offset;
+    iov[i].iov_len = pt->wire[i].size;
+  }
+  return count;
+}
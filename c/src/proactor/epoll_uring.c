@@ -0,0 +1,413 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+/* syscall() needs more than POSIX: include the system headers before epoll-internal.h
+   restricts the feature set */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "epoll-internal.h"
+
+/*
+ * io_uring poller for the epoll proactor.
+ *
+ * The proactor arms each fd as a one-shot poll and rearms it after every event, which with
+ * epoll costs an epoll_ctl() system call per rearm.  Here each arm is an IORING_OP_POLL_ADD
+ * request queued on the submission ring instead.  Arms made while the poller thread is busy
+ * are left queued and submitted by the poller together with its next wait, in a single
+ * io_uring_enter().  Arms made while the poller is blocked in the kernel must wake it, so
+ * they are submitted straight away.
+ *
+ * Poll requests are identified by a slot per polled epoll_extended_t and a generation
+ * that changes on every arm, so completions of stale or cancelled requests are ignored
+ * without ever dereferencing their (possibly freed) epoll_extended_t.
+ *
+ * io_uring polls always report EPOLLRDHUP, wanted or not, whereas the proactor relies on
+ * an arm without EPOLLIN or EPOLLRDHUP waiting for nothing but errors and hangups (and
+ * wakes).  Such arms go to a small inner epoll set instead, itself polled on the ring.
+ *
+ * Only the poller thread reaps completions.  Any thread may queue submissions; the slot
+ * table and the submission ring tail are protected by the uring mutex.
+ */
+
+#define URING_IGNORE UINT64_MAX   /* user_data of requests with no interesting completion */
+#define URING_EPOLL (UINT64_MAX - 1) /* user_data of the poll on the inner epoll fd */
+#define URING_CQ_ENTRIES 4096
+
+typedef struct uring_slot_t {
+  epoll_extended_t *ee;
+  uint32_t generation;
+  uint32_t next_free;   /* 1 + index of the next free slot, 0 for none */
+  bool armed;           /* poll request submitted and not yet completed or removed */
+  bool in_epoll;        /* registered in the inner epoll set */
+} uring_slot_t;
+
+struct pni_uring_t {
+  int fd;
+  int epollfd;          /* inner epoll set */
+  pmutex mutex;
+  bool poller_waiting;
+
+  /* submission ring */
+  void *sq_ptr;
+  size_t sq_size;
+  unsigned *sq_khead;
+  unsigned *sq_ktail;
+  unsigned *sq_kflags;
+  unsigned sq_mask;
+  unsigned sq_entries;
+  unsigned sq_tail;     /* local copy of the tail, published on every queued request */
+  struct io_uring_sqe *sqes;
+  size_t sqes_size;
+
+  /* completion ring */
+  void *cq_ptr;
+  size_t cq_size;
+  unsigned *cq_khead;
+  unsigned *cq_ktail;
+  unsigned cq_mask;
+  struct io_uring_cqe *cqes;
+
+  uring_slot_t *slots;
+  uint32_t slots_capacity;
+  uint32_t free_slot;   /* 1 + index of the first free slot, 0 for none */
+};
+
+static int uring_setup(unsigned entries, struct io_uring_params *params) {
+  return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static void uring_queue(pni_uring_t *u, uint8_t opcode, int fd, uint32_t events, uint64_t addr, uint64_t user_data);
+
+static inline uint64_t slot_user_data(uint32_t index, uint32_t generation) {
+  return ((uint64_t) index << 32) | generation;
+}
+
+pni_uring_t *pni_uring(unsigned entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = URING_CQ_ENTRIES;
+  int fd = uring_setup(entries, &params);
+  if (fd < 0) return NULL;
+  // NODROP: completions are never lost.  POLL_32BITS: EPOLLRDHUP and friends fit.
+  // NATIVE_WORKERS: poll requests outlive the (proactor) thread that submitted them.
+  const uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_POLL_32BITS |
+    IORING_FEAT_NATIVE_WORKERS;
+  if ((params.features & required) != required) {
+    close(fd);
+    return NULL;
+  }
+
+  pni_uring_t *u = (pni_uring_t *) calloc(1, sizeof(*u));
+  if (!u) {
+    close(fd);
+    return NULL;
+  }
+  u->fd = fd;
+  u->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  u->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (u->cq_size > u->sq_size) u->sq_size = u->cq_size;
+  u->sq_ptr = mmap(NULL, u->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  u->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  u->sqes = (struct io_uring_sqe *) mmap(NULL, u->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                         fd, IORING_OFF_SQES);
+  if (u->sq_ptr == MAP_FAILED || u->sqes == MAP_FAILED) {
+    if (u->sq_ptr != MAP_FAILED) munmap(u->sq_ptr, u->sq_size);
+    if (u->sqes != MAP_FAILED) munmap(u->sqes, u->sqes_size);
+    close(fd);
+    free(u);
+    return NULL;
+  }
+  u->cq_ptr = u->sq_ptr;   // IORING_FEAT_SINGLE_MMAP
+
+  char *sq = (char *) u->sq_ptr;
+  u->sq_khead = (unsigned *) (sq + params.sq_off.head);
+  u->sq_ktail = (unsigned *) (sq + params.sq_off.tail);
+  u->sq_kflags = (unsigned *) (sq + params.sq_off.flags);
+  u->sq_mask = *(unsigned *) (sq + params.sq_off.ring_mask);
+  u->sq_entries = *(unsigned *) (sq + params.sq_off.ring_entries);
+  u->sq_tail = *u->sq_ktail;
+  // Submission entries are always used in ring order
+  unsigned *array = (unsigned *) (sq + params.sq_off.array);
+  for (unsigned i = 0; i < u->sq_entries; i++)
+    array[i] = i;
+
+  char *cq = (char *) u->cq_ptr;
+  u->cq_khead = (unsigned *) (cq + params.cq_off.head);
+  u->cq_ktail = (unsigned *) (cq + params.cq_off.tail);
+  u->cq_mask = *(unsigned *) (cq + params.cq_off.ring_mask);
+  u->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+
+  pmutex_init(&u->mutex);
+  u->epollfd = epoll_create(1);
+  if (u->epollfd < 0) {
+    pni_uring_free(u);
+    return NULL;
+  }
+  uring_queue(u, IORING_OP_POLL_ADD, u->epollfd, EPOLLIN, 0, URING_EPOLL);
+  return u;
+}
+
+void pni_uring_free(pni_uring_t *u) {
+  if (!u) return;
+  munmap(u->sqes, u->sqes_size);
+  munmap(u->sq_ptr, u->sq_size);
+  if (u->fd >= 0) close(u->fd);
+  if (u->epollfd >= 0) close(u->epollfd);
+  pmutex_finalize(&u->mutex);
+  free(u->slots);
+  free(u);
+}
+
+int pni_uring_fd(pni_uring_t *u) {
+  return u->fd;
+}
+
+// Submit everything queued so far.  The kernel caps to_submit at what is actually on the
+// ring, so concurrent submitters never need to agree on who submits which request.
+// Called with or without the mutex held.
+static int uring_submit(pni_uring_t *u, unsigned min_complete, unsigned flags) {
+  return uring_enter(u->fd, u->sq_entries, min_complete, flags);
+}
+
+static unsigned uring_sq_pending(pni_uring_t *u) {
+  return u->sq_tail - __atomic_load_n(u->sq_khead, __ATOMIC_ACQUIRE);
+}
+
+// Called with mutex held.
+static void uring_queue(pni_uring_t *u, uint8_t opcode, int fd, uint32_t events, uint64_t addr, uint64_t user_data) {
+  while (uring_sq_pending(u) >= u->sq_entries) {
+    // Ring full: make room now rather than wait for the poller
+    if (uring_submit(u, 0, 0) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+      EPOLL_FATAL("io_uring submit", errno);
+  }
+  struct io_uring_sqe *sqe = &u->sqes[u->sq_tail & u->sq_mask];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->addr = addr;
+  sqe->poll32_events = events;
+  sqe->user_data = user_data;
+  u->sq_tail++;
+  __atomic_store_n(u->sq_ktail, u->sq_tail, __ATOMIC_RELEASE);
+}
+
+// Called with mutex held.
+static void uring_queue_remove(pni_uring_t *u, uint32_t index) {
+  uring_slot_t *s = &u->slots[index];
+  if (s->armed && !s->in_epoll)
+    uring_queue(u, IORING_OP_POLL_REMOVE, -1, 0, slot_user_data(index, s->generation), URING_IGNORE);
+  s->armed = false;
+}
+
+// Called with mutex held.
+static void uring_epoll_del(pni_uring_t *u, uint32_t index) {
+  uring_slot_t *s = &u->slots[index];
+  if (s->in_epoll) {
+    struct epoll_event ev = {0};
+    if (epoll_ctl(u->epollfd, EPOLL_CTL_DEL, s->ee->fd, &ev) == -1)
+      EPOLL_FATAL("EPOLL_CTL_DEL", errno);
+    s->in_epoll = false;
+  }
+}
+
+// Called with mutex held.
+static void uring_queue_arm(pni_uring_t *u, uint32_t index) {
+  uring_slot_t *s = &u->slots[index];
+  uint32_t wanted = s->ee->wanted;
+  uring_queue_remove(u, index);  // Replace any armed request, as EPOLL_CTL_MOD would
+  s->generation++;
+  s->armed = true;
+  if (wanted & (EPOLLIN | EPOLLRDHUP)) {
+    uring_epoll_del(u, index);
+    uring_queue(u, IORING_OP_POLL_ADD, s->ee->fd, wanted, 0, slot_user_data(index, s->generation));
+  } else {
+    struct epoll_event ev = {0};
+    ev.data.u64 = slot_user_data(index, s->generation);
+    ev.events = wanted | EPOLLONESHOT;
+    if (epoll_ctl(u->epollfd, s->in_epoll ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, s->ee->fd, &ev) == -1)
+      EPOLL_FATAL("arming polled file descriptor", errno);
+    s->in_epoll = true;
+  }
+}
+
+// Called with mutex held.
+static bool uring_slot_alloc(pni_uring_t *u, epoll_extended_t *ee) {
+  if (!u->free_slot) {
+    uint32_t old_capacity = u->slots_capacity;
+    uint32_t new_capacity = old_capacity ? 2 * old_capacity : 64;
+    uring_slot_t *slots = (uring_slot_t *) realloc(u->slots, new_capacity * sizeof(uring_slot_t));
+    if (!slots) return false;
+    memset(slots + old_capacity, 0, (new_capacity - old_capacity) * sizeof(uring_slot_t));
+    for (uint32_t i = old_capacity; i < new_capacity; i++)
+      slots[i].next_free = (i + 1 < new_capacity) ? i + 2 : 0;
+    u->slots = slots;
+    u->slots_capacity = new_capacity;
+    u->free_slot = old_capacity + 1;
+  }
+  uint32_t index = u->free_slot - 1;
+  uring_slot_t *s = &u->slots[index];
+  u->free_slot = s->next_free;
+  s->ee = ee;
+  s->armed = false;
+  s->in_epoll = false;
+  ee->uring_slot = index + 1;
+  return true;
+}
+
+// Called with mutex held.  Wake a blocked poller so it sees the change.
+static void uring_kick(pni_uring_t *u) {
+  if (u->poller_waiting && uring_submit(u, 0, 0) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+    EPOLL_FATAL("io_uring submit", errno);
+}
+
+bool pni_uring_start_polling(pni_uring_t *u, epoll_extended_t *ee) {
+  lock(&u->mutex);
+  bool ok = uring_slot_alloc(u, ee);
+  if (ok) {
+    uring_queue_arm(u, ee->uring_slot - 1);
+    uring_kick(u);
+  }
+  unlock(&u->mutex);
+  return ok;
+}
+
+void pni_uring_stop_polling(pni_uring_t *u, epoll_extended_t *ee) {
+  lock(&u->mutex);
+  if (ee->uring_slot) {
+    uint32_t index = ee->uring_slot - 1;
+    uring_slot_t *s = &u->slots[index];
+    uring_queue_remove(u, index);
+    uring_epoll_del(u, index);
+    s->ee = NULL;
+    s->generation++;
+    s->next_free = u->free_slot;
+    u->free_slot = index + 1;
+    ee->uring_slot = 0;
+    // The caller is about to close the fd: let the kernel drop its reference promptly.
+    if (uring_submit(u, 0, 0) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+      EPOLL_FATAL("io_uring submit", errno);
+  }
+  unlock(&u->mutex);
+}
+
+void pni_uring_rearm_polling(pni_uring_t *u, epoll_extended_t *ee) {
+  lock(&u->mutex);
+  if (!ee->uring_slot && !uring_slot_alloc(u, ee))
+    EPOLL_FATAL("arming polled file descriptor", ENOMEM);
+  uring_queue_arm(u, ee->uring_slot - 1);
+  uring_kick(u);
+  unlock(&u->mutex);
+}
+
+// Called with mutex held.  Translate a completion or inner epoll event for a slot.
+static bool uring_event(pni_uring_t *u, uint64_t user_data, uint32_t events, struct epoll_event *event) {
+  uint32_t index = (uint32_t) (user_data >> 32);
+  uint32_t generation = (uint32_t) user_data;
+  if (index >= u->slots_capacity) return false;
+  uring_slot_t *s = &u->slots[index];
+  if (!s->ee || !s->armed || s->generation != generation) return false;
+  s->armed = false;
+  event->events = events;
+  event->data.ptr = s->ee;
+  return true;
+}
+
+// Poller thread only.  Convert completions to epoll events, dropping stale ones.
+static int uring_reap(pni_uring_t *u, struct epoll_event *events, int maxevents) {
+  unsigned head = *u->cq_khead;
+  unsigned tail = __atomic_load_n(u->cq_ktail, __ATOMIC_ACQUIRE);
+  if (head == tail) return 0;
+  int n = 0;
+  lock(&u->mutex);
+  while (head != tail && n < maxevents) {
+    struct io_uring_cqe *cqe = &u->cqes[head & u->cq_mask];
+    head++;
+    if (cqe->user_data == URING_IGNORE) continue;
+    if (cqe->user_data == URING_EPOLL) {
+      // Collect what the inner epoll set has, in place, and poll it again.  Anything left
+      // over completes the new poll straight away.
+      int m = epoll_wait(u->epollfd, events + n, maxevents - n, 0);
+      for (int i = 0; i < m; i++) {
+        struct epoll_event ev = events[n + i];
+        if (uring_event(u, ev.data.u64, ev.events, &events[n]))
+          n++;
+      }
+      uring_queue(u, IORING_OP_POLL_ADD, u->epollfd, EPOLLIN, 0, URING_EPOLL);
+      continue;
+    }
+    if (cqe->res == -ECANCELED) continue;
+    if (uring_event(u, cqe->user_data, cqe->res >= 0 ? (uint32_t) cqe->res : EPOLLERR, &events[n]))
+      n++;
+  }
+  unlock(&u->mutex);
+  __atomic_store_n(u->cq_khead, head, __ATOMIC_RELEASE);
+  return n;
+}
+
+// Poller thread only.  Submit queued arms and wait for events like epoll_wait(): returns
+// the number of events, or -1 with errno set.
+int pni_uring_wait(pni_uring_t *u, struct epoll_event *events, int maxevents, bool block) {
+  for (;;) {
+    int n = uring_reap(u, events, maxevents);
+    if (n > 0) return n;
+
+    lock(&u->mutex);
+    bool overflow = __atomic_load_n(u->sq_kflags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW;
+    bool pending = uring_sq_pending(u) > 0;
+    u->poller_waiting = block;
+    unlock(&u->mutex);
+
+    int err = 0;
+    if (block || pending || overflow) {
+      // A blocking wait also submits any queued arms, in the same system call
+      if (uring_submit(u, block ? 1 : 0, (block || overflow) ? IORING_ENTER_GETEVENTS : 0) < 0)
+        err = errno;
+    }
+
+    if (block) {
+      lock(&u->mutex);
+      u->poller_waiting = false;
+      unlock(&u->mutex);
+    }
+
+    if (err && err != EBUSY && err != EAGAIN) {
+      errno = err;
+      return -1;
+    }
+    n = uring_reap(u, events, maxevents);
+    if (n > 0 || !block) return n;
+    // Woken by completions that were all stale: keep waiting
+  }
+}
@@ -205,6 +205,7 @@ struct pn_listener_t {
   pn_record_t *attachments;
   void *context;
   size_t backlog;
+  bool reuse_port;              /* Set before listening */
 
   /* Only used by leader */
   addr_t addr;
@@ -642,10 +643,21 @@ static int lsocket(pn_listener_t *l, struct addrinfo *ai) {
   ls->tcp.data = ls;
   ls->parent = NULL;
   ls->next = NULL;
-  int err = uv_tcp_init(&l->work.proactor->loop, &ls->tcp);
+  /* Create the socket up front if it needs options set before bind */
+  int err = l->reuse_port ?
+    uv_tcp_init_ex(&l->work.proactor->loop, &ls->tcp, ai->ai_family) :
+    uv_tcp_init(&l->work.proactor->loop, &ls->tcp);
   if (err) {
     free(ls);                   /* Will never be closed */
   } else {
+#ifdef SO_REUSEPORT
+    if (l->reuse_port) {
+      uv_os_fd_t fd;
+      int on = 1;
+      if (!uv_fileno((uv_handle_t*)&ls->tcp, &fd))
+        (void)setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    }
+#endif
     if (l->dynamic_port) set_port(ai->ai_addr, l->dynamic_port);
     int flags = (ai->ai_family == AF_INET6) ? UV_TCP_IPV6ONLY : 0;
     err = uv_tcp_bind(&ls->tcp, ai->ai_addr, flags);
@@ -1322,6 +1334,10 @@ void pn_proactor_release_connection(pn_connection_t *c) {
   }
 }
 
+void pn_listener_set_reuse_port(pn_listener_t *l, bool reuse) {
+  l->reuse_port = reuse;
+}
+
 pn_listener_t *pn_listener(void) {
   pn_listener_t *l = (pn_listener_t*)calloc(1, sizeof(pn_listener_t));
   if (l) {
@@ -1381,6 +1397,60 @@ void pn_listener_accept2(pn_listener_t *l, pn_connection_t *c, pn_transport_t *t
   work_notify(&l->work);
 }
 
+/* A libuv socket belongs to the loop it was accepted on, so it cannot be served by another proactor */
+void pn_proactor_accept(pn_proactor_t *p, pn_listener_t *l, pn_connection_t *c, pn_transport_t *t) {
+  (void)p;
+  pn_listener_accept2(l, c, t);
+}
+
+/* Connection batches are not limited by this proactor */
+void pn_proactor_set_sched_limit(pn_proactor_t *p, pn_sched_limit_t limit, uint64_t value) {
+  (void)p; (void)limit; (void)value;
+}
+
+uint64_t pn_proactor_get_sched_limit(pn_proactor_t *p, pn_sched_limit_t limit) {
+  (void)p; (void)limit;
+  return 0;
+}
+
+uint64_t pn_proactor_sched_limit_hits(pn_proactor_t *p, pn_sched_limit_t limit) {
+  (void)p; (void)limit;
+  return 0;
+}
+
+void pn_connection_set_sched_weight(pn_connection_t *c, unsigned weight) {
+  (void)c; (void)weight;
+}
+
+/* Threads always block waiting for work with this proactor */
+void pn_proactor_set_busy_poll(pn_proactor_t *p, unsigned usec) {
+  (void)p; (void)usec;
+}
+
+unsigned pn_proactor_get_busy_poll(pn_proactor_t *p) {
+  (void)p;
+  return 0;
+}
+
+void pn_proactor_set_socket_busy_poll(pn_proactor_t *p, unsigned usec) {
+  (void)p; (void)usec;
+}
+
+/* TLS runs on the loop thread with this proactor */
+void pn_proactor_set_crypto_offload(pn_proactor_t *p, unsigned threads, size_t threshold) {
+  (void)p; (void)threads; (void)threshold;
+}
+
+uint64_t pn_proactor_crypto_offloads(pn_proactor_t *p) {
+  (void)p;
+  return 0;
+}
+
+int pn_transport_set_tls(pn_transport_t *t, struct pn_tls_config_t *config, const char *peer_hostname) {
+  (void)t; (void)config; (void)peer_hostname;
+  return PN_ERR;  // Not supported
+}
+
 const pn_netaddr_t *pn_transport_local_addr(pn_transport_t *t) {
   pconnection_t *pc = get_pconnection(pn_transport_connection(t));
   return pc? &pc->local : NULL;
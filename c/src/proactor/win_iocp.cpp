@@ -3164,6 +3164,12 @@ void pn_listener_close(pn_listener_t* l) {
   wakeup(&l->psockets[0]);
 }
 
+// Windows has no SO_REUSEPORT, and SO_REUSEADDR would let listeners steal each other's port
+void pn_listener_set_reuse_port(pn_listener_t *l, bool reuse) {
+  (void)l;
+  (void)reuse;
+}
+
 pn_proactor_t *pn_listener_proactor(pn_listener_t* l) {
   return l ? l->context.proactor : NULL;
 }
@@ -3216,6 +3222,59 @@ static void recycle_result(accept_result_t *accept_result) {
   }
 }
 
+// Sockets are bound to the completion port of the listener's proactor, which serves the connection
+void pn_proactor_accept(pn_proactor_t *p, pn_listener_t *l, pn_connection_t *c, pn_transport_t *t) {
+  (void)p;
+  pn_listener_accept2(l, c, t);
+}
+
+/* Connection batches are not limited by this proactor */
+void pn_proactor_set_sched_limit(pn_proactor_t *p, pn_sched_limit_t limit, uint64_t value) {
+  (void)p; (void)limit; (void)value;
+}
+
+uint64_t pn_proactor_get_sched_limit(pn_proactor_t *p, pn_sched_limit_t limit) {
+  (void)p; (void)limit;
+  return 0;
+}
+
+uint64_t pn_proactor_sched_limit_hits(pn_proactor_t *p, pn_sched_limit_t limit) {
+  (void)p; (void)limit;
+  return 0;
+}
+
+void pn_connection_set_sched_weight(pn_connection_t *c, unsigned weight) {
+  (void)c; (void)weight;
+}
+
+/* Threads always block waiting for work with this proactor */
+void pn_proactor_set_busy_poll(pn_proactor_t *p, unsigned usec) {
+  (void)p; (void)usec;
+}
+
+unsigned pn_proactor_get_busy_poll(pn_proactor_t *p) {
+  (void)p;
+  return 0;
+}
+
+void pn_proactor_set_socket_busy_poll(pn_proactor_t *p, unsigned usec) {
+  (void)p; (void)usec;
+}
+
+void pn_proactor_set_crypto_offload(pn_proactor_t *p, unsigned threads, size_t threshold) {
+  (void)p; (void)threads; (void)threshold;
+}
+
+uint64_t pn_proactor_crypto_offloads(pn_proactor_t *p) {
+  (void)p;
+  return 0;
+}
+
+int pn_transport_set_tls(pn_transport_t *t, struct pn_tls_config_t *config, const char *peer_hostname) {
+  (void)t; (void)config; (void)peer_hostname;
+  return PN_ERR;  // Not supported
+}
+
 void pn_listener_accept2(pn_listener_t *l, pn_connection_t *c, pn_transport_t *t) {
   accept_result_t *accept_result = NULL;
   DWORD err = 0;
@@ -62,6 +62,7 @@
 #include <fcntl.h>
 #include <assert.h>
 #include <stdio.h>
+#include <time.h>
 
 /** @file
  * SSL/TLS support API.
@@ -69,9 +70,33 @@
  * This file contains an OpenSSL-based implemention of the SSL/TLS API.
  */
 
+/* Thread-safe locking for POSIX and Windows */
+
+#ifdef _WIN32
+
+typedef CRITICAL_SECTION pni_mutex_t;
+static inline void pni_mutex_init(pni_mutex_t *m) { InitializeCriticalSection(m); }
+static inline void pni_mutex_destroy(pni_mutex_t *m) { DeleteCriticalSection(m); }
+static inline void pni_mutex_lock(pni_mutex_t *m) { EnterCriticalSection(m); }
+static inline void pni_mutex_unlock(pni_mutex_t *m) { LeaveCriticalSection(m); }
+
+#else  /* POSIX */
+
+#include <pthread.h>
+
+typedef pthread_mutex_t pni_mutex_t;
+static inline int pni_mutex_init(pni_mutex_t *m) { return pthread_mutex_init(m, NULL); }
+static inline int pni_mutex_destroy(pni_mutex_t *m) { return pthread_mutex_destroy(m); }
+static inline int pni_mutex_lock(pni_mutex_t *m) { return pthread_mutex_lock(m); }
+static inline int pni_mutex_unlock(pni_mutex_t *m) { return pthread_mutex_unlock(m); }
+
+#endif
+
 typedef struct pn_ssl_session_t pn_ssl_session_t;
 
 static int ssl_ex_data_index;
+static int ssn_cache_ex_data_index;
+static BIO_METHOD *net_bio_method;
 
 struct pn_ssl_domain_t {
 
@@ -103,9 +128,15 @@ struct pni_ssl_t {
   const char *peer_hostname;
   SSL *ssl;
 
-  BIO *bio_ssl;         // i/o from/to SSL socket layer
-  BIO *bio_ssl_io;      // SSL "half" of network-facing BIO
-  BIO *bio_net_io;      // socket-side "half" of network-facing BIO
+  // Network side of the SSL socket, see net_bio_read() and net_bio_write()
+  const char *net_in;   // transport input being processed
+  size_t net_in_size;
+  bool net_in_closed;   // no more input: EOF once net_in is used up
+  char *net_out;        // transport output space being filled
+  size_t net_out_size;
+  char *net_pending;    // output SSL wrote with no space for it in net_out
+  size_t net_pending_size;
+  size_t net_pending_count;
   // buffers for holding I/O from "applications" above SSL
 #define APP_BUF_SIZE    (4*1024)
   char *outbuf;
@@ -119,11 +150,13 @@ struct pni_ssl_t {
   size_t in_size;
   size_t in_count;
 
-  bool ssl_shutdown;    // BIO_ssl_shutdown() called on socket.
+  bool ssl_shutdown;    // SSL_shutdown() called on socket.
   bool ssl_closed;      // shutdown complete, or SSL error
   bool read_blocked;    // SSL blocked until more network data is read
   bool write_blocked;   // SSL blocked until data is written to network
   bool handshake_ok;
+  bool ssn_restored;    // looked for a session to resume, see ssn_restore()
+  bool handshake_counted; // added to the session stats
   int err_reason;
 
   char *subject;
@@ -446,58 +479,223 @@ static DH *get_dh2048(void)
   return dh;
 }
 
-typedef struct {
+// Session cache and statistics, one per SSL_CTX (so per domain) held as ex_data
+// so that it lives as long as any SSL socket that uses it.
+//
+// Servers resume sessions using OpenSSL's own cache or session tickets, clients
+// using the sessions saved here under the session_id given to pn_ssl_init()
+// and the peer hostname.  The least recently used session is dropped when the
+// cache is full.
+
+typedef struct ssn_entry_t {
   char *id;
+  char *peer;
   SSL_SESSION *session;
-} ssl_cache_data;
+  struct ssn_entry_t *hash_next;
+  struct ssn_entry_t *lru_prev;       // more recently used
+  struct ssn_entry_t *lru_next;       // less recently used
+} ssn_entry_t;
+
+typedef struct {
+  pni_mutex_t lock;
+  ssn_entry_t **buckets;
+  size_t bucket_count;
+  ssn_entry_t *lru_first;
+  ssn_entry_t *lru_last;
+  size_t count;
+  size_t size;
+  uint64_t hits;
+  uint64_t misses;
+} ssn_cache_t;
+
+#define SSL_CACHE_SIZE 64
+
+static size_t ssn_hash(const char *id, const char *peer) {
+  size_t h = 5381;
+  for (const char *c = id; *c; ++c) h = h * 33 + (unsigned char)*c;
+  if (peer) for (const char *c = peer; *c; ++c) h = h * 33 + (unsigned char)*c;
+  return h;
+}
+
+static inline bool ssn_match(ssn_entry_t *e, const char *id, const char *peer) {
+  return strcmp(e->id, id) == 0 &&
+    (e->peer == peer || (e->peer && peer && strcmp(e->peer, peer) == 0));
+}
+
+static ssn_entry_t **ssn_find(ssn_cache_t *cache, const char *id, const char *peer) {
+  ssn_entry_t **pe = &cache->buckets[ssn_hash(id, peer) % cache->bucket_count];
+  while (*pe && !ssn_match(*pe, id, peer)) pe = &(*pe)->hash_next;
+  return pe;
+}
+
+static void ssn_lru_remove(ssn_cache_t *cache, ssn_entry_t *e) {
+  if (e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+  else cache->lru_first = e->lru_next;
+  if (e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+  else cache->lru_last = e->lru_prev;
+}
+
+static void ssn_lru_push(ssn_cache_t *cache, ssn_entry_t *e) {
+  e->lru_prev = NULL;
+  e->lru_next = cache->lru_first;
+  if (cache->lru_first) cache->lru_first->lru_prev = e;
+  else cache->lru_last = e;
+  cache->lru_first = e;
+}
+
+// Remove the entry at *pe
+static void ssn_remove(ssn_cache_t *cache, ssn_entry_t **pe) {
+  ssn_entry_t *e = *pe;
+  *pe = e->hash_next;
+  ssn_lru_remove(cache, e);
+  --cache->count;
+  free(e->id);
+  free(e->peer);
+  SSL_SESSION_free(e->session);
+  free(e);
+}
+
+static void ssn_evict(ssn_cache_t *cache, size_t size) {
+  while (cache->count > size) {
+    ssn_entry_t *e = cache->lru_last;
+    ssn_remove(cache, ssn_find(cache, e->id, e->peer));
+  }
+}
 
-#define SSL_CACHE_SIZE 4
-static int ssl_cache_ptr = 0;
-static ssl_cache_data ssl_cache[SSL_CACHE_SIZE];
+// Buckets stay in proportion to the cache size, call with the lock held
+static bool ssn_set_size(ssn_cache_t *cache, size_t size) {
+  ssn_evict(cache, size);
+  size_t bucket_count = size ? size : 1;
+  ssn_entry_t **buckets = (ssn_entry_t **)calloc(bucket_count, sizeof(ssn_entry_t *));
+  if (!buckets) return false;
+  for (ssn_entry_t *e = cache->lru_first; e; e = e->lru_next) {
+    ssn_entry_t **pe = &buckets[ssn_hash(e->id, e->peer) % bucket_count];
+    e->hash_next = *pe;
+    *pe = e;
+  }
+  free(cache->buckets);
+  cache->buckets = buckets;
+  cache->bucket_count = bucket_count;
+  cache->size = size;
+  return true;
+}
 
-static void ssn_init(void) {
-  ssl_cache_data s = {NULL, NULL};
-  for (int i=0; i<SSL_CACHE_SIZE; i++) {
-    ssl_cache[i] = s;
+static ssn_cache_t *ssn_cache_new(void) {
+  ssn_cache_t *cache = (ssn_cache_t *)calloc(1, sizeof(ssn_cache_t));
+  if (!cache) return NULL;
+  if (!ssn_set_size(cache, SSL_CACHE_SIZE)) {
+    free(cache);
+    return NULL;
   }
+  pni_mutex_init(&cache->lock);
+  return cache;
+}
+
+static void ssn_cache_free(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int idx, long argl, void *argp) {
+  ssn_cache_t *cache = (ssn_cache_t *)ptr;
+  if (!cache) return;
+  ssn_evict(cache, 0);
+  pni_mutex_destroy(&cache->lock);
+  free(cache->buckets);
+  free(cache);
+}
+
+static inline ssn_cache_t *ssn_cache(SSL_CTX *ctx) {
+  return (ssn_cache_t *)SSL_CTX_get_ex_data(ctx, ssn_cache_ex_data_index);
 }
 
+// Called before the handshake starts rather than from pn_ssl_init() as the
+// peer hostname is usually set afterwards
 static void ssn_restore(pn_transport_t *transport, pni_ssl_t *ssl) {
+  if (ssl->ssn_restored) return;
+  ssl->ssn_restored = true;
   if (!ssl->session_id) return;
-  for (int i = ssl_cache_ptr;;) {
-    i = (i==0) ? SSL_CACHE_SIZE-1 : i-1;
-    if (ssl_cache[i].id == NULL) return;
-    if (strcmp(ssl_cache[i].id, ssl->session_id) == 0) {
-      ssl_log( transport, PN_LEVEL_TRACE, "Restoring previous session id=%s", ssl->session_id );
-      int rc = SSL_set_session( ssl->ssl, ssl_cache[i].session );
-      if (rc != 1) {
-        ssl_log( transport, PN_LEVEL_WARNING, "Session restore failed, id=%s", ssl->session_id );
-      }
-      return;
+  ssn_cache_t *cache = ssn_cache(SSL_get_SSL_CTX(ssl->ssl));
+  if (!cache) return;
+  pni_mutex_lock(&cache->lock);
+  ssn_entry_t **pe = ssn_find(cache, ssl->session_id, ssl->peer_hostname);
+  ssn_entry_t *e = *pe;
+  if (e && SSL_SESSION_get_time(e->session) + SSL_SESSION_get_timeout(e->session) < (long)time(NULL)) {
+    ssl_log( transport, PN_LEVEL_TRACE, "Dropping expired session id=%s", ssl->session_id );
+    ssn_remove(cache, pe);
+    e = NULL;
+  }
+  if (e) {
+    ssl_log( transport, PN_LEVEL_TRACE, "Restoring previous session id=%s", ssl->session_id );
+    ssn_lru_remove(cache, e);
+    ssn_lru_push(cache, e);
+    int rc = SSL_set_session( ssl->ssl, e->session );
+    if (rc != 1) {
+      ssl_log( transport, PN_LEVEL_WARNING, "Session restore failed, id=%s", ssl->session_id );
     }
-    if (i == ssl_cache_ptr) return;
   }
+  pni_mutex_unlock(&cache->lock);
 }
 
 static void ssn_save(pn_transport_t *transport, pni_ssl_t *ssl) {
   if (ssl->session_id) {
+    ssn_cache_t *cache = ssn_cache(SSL_get_SSL_CTX(ssl->ssl));
+    if (!cache) return;
     // Attach the session id to the session before we close the connection
     // So that if we find it in the cache later we can figure out the session id
     SSL_SESSION *session = SSL_get1_session( ssl->ssl );
-    if (session) {
+    if (!session) return;
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if (!SSL_SESSION_is_resumable(session)) {
+      SSL_SESSION_free(session);
+      return;
+    }
+#endif
+    pni_mutex_lock(&cache->lock);
+    ssn_entry_t **pe = ssn_find(cache, ssl->session_id, ssl->peer_hostname);
+    if (*pe) {
+      // Replace the previous session, it may have been used up
+      ssn_entry_t *e = *pe;
+      ssl_log(transport, PN_LEVEL_TRACE, "Updating SSL session %s", ssl->session_id );
+        SSL_SESSION_free(e->session);
+      e->session = session;
+      session = NULL;
+      ssn_lru_remove(cache, e);
+      ssn_lru_push(cache, e);
+    } else if (cache->size) {
       ssl_log(transport, PN_LEVEL_TRACE, "Saving SSL session as %s", ssl->session_id );
-      // If we're overwriting a value, need to free it
-      free(ssl_cache[ssl_cache_ptr].id);
-      if (ssl_cache[ssl_cache_ptr].session) SSL_SESSION_free(ssl_cache[ssl_cache_ptr].session);
-
+      ssn_evict(cache, cache->size - 1);
+      ssn_entry_t *e = (ssn_entry_t *)calloc(1, sizeof(ssn_entry_t));
       char *id = pn_strdup( ssl->session_id );
-      ssl_cache_data s = {id, session};
-      ssl_cache[ssl_cache_ptr++] = s;
-      if (ssl_cache_ptr==SSL_CACHE_SIZE) ssl_cache_ptr = 0;
+      char *peer = ssl->peer_hostname ? pn_strdup( ssl->peer_hostname ) : NULL;
+      if (e && id && (peer || !ssl->peer_hostname)) {
+        e->id = id;
+        e->peer = peer;
+        e->session = session;
+        pe = ssn_find(cache, id, peer);
+        *pe = e;
+        ssn_lru_push(cache, e);
+        ++cache->count;
+        session = NULL;
+      } else {
+        free(e);
+        free(id);
+        free(peer);
+      }
     }
+    pni_mutex_unlock(&cache->lock);
+    if (session) SSL_SESSION_free(session);
   }
 }
 
+// Count each completed handshake once, as a hit if it resumed a session
+static void ssn_count_handshake(pni_ssl_t *ssl) {
+  if (ssl->handshake_counted || !SSL_is_init_finished(ssl->ssl)) return;
+  ssl->handshake_counted = true;
+  ssn_cache_t *cache = ssn_cache(SSL_get_SSL_CTX(ssl->ssl));
+  if (!cache) return;
+  bool reused = SSL_session_reused(ssl->ssl);
+  pni_mutex_lock(&cache->lock);
+  if (reused) ++cache->hits;
+  else ++cache->misses;
+  pni_mutex_unlock(&cache->lock);
+}
+
 /** Public API - visible to application code */
 
 bool pn_ssl_present(void)
@@ -527,7 +725,8 @@ static bool pni_init_ssl_domain( pn_ssl_domain_t * domain, pn_ssl_mode_t mode )
       ssl_log_error("Unable to initialize OpenSSL context.");
       return false;
     }
-    SSL_CTX_set_session_cache_mode(domain->ctx, SSL_SESS_CACHE_CLIENT);
+    // Sessions are kept in the domain's ssn_cache_t, not by OpenSSL
+    SSL_CTX_set_session_cache_mode(domain->ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
 
     // By default, require peer name verification - this is a safe default
     if (pn_ssl_domain_set_peer_authentication( domain, PN_SSL_VERIFY_PEER_NAME, NULL )) {
@@ -555,6 +754,20 @@ static bool pni_init_ssl_domain( pn_ssl_domain_t * domain, pn_ssl_mode_t mode )
     return false;
   }
 
+  ssn_cache_t *cache = ssn_cache_new();
+  if (!cache || !SSL_CTX_set_ex_data(domain->ctx, ssn_cache_ex_data_index, cache)) {
+    ssl_log_error("Unable to create SSL session cache.");
+    ssn_cache_free(NULL, cache, NULL, 0, 0, NULL);
+    SSL_CTX_free(domain->ctx);
+    return false;
+  }
+  if (mode == PN_SSL_MODE_SERVER) {
+    // Required to resume sessions with verified clients, the same for every
+    // domain so tickets stay valid across restarts given the same ticket keys
+    static const unsigned char sid_ctx[] = "org.apache.qpid.proton";
+    SSL_CTX_set_session_id_context(domain->ctx, sid_ctx, sizeof(sid_ctx) - 1);
+  }
+
   // By default set up system default certificates
   if (!SSL_CTX_set_default_verify_paths(domain->ctx)){
     ssl_log_error("Failed to set default certificate paths");
@@ -1006,6 +1219,56 @@ int pn_ssl_init(pn_ssl_t *ssl0, pn_ssl_domain_t *domain, const char *session_id)
 }
 
 
+int pn_ssl_domain_set_session_cache(pn_ssl_domain_t *domain, size_t size, unsigned timeout)
+{
+  if (!domain) return PN_ARG_ERR;
+  if (domain->mode == PN_SSL_MODE_SERVER) {
+    SSL_CTX_set_session_cache_mode(domain->ctx, size ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_OFF);
+    if (size) SSL_CTX_sess_set_cache_size(domain->ctx, (long)size);
+    if (timeout) SSL_CTX_set_timeout(domain->ctx, (long)timeout);
+    return 0;
+  }
+  ssn_cache_t *cache = ssn_cache(domain->ctx);
+  if (!cache) return PN_ERR;
+  pni_mutex_lock(&cache->lock);
+  bool ok = ssn_set_size(cache, size);
+  pni_mutex_unlock(&cache->lock);
+  return ok ? 0 : PN_OUT_OF_MEMORY;
+}
+
+int pn_ssl_domain_set_session_ticket_keys(pn_ssl_domain_t *domain, const char *keys, size_t size)
+{
+  if (!domain) return PN_ARG_ERR;
+  if (domain->mode != PN_SSL_MODE_SERVER) {
+    ssl_log_error("Cannot set session ticket keys - not a server.");
+    return PN_ARG_ERR;
+  }
+  if (!keys) {
+    SSL_CTX_set_options(domain->ctx, SSL_OP_NO_TICKET);
+    return 0;
+  }
+  // The required size depends on the OpenSSL version
+  if (size != (size_t)SSL_CTX_get_tlsext_ticket_keys(domain->ctx, NULL, 0)) {
+    ssl_log_error("Session ticket keys must be %ld bytes", SSL_CTX_get_tlsext_ticket_keys(domain->ctx, NULL, 0));
+    return PN_ARG_ERR;
+  }
+  if (SSL_CTX_set_tlsext_ticket_keys(domain->ctx, (void *)keys, (long)size) != 1) {
+    ssl_log_error("Failed to set session ticket keys");
+    return PN_ERR;
+  }
+  SSL_CTX_clear_options(domain->ctx, SSL_OP_NO_TICKET);
+  return 0;
+}
+
+void pn_ssl_domain_get_session_stats(pn_ssl_domain_t *domain, uint64_t *hits, uint64_t *misses)
+{
+  ssn_cache_t *cache = domain ? ssn_cache(domain->ctx) : NULL;
+  if (cache) pni_mutex_lock(&cache->lock);
+  if (hits) *hits = cache ? cache->hits : 0;
+  if (misses) *misses = cache ? cache->misses : 0;
+  if (cache) pni_mutex_unlock(&cache->lock);
+}
+
 int pn_ssl_domain_allow_unsecured_client(pn_ssl_domain_t *domain)
 {
   if (!domain) return -1;
@@ -1128,12 +1391,118 @@ static int start_ssl_shutdown(pn_transport_t *transport)
     ssl_log(transport, PN_LEVEL_TRACE, "Shutting down SSL connection...");
     ssn_save(transport, ssl);
     ssl->ssl_shutdown = true;
-    BIO_ssl_shutdown( ssl->bio_ssl );
+    (void)SSL_shutdown( ssl->ssl );
   }
   return 0;
 }
 
 
+//////// Network BIO
+
+// The SSL socket reads and writes the network through a BIO that works on the
+// transport's own buffers: it reads ciphertext straight from the input given to
+// process_input_ssl() and writes it straight to the space given to
+// process_output_ssl().  Only output written with no space for it (handshake
+// replies to input, or the end of a record that did not fit) is buffered.
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000
+#define BIO_get_data(b) ((b)->ptr)
+#define BIO_set_data(b, p) ((b)->ptr = (p))
+#define BIO_set_init(b, i) ((b)->init = (i))
+#endif
+
+static int net_bio_read(BIO *bio, char *out, int len)
+{
+  pni_ssl_t *ssl = (pni_ssl_t *)BIO_get_data(bio);
+  BIO_clear_retry_flags(bio);
+  if (len <= 0) return 0;
+  if (!ssl->net_in_size) {
+    if (ssl->net_in_closed) return 0;
+    BIO_set_retry_read(bio);
+    return -1;
+  }
+  size_t n = pn_min((size_t)len, ssl->net_in_size);
+  memcpy(out, ssl->net_in, n);
+  ssl->net_in += n;
+  ssl->net_in_size -= n;
+  return (int)n;
+}
+
+static int net_bio_write(BIO *bio, const char *in, int len)
+{
+  pni_ssl_t *ssl = (pni_ssl_t *)BIO_get_data(bio);
+  BIO_clear_retry_flags(bio);
+  if (len <= 0) return 0;
+  size_t n = 0;
+  if (!ssl->net_pending_count && ssl->net_out_size) {
+    n = pn_min((size_t)len, ssl->net_out_size);
+    memcpy(ssl->net_out, in, n);
+    ssl->net_out += n;
+    ssl->net_out_size -= n;
+  }
+  size_t rest = len - n;
+  if (rest) {
+    if (ssl->net_pending_count + rest > ssl->net_pending_size) {
+      size_t size = pn_max(ssl->net_pending_count + rest, 2*ssl->net_pending_size);
+      char *pending = (char *)realloc(ssl->net_pending, size);
+      if (!pending) {
+        if (n) return (int)n;
+        BIO_set_retry_write(bio);
+        return -1;
+      }
+      ssl->net_pending = pending;
+      ssl->net_pending_size = size;
+    }
+    memcpy(ssl->net_pending + ssl->net_pending_count, in + n, rest);
+    ssl->net_pending_count += rest;
+  }
+  return len;
+}
+
+static long net_bio_ctrl(BIO *bio, int cmd, long num, void *ptr)
+{
+  pni_ssl_t *ssl = (pni_ssl_t *)BIO_get_data(bio);
+  switch (cmd) {
+   case BIO_CTRL_FLUSH:
+    return 1;
+   case BIO_CTRL_PENDING:
+    return (long)ssl->net_in_size;
+   case BIO_CTRL_WPENDING:
+    return (long)ssl->net_pending_count;
+   case BIO_CTRL_EOF:
+    return ssl->net_in_closed && !ssl->net_in_size;
+   default:
+    return 0;
+  }
+}
+
+static int net_bio_create(BIO *bio)
+{
+  BIO_set_init(bio, 1);
+  return 1;
+}
+
+static BIO_METHOD *net_bio_method_new(void)
+{
+#if OPENSSL_VERSION_NUMBER < 0x10100000
+  static BIO_METHOD method = {
+    BIO_TYPE_SOURCE_SINK, "proton transport",
+    net_bio_write, net_bio_read, NULL, NULL, net_bio_ctrl, net_bio_create, NULL, NULL
+  };
+  return &method;
+#else
+  BIO_METHOD *method = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "proton transport");
+  if (method) {
+    BIO_meth_set_write(method, net_bio_write);
+    BIO_meth_set_read(method, net_bio_read);
+    BIO_meth_set_ctrl(method, net_bio_ctrl);
+    BIO_meth_set_create(method, net_bio_create);
+  }
+  return method;
+#endif
+}
+
+
 //////// SSL Connections
 
 
@@ -1146,69 +1515,62 @@ static ssize_t process_input_ssl( pn_transport_t *transport, unsigned int layer,
     if (init_ssl_socket(transport, ssl, NULL)) return PN_EOS;
     transport->present_layers |= LAYER_SSL;
   }
+  ssn_restore(transport, ssl);
 
   ssl_log( transport, PN_LEVEL_TRACE, "process_input_ssl( data size=%zu )",available );
 
-  ssize_t consumed = 0;
   bool work_pending;
-  bool shutdown_input = (available == 0);  // caller is closed
+
+  // The SSL socket reads the input in place through the network BIO
+  ssl->net_in = input_data;
+  ssl->net_in_size = available;
+  if (available == 0 && !ssl->net_in_closed) {
+    // lower layer (caller) has closed.  This will cause an EOF to be passed to
+    // SSL once all pending inbound data has been consumed.
+    ssl_log( transport, PN_LEVEL_TRACE, "Lower layer closed - shutting down BIO write side");
+    ssl->net_in_closed = true;
+  }
 
   do {
     work_pending = false;
     ERR_clear_error();
 
-    // Write to network bio as much as possible, consuming bytes/available
-
-    if (available > 0) {
-      int written = BIO_write( ssl->bio_net_io, input_data, available );
-      if (written > 0) {
-        input_data += written;
-        available -= written;
-        consumed += written;
-        ssl->read_blocked = false;
-        work_pending = (available > 0);
-        ssl_log( transport, PN_LEVEL_TRACE, "Wrote %d bytes to BIO Layer, %" PN_ZU " left over", written, available );
-      }
-    } else if (shutdown_input) {
-      // lower layer (caller) has closed.  Close the WRITE side of the BIO.  This will cause
-      // an EOF to be passed to SSL once all pending inbound data has been consumed.
-      ssl_log( transport, PN_LEVEL_TRACE, "Lower layer closed - shutting down BIO write side");
-      (void)BIO_shutdown_wr( ssl->bio_net_io );
-      shutdown_input = false;
-    }
-
     // Read all available data from the SSL socket
 
     if (!ssl->ssl_closed && ssl->in_count < ssl->in_size) {
-      int read = BIO_read( ssl->bio_ssl, &ssl->inbuf[ssl->in_count], ssl->in_size - ssl->in_count );
+      size_t before = ssl->net_in_size;
+      int read = SSL_read( ssl->ssl, &ssl->inbuf[ssl->in_count], ssl->in_size - ssl->in_count );
+      if (ssl->net_in_size < before) {
+        ssl->read_blocked = false;
+        ssl_log( transport, PN_LEVEL_TRACE, "Read %" PN_ZU " bytes from network, %" PN_ZU " left over", before - ssl->net_in_size, ssl->net_in_size );
+      }
       if (read > 0) {
         ssl_log( transport, PN_LEVEL_TRACE, "Read %d bytes from SSL socket for app", read );
         ssl_log_clear_data(transport, &ssl->inbuf[ssl->in_count], read );
         ssl->in_count += read;
         work_pending = true;
       } else {
-        if (!BIO_should_retry(ssl->bio_ssl)) {
-          int reason = SSL_get_error( ssl->ssl, read );
-          switch (reason) {
-           case SSL_ERROR_ZERO_RETURN:
-            // SSL closed cleanly
-            ssl_log(transport, PN_LEVEL_TRACE, "SSL connection has closed");
-            start_ssl_shutdown(transport);  // KAG: not sure - this may not be necessary
-            ssl->ssl_closed = true;
-            break;
-           default:
-            // unexpected error
-            return (ssize_t)ssl_failed(transport, reason);
-          }
-        } else {
-          if (BIO_should_write( ssl->bio_ssl )) {
-            ssl->write_blocked = true;
-            ssl_log(transport, PN_LEVEL_TRACE, "Detected write-blocked");
-          }
-          if (BIO_should_read( ssl->bio_ssl )) {
-            ssl->read_blocked = true;
-            ssl_log(transport, PN_LEVEL_TRACE, "Detected read-blocked");
-          }
+        int reason = SSL_get_error( ssl->ssl, read );
+        switch (reason) {
+         case SSL_ERROR_WANT_READ:
+          ssl->read_blocked = true;
+          ssl_log(transport, PN_LEVEL_TRACE, "Detected read-blocked");
+          break;
+         case SSL_ERROR_WANT_WRITE:
+          ssl->write_blocked = true;
+          ssl_log(transport, PN_LEVEL_TRACE, "Detected write-blocked");
+          break;
+         case SSL_ERROR_ZERO_RETURN:
+          // SSL closed cleanly
+          ssl_log(transport, PN_LEVEL_TRACE, "SSL connection has closed");
+          start_ssl_shutdown(transport);  // KAG: not sure - this may not be necessary
+          ssl->ssl_closed = true;
+          break;
+         default:
+          // unexpected error
+          ssl->net_in = NULL;
+          ssl->net_in_size = 0;
+          return (ssize_t)ssl_failed(transport, reason);
         }
       }
     }
@@ -1264,6 +1626,13 @@ static ssize_t process_input_ssl( pn_transport_t *transport, unsigned int layer,
 
   } while (work_pending);
 
+  ssn_count_handshake(ssl);
+
+  // Whatever SSL has read is consumed, the rest stays in the transport's buffer
+  ssize_t consumed = available - ssl->net_in_size;
+  ssl->net_in = NULL;
+  ssl->net_in_size = 0;
+
   //_log(ssl, "ssl_closed=%d in_count=%d app_input_closed=%d app_output_closed=%d",
   //     ssl->ssl_closed, ssl->in_count, ssl->app_input_closed, ssl->app_output_closed );
 
@@ -1304,10 +1673,28 @@ static ssize_t process_output_ssl( pn_transport_t *transport, unsigned int layer
   pni_ssl_t *ssl = transport->ssl;
   if (!ssl) return PN_EOS;
   if (ssl->ssl == NULL && init_ssl_socket(transport, ssl, NULL)) return PN_EOS;
+  ssn_restore(transport, ssl);
 
   ssize_t written = 0;
   bool work_pending;
 
+  // first, any network output that had nowhere to go
+  if (ssl->net_pending_count && max_len) {
+    size_t n = pn_min(ssl->net_pending_count, max_len);
+    memcpy(buffer, ssl->net_pending, n);
+    ssl->net_pending_count -= n;
+    if (ssl->net_pending_count)
+      memmove(ssl->net_pending, ssl->net_pending + n, ssl->net_pending_count);
+    buffer += n;
+    max_len -= n;
+    written += n;
+    ssl_log(transport, PN_LEVEL_TRACE, "Wrote %" PN_ZU " pending bytes", n );
+  }
+
+  // The SSL socket writes the rest in place through the network BIO
+  ssl->net_out = buffer;
+  ssl->net_out_size = ssl->net_pending_count ? 0 : max_len;
+
   do {
     work_pending = false;
     ERR_clear_error();
@@ -1320,6 +1707,15 @@ static ssize_t process_output_ssl( pn_transport_t *transport, unsigned int layer
         ssl->out_count += app_bytes;
         work_pending = true;
         ssl_log(transport, PN_LEVEL_TRACE, "Gathered %" PN_ZI " bytes from app to send to peer", app_bytes);
+        if (ssl->out_count == ssl->out_size && ssl->out_size < SSL3_RT_MAX_PLAIN_LENGTH) {
+          // bulk output: grow towards a full TLS record, fewer records are cheaper
+          size_t newsize = pn_min((size_t)SSL3_RT_MAX_PLAIN_LENGTH, ssl->out_size * 2);
+          char *newbuf = (char *)realloc( ssl->outbuf, newsize );
+          if (newbuf) {
+            ssl->out_size = newsize;
+            ssl->outbuf = newbuf;
+          }
+        }
       } else {
         if (app_bytes < 0) {
           ssl_log(transport, PN_LEVEL_TRACE, "Application layer closed its output, error=%d (%d bytes pending send)",
@@ -1329,41 +1725,40 @@ static ssize_t process_output_ssl( pn_transport_t *transport, unsigned int layer
       }
     }
 
-    // now push any pending app data into the socket
+    // now push any pending app data into the socket, while there is space for the result
 
     if (!ssl->ssl_closed) {
       char *data = ssl->outbuf;
-      if (ssl->out_count > 0) {
-        int wrote = BIO_write( ssl->bio_ssl, data, ssl->out_count );
+      if (ssl->out_count > 0 && ssl->net_out_size > 0) {
+        int wrote = SSL_write( ssl->ssl, data, ssl->out_count );
         if (wrote > 0) {
           data += wrote;
           ssl->out_count -= wrote;
           work_pending = true;
           ssl_log( transport, PN_LEVEL_TRACE, "Wrote %d bytes from app to socket", wrote );
         } else {
-          if (!BIO_should_retry(ssl->bio_ssl)) {
-            int reason = SSL_get_error( ssl->ssl, wrote );
-            switch (reason) {
-             case SSL_ERROR_ZERO_RETURN:
-              // SSL closed cleanly
-              ssl_log(transport, PN_LEVEL_TRACE, "SSL connection has closed");
-              start_ssl_shutdown(transport); // KAG: not sure - this may not be necessary
-              ssl->out_count = 0;      // can no longer write to socket, so erase app output data
-              ssl->ssl_closed = true;
-              break;
-             default:
-              // unexpected error
-              return (ssize_t)ssl_failed(transport, reason);
-            }
-          } else {
-            if (BIO_should_read( ssl->bio_ssl )) {
-              ssl->read_blocked = true;
-              ssl_log(transport, PN_LEVEL_TRACE, "Detected read-blocked");
-            }
-            if (BIO_should_write( ssl->bio_ssl )) {
-              ssl->write_blocked = true;
-              ssl_log(transport, PN_LEVEL_TRACE, "Detected write-blocked");
-            }
+          int reason = SSL_get_error( ssl->ssl, wrote );
+          switch (reason) {
+           case SSL_ERROR_WANT_READ:
+            ssl->read_blocked = true;
+            ssl_log(transport, PN_LEVEL_TRACE, "Detected read-blocked");
+            break;
+           case SSL_ERROR_WANT_WRITE:
+            ssl->write_blocked = true;
+            ssl_log(transport, PN_LEVEL_TRACE, "Detected write-blocked");
+            break;
+           case SSL_ERROR_ZERO_RETURN:
+            // SSL closed cleanly
+            ssl_log(transport, PN_LEVEL_TRACE, "SSL connection has closed");
+            start_ssl_shutdown(transport); // KAG: not sure - this may not be necessary
+            ssl->out_count = 0;      // can no longer write to socket, so erase app output data
+            ssl->ssl_closed = true;
+            break;
+           default:
+            // unexpected error
+            ssl->net_out = NULL;
+            ssl->net_out_size = 0;
+            return (ssize_t)ssl_failed(transport, reason);
           }
         }
       }
@@ -1379,37 +1774,34 @@ static ssize_t process_output_ssl( pn_transport_t *transport, unsigned int layer
       }
     }
 
-    // read from the network bio as much as possible, filling the buffer
-    if (max_len) {
-      int available = BIO_read( ssl->bio_net_io, buffer, max_len );
-      if (available > 0) {
-        max_len -= available;
-        buffer += available;
-        written += available;
-        ssl->write_blocked = false;
-        work_pending = work_pending || max_len > 0;
-        ssl_log(transport, PN_LEVEL_TRACE, "Read %d bytes from BIO Layer", available );
-      } else if ( !ssl->handshake_ok && !ssl->ssl_closed ) {
-        // OpenSSL bug workaround 1.0.x -> unknown.  Harmless in all versions.
-        // See PROTON-2643. SSL_do_handshake() prevents forgetting to refill the BIO.
-        ssl->handshake_ok = (SSL_do_handshake(ssl->ssl) == 1);
-      }
+    if (ssl->net_out == buffer && ssl->net_out_size && !ssl->handshake_ok && !ssl->ssl_closed) {
+      // Nothing written yet.  OpenSSL bug workaround 1.0.x -> unknown.  Harmless in all versions.
+      // See PROTON-2643. SSL_do_handshake() prevents forgetting to refill the BIO.
+      ssl->handshake_ok = (SSL_do_handshake(ssl->ssl) == 1);
     }
 
   } while (work_pending);
 
+  ssn_count_handshake(ssl);
+
+  written += ssl->net_out - buffer;
+  if (written > 0)
+    ssl->write_blocked = false;
+  ssl->net_out = NULL;
+  ssl->net_out_size = 0;
+
   //_log(ssl, "written=%d ssl_closed=%d in_count=%d app_input_closed=%d app_output_closed=%d bio_pend=%d",
-  //     written, ssl->ssl_closed, ssl->in_count, ssl->app_input_closed, ssl->app_output_closed, BIO_pending(ssl->bio_net_io) );
+  //     written, ssl->ssl_closed, ssl->in_count, ssl->app_input_closed, ssl->app_output_closed, ssl->net_pending_count );
 
   // PROTON-82: close the output side as soon as we've sent the SSL close_notify.
   // We're not requiring the response, as some implementations never reply.
   // ----
   // Once no more data is available "below" the SSL socket, tell the transport we are
   // done.
-  //if (written == 0 && ssl->ssl_closed && BIO_pending(ssl->bio_net_io) == 0) {
+  //if (written == 0 && ssl->ssl_closed && ssl->net_pending_count == 0) {
   //  written = ssl->app_output_closed ? ssl->app_output_closed : PN_EOS;
   //}
-  if (written == 0 && (SSL_get_shutdown(ssl->ssl) & SSL_SENT_SHUTDOWN) && BIO_pending(ssl->bio_net_io) == 0) {
+  if (written == 0 && (SSL_get_shutdown(ssl->ssl) & SSL_SENT_SHUTDOWN) && ssl->net_pending_count == 0) {
     written = ssl->app_output_closed ? ssl->app_output_closed : PN_EOS;
     if (transport->io_layers[layer]==&ssl_input_closed_layer) {
       transport->io_layers[layer] = &ssl_closed_layer;
@@ -1442,31 +1834,22 @@ static int init_ssl_socket(pn_transport_t* transport, pni_ssl_t *ssl, pn_ssl_dom
   }
 #endif
 
-  // restore session, if available
-  ssn_restore(transport, ssl);
-
-  // now layer a BIO over the SSL socket
-  ssl->bio_ssl = BIO_new(BIO_f_ssl());
-  if (!ssl->bio_ssl) {
+  // attach the network BIO below the SSL socket, which owns it from now on
+  BIO *bio = net_bio_method ? BIO_new(net_bio_method) : NULL;
+  if (!bio) {
     ssl_log(transport, PN_LEVEL_ERROR, "BIO setup failure." );
     return -1;
   }
-  (void)BIO_set_ssl(ssl->bio_ssl, ssl->ssl, BIO_NOCLOSE);
-
-  // create the "lower" BIO "pipe", and attach it below the SSL layer
-  if (!BIO_new_bio_pair(&ssl->bio_ssl_io, 0, &ssl->bio_net_io, 0)) {
-    ssl_log(transport, PN_LEVEL_ERROR, "BIO setup failure." );
-    return -1;
-  }
-  SSL_set_bio(ssl->ssl, ssl->bio_ssl_io, ssl->bio_ssl_io);
+  BIO_set_data(bio, ssl);
+  SSL_set_bio(ssl->ssl, bio, bio);
+  // app output moves up outbuf between writes
+  SSL_set_mode(ssl->ssl, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 
   if (ssl->mode == PN_SSL_MODE_SERVER) {
     SSL_set_accept_state(ssl->ssl);
-    BIO_set_ssl_mode(ssl->bio_ssl, 0);  // server mode
     ssl_log( transport, PN_LEVEL_TRACE, "Server SSL socket created." );
   } else {      // client mode
     SSL_set_connect_state(ssl->ssl);
-    BIO_set_ssl_mode(ssl->bio_ssl, 1);  // client mode
     ssl_log( transport, PN_LEVEL_TRACE, "Client SSL socket created." );
   }
   ssl->subject = NULL;
@@ -1476,16 +1859,11 @@ static int init_ssl_socket(pn_transport_t* transport, pni_ssl_t *ssl, pn_ssl_dom
 
 static void release_ssl_socket(pni_ssl_t *ssl)
 {
-  if (ssl->bio_ssl) BIO_free(ssl->bio_ssl);
-  if (ssl->ssl) {
-    SSL_free(ssl->ssl);       // will free bio_ssl_io
-  } else {
-    if (ssl->bio_ssl_io) BIO_free(ssl->bio_ssl_io);
-  }
-  if (ssl->bio_net_io) BIO_free(ssl->bio_net_io);
-  ssl->bio_ssl = NULL;
-  ssl->bio_ssl_io = NULL;
-  ssl->bio_net_io = NULL;
+  if (ssl->ssl) SSL_free(ssl->ssl);       // will free the network BIO
+  free(ssl->net_pending);
+  ssl->net_pending = NULL;
+  ssl->net_pending_size = 0;
+  ssl->net_pending_count = 0;
   ssl->ssl = NULL;
 }
 
@@ -1710,9 +2088,7 @@ static size_t buffered_output(pn_transport_t *transport)
   pni_ssl_t *ssl = transport->ssl;
   if (ssl) {
     count += ssl->out_count;
-    if (ssl->bio_net_io) { // pick up any bytes waiting for network io
-      count += BIO_ctrl_pending(ssl->bio_net_io);
-    }
+    count += ssl->net_pending_count; // pick up any bytes waiting for network io
   }
   return count;
 }
@@ -1724,10 +2100,6 @@ static bool init_ok = false;
 
 #ifdef _WIN32
 
-typedef CRITICAL_SECTION pni_mutex_t;
-static inline void pni_mutex_init(pni_mutex_t *m) { InitializeCriticalSection(m); }
-static inline void pni_mutex_lock(pni_mutex_t *m) { EnterCriticalSection(m); }
-static inline void pni_mutex_unlock(pni_mutex_t *m) { LeaveCriticalSection(m); }
 static inline unsigned long id_callback(void) { return (unsigned long)GetCurrentThreadId(); }
 INIT_ONCE initialize_once = INIT_ONCE_STATIC_INIT;
 static inline bool ensure_initialized(void) {
@@ -1738,14 +2110,8 @@ static inline bool ensure_initialized(void) {
 
 #else  /* POSIX */
 
-#include <pthread.h>
-
 static void initialize(void);
 
-typedef pthread_mutex_t pni_mutex_t;
-static inline int pni_mutex_init(pni_mutex_t *m) { return pthread_mutex_init(m, NULL); }
-static inline int pni_mutex_lock(pni_mutex_t *m) { return pthread_mutex_lock(m); }
-static inline int pni_mutex_unlock(pni_mutex_t *m) { return pthread_mutex_unlock(m); }
 static inline unsigned long id_callback(void) { return (unsigned long)pthread_self(); }
 static pthread_once_t initialize_once = PTHREAD_ONCE_INIT;
 static inline bool ensure_initialized(void) {
@@ -1772,7 +2138,9 @@ static void initialize(void) {
   OpenSSL_add_all_algorithms();
   ssl_ex_data_index = SSL_get_ex_new_index( 0, (void *) "org.apache.qpid.proton.ssl",
                                             NULL, NULL, NULL);
-  ssn_init();
+  ssn_cache_ex_data_index = SSL_CTX_get_ex_new_index(0, (void *) "org.apache.qpid.proton.ssl.sessions",
+                                                    NULL, NULL, ssn_cache_free);
+  net_bio_method = net_bio_method_new();
   locks = (pni_mutex_t*)malloc(CRYPTO_num_locks() * sizeof(pni_mutex_t));
   if (!locks) return;
   for(i = 0;  i < CRYPTO_num_locks();  i++)
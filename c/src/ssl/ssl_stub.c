@@ -120,6 +120,22 @@ int pn_ssl_domain_allow_unsecured_client(pn_ssl_domain_t *domain)
   return -1;
 }
 
+int pn_ssl_domain_set_session_cache(pn_ssl_domain_t *domain, size_t size, unsigned timeout)
+{
+  return -1;
+}
+
+int pn_ssl_domain_set_session_ticket_keys(pn_ssl_domain_t *domain, const char *keys, size_t size)
+{
+  return -1;
+}
+
+void pn_ssl_domain_get_session_stats(pn_ssl_domain_t *domain, uint64_t *hits, uint64_t *misses)
+{
+  if (hits) *hits = 0;
+  if (misses) *misses = 0;
+}
+
 int pn_ssl_domain_set_ciphers(pn_ssl_domain_t *domain, const char *ciphers)
 {
   return -1;
@@ -109,6 +109,28 @@ typedef struct pbuffer_t {
 
 
 
+/* Thread-safe locking for POSIX and Windows */
+
+#ifdef _WIN32
+
+typedef CRITICAL_SECTION pni_mutex_t;
+static inline void pni_mutex_init(pni_mutex_t *m) { InitializeCriticalSection(m); }
+static inline void pni_mutex_destroy(pni_mutex_t *m) { DeleteCriticalSection(m); }
+static inline void pni_mutex_lock(pni_mutex_t *m) { EnterCriticalSection(m); }
+static inline void pni_mutex_unlock(pni_mutex_t *m) { LeaveCriticalSection(m); }
+
+#else  /* POSIX */
+
+#include <pthread.h>
+
+typedef pthread_mutex_t pni_mutex_t;
+static inline int pni_mutex_init(pni_mutex_t *m) { return pthread_mutex_init(m, NULL); }
+static inline int pni_mutex_destroy(pni_mutex_t *m) { return pthread_mutex_destroy(m); }
+static inline int pni_mutex_lock(pni_mutex_t *m) { return pthread_mutex_lock(m); }
+static inline int pni_mutex_unlock(pni_mutex_t *m) { return pthread_mutex_unlock(m); }
+
+#endif
+
 typedef struct pn_tls_session_t pn_tls_session_t;
 
 static int tls_ex_data_index;
@@ -134,6 +156,11 @@ struct pn_tls_config_t {
   bool has_certificate; // true when certificate configured
   unsigned char *alpn_list;
   unsigned int alpn_list_len;
+
+  // handshakes completed by pn_tls_t objects using this config
+  pni_mutex_t stats_lock;
+  uint64_t session_hits;      // resumed a session
+  uint64_t session_misses;    // full handshake
 };
 
 struct pn_tls_t {
@@ -851,6 +878,14 @@ static bool pni_init_ssl_domain( pn_tls_config_t * domain, pn_tls_mode_t mode )
     return false;
   }
 
+  if (mode == PN_TLS_MODE_SERVER) {
+    // Required to resume sessions with verified clients, the same for every
+    // config so tickets stay valid across restarts given the same ticket keys
+    static const unsigned char sid_ctx[] = "org.apache.qpid.proton";
+    SSL_CTX_set_session_id_context(domain->ctx, sid_ctx, sizeof(sid_ctx) - 1);
+  }
+  pni_mutex_init(&domain->stats_lock);
+
   // By default set up system default certificates
   if (!SSL_CTX_set_default_verify_paths(domain->ctx)){
     ssl_log_error("Failed to set default certificate paths");
@@ -907,6 +942,7 @@ void pn_tls_config_free( pn_tls_config_t *domain )
   if (--domain->ref_count == 0) {
 
     SSL_CTX_free(domain->ctx);
+    pni_mutex_destroy(&domain->stats_lock);
     free(domain->keyfile_pw);
     free(domain->trusted_CAs);
     free(domain->ciphers);
@@ -1487,10 +1523,6 @@ static bool init_ok = false;
 
 #ifdef _WIN32
 
-typedef CRITICAL_SECTION pni_mutex_t;
-static inline void pni_mutex_init(pni_mutex_t *m) { InitializeCriticalSection(m); }
-static inline void pni_mutex_lock(pni_mutex_t *m) { EnterCriticalSection(m); }
-static inline void pni_mutex_unlock(pni_mutex_t *m) { LeaveCriticalSection(m); }
 static inline unsigned long id_callback(void) { return (unsigned long)GetCurrentThreadId(); }
 INIT_ONCE initialize_once = INIT_ONCE_STATIC_INIT;
 static inline bool ensure_initialized(void) {
@@ -1501,14 +1533,8 @@ static inline bool ensure_initialized(void) {
 
 #else  /* POSIX */
 
-#include <pthread.h>
-
 static void initialize(void);
 
-typedef pthread_mutex_t pni_mutex_t;
-static inline int pni_mutex_init(pni_mutex_t *m) { return pthread_mutex_init(m, NULL); }
-static inline int pni_mutex_lock(pni_mutex_t *m) { return pthread_mutex_lock(m); }
-static inline int pni_mutex_unlock(pni_mutex_t *m) { return pthread_mutex_unlock(m); }
 static inline unsigned long id_callback(void) { return (unsigned long)pthread_self(); }
 static pthread_once_t initialize_once = PTHREAD_ONCE_INIT;
 static inline bool ensure_initialized(void) {
@@ -2202,6 +2228,11 @@ static void decrypt(pn_tls_t *tls) {
   if (!tls->handshake_ok && SSL_do_handshake(tls->ssl) == 1) {
     tls->handshake_ok = true;
     tls->can_shutdown = true;
+    bool reused = SSL_session_reused(tls->ssl);
+    pni_mutex_lock(&tls->domain->stats_lock);
+    if (reused) ++tls->domain->session_hits;
+    else ++tls->domain->session_misses;
+    pni_mutex_unlock(&tls->domain->stats_lock);
   }
 }
 
@@ -2356,6 +2387,51 @@ static int pn_tls_alpn_cb(SSL *ssn,
   return SSL_TLSEXT_ERR_OK;;
 }
 
+int pn_tls_config_set_session_cache(pn_tls_config_t *domain, size_t size, unsigned timeout)
+{
+  if (!domain) return PN_ARG_ERR;
+  if (domain->mode != PN_TLS_MODE_SERVER) {
+    ssl_log_error("Cannot configure the session cache - not a server.");
+    return PN_ARG_ERR;
+  }
+  SSL_CTX_set_session_cache_mode(domain->ctx, size ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_OFF);
+  if (size) SSL_CTX_sess_set_cache_size(domain->ctx, (long)size);
+  if (timeout) SSL_CTX_set_timeout(domain->ctx, (long)timeout);
+  return 0;
+}
+
+int pn_tls_config_set_session_ticket_keys(pn_tls_config_t *domain, const char *keys, size_t size)
+{
+  if (!domain) return PN_ARG_ERR;
+  if (domain->mode != PN_TLS_MODE_SERVER) {
+    ssl_log_error("Cannot set session ticket keys - not a server.");
+    return PN_ARG_ERR;
+  }
+  if (!keys) {
+    SSL_CTX_set_options(domain->ctx, SSL_OP_NO_TICKET);
+    return 0;
+  }
+  // The required size depends on the OpenSSL version
+  if (size != (size_t)SSL_CTX_get_tlsext_ticket_keys(domain->ctx, NULL, 0)) {
+    ssl_log_error("Session ticket keys must be %ld bytes", SSL_CTX_get_tlsext_ticket_keys(domain->ctx, NULL, 0));
+    return PN_ARG_ERR;
+  }
+  if (SSL_CTX_set_tlsext_ticket_keys(domain->ctx, (void *)keys, (long)size) != 1) {
+    ssl_log_error("Failed to set session ticket keys");
+    return PN_ERR;
+  }
+  SSL_CTX_clear_options(domain->ctx, SSL_OP_NO_TICKET);
+  return 0;
+}
+
+void pn_tls_config_get_session_stats(pn_tls_config_t *domain, uint64_t *hits, uint64_t *misses)
+{
+  if (domain) pni_mutex_lock(&domain->stats_lock);
+  if (hits) *hits = domain ? domain->session_hits : 0;
+  if (misses) *misses = domain ? domain->session_misses : 0;
+  if (domain) pni_mutex_unlock(&domain->stats_lock);
+}
+
 int pn_tls_config_set_alpn_protocols(pn_tls_config_t *domain, const char **protocols, size_t protocol_count) {
   unsigned char *wire_bytes;
   size_t wb_len;
@@ -28,7 +28,9 @@
 #include <proton/session.h>
 #include <proton/transport.h>
 
+#include <algorithm>
 #include <string.h>
+#include <vector>
 
 using Catch::Matchers::EndsWith;
 using Catch::Matchers::Equals;
@@ -618,3 +620,620 @@ TEST_CASE("driver_empty_last_frame") {
              cond_empty());
   CHECK_THAT(*pn_connection_condition(d.server.connection), cond_empty());
 }
+
+/* Large payloads are written as segments without copying them into the write
+ * buffer.
+ */
+TEST_CASE("driver_message_write_buffers") {
+  send_client_handler client;
+  delivery_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_flow(rcv, 1);
+  d.run();
+
+  /* Several max-frames worth of data */
+  std::vector<char> data(100 * 1024);
+  for (size_t i = 0; i < data.size(); ++i) data[i] = (char)(i % 251);
+  pn_delivery(snd, pn_bytes("x"));
+  CHECK(data.size() == (size_t)pn_link_send(snd, data.data(), data.size()));
+  CHECK(pn_link_advance(snd));
+
+  /* Shovel the client output segment by segment */
+  pn_bytes_t segs[16];
+  size_t n, largest = 0;
+  while ((n = pn_connection_driver_write_buffers(&d.client, segs, 16))) {
+    size_t written = 0;
+    for (size_t i = 0; i < n; ++i) {
+      largest = std::max(largest, segs[i].size);
+      for (size_t done = 0; done < segs[i].size;) {
+        pn_rwbytes_t rb = pn_connection_driver_read_buffer(&d.server);
+        REQUIRE(rb.size > 0);
+        size_t c = std::min(rb.size, segs[i].size - done);
+        memcpy(rb.start, segs[i].start + done, c);
+        pn_connection_driver_read_done(&d.server, c);
+        done += c;
+      }
+      written += segs[i].size;
+    }
+    pn_connection_driver_write_done(&d.client, written);
+  }
+  CHECK(largest > 16 * 1024); /* Payload segments are whole frames worth */
+
+  d.run();
+  pn_delivery_t *dlv = server.delivery;
+  REQUIRE(dlv);
+  CHECK(!pn_delivery_partial(dlv));
+  std::vector<char> received(data.size());
+  CHECK(data.size() ==
+        (size_t)pn_link_recv(rcv, received.data(), received.size()));
+  CHECK(data == received);
+  CHECK_THAT(*pn_connection_condition(d.server.connection), cond_empty());
+}
+
+/* Many unsettled deliveries, more than fit in the delivery map's ring, settled
+ * out of order.
+ */
+TEST_CASE("driver_many_unsettled") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  static const int N = 70000;
+  pn_link_flow(rcv, N);
+  d.run();
+
+  std::vector<pn_delivery_t *> sent;
+  for (int i = 0; i < N; ++i) {
+    sent.push_back(pn_delivery(snd, pn_dtag((const char *)&i, sizeof(i))));
+    CHECK(pn_link_advance(snd));
+  }
+  d.run();
+  REQUIRE(N == pn_link_queued(rcv));
+
+  std::vector<pn_delivery_t *> received;
+  for (pn_delivery_t *dlv = pn_unsettled_head(rcv); dlv;
+       dlv = pn_unsettled_next(dlv)) {
+    received.push_back(dlv);
+  }
+  REQUIRE(N == (int)received.size());
+
+  /* Keep the first delivery unsettled while settling the rest backwards */
+  for (int i = N - 1; i > 0; --i) {
+    pn_delivery_update(received[i], PN_ACCEPTED);
+    pn_delivery_settle(received[i]);
+  }
+  d.run();
+  CHECK(!pn_delivery_remote_state(sent[0]));
+  for (int i = 1; i < N; ++i) {
+    REQUIRE(pn_delivery_settled(sent[i]));
+    REQUIRE(PN_ACCEPTED == pn_delivery_remote_state(sent[i]));
+  }
+
+  pn_delivery_update(received[0], PN_REJECTED);
+  pn_delivery_settle(received[0]);
+  d.run();
+  CHECK(pn_delivery_settled(sent[0]));
+  CHECK(PN_REJECTED == pn_delivery_remote_state(sent[0]));
+  CHECK_THAT(*pn_connection_condition(d.server.connection), cond_empty());
+  CHECK_THAT(*pn_connection_condition(d.client.connection), cond_empty());
+}
+
+/* Deliveries settled by the peer in one batch raise a single event and are
+ * retrieved from the link's remote settled list.
+ */
+TEST_CASE("driver_coalesce_settled") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_set_coalesce_settled(snd, true);
+  CHECK(pn_link_get_coalesce_settled(snd));
+  static const int N = 100;
+  pn_link_flow(rcv, N);
+  d.run();
+
+  std::vector<pn_delivery_t *> sent;
+  for (int i = 0; i < N; ++i) {
+    sent.push_back(pn_delivery(snd, pn_dtag((const char *)&i, sizeof(i))));
+    CHECK(pn_link_advance(snd));
+  }
+  d.run();
+  REQUIRE(N == pn_link_queued(rcv));
+  client.log_clear();
+
+  /* Settle out of order, all before running the drivers */
+  std::vector<pn_delivery_t *> received;
+  for (pn_delivery_t *dlv = pn_unsettled_head(rcv); dlv;
+       dlv = pn_unsettled_next(dlv)) {
+    received.push_back(dlv);
+  }
+  REQUIRE(N == (int)received.size());
+  for (int i = 0; i < N; i += 2) {
+    pn_delivery_update(received[i], PN_ACCEPTED);
+    pn_delivery_settle(received[i]);
+  }
+  for (int i = 1; i < N; i += 2) {
+    pn_delivery_update(received[i], PN_ACCEPTED);
+    pn_delivery_settle(received[i]);
+  }
+  d.run();
+  CHECK_THAT((etypes{PN_LINK_REMOTE_SETTLED}), Equals(client.log_clear()));
+  CHECK(N == (int)pn_link_remote_settled(snd));
+
+  std::vector<pn_delivery_t *> settled;
+  pn_delivery_t *dlv;
+  while ((dlv = pn_link_remote_settled_next(snd))) {
+    CHECK(pn_delivery_settled(dlv));
+    CHECK(PN_ACCEPTED == pn_delivery_remote_state(dlv));
+    settled.push_back(dlv);
+    pn_delivery_settle(dlv);
+  }
+  CHECK(0 == pn_link_remote_settled(snd));
+  CHECK(0 == pn_link_unsettled(snd));
+  std::sort(sent.begin(), sent.end());
+  std::sort(settled.begin(), settled.end());
+  CHECK(sent == settled);
+
+  /* Settling locally first removes a delivery from the list */
+  pn_link_flow(rcv, 2);
+  d.run();
+  pn_delivery_t *d1 = pn_delivery(snd, pn_dtag("a", 1));
+  CHECK(pn_link_advance(snd));
+  pn_delivery(snd, pn_dtag("b", 1));
+  CHECK(pn_link_advance(snd));
+  d.run();
+  for (pn_delivery_t *r = pn_unsettled_head(rcv); r; r = pn_unsettled_head(rcv)) {
+    pn_delivery_settle(r);
+  }
+  d.run();
+  CHECK(2 == pn_link_remote_settled(snd));
+  pn_delivery_settle(d1);
+  CHECK(1 == pn_link_remote_settled(snd));
+  dlv = pn_link_remote_settled_next(snd);
+  REQUIRE(dlv);
+  CHECK(dlv != d1);
+  pn_delivery_settle(dlv);
+  CHECK(!pn_link_remote_settled_next(snd));
+  CHECK_THAT(*pn_connection_condition(d.client.connection), cond_empty());
+}
+
+/* Tags and payloads either side of the sizes kept inline in a delivery */
+TEST_CASE("driver_inline_tag_payload") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_flow(rcv, 100);
+  d.run();
+
+  size_t tag_sizes[] = {0, 8, 32, 33, 255};
+  size_t payload_sizes[] = {1, 256, 257, 5000};
+  for (size_t tag_size : tag_sizes) {
+    for (size_t payload_size : payload_sizes) {
+      std::string tag(tag_size, 't');
+      for (size_t i = 0; i < tag_size; ++i) tag[i] = char('a' + i % 26);
+      std::string payload(payload_size, 'p');
+      payload[0] = char(tag_size);
+      pn_delivery_t *sd = pn_delivery(snd, pn_dtag(tag.data(), tag.size()));
+      pn_delivery_tag_t st = pn_delivery_tag(sd);
+      CHECK(tag == std::string(st.start ? st.start : "", st.size));
+      /* Send in two pieces to cross the inline boundary while unsent */
+      size_t half = payload_size / 2;
+      CHECK((ssize_t)half == pn_link_send(snd, payload.data(), half));
+      CHECK((ssize_t)(payload_size - half) ==
+            pn_link_send(snd, payload.data() + half, payload_size - half));
+      CHECK(pn_link_advance(snd));
+      d.run();
+
+      pn_delivery_t *rd = pn_link_current(rcv);
+      REQUIRE(rd);
+      pn_delivery_tag_t rt = pn_delivery_tag(rd);
+      CHECK(tag == std::string(rt.start ? rt.start : "", rt.size));
+      REQUIRE(payload_size == pn_delivery_pending(rd));
+      std::string received(payload_size, '\0');
+      CHECK((ssize_t)payload_size == pn_link_recv(rcv, &received[0], payload_size));
+      CHECK(payload == received);
+      CHECK(pn_link_advance(rcv));
+      pn_delivery_settle(rd);
+      pn_delivery_settle(sd);
+      d.run();
+    }
+  }
+  CHECK_THAT(*pn_connection_condition(d.client.connection), cond_empty());
+}
+
+/* Decode a message in place from the delivery's bytes */
+TEST_CASE("driver_message_decode_borrowed") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_flow(rcv, 1);
+  d.run();
+
+  std::string payload(100000, 'x');
+  auto_free<pn_message_t, pn_message_free> m(pn_message());
+  pn_message_set_address(m, "example");
+  pn_data_put_binary(pn_message_body(m), pn_bytes(payload.size(), payload.data()));
+  pn_delivery(snd, pn_dtag("a", 1));
+  REQUIRE(0 < pn_message_send(m, snd, NULL));
+  d.run();
+
+  pn_delivery_t *dlv = pn_link_current(rcv);
+  REQUIRE(dlv);
+  REQUIRE(!pn_delivery_partial(dlv));
+  pn_bytes_t bytes = pn_delivery_bytes(dlv);
+  CHECK(pn_delivery_pending(dlv) == bytes.size);
+
+  auto_free<pn_message_t, pn_message_free> m2(pn_message());
+  REQUIRE(0 == pn_message_decode_borrowed(m2, bytes.start, bytes.size));
+  size_t incoming = pn_session_incoming_bytes(pn_link_session(rcv));
+  CHECK(bytes.size == incoming);
+  CHECK(pn_link_advance(rcv));
+  CHECK(0 == pn_session_incoming_bytes(pn_link_session(rcv)));
+
+  /* Still valid after advancing, until the delivery is settled */
+  CHECK("example" == std::string(pn_message_get_address(m2)));
+  pn_bytes_t body = pn_message_get_body_bytes(m2);
+  CHECK(body.start >= bytes.start);
+  CHECK(body.start + body.size <= bytes.start + bytes.size);
+  CHECK(payload == std::string(body.start, body.size));
+  pn_delivery_settle(dlv);
+  pn_message_clear(m2);
+  d.run();
+  CHECK_THAT(*pn_connection_condition(d.client.connection), cond_empty());
+}
+
+TEST_CASE("driver_delivery_peek_consume") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_flow(rcv, 1);
+  d.run();
+
+  std::string payload(10000, 'y');
+  pn_delivery(snd, pn_dtag("a", 1));
+  REQUIRE(payload.size() == (size_t)pn_link_send(snd, payload.data(), payload.size()));
+  pn_link_advance(snd);
+  d.run();
+
+  pn_delivery_t *dlv = pn_link_current(rcv);
+  REQUIRE(dlv);
+  pn_session_t *ssn = pn_link_session(rcv);
+  pn_bytes_t spans[2];
+  size_t n = pn_delivery_peek_bytes(dlv, spans);
+  REQUIRE(n >= 1);
+  std::string got(spans[0].start, spans[0].size);
+  if (n == 2) got.append(spans[1].start, spans[1].size);
+  CHECK(payload == got);
+  CHECK(payload.size() == pn_session_incoming_bytes(ssn));
+
+  /* Consuming releases the bytes from the session like pn_link_recv */
+  CHECK(1000 == pn_delivery_consume(dlv, 1000));
+  CHECK(payload.size() - 1000 == pn_delivery_pending(dlv));
+  CHECK(payload.size() - 1000 == pn_session_incoming_bytes(ssn));
+  n = pn_delivery_peek_bytes(dlv, spans);
+  REQUIRE(n >= 1);
+  CHECK(payload.size() - 1000 == spans[0].size + (n == 2 ? spans[1].size : 0));
+
+  /* Consuming more than is pending is clamped */
+  CHECK((ssize_t)(payload.size() - 1000) == pn_delivery_consume(dlv, payload.size()));
+  CHECK(0 == pn_delivery_pending(dlv));
+  CHECK(0 == pn_session_incoming_bytes(ssn));
+  CHECK(0 == pn_delivery_peek_bytes(dlv, spans));
+  CHECK(PN_EOS == pn_link_recv(rcv, NULL, 0));
+
+  /* Only received deliveries can be consumed */
+  CHECK(PN_STATE_ERR == pn_delivery_consume(pn_unsettled_head(snd), 1));
+  pn_delivery_settle(dlv);
+  d.run();
+  CHECK_THAT(*pn_connection_condition(d.client.connection), cond_empty());
+}
+
+TEST_CASE("driver_delivery_forward") {
+  open_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  pn_connection_open(d.client.connection);
+  pn_session_t *ssn = pn_session(d.client.connection);
+  pn_session_open(ssn);
+  pn_link_t *snd = pn_sender(ssn, "in");
+  pn_link_open(snd);
+  pn_link_t *rcv = pn_receiver(ssn, "out");
+  pn_link_open(rcv);
+  pn_link_flow(rcv, 2);
+  d.run();
+
+  /* Server side receives on "in" and forwards on "out" */
+  pn_link_t *in = NULL, *out = NULL;
+  for (pn_link_t *l = pn_link_head(d.server.connection, 0); l; l = pn_link_next(l, 0)) {
+    if (pn_link_is_receiver(l)) in = l; else out = l;
+  }
+  REQUIRE(in);
+  REQUIRE(out);
+  pn_link_flow(in, 2);
+  d.run();
+
+  std::string payload(1000, 'z');
+  auto_free<pn_message_t, pn_message_free> m(pn_message());
+  pn_message_set_durable(m, true);
+  pn_data_put_map(pn_message_instructions(m));
+  pn_data_enter(pn_message_instructions(m));
+  pn_data_put_symbol(pn_message_instructions(m), pn_bytes("di"));
+  pn_data_put_int(pn_message_instructions(m), 1);
+  pn_data_exit(pn_message_instructions(m));
+  pn_message_set_address(m, "queue");
+  pn_data_put_binary(pn_message_body(m), pn_bytes(payload.size(), payload.data()));
+  pn_delivery(snd, pn_dtag("a", 1));
+  REQUIRE(0 < pn_message_send(m, snd, NULL));
+  pn_delivery(snd, pn_dtag("b", 1));
+  REQUIRE(0 < pn_message_send(m, snd, NULL));
+  d.run();
+
+  auto_free<pn_data_t, pn_data_free> annotations(pn_data(0));
+  pn_data_put_map(annotations);
+  pn_data_enter(annotations);
+  pn_data_put_symbol(annotations, pn_bytes("x-hops"));
+  pn_data_put_int(annotations, 1);
+  pn_data_exit(annotations);
+
+  /* First as it is, second with new annotations */
+  for (int i = 0; i < 2; ++i) {
+    pn_delivery_t *dlv = pn_link_current(in);
+    REQUIRE(dlv);
+    REQUIRE(!pn_delivery_partial(dlv));
+    size_t size = pn_delivery_pending(dlv);
+    CHECK(PN_EOS == pn_delivery_forward(dlv, out, NULL));
+    pn_delivery(out, pn_dtag(i ? "2" : "1", 1));
+    ssize_t n = pn_delivery_forward(dlv, out, i ? annotations.get() : NULL);
+    if (i) CHECK((size_t)n > size); else CHECK((size_t)n == size);
+    CHECK(0 == pn_delivery_pending(dlv));
+    CHECK(PN_STATE_ERR == pn_delivery_forward(dlv, out, NULL));
+    CHECK(pn_link_advance(out));
+    CHECK(pn_link_advance(in));
+    pn_delivery_settle(dlv);
+  }
+  CHECK(0 == pn_session_incoming_bytes(pn_link_session(in)));
+  CHECK(PN_ARG_ERR == pn_delivery_forward(pn_unsettled_head(out), in, NULL));
+  d.run();
+
+  for (int i = 0; i < 2; ++i) {
+    pn_delivery_t *dlv = pn_link_current(rcv);
+    REQUIRE(dlv);
+    REQUIRE(!pn_delivery_partial(dlv));
+    pn_bytes_t bytes = pn_delivery_bytes(dlv);
+    auto_free<pn_message_t, pn_message_free> m2(pn_message());
+    REQUIRE(0 == pn_message_decode(m2, bytes.start, bytes.size));
+    CHECK(pn_message_is_durable(m2));
+    CHECK("queue" == std::string(pn_message_get_address(m2)));
+    CHECK_THAT(i ? "{:\"x-hops\"=1}" : "", Equals(inspect(pn_message_annotations(m2))));
+    CHECK_THAT("{:di=1}", Equals(inspect(pn_message_instructions(m2))));
+    pn_bytes_t body = pn_message_get_body_bytes(m2);
+    CHECK(payload == std::string(body.start, body.size));
+    pn_link_advance(rcv);
+    pn_delivery_settle(dlv);
+  }
+  d.run();
+  CHECK_THAT(*pn_connection_condition(d.client.connection), cond_empty());
+  CHECK_THAT(*pn_connection_condition(d.server.connection), cond_empty());
+}
+
+namespace {
+void count_completion(void *context) { ++*(int *)context; }
+} // namespace
+
+/* Lent segments are written in place once the delivery is complete, and
+ * released once written.
+ */
+TEST_CASE("driver_link_sendv") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_flow(rcv, 3);
+  d.run();
+
+  std::string head(100, 'h'), tail(5000, 't');
+  std::vector<char> body(100 * 1024);
+  for (size_t i = 0; i < body.size(); ++i) body[i] = (char)(i % 251);
+  pn_bytes_t parts[] = {pn_bytes(head.size(), head.data()), pn_bytes(0, NULL),
+                        pn_bytes(body.size(), body.data()),
+                        pn_bytes(tail.size(), tail.data())};
+  std::string expect = head + std::string(body.begin(), body.end()) + tail;
+
+  SECTION("copied") {
+    pn_delivery(snd, pn_bytes("x"));
+    CHECK((ssize_t)expect.size() == pn_link_sendv(snd, parts, 4, NULL, NULL));
+    CHECK(expect.size() == pn_delivery_pending(pn_link_current(snd)));
+    CHECK(pn_link_advance(snd));
+    d.run();
+  }
+
+  SECTION("lent, copied by a contiguous writer") {
+    int done = 0;
+    pn_delivery(snd, pn_bytes("x"));
+    CHECK((ssize_t)expect.size() == pn_link_sendv(snd, parts, 4, count_completion, &done));
+    CHECK(expect.size() == pn_delivery_pending(pn_link_current(snd)));
+    CHECK(expect.size() == pn_session_outgoing_bytes(pn_link_session(snd)));
+    CHECK(pn_link_advance(snd));
+    CHECK(0 == done);
+    d.run();
+    CHECK(1 == done);
+    CHECK(0 == pn_session_outgoing_bytes(pn_link_session(snd)));
+  }
+
+  SECTION("lent, written in place") {
+    int done = 0;
+    pn_delivery(snd, pn_bytes("x"));
+    CHECK((ssize_t)expect.size() == pn_link_sendv(snd, parts, 4, count_completion, &done));
+    CHECK(pn_link_advance(snd));
+
+    bool in_place = false;
+    pn_bytes_t segs[16];
+    size_t n;
+    while ((n = pn_connection_driver_write_buffers(&d.client, segs, 16))) {
+      size_t written = 0;
+      for (size_t i = 0; i < n; ++i) {
+        in_place = in_place || (segs[i].start >= body.data() && segs[i].start < body.data() + body.size());
+        for (size_t c = 0; c < segs[i].size;) {
+          pn_rwbytes_t rb = pn_connection_driver_read_buffer(&d.server);
+          REQUIRE(rb.size > 0);
+          size_t m = std::min(rb.size, segs[i].size - c);
+          memcpy(rb.start, segs[i].start + c, m);
+          pn_connection_driver_read_done(&d.server, m);
+          c += m;
+        }
+        written += segs[i].size;
+      }
+      CHECK(0 == done);
+      pn_connection_driver_write_done(&d.client, written);
+    }
+    CHECK(in_place);
+    CHECK(1 == done);
+    d.run();
+  }
+
+  SECTION("lent then copied") {
+    int done = 0;
+    pn_delivery(snd, pn_bytes("x"));
+    CHECK((ssize_t)(head.size() + body.size()) == pn_link_sendv(snd, parts, 3, count_completion, &done));
+    CHECK((ssize_t)tail.size() == pn_link_send(snd, tail.data(), tail.size()));
+    CHECK(1 == done); /* Copied to keep the data in order */
+    CHECK(expect.size() == pn_delivery_pending(pn_link_current(snd)));
+    CHECK(pn_link_advance(snd));
+    d.run();
+  }
+
+  SECTION("lent and aborted") {
+    int done = 0;
+    pn_delivery(snd, pn_bytes("x"));
+    CHECK((ssize_t)expect.size() == pn_link_sendv(snd, parts, 4, count_completion, &done));
+    pn_delivery_abort(pn_link_current(snd));
+    CHECK(1 == done);
+    CHECK(0 == pn_session_outgoing_bytes(pn_link_session(snd)));
+    d.run();
+    CHECK(!pn_link_current(rcv));
+    return;
+  }
+
+  pn_delivery_t *dlv = pn_link_current(rcv);
+  REQUIRE(dlv);
+  CHECK(!pn_delivery_partial(dlv));
+  pn_bytes_t bytes = pn_delivery_bytes(dlv);
+  CHECK(expect == std::string(bytes.start, bytes.size));
+  CHECK_THAT(*pn_connection_condition(d.server.connection), cond_empty());
+  CHECK_THAT(*pn_connection_condition(d.client.connection), cond_empty());
+}
+
+/* Payload written in place can be held after it is written, for IO that
+ * goes on reading it, until its tag is released.
+ */
+TEST_CASE("driver_write_hold") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_flow(rcv, 1);
+  d.run();
+
+  std::vector<char> body(100 * 1024);
+  for (size_t i = 0; i < body.size(); ++i) body[i] = (char)(i % 251);
+  pn_bytes_t part = pn_bytes(body.size(), body.data());
+  int done = 0;
+  pn_delivery(snd, pn_bytes("x"));
+  CHECK((ssize_t)body.size() == pn_link_sendv(snd, &part, 1, count_completion, &done));
+  CHECK(pn_link_advance(snd));
+
+  uint32_t tag = 0xfffffffe; /* Tags wrap around */
+  size_t held = 0;
+  pn_bytes_t segs[2]; /* Write a few segments at a time */
+  size_t n;
+  while ((n = pn_connection_driver_write_buffers(&d.client, segs, 2))) {
+    size_t written = 0;
+    for (size_t i = 0; i < n; ++i) {
+      bool in_place = segs[i].start >= body.data() && segs[i].start < body.data() + body.size();
+      CHECK(in_place == pn_connection_driver_write_hold(&d.client, segs[i], tag));
+      if (in_place) ++held;
+      for (size_t c = 0; c < segs[i].size;) {
+        pn_rwbytes_t rb = pn_connection_driver_read_buffer(&d.server);
+        REQUIRE(rb.size > 0);
+        size_t m = std::min(rb.size, segs[i].size - c);
+        memcpy(rb.start, segs[i].start + c, m);
+        pn_connection_driver_read_done(&d.server, m);
+        c += m;
+      }
+      written += segs[i].size;
+    }
+    pn_connection_driver_write_done(&d.client, written);
+    ++tag;
+  }
+  CHECK(held > 1); /* Sent in several frames */
+  CHECK(0 == done);
+  pn_connection_driver_write_release(&d.client, 0xfffffffe);
+  CHECK(0 == done);
+  pn_connection_driver_write_release(&d.client, tag);
+  CHECK(1 == done);
+
+  d.run();
+  pn_delivery_t *dlv = pn_link_current(rcv);
+  REQUIRE(dlv);
+  CHECK(!pn_delivery_partial(dlv));
+  pn_bytes_t bytes = pn_delivery_bytes(dlv);
+  CHECK(std::string(body.begin(), body.end()) == std::string(bytes.start, bytes.size));
+}
+
+/* Shrinking buffers frees grown space and the connection carries on */
+TEST_CASE("driver_shrink_buffers") {
+  send_client_handler client;
+  open_handler server;
+  pn_test::driver_pair d(client, server);
+
+  d.run();
+  pn_link_t *rcv = server.link;
+  pn_link_t *snd = client.link;
+  pn_link_flow(rcv, 1);
+  d.run();
+
+  CHECK(pn_connection_driver_read_buffer_sized(&d.server, 32 * 1024).size >= 32 * 1024);
+  CHECK(pn_connection_driver_shrink_buffers(&d.server, 1024) >= 31 * 1024);
+  CHECK(1024 == pn_connection_driver_read_buffer(&d.server).size);
+  CHECK(0 == pn_connection_driver_shrink_buffers(&d.server, 1024));
+
+  std::string body(16 * 1024, 'x');
+  pn_delivery(snd, pn_bytes("x"));
+  CHECK((ssize_t)body.size() == pn_link_send(snd, body.data(), body.size()));
+  CHECK(pn_link_advance(snd));
+  d.run();
+  pn_delivery_t *dlv = pn_link_current(rcv);
+  REQUIRE(dlv);
+  CHECK(!pn_delivery_partial(dlv));
+  pn_bytes_t bytes = pn_delivery_bytes(dlv);
+  CHECK(body == std::string(bytes.start, bytes.size));
+}
@@ -24,6 +24,9 @@
 #include <proton/error.h>
 #include <proton/message.h>
 #include <stdarg.h>
+#include <string.h>
+
+#include <vector>
 
 using namespace pn_test;
 
@@ -94,3 +97,95 @@ TEST_CASE("message_inferred") {
   pn_message_free(src);
   pn_message_free(dst);
 }
+
+TEST_CASE("message_encoded_size") {
+  pn_message_t *src = pn_message();
+  pn_message_t *dst = pn_message();
+
+  pn_message_set_address(src, "example");
+  pn_data_put_int(pn_message_annotations(src), 1);
+  std::string payload(100000, 'x');
+  pn_data_put_binary(pn_message_body(src), pn_bytes(payload.size(), payload.data()));
+
+  ssize_t size = pn_message_encoded_size(src);
+  REQUIRE(size > (ssize_t)payload.size());
+
+  /* Exactly the measured size is enough, one byte less is not */
+  std::vector<char> buf(size);
+  size_t n = size - 1;
+  CHECK(PN_OVERFLOW == pn_message_encode(src, buf.data(), &n));
+  n = size;
+  CHECK(0 == pn_message_encode(src, buf.data(), &n));
+  CHECK((size_t)size == n);
+
+  /* pn_message_encode2 allocates just what it needs */
+  pn_rwbytes_t rw = {0, NULL};
+  CHECK(size == pn_message_encode2(src, &rw));
+  CHECK((size_t)size == rw.size);
+  CHECK(0 == memcmp(buf.data(), rw.start, size));
+  free(rw.start);
+
+  REQUIRE(0 == pn_message_decode(dst, buf.data(), n));
+  CHECK("example" == std::string(pn_message_get_address(dst)));
+  pn_data_t *body = pn_message_body(dst);
+  REQUIRE(pn_data_next(body));
+  CHECK(payload == std::string(pn_data_get_binary(body).start, pn_data_get_binary(body).size));
+
+  pn_message_free(src);
+  pn_message_free(dst);
+}
+
+TEST_CASE("message_decode_borrowed") {
+  pn_message_t *src = pn_message();
+  pn_message_t *dst = pn_message();
+
+  pn_message_set_address(src, "example");
+  pn_data_put_int(pn_message_properties(src), 42);
+  std::string payload(100000, 'x');
+  pn_data_put_binary(pn_message_body(src), pn_bytes(payload.size(), payload.data()));
+  pn_rwbytes_t buf = {0, NULL};
+  ssize_t size = pn_message_encode2(src, &buf);
+  REQUIRE(size > 0);
+
+  REQUIRE(0 == pn_message_decode_borrowed(dst, buf.start, size));
+  CHECK("example" == std::string(pn_message_get_address(dst)));
+  /* The body refers into the encoded bytes */
+  pn_bytes_t body = pn_message_get_body_bytes(dst);
+  CHECK(payload.size() == body.size);
+  CHECK(body.start > buf.start);
+  CHECK(body.start + body.size <= buf.start + size);
+  CHECK(payload == std::string(body.start, body.size));
+
+  /* Sections accessed as pn_data_t are decoded out of the borrowed bytes */
+  pn_data_t *props = pn_message_properties(dst);
+  REQUIRE(pn_data_next(props));
+  CHECK(42 == pn_data_get_int(props));
+  pn_data_t *data = pn_message_body(dst);
+  CHECK(0 == pn_message_get_body_bytes(dst).size);
+  memset(buf.start, 0, size);
+  REQUIRE(pn_data_next(data));
+  CHECK(payload == std::string(pn_data_get_binary(data).start, pn_data_get_binary(data).size));
+
+  /* Re-encoding after the borrowed bytes are gone only uses copies */
+  free(buf.start);
+  buf.start = NULL;
+  buf.size = 0;
+  CHECK(pn_message_encode2(dst, &buf) == size);
+  free(buf.start);
+
+  /* A borrowing message can be cleared, decoded again or freed safely */
+  std::vector<char> encoded(size);
+  size_t n = size;
+  REQUIRE(0 == pn_message_encode(src, encoded.data(), &n));
+  REQUIRE(0 == pn_message_decode_borrowed(dst, encoded.data(), n));
+  REQUIRE(0 == pn_message_decode(dst, encoded.data(), n));
+  const char *copied = pn_message_get_body_bytes(dst).start;
+  CHECK((copied < encoded.data() || copied >= encoded.data() + n));
+  REQUIRE(0 == pn_message_decode_borrowed(dst, encoded.data(), n));
+  pn_message_clear(dst);
+  CHECK(0 == pn_message_get_body_bytes(dst).size);
+  REQUIRE(0 == pn_message_decode_borrowed(dst, encoded.data(), n));
+
+  pn_message_free(src);
+  pn_message_free(dst);
+}
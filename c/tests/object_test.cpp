@@ -997,3 +997,67 @@ TEST_CASE("list_heap") {
 
   pn_free(list);
 }
+
+namespace {
+struct counting_allocator_t {
+  size_t allocations;
+  size_t outstanding;
+};
+
+void *counting_allocate(void *context, size_t size) {
+  counting_allocator_t *c = (counting_allocator_t *)context;
+  c->allocations++;
+  c->outstanding += size;
+  return malloc(size);
+}
+
+void *counting_reallocate(void *context, void *ptr, size_t old_size,
+                          size_t size) {
+  counting_allocator_t *c = (counting_allocator_t *)context;
+  c->allocations++;
+  c->outstanding += size - old_size;
+  return realloc(ptr, size);
+}
+
+void counting_deallocate(void *context, void *ptr, size_t size) {
+  counting_allocator_t *c = (counting_allocator_t *)context;
+  c->outstanding -= size;
+  free(ptr);
+}
+} // namespace
+
+TEST_CASE("object_allocator") {
+  counting_allocator_t counts = {0, 0};
+  pn_allocator_t a = {counting_allocate, counting_reallocate,
+                      counting_deallocate, &counts};
+  pn_set_allocator(&a);
+
+  // Small objects are recycled from the thread cache after the first round
+  pn_string_t *s = pn_string("hello");
+  pn_list_t *l = pn_list(PN_OBJECT, 4);
+  pn_list_add(l, s);
+  pn_decref(s);
+  pn_free(l);
+  size_t first = counts.allocations;
+  CHECK(first > 0);
+  for (int i = 0; i < 100; ++i) {
+    s = pn_string("hello");
+    l = pn_list(PN_OBJECT, 4);
+    pn_list_add(l, s);
+    pn_decref(s);
+    pn_free(l);
+  }
+  CHECK(counts.allocations == first);
+
+  // Large buffers always come from the allocator
+  std::string big(4096, 'x');
+  s = pn_string(big.c_str());
+  CHECK(counts.allocations > first);
+  CHECK(big == pn_string_get(s));
+  pn_free(s);
+
+  // Everything is returned once the cache is flushed
+  pn_allocator_flush();
+  CHECK(counts.outstanding == 0);
+  pn_set_allocator(NULL);
+}
@@ -28,12 +28,16 @@
 #include <proton/listener.h>
 #include <proton/netaddr.h>
 #include <proton/proactor.h>
+#include <proton/proactor_ext.h>
 #include <proton/session.h>
 #include <proton/ssl.h>
 #include <proton/transport.h>
 
+#include <algorithm>
+#include <chrono>
 #include <string.h>
 #include <filesystem>
+#include <thread>
 
 using namespace pn_test;
 using Catch::Matchers::Contains;
@@ -271,6 +275,89 @@ TEST_CASE("proactor_connection_wake") {
   pn_decref(c);
 }
 
+namespace {
+/* Accept connections into another proactor */
+struct shard_handler : public common_handler {
+  pn_proactor_t *shard;
+  explicit shard_handler(pn_proactor_t *p) : shard(p) {}
+
+  bool handle(pn_event_t *e) override {
+    switch (pn_event_type(e)) {
+    case PN_LISTENER_ACCEPT:
+      listener = pn_event_listener(e);
+      connection = pn_connection();
+      pn_proactor_accept(shard, listener, connection, NULL);
+      return false;
+    default:
+      return common_handler::handle(e);
+    }
+  }
+};
+} // namespace
+
+/* Connections accepted into another proactor are served entirely by it */
+TEST_CASE("proactor_accept_shard") {
+  common_handler sh;
+  proactor shard(&sh);
+  shard_handler h(shard);
+  proactor p(&h);
+  pn_listener_t *l = p.listen(":0", &h);
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+
+  pn_connection_t *c = pn_connection();
+  pn_connection_open(c);
+  p.connect(l, NULL, c);
+  /* The server end opens on the shard, then the client end on p */
+  REQUIRE(PN_CONNECTION_REMOTE_OPEN == shard.corun(p, PN_CONNECTION_REMOTE_OPEN));
+  REQUIRE(PN_CONNECTION_REMOTE_OPEN == p.corun(shard, PN_CONNECTION_REMOTE_OPEN));
+  CHECK(sh.log_clear() == etypes({PN_CONNECTION_INIT, PN_CONNECTION_BOUND, PN_CONNECTION_REMOTE_OPEN}));
+
+  /* Wakes go to the serving proactor */
+  pn_connection_wake(h.connection);
+  REQUIRE(PN_CONNECTION_WAKE == shard.corun(p, PN_CONNECTION_WAKE));
+
+  pn_connection_close(c);
+  pn_connection_wake(c);
+  REQUIRE(PN_TRANSPORT_CLOSED == shard.corun(p, PN_TRANSPORT_CLOSED));
+  REQUIRE(PN_TRANSPORT_CLOSED == p.corun(shard, PN_TRANSPORT_CLOSED));
+  pn_listener_close(l);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+}
+
+/* Listeners sharing a port with SO_REUSEPORT each accept connections */
+TEST_CASE("proactor_listen_reuse_port") {
+  close_on_open_handler h;
+  proactor p(&h);
+  pn_listener_t *l1 = pn_listener();
+  pn_listener_set_reuse_port(l1, true);
+  pn_proactor_listen(p, l1, "127.0.0.1:0", 4);
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+  std::string addr = "127.0.0.1:" + listening_port(l1);
+
+  pn_listener_t *l2 = pn_listener();
+  pn_listener_set_reuse_port(l2, true);
+  pn_proactor_listen(p, l2, addr.c_str(), 4);
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+
+  /* A listener that does not share cannot use the address */
+  pn_listener_t *l3 = pn_listener();
+  pn_proactor_listen(p, l3, addr.c_str(), 4);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+  CHECK_THAT(*h.last_condition, cond_matches("proton:io"));
+
+  const int n = 8;
+  for (int i = 0; i < n; ++i) p.connect(addr);
+  for (int closed = 0; closed < 2 * n; ++closed)
+    REQUIRE_RUN(p, PN_TRANSPORT_CLOSED);
+  etypes log = h.log_clear();
+  CHECK(std::count(log.begin(), log.end(), PN_LISTENER_ACCEPT) == n);
+
+  pn_listener_close(l1);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+  pn_listener_close(l2);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+}
+
 namespace {
 struct abort_handler : public common_handler {
   bool handle(pn_event_t *e) {
@@ -958,3 +1045,333 @@ TEST_CASE("proactor_message_stream") {
   free(h.send_buf.start);
   free(h.recv_buf.start);
 }
+
+namespace {
+void count_completion(void *context) { ++*(int *)context; }
+
+struct zerocopy_handler : public common_handler {
+  pn_bytes_t body;
+  int done;
+  std::string received;
+  bool complete;
+
+  zerocopy_handler() : body(), done(), complete() {}
+
+  bool handle(pn_event_t *e) override {
+    switch (pn_event_type(e)) {
+    case PN_CONNECTION_BOUND:
+      pn_transport_set_zerocopy(pn_event_transport(e), 4096);
+      return false;
+
+    case PN_LINK_REMOTE_OPEN:
+      common_handler::handle(e);
+      if (pn_link_is_receiver(pn_event_link(e))) pn_link_flow(pn_event_link(e), 1);
+      return false;
+
+    case PN_LINK_FLOW: {
+      pn_link_t *l = pn_event_link(e);
+      if (pn_link_is_sender(l) && pn_link_credit(l) > 0 && !pn_link_current(l)) {
+        pn_delivery(l, pn_dtag("x", 1));
+        CHECK((ssize_t)body.size == pn_link_sendv(l, &body, 1, count_completion, &done));
+        CHECK(pn_link_advance(l));
+      }
+      return false;
+    }
+
+    case PN_DELIVERY: {
+      pn_delivery_t *dlv = pn_event_delivery(e);
+      if (pn_link_is_receiver(pn_delivery_link(dlv)) && pn_delivery_readable(dlv)) {
+        char buf[4096];
+        ssize_t n;
+        while ((n = pn_link_recv(pn_event_link(e), buf, sizeof(buf))) > 0) received.append(buf, n);
+        complete = !pn_delivery_partial(dlv);
+        return complete;
+      }
+      return false;
+    }
+    default:
+      return common_handler::handle(e);
+    }
+  }
+};
+} // namespace
+
+/* Test sending a large lent payload that may be sent without copying */
+TEST_CASE("proactor_zerocopy") {
+  zerocopy_handler h;
+  proactor p(&h);
+
+  std::string body(1024 * 1024, 0);
+  for (size_t i = 0; i < body.size(); ++i) body[i] = (char)(i % 251);
+  h.body = pn_bytes(body.size(), body.data());
+
+  pn_listener_t *l = p.listen();
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+  pn_connection_t *c = p.connect(l);
+  pn_session_t *ssn = pn_session(c);
+  pn_session_open(ssn);
+  pn_link_open(pn_sender(ssn, "x"));
+
+  REQUIRE_RUN(p, PN_DELIVERY);
+  while (!h.complete) REQUIRE_RUN(p, PN_DELIVERY);
+  CHECK(h.received == body);
+
+  /* The payload is released once the kernel is done with it */
+  for (int i = 0; i < 1000 && !h.done; ++i) {
+    p.flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(1 == h.done);
+  pn_connection_close(c);
+  pn_connection_wake(c);
+  pn_listener_close(l);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+  REQUIRE_RUN(p, PN_PROACTOR_INACTIVE);
+}
+
+namespace {
+/* Send one large message then small ones, one at a time */
+struct sizing_handler : public common_handler {
+  static const int N = 20;
+  std::string body;
+  int sent = 0;
+  int received = 0;
+  size_t most = 0;
+  size_t last = 0;
+
+  bool handle(pn_event_t *e) override {
+    switch (pn_event_type(e)) {
+    case PN_LINK_REMOTE_OPEN:
+      common_handler::handle(e);
+      if (pn_link_is_receiver(pn_event_link(e))) pn_link_flow(pn_event_link(e), 1);
+      return false;
+
+    case PN_LINK_FLOW: {
+      pn_link_t *l = pn_event_link(e);
+      if (pn_link_is_sender(l) && pn_link_credit(l) > 0 && sent < N) {
+        pn_delivery_t *dlv = pn_delivery(l, pn_dtag((const char *)&sent, sizeof(sent)));
+        size_t size = sent++ ? 10 : body.size();
+        CHECK((ssize_t)size == pn_link_send(l, body.data(), size));
+        CHECK(pn_link_advance(l));
+        pn_delivery_settle(dlv);
+      }
+      return false;
+    }
+
+    case PN_DELIVERY: {
+      pn_delivery_t *dlv = pn_event_delivery(e);
+      pn_link_t *l = pn_delivery_link(dlv);
+      if (pn_link_is_receiver(l) && !pn_delivery_partial(dlv)) {
+        char buf[4096];
+        while (pn_link_recv(l, buf, sizeof(buf)) > 0) {}
+        pn_delivery_settle(dlv);
+        last = pn_transport_capacity(pn_event_transport(e));
+        most = std::max(most, last);
+        if (++received == N) return true;
+        pn_link_flow(l, 1);
+      }
+      return false;
+    }
+    default:
+      return common_handler::handle(e);
+    }
+  }
+};
+} // namespace
+
+/* Test connection buffers grow for large input and shrink once it is small again */
+TEST_CASE("proactor_buffer_sizing") {
+  sizing_handler h;
+  proactor p(&h);
+  h.body = std::string(256 * 1024, 'x');
+
+  pn_listener_t *l = p.listen();
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+  pn_connection_t *c = p.connect(l);
+  pn_session_t *ssn = pn_session(c);
+  pn_session_open(ssn);
+  pn_link_t *snd = pn_sender(ssn, "x");
+  pn_link_set_snd_settle_mode(snd, PN_SND_SETTLED);
+  pn_link_open(snd);
+
+  while (h.received < h.N) REQUIRE_RUN(p, PN_DELIVERY);
+  CHECK(h.most > 16 * 1024);
+  CHECK(h.last <= 1024);
+
+  pn_connection_close(c);
+  pn_connection_wake(c);
+  pn_listener_close(l);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+  REQUIRE_RUN(p, PN_PROACTOR_INACTIVE);
+}
+
+namespace {
+/* Give each connection a different idle timeout, so heartbeats are due at different times */
+struct heartbeat_handler : public common_handler {
+  pn_millis_t next_timeout = 200;
+
+  bool handle(pn_event_t *e) override {
+    switch (pn_event_type(e)) {
+    case PN_CONNECTION_BOUND:
+      pn_transport_set_idle_timeout(pn_event_transport(e), next_timeout);
+      next_timeout += 50;
+      return false;
+    case PN_PROACTOR_TIMEOUT:
+      return true;
+    default:
+      return common_handler::handle(e);
+    }
+  }
+};
+} // namespace
+
+/* Test connection heartbeats keep idle connections open alongside the proactor timeout */
+TEST_CASE("proactor_heartbeat") {
+  heartbeat_handler h;
+  proactor p(&h);
+  pn_listener_t *l = p.listen();
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+
+  const int n = 8;
+  std::vector<pn_connection_t *> cs;
+  for (int i = 0; i < n; ++i) cs.push_back(p.connect(l));
+  for (int i = 0; i < 2 * n; ++i) REQUIRE_RUN(p, PN_CONNECTION_REMOTE_OPEN);
+
+  pn_proactor_set_timeout(p, 1000);
+  REQUIRE_RUN(p, PN_PROACTOR_TIMEOUT);
+  for (pn_connection_t *c : cs) {
+    pn_transport_t *t = pn_connection_transport(c);
+    /* The peer sends a frame every half idle timeout */
+    INFO("idle timeout " << pn_transport_get_idle_timeout(t));
+    CHECK(pn_transport_get_frames_input(t) > 1000 / pn_transport_get_idle_timeout(t));
+    pn_connection_close(c);
+    pn_connection_wake(c);
+  }
+  pn_listener_close(l);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+  REQUIRE_RUN(p, PN_PROACTOR_INACTIVE);
+}
+
+namespace {
+/* Send pre-settled messages as fast as credit allows */
+struct firehose_handler : public common_handler {
+  static const int N = 2000;
+  int sent = 0;
+  int received = 0;
+  unsigned server_weight = 1;
+
+  bool handle(pn_event_t *e) override {
+    switch (pn_event_type(e)) {
+    case PN_CONNECTION_BOUND:
+      if (pn_event_connection(e) == connection) /* Accepted */
+        pn_connection_set_sched_weight(pn_event_connection(e), server_weight);
+      return false;
+    case PN_LINK_REMOTE_OPEN:
+      common_handler::handle(e);
+      if (pn_link_is_receiver(pn_event_link(e))) pn_link_flow(pn_event_link(e), N);
+      return false;
+    case PN_LINK_FLOW: {
+      pn_link_t *l = pn_event_link(e);
+      while (pn_link_is_sender(l) && pn_link_credit(l) > 0 && sent < N) {
+        pn_delivery_t *d = pn_delivery(l, pn_dtag((const char *)&sent, sizeof(sent)));
+        pn_link_send(l, "x", 1);
+        pn_link_advance(l);
+        pn_delivery_settle(d);
+        ++sent;
+      }
+      return false;
+    }
+    case PN_DELIVERY: {
+      pn_delivery_t *d = pn_event_delivery(e);
+      if (pn_link_is_receiver(pn_delivery_link(d)) && !pn_delivery_partial(d)) {
+        pn_delivery_settle(d);
+        ++received;
+      }
+      return false;
+    }
+    default:
+      return common_handler::handle(e);
+    }
+  }
+};
+} // namespace
+
+/* Test limiting the events a connection handles per batch */
+TEST_CASE("proactor_sched_limit") {
+  firehose_handler h;
+  proactor p(&h);
+  if (!pn_proactor_get_sched_limit(p, PN_SCHED_REPLENISH)) return; /* Proactor does not limit batches */
+  CHECK(0 == pn_proactor_get_sched_limit(p, PN_SCHED_EVENTS));
+  pn_proactor_set_sched_limit(p, PN_SCHED_EVENTS, 4);
+  CHECK(4 == pn_proactor_get_sched_limit(p, PN_SCHED_EVENTS));
+
+  SECTION("equal") {}
+  SECTION("weighted") { h.server_weight = 3; } /* For the receiver, which has the most events */
+
+  pn_listener_t *l = p.listen();
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+  pn_connection_t *c = p.connect(l);
+  pn_session_t *ssn = pn_session(c);
+  pn_session_open(ssn);
+  pn_link_t *snd = pn_sender(ssn, "x");
+  pn_link_set_snd_settle_mode(snd, PN_SND_SETTLED);
+  pn_link_open(snd);
+
+  size_t most = 0;
+  while (h.received < h.N) {
+    pn_event_batch_t *b = pn_proactor_wait(p);
+    pn_connection_t *bc = pn_event_batch_connection(b);
+    size_t n = 0;
+    while (pn_event_t *e = pn_event_batch_next(b)) {
+      h.handle(e);
+      ++n;
+    }
+    pn_proactor_done(p, b);
+    size_t weight = (bc && bc != c) ? h.server_weight : 1;
+    CHECK(n <= 4 * weight);
+    if (bc && bc != c) most = std::max(most, n);
+  }
+  CHECK(most == 4 * h.server_weight);
+  CHECK(pn_proactor_sched_limit_hits(p, PN_SCHED_EVENTS) > 0);
+  CHECK(0 == pn_proactor_sched_limit_hits(p, PN_SCHED_BYTES));
+
+  pn_connection_close(c);
+  pn_connection_wake(c);
+  pn_listener_close(l);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+  REQUIRE_RUN(p, PN_PROACTOR_INACTIVE);
+}
+
+TEST_CASE("proactor_busy_poll") {
+  firehose_handler h;
+  proactor p(&h);
+  pn_proactor_set_busy_poll(p, 200);
+  if (!pn_proactor_get_busy_poll(p)) return; /* Proactor does not busy poll */
+  CHECK(200 == pn_proactor_get_busy_poll(p));
+  pn_proactor_set_socket_busy_poll(p, 50);
+
+  /* Timers still fire while the poller spins */
+  pn_proactor_set_timeout(p, 1);
+  REQUIRE_RUN(p, PN_PROACTOR_TIMEOUT);
+  REQUIRE_RUN(p, PN_PROACTOR_INACTIVE);
+
+  pn_listener_t *l = p.listen();
+  REQUIRE_RUN(p, PN_LISTENER_OPEN);
+  pn_connection_t *c = p.connect(l);
+  pn_session_t *ssn = pn_session(c);
+  pn_session_open(ssn);
+  pn_link_t *snd = pn_sender(ssn, "x");
+  pn_link_set_snd_settle_mode(snd, PN_SND_SETTLED);
+  pn_link_open(snd);
+  while (h.received < h.N) {
+    pn_event_batch_t *b = pn_proactor_wait(p);
+    while (pn_event_t *e = pn_event_batch_next(b)) h.handle(e);
+    pn_proactor_done(p, b);
+  }
+
+  pn_connection_close(c);
+  pn_connection_wake(c);
+  pn_listener_close(l);
+  REQUIRE_RUN(p, PN_LISTENER_CLOSE);
+  REQUIRE_RUN(p, PN_PROACTOR_INACTIVE);
+}
@@ -28,6 +28,7 @@
 #include <proton/listener.h>
 #include <proton/netaddr.h>
 #include <proton/proactor.h>
+#include <proton/proactor_ext.h>
 #include <proton/session.h>
 #include <proton/sasl.h>
 #include <proton/ssl.h>
@@ -325,3 +326,71 @@ TEST_CASE("ssl certificate verification tests") {
 #endif
   }
 }
+
+TEST_CASE("ssl crypto offload") {
+  struct app_data_t app = {0};
+
+  app.container_id = "ssl-test";
+  app.amqp_address = "fubar";
+
+  pn_test::auto_free<pn_proactor_t, pn_proactor_free> proactor(pn_proactor());
+
+  pn_test::auto_free<pn_ssl_domain_t, pn_ssl_domain_free>
+    sd(pn_ssl_domain(PN_SSL_MODE_SERVER));
+  app.server_ssl_domain = sd;
+  REQUIRE(SET_CREDENTIALS(sd, "tserver") == 0);
+
+  pn_transport_t *t = pn_transport();
+  pn_test::auto_free<pn_ssl_domain_t, pn_ssl_domain_free>
+    cd(pn_ssl_domain(PN_SSL_MODE_CLIENT));
+  REQUIRE(pn_ssl_domain_set_trusted_ca_db(cd, CERTIFICATE("tserver")) == 0);
+  REQUIRE(pn_ssl_domain_set_peer_authentication(cd, PN_SSL_VERIFY_PEER_NAME, NULL) == 0);
+  REQUIRE(pn_ssl_init(pn_ssl(t), cd, NULL) == 0);
+
+  SECTION("Handshakes complete on the offload threads") {
+    pn_proactor_set_crypto_offload(proactor, 2, 0);
+    REQUIRE(pn_ssl_set_peer_hostname(pn_ssl(t), "test_server") == 0);
+
+    setup_connection(proactor, t);
+
+    run(proactor, &app, server_handler, client_handler);
+    CHECK(app.connection_succeeded==true);
+    CHECK(app.transport_error==false);
+    /* At least the server's read of the client hello, the client may read within a batch */
+    if (!pn_proactor_crypto_offloads(proactor)) WARN("Proactor does not offload");
+  }
+
+  SECTION("Handshake failures are reported from the offload threads") {
+    pn_proactor_set_crypto_offload(proactor, 2, 0);
+    REQUIRE(pn_ssl_set_peer_hostname(pn_ssl(t), "wrong_server") == 0);
+
+    setup_connection(proactor, t);
+
+    run(proactor, &app, server_handler, client_handler);
+    CHECK(app.connection_succeeded==false);
+    CHECK(app.transport_error==true);
+  }
+
+  SECTION("Reads over the threshold are offloaded after the handshake") {
+    pn_proactor_set_crypto_offload(proactor, 1, 1);
+    REQUIRE(pn_ssl_set_peer_hostname(pn_ssl(t), "test_server") == 0);
+
+    setup_connection(proactor, t);
+
+    run(proactor, &app, server_handler, client_handler);
+    CHECK(app.connection_succeeded==true);
+    CHECK(app.transport_error==false);
+  }
+
+  SECTION("Offloading can be turned off again") {
+    pn_proactor_set_crypto_offload(proactor, 2, 0);
+    pn_proactor_set_crypto_offload(proactor, 0, 0);
+    REQUIRE(pn_ssl_set_peer_hostname(pn_ssl(t), "test_server") == 0);
+
+    setup_connection(proactor, t);
+
+    run(proactor, &app, server_handler, client_handler);
+    CHECK(app.connection_succeeded==true);
+    CHECK(0 == pn_proactor_crypto_offloads(proactor));
+  }
+}
@@ -17,10 +17,16 @@
  * under the License.
  */
 
+#include <proton/connection.h>
 #include <proton/ssl.h>
+#include <proton/transport.h>
 
 #include "./pn_test.hpp"
 
+#include <stdlib.h>
+
+#include <string>
+
 TEST_CASE("ssl_protocols") {
   if (!pn_ssl_present()) {
     WARN("SSL not available, skipping");
@@ -70,3 +76,121 @@ TEST_CASE("ssl_protocols") {
   // Known followed by unknown protocols
   CHECK(pn_ssl_domain_set_protocols(sd, "TLSv1 TLSv1.x;TLSv1_2") == PN_ARG_ERR);
 }
+
+namespace {
+
+std::string cert_file(const char *name) {
+  const char *dir = getenv("TEST_CERT_DIR");
+  return std::string(dir ? dir : "ssl-certs") + "/" + name;
+}
+
+struct echo_open_close_handler : public pn_test::handler {
+  bool stop_on_open;
+  explicit echo_open_close_handler(bool stop) : stop_on_open(stop) {}
+
+  bool handle(pn_event_t *e) override {
+    switch (pn_event_type(e)) {
+    case PN_CONNECTION_REMOTE_OPEN:
+      pn_connection_open(pn_event_connection(e));
+      return stop_on_open;
+    case PN_CONNECTION_REMOTE_CLOSE:
+      pn_connection_close(pn_event_connection(e));
+      break;
+    default:
+      break;
+    }
+    return false;
+  }
+};
+
+// Open a connection, then close it cleanly so the client saves its session
+pn_ssl_resume_status_t connect(pn_ssl_domain_t *client_domain, pn_ssl_domain_t *server_domain,
+                               const char *session_id) {
+  echo_open_close_handler ch(true), sh(false);
+  pn_test::driver_pair d(ch, sh);
+  pn_ssl_t *client_ssl = pn_ssl(d.client.transport);
+  REQUIRE(pn_ssl_init(client_ssl, client_domain, session_id) == 0);
+  REQUIRE(pn_ssl_set_peer_hostname(client_ssl, "test_server") == 0);
+  REQUIRE(pn_ssl_init(pn_ssl(d.server.transport), server_domain, NULL) == 0);
+  d.run();
+  CHECK_THAT(*pn_transport_condition(d.client.transport), pn_test::cond_empty());
+  REQUIRE(pn_connection_state(d.client.connection) & PN_REMOTE_ACTIVE);
+  pn_ssl_resume_status_t status = pn_ssl_resume_status(client_ssl);
+  // Not d.run(), which would open the connection again
+  pn_connection_close(d.client.connection);
+  do {
+    d.client.run();
+    d.server.run();
+  } while (d.client.read(d.server) + d.server.read(d.client));
+  CHECK(pn_connection_driver_finished(&d.client));
+  return status;
+}
+
+} // namespace
+
+TEST_CASE("ssl_session_cache") {
+  if (!pn_ssl_present()) {
+    WARN("SSL not available, skipping");
+    return;
+  }
+  pn_test::auto_free<pn_ssl_domain_t, pn_ssl_domain_free> cd(
+      pn_ssl_domain(PN_SSL_MODE_CLIENT));
+  pn_test::auto_free<pn_ssl_domain_t, pn_ssl_domain_free> sd(
+      pn_ssl_domain(PN_SSL_MODE_SERVER));
+  REQUIRE(pn_ssl_domain_set_credentials(sd, cert_file("tserver-certificate.pem").c_str(),
+                                        cert_file("tserver-private-key.pem").c_str(), "tserverpw") == 0);
+  REQUIRE(pn_ssl_domain_set_trusted_ca_db(cd, cert_file("tserver-certificate.pem").c_str()) == 0);
+  REQUIRE(pn_ssl_domain_set_peer_authentication(cd, PN_SSL_VERIFY_PEER_NAME, NULL) == 0);
+
+  CHECK(connect(cd, sd, "a") == PN_SSL_RESUME_NEW);
+  CHECK(connect(cd, sd, "a") == PN_SSL_RESUME_REUSED);
+  CHECK(connect(cd, sd, "b") == PN_SSL_RESUME_NEW);
+  CHECK(connect(cd, sd, "a") == PN_SSL_RESUME_REUSED);
+  CHECK(connect(cd, sd, NULL) == PN_SSL_RESUME_NEW);
+
+  uint64_t hits = 0, misses = 0;
+  pn_ssl_domain_get_session_stats(cd, &hits, &misses);
+  CHECK(hits == 2);
+  CHECK(misses == 3);
+  pn_ssl_domain_get_session_stats(sd, &hits, &misses);
+  CHECK(hits == 2);
+  CHECK(misses == 3);
+
+  // Least recently used sessions are dropped
+  REQUIRE(pn_ssl_domain_set_session_cache(cd, 1, 0) == 0);
+  CHECK(connect(cd, sd, "b") == PN_SSL_RESUME_NEW);
+  CHECK(connect(cd, sd, "a") == PN_SSL_RESUME_NEW);
+  CHECK(connect(cd, sd, "a") == PN_SSL_RESUME_REUSED);
+
+  // Server side cache and tickets off
+  REQUIRE(pn_ssl_domain_set_session_cache(sd, 0, 0) == 0);
+  REQUIRE(pn_ssl_domain_set_session_ticket_keys(sd, NULL, 0) == 0);
+  CHECK(connect(cd, sd, "a") == PN_SSL_RESUME_NEW);
+  CHECK(connect(cd, sd, "a") == PN_SSL_RESUME_NEW);
+}
+
+TEST_CASE("ssl_session_ticket_keys") {
+  if (!pn_ssl_present()) {
+    WARN("SSL not available, skipping");
+    return;
+  }
+  pn_test::auto_free<pn_ssl_domain_t, pn_ssl_domain_free> cd(
+      pn_ssl_domain(PN_SSL_MODE_CLIENT));
+  REQUIRE(pn_ssl_domain_set_peer_authentication(cd, PN_SSL_ANONYMOUS_PEER, NULL) == 0);
+  CHECK(pn_ssl_domain_set_session_ticket_keys(cd, NULL, 0) == PN_ARG_ERR);
+
+  // Tickets from one server are accepted by another with the same keys
+  char keys[80];
+  for (size_t i = 0; i < sizeof(keys); ++i) keys[i] = (char)i;
+  pn_ssl_domain_t *sd[2];
+  for (auto &d : sd) {
+    d = pn_ssl_domain(PN_SSL_MODE_SERVER);
+    REQUIRE(pn_ssl_domain_set_credentials(d, cert_file("tserver-certificate.pem").c_str(),
+                                          cert_file("tserver-private-key.pem").c_str(), "tserverpw") == 0);
+    CHECK(pn_ssl_domain_set_session_ticket_keys(d, keys, 1) == PN_ARG_ERR);
+    REQUIRE(pn_ssl_domain_set_session_ticket_keys(d, keys, sizeof(keys)) == 0);
+  }
+  CHECK(connect(cd, sd[0], "a") == PN_SSL_RESUME_NEW);
+  CHECK(connect(cd, sd[1], "a") == PN_SSL_RESUME_REUSED);
+  for (auto d : sd) pn_ssl_domain_free(d);
+}
@@ -226,6 +226,17 @@ TEST_CASE("handshake and data") {
   REQUIRE( pn_tls_take_decrypt_input_buffers(srv_tls, rb_array, 2) == 1 );
   REQUIRE( pn_tls_is_input_closed(srv_tls) == true );
 
+  /* one full handshake on each side */
+
+  uint64_t hits = 1, misses = 0;
+  pn_tls_config_get_session_stats(client_config, &hits, &misses);
+  CHECK( hits == 0 );
+  CHECK( misses == 1 );
+  hits = 1, misses = 0;
+  pn_tls_config_get_session_stats(server_config, &hits, &misses);
+  CHECK( hits == 0 );
+  CHECK( misses == 1 );
+
   /* clean up */
 
   pn_tls_stop(cli_tls);
@@ -427,6 +438,26 @@ struct TestPair {
   }
 };
 
+TEST_CASE("session cache config") {
+  pn_tls_config_t *client_config = pn_tls_config(PN_TLS_MODE_CLIENT);
+  pn_tls_config_t *server_config = pn_tls_config(PN_TLS_MODE_SERVER);
+  REQUIRE( client_config );
+  REQUIRE( server_config );
+
+  CHECK( pn_tls_config_set_session_cache(client_config, 10, 0) == PN_ARG_ERR );
+  CHECK( pn_tls_config_set_session_ticket_keys(client_config, NULL, 0) == PN_ARG_ERR );
+
+  char keys[80] = {0};
+  CHECK( pn_tls_config_set_session_cache(server_config, 1000, 60) == 0 );
+  CHECK( pn_tls_config_set_session_cache(server_config, 0, 0) == 0 );
+  CHECK( pn_tls_config_set_session_ticket_keys(server_config, keys, 1) == PN_ARG_ERR );
+  CHECK( pn_tls_config_set_session_ticket_keys(server_config, keys, sizeof(keys)) == 0 );
+  CHECK( pn_tls_config_set_session_ticket_keys(server_config, NULL, 0) == 0 );
+
+  pn_tls_config_free(client_config);
+  pn_tls_config_free(server_config);
+}
+
 TEST_CASE("default - no data") {
   TestPair tp;
   tp.init();  // just use default setup
@@ -57,6 +57,34 @@ class binary : public std::vector<uint8_t> {
 /// Print a binary value
 PN_CPP_EXTERN std::ostream& operator<<(std::ostream&, const binary&);
 
+/// **Unsettled API** - A read-only view of binary data owned elsewhere.
+///
+/// The viewed memory must outlive the view.
+class binary_view {
+  public:
+    /// @name Constructors
+    /// @{
+    binary_view() = default;
+    binary_view(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    binary_view(const char* data, size_t size) : data_(reinterpret_cast<const uint8_t*>(data)), size_(size) {}
+    binary_view(const binary& b) : data_(b.data()), size_(b.size()) {}
+    binary_view(const std::string& s) : data_(reinterpret_cast<const uint8_t*>(s.data())), size_(s.size()) {}
+    /// @}
+
+    /// The start of the data
+    const uint8_t* data() const { return data_; }
+
+    /// The number of bytes of data
+    size_t size() const { return size_; }
+
+    /// True if there is no data
+    bool empty() const { return size_ == 0; }
+
+  private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
 } // proton
 
 /// Specialize std::hash so we can use proton::binary as a key for unordered datastructures
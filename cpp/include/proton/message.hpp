@@ -325,6 +325,7 @@ class message {
     mutable pn_message_t* pn_msg_;
 
   PN_CPP_EXTERN friend void swap(message&, message&);
+  friend void message_decode(message&, delivery);
     /// @endcond
 };
 
@@ -22,14 +22,19 @@
  *
  */
 
+#include "./binary.hpp"
 #include "./fwd.hpp"
 #include "./internal/export.hpp"
 #include "./link.hpp"
 #include "./tracker.hpp"
 
+#include <functional>
+#include <vector>
+
 /// @file
 /// @copybrief proton::sender
 
+struct pn_delivery_t;
 struct pn_link_t;
 struct pn_session_t;
 
@@ -58,6 +63,22 @@ PN_CPP_CLASS_EXTERN sender : public link {
     PN_CPP_EXTERN tracker send(const message &m);
     PN_CPP_EXTERN tracker send(const message &m, const binary &tag);
 
+    /// **Unsettled API** - Send an already encoded message made up of
+    /// several segments, copying them all in one go.
+    PN_CPP_EXTERN tracker send(const std::vector<binary_view> &segments);
+    PN_CPP_EXTERN tracker send(const std::vector<binary_view> &segments, const binary &tag);
+
+    /// **Unsettled API** - Send an already encoded message made up of
+    /// several segments without copying them.
+    ///
+    /// The viewed memory must stay valid and unchanged until
+    /// `on_done` is called, on the connection's thread, once it is no
+    /// longer needed. The segments are only written out without a
+    /// copy on connections that allow it, see pn_link_sendv().
+    /// `on_done` must not throw.
+    PN_CPP_EXTERN tracker send(const std::vector<binary_view> &segments, const binary &tag,
+                               std::function<void()> on_done);
+
     /// Get the source node.
     PN_CPP_EXTERN class source source() const;
 
@@ -83,6 +104,11 @@ PN_CPP_CLASS_EXTERN sender : public link {
 
   private:
     /// @cond INTERNAL
+    binary next_tag();
+    tracker send_segments(const std::vector<binary_view> &segments, const binary &tag,
+                          std::function<void()> *on_done);
+    tracker sent(pn_delivery_t *dlv);
+
     uint64_t tag_counter = 0;
     /// @endcond
 };
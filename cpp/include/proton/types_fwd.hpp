@@ -29,6 +29,7 @@
 namespace proton {
 
 class binary;
+class binary_view;
 class decimal128;
 class decimal32;
 class decimal64;
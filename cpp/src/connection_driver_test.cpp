@@ -509,6 +509,34 @@ void test_message() {
     ASSERT_EQUAL(value("b"), m2.message_annotations().get("a"));
 }
 
+void test_message_segments() {
+    // Verify an already encoded message sent in pieces arrives intact
+    record_handler ha, hb;
+    driver_pair d(ha, hb);
+
+    proton::sender s = d.a.connection().open_sender("x");
+    proton::message m("segments");
+    m.message_annotations().put("a", "b");
+    std::vector<char> encoded;
+    m.encode(encoded);
+    std::string head(encoded.begin(), encoded.begin() + 5);
+    std::vector<proton::binary_view> segments = {
+        head, proton::binary_view(encoded.data() + 5, encoded.size() - 5)};
+    s.send(segments);
+    bool done = false;
+    s.send(segments, binary("lent"), [&done]() { done = true; });
+
+    while (hb.messages.size() < 2)
+        d.process();
+
+    ASSERT(done);
+    for (int i = 0; i < 2; ++i) {
+        proton::message m2 = quick_pop(hb.messages);
+        ASSERT_EQUAL(value("segments"), m2.body());
+        ASSERT_EQUAL(value("b"), m2.message_annotations().get("a"));
+    }
+}
+
 void test_message_timeout_succeed() {
     // Verify a message arrives intact
     record_handler ha, hb;
@@ -569,6 +597,7 @@ int main(int argc, char** argv) {
     RUN_ARGV_TEST(failed, test_link_capability_filter());
     RUN_ARGV_TEST(failed, test_terminus_capabilities_single_symbol());
     RUN_ARGV_TEST(failed, test_message());
+    RUN_ARGV_TEST(failed, test_message_segments());
     RUN_ARGV_TEST(failed, test_message_timeout_succeed());
     RUN_ARGV_TEST(failed, test_message_timeout_fail());
     return failed;
@@ -83,6 +83,9 @@ message::~message() {
 
 void swap(message& x, message& y) {
     std::swap(x.pn_msg_, y.pn_msg_);
+    // A message decoded in place from a delivery must not outlive it elsewhere
+    if (x.pn_msg_) pni_message_own(x.pn_msg_);
+    if (y.pn_msg_) pni_message_own(y.pn_msg_);
 }
 
 pn_message_t *message::pn_msg() const {
@@ -282,20 +285,13 @@ const message::annotation_map& message::delivery_annotations() const {
 
 void message::encode(std::vector<char> &s) const {
     impl().flush();
-    size_t sz = std::max(s.capacity(), size_t(512));
-    while (true) {
-        s.resize(sz);
-        assert(!s.empty());
-        int err = pn_message_encode(pn_msg(), const_cast<char*>(&s[0]), &sz);
-        if (err) {
-            if (err != PN_OVERFLOW)
-                check(err);
-        } else {
-            s.resize(sz);
-            return;
-        }
-        sz *= 2;
-    }
+    ssize_t encoded = pn_message_encoded_size(pn_msg());
+    if (encoded < 0) check(int(encoded));
+    size_t sz = size_t(encoded);
+    s.resize(sz);
+    assert(!s.empty());
+    check(pn_message_encode(pn_msg(), const_cast<char*>(&s[0]), &sz));
+    s.resize(sz);
 }
 
 std::vector<char> message::encode() const {
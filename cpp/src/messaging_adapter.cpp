@@ -94,21 +94,23 @@ void on_link_flow(messaging_handler& handler, pn_event_t* event) {
     }
 }
 
+} // namespace
+
 // Decode the message corresponding to a delivery from a link.
+// The message refers into the delivery's bytes, which stay put until it is settled.
 void message_decode(message& msg, proton::delivery delivery) {
-    std::vector<char> buf;
-    buf.resize(pn_delivery_pending(unwrap(delivery)));
-    if (buf.empty())
+    pn_bytes_t bytes = pn_delivery_bytes(unwrap(delivery));
+    if (!bytes.size)
         throw error("message decode: no delivery pending on link");
     proton::receiver link = delivery.receiver();
-    assert(!buf.empty());
-    ssize_t n = pn_link_recv(unwrap(link), const_cast<char *>(&buf[0]), buf.size());
-    if (n != ssize_t(buf.size())) throw error(MSG("receiver read failure"));
     msg.clear();
-    msg.decode(buf);
+    int err = pn_message_decode_borrowed(msg.pn_msg(), bytes.start, bytes.size);
+    if (err) throw error(MSG("message decode: " << error_str(pn_message_error(msg.pn_msg()), err)));
     pn_link_advance(unwrap(link));
 }
 
+namespace {
+
 bool transaction_coordinator_sender(const sender& s) {
     auto& txn_context = session_context::get(unwrap(s.session())).transaction_context_;
     return txn_context && (txn_context->coordinator == unwrap(s));
@@ -375,6 +377,8 @@ void on_delivery(messaging_handler& handler, pn_event_t* event) {
                 ot.on_message_handler(handler, d, msg);
                 if (lctx.auto_accept && pn_delivery_local_state(dlv) == 0) // Not set by handler
                     d.accept();
+                // Don't leave the message referring to a delivery that may be gone
+                msg.clear();
                 if (lctx.draining && !pn_link_credit(lnk)) {
                     lctx.draining = false;
                     pn_link_set_drain(lnk, false);
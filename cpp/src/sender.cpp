@@ -21,6 +21,7 @@
 
 #include "proton/sender.hpp"
 
+#include "proton/error.hpp"
 #include "proton/link.hpp"
 #include "proton/sender_options.hpp"
 #include "proton/session.hpp"
@@ -36,8 +37,10 @@
 #include "contexts.hpp"
 #include "tracing_private.hpp"
 #include "types_internal.hpp"
+#include "msg.hpp"
 
 #include <assert.h>
+#include <memory>
 
 namespace proton {
 
@@ -62,11 +65,14 @@ class target sender::target() const {
     return proton::target(*this);
 }
 
-tracker sender::send(const message &message) {
+binary sender::next_tag() {
     uint64_t id = ++tag_counter;
     const uint8_t *begin = reinterpret_cast<const uint8_t *>(&id);
-    const binary tag(begin, begin + sizeof(id));
-    return send(message, tag);
+    return binary(begin, begin + sizeof(id));
+}
+
+tracker sender::send(const message &message) {
+    return send(message, next_tag());
 }
 
 tracker sender::send(const message &message, const binary &tag) {
@@ -81,6 +87,53 @@ tracker sender::send(const message &message, const binary &tag) {
 
     assert(!buf.empty());
     pn_link_send(pn_object(), &buf[0], buf.size());
+    return sent(dlv);
+}
+
+tracker sender::send(const std::vector<binary_view> &segments) {
+    return send_segments(segments, next_tag(), nullptr);
+}
+
+tracker sender::send(const std::vector<binary_view> &segments, const binary &tag) {
+    return send_segments(segments, tag, nullptr);
+}
+
+tracker sender::send(const std::vector<binary_view> &segments, const binary &tag,
+                     std::function<void()> on_done) {
+    return send_segments(segments, tag, new std::function<void()>(std::move(on_done)));
+}
+
+namespace {
+extern "C" void sender_segments_done(void *context) {
+    std::unique_ptr<std::function<void()>> on_done(static_cast<std::function<void()>*>(context));
+    if (*on_done) (*on_done)();
+}
+}
+
+tracker sender::send_segments(const std::vector<binary_view> &segments, const binary &tag,
+                              std::function<void()> *on_done) {
+    std::unique_ptr<std::function<void()>> done(on_done);
+    std::vector<pn_bytes_t> segs;
+    segs.reserve(segments.size());
+    for (const auto& s : segments) {
+        segs.push_back(::pn_bytes(s.size(), reinterpret_cast<const char*>(s.data())));
+    }
+    pn_delivery_t *dlv = pn_delivery(
+        pn_object(),
+        pn_dtag((reinterpret_cast<const char *>(tag.data())), tag.size()));
+    ssize_t err = pn_link_sendv(pn_object(), segs.data(), segs.size(),
+                                done ? sender_segments_done : nullptr, done.get());
+    if (err < 0) {
+        pn_delivery_abort(dlv);
+        throw proton::error(MSG("send: " << error_str(err)));
+    }
+    done.release();
+    return sent(dlv);
+}
+
+// Finish off a delivery once all its data has been sent
+tracker sender::sent(pn_delivery_t *dlv) {
+    tracker track = make_wrapper<tracker>(dlv);
     pn_link_advance(pn_object());
     if (pn_link_snd_settle_mode(pn_object()) == PN_SND_SETTLED)
         pn_delivery_settle(dlv);
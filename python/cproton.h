@@ -112,7 +112,8 @@ typedef enum
   PN_RAW_CONNECTION_READ,
   PN_RAW_CONNECTION_WRITTEN,
   PN_RAW_CONNECTION_WAKE,
-  PN_RAW_CONNECTION_DRAIN_BUFFERS
+  PN_RAW_CONNECTION_DRAIN_BUFFERS,
+  PN_LINK_REMOTE_SETTLED
 } pn_event_type_t;
 typedef enum
 {